@@ -0,0 +1,166 @@
+/* Attribute access benchmark.
+   Compares IupSetAttribute/IupGetAttribute with the atom based functions,
+   for attributes registered in the class and for custom attributes. */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "iup.h"
+
+
+#define ATTRIB_LOOPS 1000000
+
+static const char* attrib_names[] = { "TITLE", "ALIGNMENT", "EXPAND", "ACTIVE", "TIP", "MY_VALUE", "MY_DATA", "MY_OTHER" };
+#define ATTRIB_COUNT (int)(sizeof(attrib_names) / sizeof(attrib_names[0]))
+
+static char attrib_log[2048] = "";
+
+static void attrib_log_line(const char* line)
+{
+  printf("%s\n", line);
+  if (strlen(attrib_log) + strlen(line) + 2 < sizeof(attrib_log))
+  {
+    strcat(attrib_log, line);
+    strcat(attrib_log, "\n");
+  }
+}
+
+static void attrib_log_time(const char* name, clock_t start)
+{
+  char line[256];
+  sprintf(line, "%s: %.1f ns/call", name, (double)(clock() - start) * 1.0e9 / CLOCKS_PER_SEC / ATTRIB_LOOPS);
+  attrib_log_line(line);
+}
+
+static void attrib_benchmark(Ihandle* ih)
+{
+  int atoms[ATTRIB_COUNT];
+  const char* values[] = { "Value1", "Value2" };
+  clock_t start;
+  int i, a, errors = 0;
+  long sum = 0;
+  char line[256];
+
+  for (a = 0; a < ATTRIB_COUNT; a++)
+    atoms[a] = IupAtom(attrib_names[a]);
+
+  /* the string and the atom paths must see the same values */
+  for (a = 0; a < ATTRIB_COUNT; a++)
+  {
+    char *str_value, *atom_value;
+
+    if (strcmp(attrib_names[a], "ALIGNMENT") == 0 || strcmp(attrib_names[a], "EXPAND") == 0 || strcmp(attrib_names[a], "ACTIVE") == 0)
+      continue;  /* these accept only some values */
+
+    IupSetAttributeAtom(ih, atoms[a], values[0]);
+    str_value = IupGetAttribute(ih, attrib_names[a]);
+    IupSetStrAttribute(ih, attrib_names[a], values[1]);
+    atom_value = IupGetAttributeAtom(ih, atoms[a]);
+    if (!str_value || strcmp(str_value, values[0]) != 0 || !atom_value || strcmp(atom_value, values[1]) != 0)
+    {
+      sprintf(line, "FAILED: %s", attrib_names[a]);
+      attrib_log_line(line);
+      errors++;
+    }
+  }
+  if (strcmp(IupAtomName(atoms[0]), attrib_names[0]) != 0)
+  {
+    attrib_log_line("FAILED: IupAtomName");
+    errors++;
+  }
+
+  start = clock();
+  for (i = 0; i < ATTRIB_LOOPS; i++)
+  {
+    char* value = IupGetAttribute(ih, attrib_names[i % ATTRIB_COUNT]);
+    if (value)
+      sum += value[0];
+  }
+  attrib_log_time("IupGetAttribute", start);
+
+  start = clock();
+  for (i = 0; i < ATTRIB_LOOPS; i++)
+  {
+    char* value = IupGetAttributeAtom(ih, atoms[i % ATTRIB_COUNT]);
+    if (value)
+      sum += value[0];
+  }
+  attrib_log_time("IupGetAttributeAtom", start);
+
+  start = clock();
+  for (i = 0; i < ATTRIB_LOOPS; i++)
+    IupSetStrAttribute(ih, attrib_names[5 + i % 3], values[i % 2]);
+  attrib_log_time("IupSetStrAttribute (custom)", start);
+
+  start = clock();
+  for (i = 0; i < ATTRIB_LOOPS; i++)
+    IupSetStrAttributeAtom(ih, atoms[5 + i % 3], values[i % 2]);
+  attrib_log_time("IupSetStrAttributeAtom (custom)", start);
+
+  start = clock();
+  for (i = 0; i < ATTRIB_LOOPS; i++)
+    IupSetStrAttribute(ih, "TIP", values[i % 2]);
+  attrib_log_time("IupSetStrAttribute (TIP)", start);
+
+  start = clock();
+  for (i = 0; i < ATTRIB_LOOPS; i++)
+    IupSetStrAttributeAtom(ih, atoms[4], values[i % 2]);
+  attrib_log_time("IupSetStrAttributeAtom (TIP)", start);
+
+  /* computed values are returned in temporary buffers */
+  start = clock();
+  for (i = 0; i < ATTRIB_LOOPS; i++)
+  {
+    char* value = IupGetAttribute(ih, "RASTERSIZE");
+    if (value)
+      sum += value[0];
+  }
+  attrib_log_time("IupGetAttribute (RASTERSIZE)", start);
+
+  sprintf(line, "Errors: %d (sum %ld)", errors, sum);
+  attrib_log_line(line);
+}
+
+void AttribTest(void)
+{
+  Ihandle *dlg, *label, *text;
+
+  label = IupLabel("Label");
+  text = IupText(NULL);
+  IupSetAttribute(text, "MULTILINE", "YES");
+  IupSetAttribute(text, "READONLY", "YES");
+  IupSetAttribute(text, "EXPAND", "YES");
+  IupSetAttribute(text, "VISIBLELINES", "12");
+  IupSetAttribute(text, "VISIBLECOLUMNS", "40");
+
+  dlg = IupDialog(IupVbox(label, text, NULL));
+  IupSetAttribute(dlg, "TITLE", "Attribute Access Test");
+  IupSetAttribute(dlg, "MARGIN", "10x10");
+  IupSetAttribute(dlg, "GAP", "10");
+
+  /* measure the mapped element, as applications do */
+  IupMap(dlg);
+
+  attrib_log[0] = 0;
+  attrib_benchmark(label);
+  IupSetStrAttribute(label, "TITLE", "Label");
+  IupSetAttribute(text, "VALUE", attrib_log);
+
+  IupShow(dlg);
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  IupOpen(&argc, &argv);
+
+  AttribTest();
+
+  IupMainLoop();
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
@@ -0,0 +1,255 @@
+/* Benchmark of attribute getters that return formatted numbers.
+   The returned values use the string buffers of the calling thread,
+   so the main thread and several worker threads format numbers at the same time.
+   Also keeps many returned values alive inside a scope. */
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#include <pthread.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "iup.h"
+
+#include "iup_str.h"
+
+
+#define ATTRIBNUM_LOOPS 1000000
+#define ATTRIBNUM_THREADS 4
+#define ATTRIBNUM_SCOPE_COUNT 10000
+#define ATTRIBNUM_SCOPES 100
+
+typedef struct _AttribNumThread {
+  Ihandle *label;
+  char rastersize[50], position[50];
+  int errors;
+} AttribNumThread;
+
+static AttribNumThread attribnum_thread[ATTRIBNUM_THREADS];
+static char attribnum_log[2048] = "";
+
+static double attribnum_time(void)
+{
+#ifdef WIN32
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (double)count.QuadPart * 1000.0 / (double)freq.QuadPart;
+#else
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (double)tv.tv_sec * 1000.0 + (double)tv.tv_usec / 1000.0;
+#endif
+}
+
+static void attribnum_log_line(const char* line)
+{
+  printf("%s\n", line);
+  if (strlen(attribnum_log) + strlen(line) + 2 < sizeof(attribnum_log))
+  {
+    strcat(attribnum_log, line);
+    strcat(attribnum_log, "\n");
+  }
+}
+
+static void attribnum_log_time(const char* name, double start, int calls)
+{
+  char line[256];
+  sprintf(line, "%s: %.1f ns/call", name, (attribnum_time() - start) * 1.0e6 / calls);
+  attribnum_log_line(line);
+}
+
+static void attribnum_run(AttribNumThread* t)
+{
+  int i;
+
+  for (i = 0; i < ATTRIBNUM_LOOPS; i++)
+  {
+    /* the first value must not be overwritten by the second call,
+       nor by the other threads */
+    char* rastersize = IupGetAttribute(t->label, "RASTERSIZE");
+    char* position = IupGetAttribute(t->label, "POSITION");
+
+    if (!rastersize || strcmp(rastersize, t->rastersize) != 0 ||
+        !position || strcmp(position, t->position) != 0)
+      t->errors++;
+  }
+}
+
+#ifdef WIN32
+static DWORD WINAPI attribnum_thread_func(LPVOID arg)
+{
+  attribnum_run((AttribNumThread*)arg);
+  return 0;
+}
+#else
+static void* attribnum_thread_func(void* arg)
+{
+  attribnum_run((AttribNumThread*)arg);
+  return NULL;
+}
+#endif
+
+static void attribnum_threads(int count)
+{
+#ifdef WIN32
+  HANDLE threads[ATTRIBNUM_THREADS];
+#else
+  pthread_t threads[ATTRIBNUM_THREADS];
+#endif
+  int i;
+
+  for (i = 0; i < count; i++)
+  {
+#ifdef WIN32
+    threads[i] = CreateThread(NULL, 0, attribnum_thread_func, attribnum_thread + i, 0, NULL);
+#else
+    pthread_create(threads + i, NULL, attribnum_thread_func, attribnum_thread + i);
+#endif
+  }
+
+  for (i = 0; i < count; i++)
+  {
+#ifdef WIN32
+    WaitForSingleObject(threads[i], INFINITE);
+    CloseHandle(threads[i]);
+#else
+    pthread_join(threads[i], NULL);
+#endif
+  }
+}
+
+static void attribnum_scope(int *errors)
+{
+  char* values[ATTRIBNUM_SCOPE_COUNT];
+  char num[50];
+  int s, i;
+
+  for (s = 0; s < ATTRIBNUM_SCOPES; s++)
+  {
+    int scope = iupStrScopeBegin();
+
+    for (i = 0; i < ATTRIBNUM_SCOPE_COUNT; i++)
+      values[i] = iupStrReturnInt(i);
+
+    /* all the values returned inside the scope must still be valid */
+    for (i = 0; i < ATTRIBNUM_SCOPE_COUNT; i++)
+    {
+      sprintf(num, "%d", i);
+      if (strcmp(values[i], num) != 0)
+      {
+        (*errors)++;
+        break;
+      }
+    }
+
+    iupStrScopeEnd(scope);
+  }
+}
+
+static void attribnum_benchmark(Ihandle* label, Ihandle* val)
+{
+  char line[256];
+  double start;
+  int i, n, errors = 0;
+  long sum = 0;
+
+  start = attribnum_time();
+  for (i = 0; i < ATTRIBNUM_LOOPS; i++)
+    sum += IupGetAttribute(label, "RASTERSIZE")[0];
+  attribnum_log_time("IupGetAttribute (RASTERSIZE)", start, ATTRIBNUM_LOOPS);
+
+  start = attribnum_time();
+  for (i = 0; i < ATTRIBNUM_LOOPS; i++)
+    sum += IupGetAttribute(label, "POSITION")[0];
+  attribnum_log_time("IupGetAttribute (POSITION)", start, ATTRIBNUM_LOOPS);
+
+  start = attribnum_time();
+  for (i = 0; i < ATTRIBNUM_LOOPS; i++)
+    sum += IupGetAttribute(val, "VALUE")[0];
+  attribnum_log_time("IupGetAttribute (IupVal VALUE)", start, ATTRIBNUM_LOOPS);
+
+  start = attribnum_time();
+  attribnum_scope(&errors);
+  attribnum_log_time("iupStrReturnInt inside a scope", start, ATTRIBNUM_SCOPES * ATTRIBNUM_SCOPE_COUNT);
+
+  /* each thread has its own unmapped element with different values */
+  for (i = 0; i < ATTRIBNUM_THREADS; i++)
+  {
+    AttribNumThread* t = attribnum_thread + i;
+
+    t->label = IupLabel(NULL);
+    IupSetfAttribute(t->label, "RASTERSIZE", "%dx%d", 100 + i, 20 + i);
+    IupSetfAttribute(t->label, "POSITION", "%d,%d", 1000 + i, 2000 + i);
+    strcpy(t->rastersize, IupGetAttribute(t->label, "RASTERSIZE"));
+    strcpy(t->position, IupGetAttribute(t->label, "POSITION"));
+
+    t->errors = 0;
+  }
+
+  for (n = 1; n <= ATTRIBNUM_THREADS; n *= 2)
+  {
+    start = attribnum_time();
+    attribnum_threads(n);
+    sprintf(line, "IupGetAttribute in %d threads", n);
+    attribnum_log_time(line, start, n * 2 * ATTRIBNUM_LOOPS);
+  }
+
+  for (i = 0; i < ATTRIBNUM_THREADS; i++)
+  {
+    errors += attribnum_thread[i].errors;
+    IupDestroy(attribnum_thread[i].label);
+  }
+
+  sprintf(line, "Errors: %d (sum %ld)", errors, sum);
+  attribnum_log_line(line);
+}
+
+void AttribNumberTest(void)
+{
+  Ihandle *dlg, *label, *val, *text;
+
+  label = IupLabel("Label");
+  val = IupVal("HORIZONTAL");
+  IupSetAttribute(val, "VALUE", "0.3");
+
+  text = IupText(NULL);
+  IupSetAttribute(text, "MULTILINE", "YES");
+  IupSetAttribute(text, "READONLY", "YES");
+  IupSetAttribute(text, "EXPAND", "YES");
+  IupSetAttribute(text, "VISIBLELINES", "10");
+  IupSetAttribute(text, "VISIBLECOLUMNS", "40");
+
+  dlg = IupDialog(IupVbox(label, val, text, NULL));
+  IupSetAttribute(dlg, "TITLE", "Attribute Number Formatting Test");
+  IupSetAttribute(dlg, "MARGIN", "10x10");
+  IupSetAttribute(dlg, "GAP", "10");
+
+  /* measure the mapped elements, as applications do */
+  IupMap(dlg);
+
+  attribnum_log[0] = 0;
+  attribnum_benchmark(label, val);
+  IupSetAttribute(text, "VALUE", attribnum_log);
+
+  IupShow(dlg);
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  IupOpen(&argc, &argv);
+
+  AttribNumberTest();
+
+  IupMainLoop();
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
@@ -19,6 +19,8 @@ export G_SLICE=always-malloc
 
 /* Must define BIG_TEST on the Project and include in the build all test files */
 #ifdef BIG_TEST
+void AttribTest(void);
+void AttribNumberTest(void);
 void ButtonTest(void);
 void CanvasScrollbarTest(void);
 void CanvasTest(void);
@@ -32,10 +34,17 @@ void FrameTest(void);
 void FlatFrameTest(void);
 void TabsTest(void);
 void SysInfoTest(void);
+void TableTest(void);
+void TableBenchTest(void);
+void LineFileBenchTest(void);
+void PostMessageBenchTest(void);
+void ImageBenchTest(void);
 void GetColorTest(void);
 #ifdef USE_OPENGL
 void GLCanvasTest(void);
 void GLCanvasCubeTest(void);
+void GLControlsFrameTest(void);
+void GLControlsTextTest(void);
 #endif
 void HboxTest(void);
 void IdleTest(void);
@@ -45,6 +54,7 @@ void ListTest(void);
 void MatrixTest(void);
 void MatrixCbModeTest(void);
 void MatrixCbsTest(void);
+void MatrixLargeTest(void);
 void MdiTest(void);
 void VboxTest(void);
 void GridBoxTest(void);
@@ -58,6 +68,7 @@ void CellsDegradeTest(void);
 void CellsCheckboardTest(void);
 void ValTest(void);
 void TreeTest(void);
+void TreeLargeTest(void);
 void TrayTest(void);
 void ToggleTest(void);
 void TimerTest(void);
@@ -70,6 +81,7 @@ void ProgressbarTest(void);
 void ProgressDlgTest(void);
 void PreDialogsTest(void);
 void PlotTest(void);
+void PlotRingTest(void);
 #ifdef MGLPLOT_TEST
 void MglPlotTest(void);
 #endif
@@ -122,6 +134,8 @@ typedef struct _TestItems{
 }TestItems;
 
 static TestItems test_list[] = {
+  { "Attrib", AttribTest },
+  { "AttribNumber", AttribNumberTest },
   {"Button", ButtonTest},
   { "FlatButton", FlatButtonTest },
   { "DropButton", DropButtonTest },
@@ -150,6 +164,8 @@ static TestItems test_list[] = {
 #ifdef USE_OPENGL
   {"GLCanvas", GLCanvasTest},
   {"GLCanvasCube", GLCanvasCubeTest},
+  { "GLControlsFrame", GLControlsFrameTest },
+  { "GLControlsText", GLControlsTextTest },
 #endif
   {"Gauge", GaugeTest},
   {"GetColor", GetColorTest},
@@ -165,6 +181,7 @@ static TestItems test_list[] = {
   {"Matrix", MatrixTest},
   {"MatrixCbMode", MatrixCbModeTest},
   {"MatrixCbs", MatrixCbsTest},
+  { "MatrixLarge", MatrixLargeTest },
   { "MatrixList", MatrixListTest },
   { "Mdi", MdiTest },
   {"Menu", MenuTest},
@@ -174,6 +191,7 @@ static TestItems test_list[] = {
   { "MglLabel", MglLabelTest },
 #endif
   { "Plot", PlotTest },
+  { "PlotRing", PlotRingTest },
   {"PreDialogs", PreDialogsTest},
   {"Progressbar", ProgressbarTest},
   {"ProgressDlg", ProgressDlgTest},
@@ -187,6 +205,11 @@ static TestItems test_list[] = {
   {"Scanf", ScanfTest},
   {"Spin", SpinTest},
   {"SysInfo", SysInfoTest},
+  { "Table", TableTest },
+  { "TableBench", TableBenchTest },
+  { "LineFileBench", LineFileBenchTest },
+  { "PostMessageBench", PostMessageBenchTest },
+  { "ImageBench", ImageBenchTest },
   {"Tabs", TabsTest},
   { "FlatTabs", FlatTabsTest },
   { "Text", TextTest },
@@ -196,6 +219,7 @@ static TestItems test_list[] = {
   { "FlatToggle", FlatToggleTest },
   { "Tray", TrayTest },
   {"Tree", TreeTest},
+  { "TreeLarge", TreeLargeTest },
   {"Val", ValTest},
   {"Vbox", VboxTest},
   {"Zbox", ZboxTest},
@@ -14,7 +14,7 @@ else
   endif
 endif
 
-INCLUDES = ../include
+INCLUDES = ../include ../../../src
 
 USE_IUP3 = Yes
 USE_STATIC = Yes
@@ -47,6 +47,7 @@ SRC += calendar.c
 SRC += predialogs.c
 SRC += timer.c
 SRC += postmessage.c
+SRC += postmessage_bench.c
 SRC += label.c
 SRC += canvas.c
 SRC += frame.c
@@ -74,6 +75,7 @@ SRC += getparam.c
 SRC += getcolor.c
 SRC += class_conf.c
 SRC += tree.c
+SRC += tree_large.c
 SRC += zbox.c
 SRC += scanf.c
 SRC += sbox.c
@@ -90,6 +92,15 @@ SRC += flatscrollbox.c
 SRC += dropbutton.c
 SRC += flatlabel.c
 SRC += flattoggle.c
+SRC += table.c
+SRC += table_bench.c
+SRC += table_old.c
+SRC += linefile_bench.c
+SRC += linefile_old.c
+SRC += image_bench.c
+SRC += image_old.c
+SRC += attrib.c
+SRC += attrib_number.c
 
 ifneq ($(findstring Win, $(TEC_SYSNAME)), )
   LIBS += iupimglib
@@ -107,6 +118,8 @@ USE_FTGL = Yes
 DEFINES += USE_OPENGL
 SRC += glcanvas.c
 SRC += glcanvas_cube.c
+SRC += glcontrols_frame.c
+SRC += glcontrols_text.c
 SRC += charac.c
 ifneq ($(findstring Win, $(TEC_SYSNAME)), )
   LIBS += cdgl iupglcontrols
@@ -139,10 +152,12 @@ SRC += matrix.c
 SRC += matrix_cbs.c
 SRC += matrix_cbmode.c
 SRC += matrixlist.c
+SRC += matrix_large.c
 
 LINKER = g++
 DEFINES += PLOT_TEST
 SRC += plot.c
+SRC += plot_ring.c
 ifneq ($(findstring Win, $(TEC_SYSNAME)), )
   LIBS += iup_plot cdcontextplus gdiplus
 #  LIBS += cdpdflib
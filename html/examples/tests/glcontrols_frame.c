@@ -0,0 +1,152 @@
+/* IupGLControls frame time benchmark.
+   Redraws a canvas box with many controls and reports the time per frame.
+   To measure the software renderer (llvmpipe) in Linux without a display:
+     xvfb-run -a env LIBGL_ALWAYS_SOFTWARE=1 ./glcontrols_frame
+*/
+#ifdef USE_OPENGL
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+#include <GL/gl.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "iup.h"
+#include "iupgl.h"
+#include "iupglcontrols.h"
+
+
+#define GLFRAME_COLUMNS 10
+#define GLFRAME_COUNT 400
+#define GLFRAME_FRAMES 50
+
+static Ihandle *glframe_canvas, *glframe_label;
+static Ihandle *glframe_pbar[GLFRAME_COUNT / 4];
+
+static double glframe_time(void)
+{
+#ifdef WIN32
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (double)count.QuadPart * 1000.0 / (double)freq.QuadPart;
+#else
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (double)tv.tv_sec * 1000.0 + (double)tv.tv_usec / 1000.0;
+#endif
+}
+
+static int glframe_start_cb(Ihandle* ih)
+{
+  double total = 0, max = 0;
+  char msg[512];
+  int f, i;
+  (void)ih;
+
+  for (f = 0; f < GLFRAME_FRAMES; f++)
+  {
+    double start, frame_time;
+
+    for (i = 0; i < GLFRAME_COUNT / 4; i++)
+      IupSetDouble(glframe_pbar[i], "VALUE", (double)((f + i) % GLFRAME_FRAMES) / (GLFRAME_FRAMES - 1));
+
+    start = glframe_time();
+    IupSetAttribute(glframe_canvas, "REDRAW", NULL);
+    /* wait for the renderer, so the frame is fully accounted */
+    IupGLMakeCurrent(glframe_canvas);
+    glFinish();
+    frame_time = glframe_time() - start;
+
+    total += frame_time;
+    if (frame_time > max)
+      max = frame_time;
+  }
+
+  sprintf(msg, "%d controls, %d frames: %.2f ms/frame (max %.2f ms)\nRenderer: %s",
+          GLFRAME_COUNT, GLFRAME_FRAMES, total / GLFRAME_FRAMES, max, (char*)glGetString(GL_RENDERER));
+  printf("%s\n", msg);
+  IupSetStrAttribute(glframe_label, "TITLE", msg);
+  return IUP_DEFAULT;
+}
+
+void GLControlsFrameTest(void)
+{
+  Ihandle *dlg, *grid, *button, *child;
+  char title[50];
+  int i;
+
+  IupGLCanvasOpen();
+  IupGLControlsOpen();
+
+  grid = IupGridBox(NULL);
+  IupSetInt(grid, "NUMDIV", GLFRAME_COLUMNS);
+  IupSetAttribute(grid, "MARGIN", "5x5");
+  IupSetAttribute(grid, "GAPLIN", "2");
+  IupSetAttribute(grid, "GAPCOL", "2");
+
+  /* the usual mix of a control panel: buttons, toggles, labels and progress bars */
+  for (i = 0; i < GLFRAME_COUNT; i++)
+  {
+    sprintf(title, "Item %d", i);
+
+    switch (i % 4)
+    {
+    case 0:
+      child = IupGLButton(title);
+      break;
+    case 1:
+      child = IupGLToggle(title);
+      IupSetAttribute(child, "VALUE", i % 8 == 1 ? "ON" : "OFF");
+      break;
+    case 2:
+      child = IupGLLabel(title);
+      break;
+    default:
+      child = IupGLProgressBar();
+      IupSetAttribute(child, "RASTERSIZE", "60x");
+      glframe_pbar[i / 4] = child;
+      break;
+    }
+
+    IupAppend(grid, child);
+  }
+
+  glframe_canvas = IupGLCanvasBox(IupSetAttributes(IupGLFrame(grid), "HORIZONTALALIGN=ALEFT, VERTICALALIGN=ATOP"), NULL);
+  IupSetAttribute(glframe_canvas, "BUFFER", "DOUBLE");
+  IupSetAttribute(glframe_canvas, "MARGIN", "10x10");
+  IupSetAttribute(glframe_canvas, "RASTERSIZE", "900x600");
+
+  glframe_label = IupLabel("");
+  IupSetAttribute(glframe_label, "EXPAND", "HORIZONTAL");
+  IupSetAttribute(glframe_label, "SIZE", "x16");
+
+  button = IupButton("Start", NULL);
+  IupSetCallback(button, "ACTION", (Icallback)glframe_start_cb);
+
+  dlg = IupDialog(IupVbox(glframe_canvas, IupHbox(button, glframe_label, NULL), NULL));
+  IupSetAttribute(dlg, "TITLE", "IupGLControls Frame Time");
+  IupSetAttribute(dlg, "MARGIN", "10x10");
+  IupSetAttribute(dlg, "GAP", "10");
+
+  IupShowXY(dlg, IUP_CENTER, IUP_CENTER);
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  IupOpen(&argc, &argv);
+
+  GLControlsFrameTest();
+
+  IupMainLoop();
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
+#endif
@@ -0,0 +1,181 @@
+/* IupGLControls text benchmark.
+   Measures many strings with IupGLDrawGetTextSize and draws them with IupGLDrawText.
+   Half of the strings change at every frame, so cached and new layouts are both used.
+   To measure the software renderer (llvmpipe) in Linux without a display:
+     xvfb-run -a env LIBGL_ALWAYS_SOFTWARE=1 ./glcontrols_text
+*/
+#ifdef USE_OPENGL
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+#include <GL/gl.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "iup.h"
+#include "iupgl.h"
+#include "iupglcontrols.h"
+
+
+#define GLTEXT_COLUMNS 8
+#define GLTEXT_COUNT 400
+#define GLTEXT_MEASURES 100
+#define GLTEXT_FRAMES 50
+
+static Ihandle *gltext_canvas, *gltext_label;
+static char gltext_str[GLTEXT_COUNT][50];
+static int gltext_frame = 0;
+
+static double gltext_time(void)
+{
+#ifdef WIN32
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (double)count.QuadPart * 1000.0 / (double)freq.QuadPart;
+#else
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (double)tv.tv_sec * 1000.0 + (double)tv.tv_usec / 1000.0;
+#endif
+}
+
+static void gltext_update_strings(int frame)
+{
+  int i;
+  for (i = 0; i < GLTEXT_COUNT; i++)
+  {
+    if (i % 2)
+      sprintf(gltext_str[i], "Value %d = %.3f", i, (double)(i * 1000 + frame) / 7.0);  /* changes every frame */
+    else
+      sprintf(gltext_str[i], "Label %d", i);
+  }
+}
+
+static int gltext_action_cb(Ihandle* ih)
+{
+  int i, w, h, cell_w;
+
+  IupGetIntInt(ih, "RASTERSIZE", &w, &h);
+  cell_w = w / GLTEXT_COLUMNS;
+
+  glColor4f(0, 0, 0, 1);
+  for (i = 0; i < GLTEXT_COUNT; i++)
+  {
+    int x = (i % GLTEXT_COLUMNS) * cell_w + 2;
+    int y = (i / GLTEXT_COLUMNS) * 12;
+    IupGLDrawText(ih, gltext_str[i], 0, x, y);
+  }
+
+  return IUP_DEFAULT;
+}
+
+static int gltext_start_cb(Ihandle* ih)
+{
+  Ihandle* subcanvas = IupGetChild(gltext_canvas, 0);
+  double start, first_time, measure_time, total = 0, max = 0;
+  char msg[512];
+  int f, i, w, h;
+  long sum = 0;
+  (void)ih;
+
+  /* the first measure of a string creates its layout */
+  gltext_update_strings(gltext_frame++);
+  start = gltext_time();
+  for (i = 0; i < GLTEXT_COUNT; i++)
+  {
+    IupGLDrawGetTextSize(subcanvas, gltext_str[i], &w, &h);
+    sum += w;
+  }
+  first_time = gltext_time() - start;
+
+  /* the other measures must use the cached layout */
+  start = gltext_time();
+  for (f = 0; f < GLTEXT_MEASURES; f++)
+  {
+    for (i = 0; i < GLTEXT_COUNT; i++)
+    {
+      IupGLDrawGetTextSize(subcanvas, gltext_str[i], &w, &h);
+      sum += w;
+    }
+  }
+  measure_time = gltext_time() - start;
+
+  for (f = 0; f < GLTEXT_FRAMES; f++)
+  {
+    double frame_time;
+
+    gltext_update_strings(gltext_frame++);
+
+    start = gltext_time();
+    IupSetAttribute(gltext_canvas, "REDRAW", NULL);
+    /* wait for the renderer, so the frame is fully accounted */
+    IupGLMakeCurrent(gltext_canvas);
+    glFinish();
+    frame_time = gltext_time() - start;
+
+    total += frame_time;
+    if (frame_time > max)
+      max = frame_time;
+  }
+
+  sprintf(msg, "Measure: first %.2f us/string, cached %.2f us/string (width sum %ld)\n"
+          "Draw %d strings, %d frames: %.2f ms/frame (max %.2f ms)\nRenderer: %s",
+          first_time * 1000.0 / GLTEXT_COUNT, measure_time * 1000.0 / (GLTEXT_MEASURES * GLTEXT_COUNT), sum,
+          GLTEXT_COUNT, GLTEXT_FRAMES, total / GLTEXT_FRAMES, max, (char*)glGetString(GL_RENDERER));
+  printf("%s\n", msg);
+  IupSetStrAttribute(gltext_label, "TITLE", msg);
+  return IUP_DEFAULT;
+}
+
+void GLControlsTextTest(void)
+{
+  Ihandle *dlg, *button, *subcanvas;
+
+  IupGLCanvasOpen();
+  IupGLControlsOpen();
+
+  gltext_update_strings(gltext_frame);
+
+  subcanvas = IupGLSubCanvas();
+  IupSetAttribute(subcanvas, "EXPANDHORIZONTAL", "YES");
+  IupSetAttribute(subcanvas, "EXPANDVERTICAL", "YES");
+  IupSetCallback(subcanvas, "GL_ACTION", (Icallback)gltext_action_cb);
+
+  gltext_canvas = IupGLCanvasBox(subcanvas, NULL);
+  IupSetAttribute(gltext_canvas, "BUFFER", "DOUBLE");
+  IupSetAttribute(gltext_canvas, "RASTERSIZE", "900x620");
+
+  gltext_label = IupLabel("");
+  IupSetAttribute(gltext_label, "EXPAND", "HORIZONTAL");
+  IupSetAttribute(gltext_label, "SIZE", "x24");
+
+  button = IupButton("Start", NULL);
+  IupSetCallback(button, "ACTION", (Icallback)gltext_start_cb);
+
+  dlg = IupDialog(IupVbox(gltext_canvas, IupHbox(button, gltext_label, NULL), NULL));
+  IupSetAttribute(dlg, "TITLE", "IupGLControls Text");
+  IupSetAttribute(dlg, "MARGIN", "10x10");
+  IupSetAttribute(dlg, "GAP", "10");
+
+  IupShowXY(dlg, IUP_CENTER, IUP_CENTER);
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  IupOpen(&argc, &argv);
+
+  GLControlsTextTest();
+
+  IupMainLoop();
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
+#endif
@@ -0,0 +1,237 @@
+/* Image conversion benchmark.
+   Compares the kernels of iup_imageconv.c with the previous per pixel code (image_old.c)
+   for resize, palette expansion, alpha blend, premultiplication and inactive tint,
+   on images from 16x16 to 4096x4096. */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "iup.h"
+
+#include "iup_object.h"
+#include "iup_image.h"
+#include "image_old.h"
+
+
+#define IMGBENCH_MIN_SIZE 16
+#define IMGBENCH_MAX_SIZE 4096
+#define IMGBENCH_PIXELS (16 * 1024 * 1024)  /* minimum pixels processed by each measure */
+#define IMGBENCH_RESIZE_TOLERANCE 4       /* fixed point bilinear against the double version */
+
+enum { IMGBENCH_RESIZE_UP, IMGBENCH_RESIZE_DOWN, IMGBENCH_PALETTE, IMGBENCH_BLEND, IMGBENCH_PREMULTIPLY, IMGBENCH_INACTIVE, IMGBENCH_KERNELS };
+
+static const char* imgbench_names[IMGBENCH_KERNELS] = { "resize x2", "resize /2", "palette", "blend", "premultiply", "inactive" };
+
+static char imgbench_log[8192] = "";
+static int imgbench_errors = 0;
+
+static void imgbench_log_line(const char* line)
+{
+  printf("%s\n", line);
+  if (strlen(imgbench_log) + strlen(line) + 2 < sizeof(imgbench_log))
+  {
+    strcat(imgbench_log, line);
+    strcat(imgbench_log, "\n");
+  }
+}
+
+static void imgbench_run_kernel(int kernel, int use_old, int size, const unsigned char* src, const unsigned char* index, const iupColor* colors, unsigned char* dst)
+{
+  int count = size * size;
+
+  switch (kernel)
+  {
+  case IMGBENCH_RESIZE_UP:
+    if (use_old)
+      iupOldImageResize(size, size, src, 2 * size, 2 * size, dst, 4);
+    else
+      iupImageConvResize(size, size, src, 2 * size, 2 * size, dst, 4);
+    break;
+  case IMGBENCH_RESIZE_DOWN:
+    if (use_old)
+      iupOldImageResize(size, size, src, size / 2, size / 2, dst, 4);
+    else
+      iupImageConvResize(size, size, src, size / 2, size / 2, dst, 4);
+    break;
+  case IMGBENCH_PALETTE:
+    if (use_old)
+      iupOldImagePalette(index, count, colors, dst, 4);
+    else
+      iupImageConvPalette(index, count, colors, dst, 4);
+    break;
+  case IMGBENCH_BLEND:
+    memcpy(dst, src, count * 4);
+    if (use_old)
+      iupOldImageBlendBgColor(dst, count, 240, 240, 240);
+    else
+      iupImageConvBlendBgColor(dst, count, 240, 240, 240, 0);
+    break;
+  case IMGBENCH_PREMULTIPLY:
+    memcpy(dst, src, count * 4);
+    if (use_old)
+      iupOldImagePremultiply(dst, count);
+    else
+      iupImageConvPremultiply(dst, count);
+    break;
+  case IMGBENCH_INACTIVE:
+    memcpy(dst, src, count * 4);
+    if (use_old)
+      iupOldImageMakeInactive(dst, count, 4, 240, 240, 240);
+    else
+      iupImageConvMakeInactive(dst, count, 4, 240, 240, 240);
+    break;
+  }
+}
+
+static double imgbench_time(int kernel, int use_old, int size, const unsigned char* src, const unsigned char* index, const iupColor* colors, unsigned char* dst)
+{
+  int i, repeat = IMGBENCH_PIXELS / (size * size);
+  clock_t start;
+
+  if (repeat < 1)
+    repeat = 1;
+
+  start = clock();
+  for (i = 0; i < repeat; i++)
+    imgbench_run_kernel(kernel, use_old, size, src, index, colors, dst);
+
+  /* nanoseconds per source pixel */
+  return (double)(clock() - start) * 1.0e9 / CLOCKS_PER_SEC / ((double)repeat * size * size);
+}
+
+static int imgbench_compare(int kernel, const unsigned char* old_dst, const unsigned char* new_dst, int count)
+{
+  int i, tolerance = 0;
+
+  if (kernel == IMGBENCH_RESIZE_DOWN)
+    return 1;  /* the box filter is not comparable with the previous bilinear result */
+  if (kernel == IMGBENCH_RESIZE_UP)
+    tolerance = IMGBENCH_RESIZE_TOLERANCE;
+
+  for (i = 0; i < count; i++)
+  {
+    int diff = (int)old_dst[i] - (int)new_dst[i];
+    if (diff > tolerance || diff < -tolerance)
+      return 0;
+  }
+  return 1;
+}
+
+static void imgbench_run(int size, const unsigned char* src, const unsigned char* index, const iupColor* colors, unsigned char* old_dst, unsigned char* new_dst)
+{
+  char line[256];
+  int kernel;
+
+  for (kernel = 0; kernel < IMGBENCH_KERNELS; kernel++)
+  {
+    double old_time, new_time;
+    int dst_count = kernel == IMGBENCH_RESIZE_UP ? 4 * size * size * 4 : (kernel == IMGBENCH_RESIZE_DOWN ? (size / 2) * (size / 2) * 4 : size * size * 4);
+
+    old_time = imgbench_time(kernel, 1, size, src, index, colors, old_dst);
+    new_time = imgbench_time(kernel, 0, size, src, index, colors, new_dst);
+
+    sprintf(line, "%4dx%-4d %-11s: previous %7.2f ns/px, current %6.2f ns/px, %5.1fx",
+            size, size, imgbench_names[kernel], old_time, new_time, new_time > 0 ? old_time / new_time : 0.0);
+    imgbench_log_line(line);
+
+    if (!imgbench_compare(kernel, old_dst, new_dst, dst_count))
+    {
+      sprintf(line, "FAILED: %s %dx%d results differ", imgbench_names[kernel], size, size);
+      imgbench_log_line(line);
+      imgbench_errors++;
+    }
+  }
+}
+
+void ImageBenchTest(void)
+{
+  Ihandle *dlg, *text;
+  int count = IMGBENCH_MAX_SIZE * IMGBENCH_MAX_SIZE;
+  unsigned char* src = malloc(count * 4);
+  unsigned char* index = malloc(count);
+  unsigned char* old_dst = malloc(4 * count * 4);  /* resize x2 */
+  unsigned char* new_dst = malloc(4 * count * 4);
+  iupColor colors[256];
+  char line[50];
+  int i, size;
+
+  imgbench_log[0] = 0;
+  imgbench_errors = 0;
+
+  /* a gradient with some noise, and some fully opaque and fully transparent pixels */
+  srand(1);
+  for (i = 0; i < count; i++)
+  {
+    int x = i % IMGBENCH_MAX_SIZE, y = i / IMGBENCH_MAX_SIZE;
+    src[4 * i + 0] = (unsigned char)((x + rand() % 16) & 0xFF);
+    src[4 * i + 1] = (unsigned char)((y + rand() % 16) & 0xFF);
+    src[4 * i + 2] = (unsigned char)((x + y) & 0xFF);
+    src[4 * i + 3] = (unsigned char)(i % 7 == 0 ? 0 : (i % 5 == 0 ? 255 : rand() % 256));
+    index[i] = (unsigned char)(rand() % 256);
+  }
+  for (i = 0; i < 256; i++)
+  {
+    colors[i].r = (unsigned char)i;
+    colors[i].g = (unsigned char)(255 - i);
+    colors[i].b = (unsigned char)(i * 7);
+    colors[i].a = (unsigned char)(i < 16 ? 0 : 255);
+  }
+
+  /* the source of each size is the top left corner, with the rows of the largest image */
+  for (size = IMGBENCH_MIN_SIZE; size <= IMGBENCH_MAX_SIZE; size *= 4)
+  {
+    unsigned char* size_src = malloc(size * size * 4);
+    unsigned char* size_index = malloc(size * size);
+    int y;
+
+    for (y = 0; y < size; y++)
+    {
+      memcpy(size_src + y * size * 4, src + y * IMGBENCH_MAX_SIZE * 4, size * 4);
+      memcpy(size_index + y * size, index + y * IMGBENCH_MAX_SIZE, size);
+    }
+
+    imgbench_run(size, size_src, size_index, colors, old_dst, new_dst);
+
+    free(size_src);
+    free(size_index);
+  }
+
+  free(src);
+  free(index);
+  free(old_dst);
+  free(new_dst);
+
+  sprintf(line, "Errors: %d", imgbench_errors);
+  imgbench_log_line(line);
+
+  text = IupText(NULL);
+  IupSetAttribute(text, "MULTILINE", "YES");
+  IupSetAttribute(text, "READONLY", "YES");
+  IupSetAttribute(text, "EXPAND", "YES");
+  IupSetAttribute(text, "VISIBLELINES", "20");
+  IupSetAttribute(text, "VISIBLECOLUMNS", "80");
+  IupSetAttribute(text, "FONT", "Courier, 10");
+  IupSetAttribute(text, "VALUE", imgbench_log);
+
+  dlg = IupDialog(IupVbox(text, NULL));
+  IupSetAttribute(dlg, "TITLE", "Image Conversion Benchmark");
+  IupSetAttribute(dlg, "MARGIN", "10x10");
+
+  IupShow(dlg);
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  IupOpen(&argc, &argv);
+
+  ImageBenchTest();
+
+  IupMainLoop();
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
@@ -0,0 +1,184 @@
+/* The previous per pixel image conversion code, from iup_image.c,
+   iupgtk_image.c and iupwin_image.c, before the kernels of iup_imageconv.c.
+   Kept only to compare with the current kernels in image_bench.c.
+
+   See Copyright Notice in "iup.h"
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <memory.h>
+
+#include "iup.h"
+
+#include "iup_object.h"
+#include "iup_image.h"
+#include "image_old.h"
+
+
+#define iupALPHAPRE(_src, _alpha) (((_src)*(_alpha))/255)
+
+void iupOldImageResize(int src_width, int src_height, const unsigned char *src_map, int dst_width, int dst_height, unsigned char *dst_map, int depth)
+{
+  /* Do bilinear interpolation */
+
+  const unsigned char *line_mapl, *line_maph;
+  double t, u, src_x, src_y, factor;
+  int xl, yl, xh, yh, x, y;
+  const unsigned char *fhh, *fll, *fhl, *flh;
+
+  int *XL = (int*)malloc(dst_width * sizeof(int));
+  double *T = (double*)malloc(dst_width * sizeof(double));
+
+  factor = (double)src_width / (double)dst_width;
+  for (x = 0; x < dst_width; x++)
+  {
+    src_x = x * factor;
+    xl = (int)(src_x);
+    T[x] = src_x - xl;
+    XL[x] = xl;
+  }
+
+  factor = (double)src_height / (double)dst_height;
+
+  for (y = 0; y < dst_height; y++)
+  {
+    src_y = y * factor;
+    yl = (int)(src_y);
+    yh = (yl == src_height - 1) ? yl : yl + 1;
+    u = src_y - yl;
+
+    line_mapl = src_map + yl * src_width * depth;
+    line_maph = src_map + yh * src_width * depth;
+
+    for (x = 0; x < dst_width; x++)
+    {
+      xl = XL[x];
+      xh = (xl == src_width - 1) ? xl : xl + 1;
+      t = T[x];
+
+      fll = line_mapl + xl * depth;
+      fhl = line_mapl + xh * depth;
+      flh = line_maph + xl * depth;
+      fhh = line_maph + xh * depth;
+
+      dst_map[0] = (unsigned char)(u * t * (fhh[0] - flh[0] - fhl[0] + fll[0]) + t * (fhl[0] - fll[0]) + u * (flh[0] - fll[0]) + fll[0]);
+      dst_map[1] = (unsigned char)(u * t * (fhh[1] - flh[1] - fhl[1] + fll[1]) + t * (fhl[1] - fll[1]) + u * (flh[1] - fll[1]) + fll[1]);
+      dst_map[2] = (unsigned char)(u * t * (fhh[2] - flh[2] - fhl[2] + fll[2]) + t * (fhl[2] - fll[2]) + u * (flh[2] - fll[2]) + fll[2]);
+      if (depth == 4)
+        dst_map[3] = (unsigned char)(u * t * (fhh[3] - flh[3] - fhl[3] + fll[3]) + t * (fhl[3] - fll[3]) + u * (flh[3] - fll[3]) + fll[3]);
+
+      dst_map += depth;
+    }
+  }
+
+  free(XL);
+  free(T);
+}
+
+static void iOldImageColorMakeInactive(unsigned char *r, unsigned char *g, unsigned char *b, unsigned char bg_r, unsigned char bg_g, unsigned char bg_b)
+{
+  if (*r==bg_r && *g==bg_g && *b==bg_b)  /* preserve colors identical to the background color */
+  {
+    *r = bg_r; 
+    *g = bg_g; 
+    *b = bg_b; 
+  }
+  else
+  {
+    int ir = 0, ig = 0, ib = 0, 
+      i = (*r+*g+*b)/3,
+      bg_i = (bg_r+bg_g+bg_b)/3;
+
+    if (bg_i)
+    {
+      ir = (bg_r*i)/bg_i; 
+      ig = (bg_g*i)/bg_i; 
+      ib = (bg_b*i)/bg_i; 
+    }
+
+#define LIGHTER(_c) ((255 + _c)/2)
+    ir = LIGHTER(ir);
+    ig = LIGHTER(ig);
+    ib = LIGHTER(ib);
+
+    *r = iupBYTECROP(ir);
+    *g = iupBYTECROP(ig);
+    *b = iupBYTECROP(ib);
+  }
+}
+
+void iupOldImagePalette(const unsigned char* index, int count, const iupColor* colors, unsigned char* dst, int dst_channels)
+{
+  int x;
+  int has_alpha = (dst_channels == 4);
+
+  for (x=0; x<count; x++)
+  {
+    const iupColor* c = &colors[index[x]];
+    unsigned char *r = &dst[dst_channels*x],
+                  *g = r+1,
+                  *b = g+1,
+                  *a = b+1;
+
+    *r = c->r;
+    *g = c->g;
+    *b = c->b;
+
+    if (has_alpha)
+      *a = c->a;
+  }
+}
+
+void iupOldImageBlendBgColor(unsigned char* rgba, int count, unsigned char bg_r, unsigned char bg_g, unsigned char bg_b)
+{
+  int x;
+
+  for (x=0; x<count; x++)
+  {
+    unsigned char *r = &rgba[4*x],
+                  *g = r+1,
+                  *b = g+1,
+                  *a = b+1;
+
+    if (*a != 255)
+    {
+      *r = iupALPHABLEND(*r, bg_r, *a);
+      *g = iupALPHABLEND(*g, bg_g, *a);
+      *b = iupALPHABLEND(*b, bg_b, *a);
+    }
+  }
+}
+
+void iupOldImagePremultiply(unsigned char* rgba, int count)
+{
+  int x;
+
+  for (x=0; x<count; x++)
+  {
+    unsigned char *r = &rgba[4*x],
+                  *g = r+1,
+                  *b = g+1,
+                  *a = b+1;
+
+    /* RGB in RGBA DIBs are pre-multiplied by alpha to AlphaBlend usage. */
+    *r = iupALPHAPRE(*r,*a);
+    *g = iupALPHAPRE(*g,*a);
+    *b = iupALPHAPRE(*b,*a);
+  }
+}
+
+void iupOldImageMakeInactive(unsigned char* data, int count, int channels, unsigned char bg_r, unsigned char bg_g, unsigned char bg_b)
+{
+  int x;
+
+  for (x=0; x<count; x++)
+  {
+    unsigned char *r = &data[channels*x],
+                  *g = r+1,
+                  *b = g+1;
+
+    iOldImageColorMakeInactive(r, g, b, 
+                               bg_r, bg_g, bg_b);
+  }
+}
@@ -0,0 +1,22 @@
+/* The previous per pixel image conversion code, see image_old.c.
+   Uses the iupColor type of iup_image.h. */
+
+#ifndef __IMAGE_OLD_H
+#define __IMAGE_OLD_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+void iupOldImageResize(int src_width, int src_height, const unsigned char *src_map, int dst_width, int dst_height, unsigned char *dst_map, int depth);
+void iupOldImagePalette(const unsigned char* index, int count, const iupColor* colors, unsigned char* dst, int dst_channels);
+void iupOldImageBlendBgColor(unsigned char* rgba, int count, unsigned char bg_r, unsigned char bg_g, unsigned char bg_b);
+void iupOldImagePremultiply(unsigned char* rgba, int count);
+void iupOldImageMakeInactive(unsigned char* data, int count, int channels, unsigned char bg_r, unsigned char bg_g, unsigned char bg_b);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,213 @@
+/* IlineFile benchmark.
+   Compares the previous reader (linefile_old.c) with the block reader
+   and the memory mapped reader, copying the lines and using line views,
+   for plot data files of 1 MB to 100 MB. */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "iup.h"
+
+#include "iup_linefile.h"
+#include "linefile_old.h"
+
+
+#define LINEFILE_BENCH_FILE "linefile_bench.txt"
+#define LINEFILE_BENCH_MAX_MB 100
+
+enum { LINEFILE_OLD, LINEFILE_BLOCK, LINEFILE_BLOCK_VIEW, LINEFILE_MAPPED, LINEFILE_MAPPED_VIEW, LINEFILE_MODES };
+
+static const char* linefile_bench_names[LINEFILE_MODES] = { "previous", "block", "block view", "mapped", "mapped view" };
+
+static char linefile_bench_log[4096] = "";
+static int linefile_bench_errors = 0;
+
+static void iLineFileBenchLog(const char* line)
+{
+  printf("%s\n", line);
+  if (strlen(linefile_bench_log) + strlen(line) + 2 < sizeof(linefile_bench_log))
+  {
+    strcat(linefile_bench_log, line);
+    strcat(linefile_bench_log, "\n");
+  }
+}
+
+static double iLineFileBenchWrite(int mb)
+{
+  /* two columns of numbers, as saved by IupPlotSave and loaded by IupPlotLoadData */
+  FILE* file = fopen(LINEFILE_BENCH_FILE, "wb");
+  long size = 0, max_size = (long)mb * 1024 * 1024;
+  int i = 0;
+
+  if (!file)
+    return 0;
+
+  while (size < max_size)
+  {
+    size += fprintf(file, "%d %.6f\n", i, (double)(i % 10007) / 7.0);
+    i++;
+  }
+
+  fclose(file);
+  return (double)size / (1024.0 * 1024.0);
+}
+
+static int iLineFileBenchRead(int mode, long *lines, long *total)
+{
+  *lines = 0;
+  *total = 0;
+
+  if (mode == LINEFILE_OLD)
+  {
+    IoldLineFile* line_file = iupOldLineFileOpen(LINEFILE_BENCH_FILE);
+    if (!line_file)
+      return 0;
+
+    do
+    {
+      int line_len = iupOldLineFileReadLine(line_file);
+      if (line_len == -1)
+        break;
+
+      /* touch the line as a parser would */
+      if (line_len)
+        *total += line_len + iupOldLineFileGetBuffer(line_file)[0];
+      (*lines)++;
+    } while (!iupOldLineFileEOF(line_file));
+
+    iupOldLineFileClose(line_file);
+  }
+  else
+  {
+    IlineFile* line_file;
+    if (mode == LINEFILE_MAPPED || mode == LINEFILE_MAPPED_VIEW)
+      line_file = iupLineFileOpenMapped(LINEFILE_BENCH_FILE);
+    else
+      line_file = iupLineFileOpen(LINEFILE_BENCH_FILE);
+    if (!line_file)
+      return 0;
+
+    do
+    {
+      const char* line;
+      int line_len;
+
+      if (mode == LINEFILE_BLOCK_VIEW || mode == LINEFILE_MAPPED_VIEW)
+      {
+        line = iupLineFileReadLineView(line_file, &line_len);
+        if (!line)
+          break;
+      }
+      else
+      {
+        line_len = iupLineFileReadLine(line_file);
+        if (line_len == -1)
+          break;
+        line = iupLineFileGetBuffer(line_file);
+      }
+
+      if (line_len)
+        *total += line_len + line[0];
+      (*lines)++;
+    } while (!iupLineFileEOF(line_file));
+
+    iupLineFileClose(line_file);
+  }
+
+  return 1;
+}
+
+static void iLineFileBenchRun(int mb)
+{
+  long lines, total, first_lines = 0, first_total = 0;
+  double size = iLineFileBenchWrite(mb);
+  char line[256];
+  int mode;
+
+  if (size == 0)
+  {
+    iLineFileBenchLog("FAILED: can not write " LINEFILE_BENCH_FILE);
+    linefile_bench_errors++;
+    return;
+  }
+
+  for (mode = 0; mode < LINEFILE_MODES; mode++)
+  {
+    clock_t start = clock();
+    double time;
+
+    if (!iLineFileBenchRead(mode, &lines, &total))
+    {
+      sprintf(line, "FAILED: %s can not open the file", linefile_bench_names[mode]);
+      iLineFileBenchLog(line);
+      linefile_bench_errors++;
+      continue;
+    }
+
+    time = (double)(clock() - start) / CLOCKS_PER_SEC;
+    sprintf(line, "%3d MB %-11s: %8.1f ms, %7.1f MB/s", mb, linefile_bench_names[mode], time * 1000.0, time > 0 ? size / time : 0.0);
+    iLineFileBenchLog(line);
+
+    /* all the readers must see the same lines */
+    if (mode == 0)
+    {
+      first_lines = lines;
+      first_total = total;
+    }
+    else if (lines != first_lines || total != first_total)
+    {
+      sprintf(line, "FAILED: %s read %ld lines, %s read %ld lines", linefile_bench_names[mode], lines, linefile_bench_names[0], first_lines);
+      iLineFileBenchLog(line);
+      linefile_bench_errors++;
+    }
+  }
+}
+
+void LineFileBenchTest(void)
+{
+  Ihandle *dlg, *text;
+  char line[50];
+  int mb;
+
+  linefile_bench_log[0] = 0;
+  linefile_bench_errors = 0;
+
+  for (mb = 1; mb <= LINEFILE_BENCH_MAX_MB; mb *= 10)
+    iLineFileBenchRun(mb);
+
+  remove(LINEFILE_BENCH_FILE);
+
+  sprintf(line, "Errors: %d", linefile_bench_errors);
+  iLineFileBenchLog(line);
+
+  text = IupText(NULL);
+  IupSetAttribute(text, "MULTILINE", "YES");
+  IupSetAttribute(text, "READONLY", "YES");
+  IupSetAttribute(text, "EXPAND", "YES");
+  IupSetAttribute(text, "VISIBLELINES", "16");
+  IupSetAttribute(text, "VISIBLECOLUMNS", "50");
+  IupSetAttribute(text, "FONT", "Courier, 10");
+  IupSetAttribute(text, "VALUE", linefile_bench_log);
+
+  dlg = IupDialog(IupVbox(text, NULL));
+  IupSetAttribute(dlg, "TITLE", "IlineFile Benchmark");
+  IupSetAttribute(dlg, "MARGIN", "10x10");
+
+  IupShow(dlg);
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  IupOpen(&argc, &argv);
+
+  LineFileBenchTest();
+
+  IupMainLoop();
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
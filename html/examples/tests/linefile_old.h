@@ -0,0 +1,23 @@
+/* The previous IlineFile reader, see linefile_old.c. */
+
+#ifndef __LINEFILE_OLD_H
+#define __LINEFILE_OLD_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct _IoldLineFile IoldLineFile;
+
+IoldLineFile* iupOldLineFileOpen(const char* filename);
+void iupOldLineFileClose(IoldLineFile* line_file);
+int iupOldLineFileReadLine(IoldLineFile* line_file);
+const char* iupOldLineFileGetBuffer(IoldLineFile* line_file);
+int iupOldLineFileEOF(IoldLineFile* line_file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
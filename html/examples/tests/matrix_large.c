@@ -0,0 +1,285 @@
+/* IupMatrixEx large data benchmark.
+   Fills typed columns, inserts and deletes lines at the top,
+   scrolls to random lines and sorts by one and by several columns.
+   A second matrix in callback mode with 1M lines measures scrolling
+   and hit-testing deep into the table. */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "iup.h"
+#include "iupcontrols.h"
+
+
+#define MATLARGE_LINES 100000
+#define MATLARGE_EDITS 1000
+#define MATLARGE_SCROLLS 1000
+#define MATLARGE_DEEP_LINES 1000000
+#define MATLARGE_HITS 100000
+
+static Ihandle *matlarge_mat, *matlarge_deep, *matlarge_text;
+static char matlarge_log[2048] = "";
+
+static void matlarge_log_line(const char* line)
+{
+  printf("%s\n", line);
+  if (strlen(matlarge_log) + strlen(line) + 2 < sizeof(matlarge_log))
+  {
+    strcat(matlarge_log, line);
+    strcat(matlarge_log, "\n");
+  }
+}
+
+static void matlarge_log_time(const char* name, clock_t start)
+{
+  char line[256];
+  sprintf(line, "%s: %.1f ms", name, (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC);
+  matlarge_log_line(line);
+}
+
+static void matlarge_fill(Ihandle* mat)
+{
+  static const char* names[] = { "Oslo", "Lima", "Quito", "Bern", "Rome", "Kyiv", "Doha", "Riga" };
+  char value[50];
+  int lin;
+
+  for (lin = 1; lin <= MATLARGE_LINES; lin++)
+  {
+    sprintf(value, "%d", (lin * 7919) % MATLARGE_LINES);
+    IupSetStrAttributeId2(mat, "", lin, 1, value);
+    sprintf(value, "%.2f", (double)((lin * 104729) % 100000) / 100.0);
+    IupSetStrAttributeId2(mat, "", lin, 2, value);
+    IupSetStrAttributeId2(mat, "", lin, 3, names[lin % 8]);
+    sprintf(value, "Item %d", lin);
+    IupSetStrAttributeId2(mat, "", lin, 4, value);
+
+    /* some cell attributes, they must be renamed when lines are added or removed */
+    if (lin % 100 == 0)
+      IupSetAttributeId2(mat, "BGCOLOR", lin, 4, "255 240 200");
+  }
+}
+
+static char* matlarge_deep_value_cb(Ihandle* ih, int lin, int col)
+{
+  static char value[50];
+  (void)ih;
+
+  if (lin == 0)
+    return col == 1 ? "Line" : "Value";
+  if (col == 0)
+    return NULL;
+
+  sprintf(value, "%d", col == 1 ? lin : (lin * 7919) % MATLARGE_DEEP_LINES);
+  return value;
+}
+
+static int matlarge_deep_test(void)
+{
+  Ihandle* mat = matlarge_deep;
+  int numcol = IupGetInt(mat, "NUMCOL") + 1;  /* with the title column */
+  int i, lin, col, first, x, y, w, h, errors = 0;
+  clock_t start;
+  char* value;
+
+  /* scroll to lines in the second half, each scroll computes the position of the line */
+  start = clock();
+  srand(2);
+  for (i = 0; i < MATLARGE_SCROLLS; i++)
+  {
+    lin = MATLARGE_DEEP_LINES / 2 + rand() % (MATLARGE_DEEP_LINES / 2);
+    IupSetfAttribute(mat, "SHOW", "%d:1", lin);
+    IupSetAttribute(mat, "REDRAW", "ALL");
+  }
+  matlarge_log_time("Scroll to deep lines (1M)", start);
+
+  first = 0;
+  sscanf(IupGetAttribute(mat, "ORIGIN"), "%d:%d", &first, &col);
+  if (lin < first || lin > first + IupGetInt(mat, "NUMLIN_VISIBLE") + 1)
+  {
+    matlarge_log_line("FAILED: SHOW of a deep line");
+    errors++;
+  }
+
+  /* hit-test the visible lines near the end */
+  first = MATLARGE_DEEP_LINES - 100;
+  IupSetfAttribute(mat, "ORIGIN", "%d:1", first);
+  IupSetAttribute(mat, "REDRAW", "ALL");
+  value = IupGetAttributeId2(mat, "CELLOFFSET", first, 1);
+  if (!value || sscanf(value, "%dx%d", &x, &y) != 2 ||
+      sscanf(IupGetAttributeId2(mat, "CELLSIZE", first, 1), "%dx%d", &w, &h) != 2 || h <= 0)
+  {
+    matlarge_log_line("FAILED: CELLOFFSET of a deep line");
+    return errors + 1;
+  }
+
+  start = clock();
+  for (i = 0; i < MATLARGE_HITS; i++)
+  {
+    int pos = IupConvertXYToPos(mat, x + 2, y + 1 + i % (10 * h));
+    lin = pos / numcol;
+    if (pos < 0 || lin < first || lin > first + 10)
+      break;
+  }
+  matlarge_log_time("Hit-test deep lines (1M)", start);
+  if (i != MATLARGE_HITS)
+  {
+    matlarge_log_line("FAILED: hit-test of deep lines");
+    errors++;
+  }
+
+  return errors;
+}
+
+static int matlarge_check_attrib(Ihandle* mat, const char* name, int lin, int col, const char* expected)
+{
+  char* value = IupGetAttributeId2(mat, name, lin, col);
+  return value && strcmp(value, expected) == 0;
+}
+
+static int matlarge_start_cb(Ihandle* ih)
+{
+  Ihandle* mat = matlarge_mat;
+  clock_t start;
+  char line[256], *value;
+  int i, errors = 0;
+  (void)ih;
+
+  matlarge_log[0] = 0;
+
+  IupSetInt(mat, "NUMLIN", 0);
+  IupSetInt(mat, "NUMLIN", MATLARGE_LINES);
+
+  start = clock();
+  matlarge_fill(mat);
+  matlarge_log_time("Fill", start);
+
+  /* title frame colors are stored apart from the frame colors of the same cell */
+  IupSetAttributeId2(mat, "FRAMEHORIZCOLOR", 0, 2, "255 0 0");
+  IupSetAttributeId2(mat, "FRAMETITLEHORIZCOLOR", 0, 2, "0 255 0");
+  IupSetAttributeId2(mat, "FRAMEVERTCOLOR", 5, 0, "255 0 0");
+  IupSetAttributeId2(mat, "FRAMETITLEVERTCOLOR", 5, 0, "0 0 255");
+
+  start = clock();
+  for (i = 0; i < MATLARGE_EDITS; i++)
+    IupSetAttribute(mat, "ADDLIN", "0");
+  matlarge_log_time("ADDLIN at the top", start);
+
+  start = clock();
+  for (i = 0; i < MATLARGE_EDITS; i++)
+    IupSetAttribute(mat, "DELLIN", "1");
+  matlarge_log_time("DELLIN at the top", start);
+
+  /* the values and the cell attributes must be back at their places */
+  sprintf(line, "Item %d", MATLARGE_LINES);
+  value = IupGetAttributeId2(mat, "", MATLARGE_LINES, 4);
+  if (IupGetIntId2(mat, "", 1, 1) != 7919 % MATLARGE_LINES ||
+      !value || strcmp(value, line) != 0 ||
+      !IupGetAttributeId2(mat, "BGCOLOR", 100, 4) || IupGetAttributeId2(mat, "BGCOLOR", 101, 4))
+  {
+    matlarge_log_line("FAILED: lines after ADDLIN and DELLIN");
+    errors++;
+  }
+
+  if (!matlarge_check_attrib(mat, "FRAMEHORIZCOLOR", 0, 2, "255 0 0") ||
+      !matlarge_check_attrib(mat, "FRAMETITLEHORIZCOLOR", 0, 2, "0 255 0") ||
+      !matlarge_check_attrib(mat, "FRAMEVERTCOLOR", 5, 0, "255 0 0") ||
+      !matlarge_check_attrib(mat, "FRAMETITLEVERTCOLOR", 5, 0, "0 0 255") ||
+      IupGetAttributeId2(mat, "FRAMETITLEVERTCOLOR", 6, 0))
+  {
+    matlarge_log_line("FAILED: frame colors after ADDLIN and DELLIN");
+    errors++;
+  }
+
+  start = clock();
+  srand(1);
+  for (i = 0; i < MATLARGE_SCROLLS; i++)
+  {
+    IupSetfAttribute(mat, "ORIGIN", "%d:1", 1 + rand() % (MATLARGE_LINES - 20));
+    IupSetAttribute(mat, "REDRAW", "ALL");
+  }
+  matlarge_log_time("Scroll to random lines", start);
+  IupSetAttribute(mat, "ORIGIN", "1:1");
+
+  start = clock();
+  IupSetAttributeId(mat, "SORTCOLUMN", 1, "ALL");
+  matlarge_log_time("Sort INTEGER column", start);
+
+  start = clock();
+  IupSetAttributeId(mat, "SORTCOLUMN", 4, "ALL");
+  matlarge_log_time("Sort TEXT column", start);
+
+  start = clock();
+  IupSetAttribute(mat, "SORTCOLUMN", "3,2");
+  matlarge_log_time("Sort STRING, REAL columns", start);
+
+  IupSetAttributeId(mat, "SORTCOLUMN", 0, "RESET");
+  IupSetAttribute(mat, "REDRAW", "ALL");
+
+  errors += matlarge_deep_test();
+
+  sprintf(line, "Errors: %d", errors);
+  matlarge_log_line(line);
+  IupSetAttribute(matlarge_text, "VALUE", matlarge_log);
+  return IUP_DEFAULT;
+}
+
+void MatrixLargeTest(void)
+{
+  Ihandle *dlg, *button;
+
+  matlarge_mat = IupMatrixEx();
+  IupSetInt(matlarge_mat, "NUMCOL", 4);
+  IupSetInt(matlarge_mat, "NUMLIN", MATLARGE_LINES);
+  IupSetAttribute(matlarge_mat, "NUMCOL_VISIBLE", "4");
+  IupSetAttribute(matlarge_mat, "NUMLIN_VISIBLE", "15");
+  IupSetAttribute(matlarge_mat, "0:1", "Integer");
+  IupSetAttribute(matlarge_mat, "0:2", "Real");
+  IupSetAttribute(matlarge_mat, "0:3", "City");
+  IupSetAttribute(matlarge_mat, "0:4", "Text");
+  IupSetAttribute(matlarge_mat, "COLUMNSTORAGE1", "INTEGER");
+  IupSetAttribute(matlarge_mat, "COLUMNSTORAGE2", "REAL");
+  IupSetAttribute(matlarge_mat, "COLUMNSTORAGE3", "STRING");
+  IupSetAttribute(matlarge_mat, "WIDTHDEF", "50");
+
+  matlarge_deep = IupMatrix(NULL);
+  IupSetInt(matlarge_deep, "NUMCOL", 2);
+  IupSetInt(matlarge_deep, "NUMLIN", MATLARGE_DEEP_LINES);
+  IupSetAttribute(matlarge_deep, "NUMCOL_VISIBLE", "2");
+  IupSetAttribute(matlarge_deep, "NUMLIN_VISIBLE", "15");
+  IupSetAttribute(matlarge_deep, "WIDTH0", "0");
+  IupSetAttribute(matlarge_deep, "WIDTHDEF", "50");
+  IupSetCallback(matlarge_deep, "VALUE_CB", (Icallback)matlarge_deep_value_cb);
+
+  matlarge_text = IupText(NULL);
+  IupSetAttribute(matlarge_text, "MULTILINE", "YES");
+  IupSetAttribute(matlarge_text, "READONLY", "YES");
+  IupSetAttribute(matlarge_text, "EXPAND", "HORIZONTAL");
+  IupSetAttribute(matlarge_text, "VISIBLELINES", "10");
+
+  button = IupButton("Start", NULL);
+  IupSetCallback(button, "ACTION", (Icallback)matlarge_start_cb);
+
+  dlg = IupDialog(IupVbox(IupHbox(matlarge_mat, matlarge_deep, NULL), IupHbox(button, matlarge_text, NULL), NULL));
+  IupSetAttribute(dlg, "TITLE", "IupMatrixEx Large Data Test");
+  IupSetAttribute(dlg, "MARGIN", "10x10");
+  IupSetAttribute(dlg, "GAP", "10");
+
+  IupShowXY(dlg, IUP_CENTER, IUP_CENTER);
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  IupOpen(&argc, &argv);
+  IupControlsOpen();
+
+  MatrixLargeTest();
+
+  IupMainLoop();
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
@@ -0,0 +1,462 @@
+/*
+ * IupPlot Streaming Test
+ * Description : Benchmark of sample appends and redraws.
+ *               First appends 10M samples one by one with IupPlotAdd
+ *               and small batches to growing datasets,
+ *               then streams 1M samples per second into a ring dataset
+ *               of 1M samples, redrawing at 30 frames per second.
+ *               Also measures the redraw time of 1e5 to 1e7 samples
+ *               with and without DS_DECIMATE,
+ *               and the latency from a view change to its frame
+ *               with and without ASYNCRENDER.
+ *      Remark : depend on libs IUP, CD, IUP_PLOT
+ */
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "iup.h"
+#include "iupcontrols.h"
+#include "iup_plot.h"
+
+#include <cd.h>
+
+#ifdef PLOT_TEST
+
+#define RING_CAPACITY 1000000
+#define RING_FPS 30
+#define RING_FRAME_SAMPLES (1000000 / RING_FPS)  /* 1 MHz */
+#define RING_FRAMES (3 * RING_FPS)               /* 3 seconds */
+#define RING_BATCH 1000
+#define GROW_BATCHES 300
+#define GROW_SINGLE 10000000
+#define DECIMATE_MAX 10000000
+#define DECIMATE_REDRAWS 5
+#define LATENCY_DATASETS 3
+#define LATENCY_SAMPLES 2000000
+#define LATENCY_EVENTS 30
+#define LATENCY_INTERVAL 100  /* ms between view changes */
+
+static Ihandle *ring_plot, *ring_label, *ring_timer;
+static double ring_x[RING_BATCH], ring_y[RING_BATCH];
+static int ring_ds, ring_frame, ring_sample;
+static double ring_append_time, ring_redraw_time, ring_max_frame;
+
+static Ihandle *latency_timer;
+static int latency_async, latency_event, latency_frames, latency_cancelled;
+static double latency_request, latency_input_time, latency_total, latency_max;
+static char latency_msg[1024];
+
+static double ring_time(clock_t start)
+{
+  return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+static void ring_fill_batch(int start)
+{
+  int i;
+  for (i = 0; i < RING_BATCH; i++)
+  {
+    ring_x[i] = (double)(start + i) / 1000000.0;
+    ring_y[i] = sin(ring_x[i] * 50.0) + 0.1 * sin(ring_x[i] * 5000.0);
+  }
+}
+
+static void ring_grow_test(char* msg)
+{
+  const char* str_x[RING_BATCH];
+  char* str_buffer = malloc(RING_BATCH * 10);
+  clock_t start;
+  int i, ds;
+
+  /* one sample at a time, each append must not reallocate the whole column */
+  start = clock();
+  IupPlotBegin(ring_plot, 0);
+  for (i = 0; i < GROW_SINGLE; i++)
+    IupPlotAdd(ring_plot, (double)i, (double)(i % 1000));
+  ds = IupPlotEnd(ring_plot);
+  sprintf(msg, "IupPlotAdd %d samples: %.1f ms\n", GROW_SINGLE, ring_time(start));
+  if (IupGetInt(ring_plot, "DS_COUNT") != GROW_SINGLE)
+    strcat(msg, "FAILED: IupPlotAdd count\n");
+  IupSetInt(ring_plot, "REMOVE", ds);
+
+  /* small batches into datasets without capacity,
+     each batch must not reallocate the whole column */
+  IupPlotBegin(ring_plot, 0);
+  ds = IupPlotEnd(ring_plot);
+  start = clock();
+  for (i = 0; i < GROW_BATCHES; i++)
+  {
+    ring_fill_batch(i * RING_BATCH);
+    IupPlotAddSamples(ring_plot, ds, ring_x, ring_y, RING_BATCH);
+  }
+  sprintf(msg + strlen(msg), "Add %d samples: %.1f ms\n", GROW_BATCHES * RING_BATCH, ring_time(start));
+  IupSetInt(ring_plot, "REMOVE", ds);
+
+  for (i = 0; i < RING_BATCH; i++)
+  {
+    str_x[i] = str_buffer + i * 10;
+    sprintf(str_buffer + i * 10, "S%d", i);
+  }
+
+  IupPlotBegin(ring_plot, 1);
+  ds = IupPlotEnd(ring_plot);
+  start = clock();
+  for (i = 0; i < GROW_BATCHES; i++)
+    IupPlotAddStrSamples(ring_plot, ds, str_x, ring_y, RING_BATCH);
+  sprintf(msg + strlen(msg), "Add %d string samples: %.1f ms\n", GROW_BATCHES * RING_BATCH, ring_time(start));
+  IupSetInt(ring_plot, "REMOVE", ds);
+
+  IupPlotBegin(ring_plot, 0);
+  ds = IupPlotEnd(ring_plot);
+  start = clock();
+  for (i = 0; i < GROW_BATCHES; i++)
+  {
+    ring_fill_batch(i * RING_BATCH);
+    IupPlotInsertSamples(ring_plot, ds, 0, ring_x, ring_y, RING_BATCH);
+  }
+  sprintf(msg + strlen(msg), "Insert %d samples: %.1f ms\n", GROW_BATCHES * RING_BATCH, ring_time(start));
+  IupSetInt(ring_plot, "REMOVE", ds);
+
+  free(str_buffer);
+}
+
+static void ring_decimate_test(char* msg)
+{
+  static const char* modes[] = { "NONE", "MINMAX" };
+  clock_t start;
+  double first;
+  int count, i, m, ds;
+
+  msg[0] = 0;
+  for (count = 100000; count <= DECIMATE_MAX; count *= 10)
+  {
+    IupSetAttribute(ring_plot, "CLEAR", NULL);
+    IupPlotBegin(ring_plot, 0);
+    ds = IupPlotEnd(ring_plot);
+    for (i = 0; i < count; i += RING_BATCH)
+    {
+      ring_fill_batch(i);
+      IupPlotAddSamples(ring_plot, ds, ring_x, ring_y, RING_BATCH);
+    }
+    IupSetAttribute(ring_plot, "DS_NAME", "Decimate");
+
+    for (m = 0; m < 2; m++)
+    {
+      IupSetAttribute(ring_plot, "DS_DECIMATE", modes[m]);
+
+      /* the first redraw also computes the decimation */
+      start = clock();
+      IupSetAttribute(ring_plot, "REDRAW", NULL);
+      first = ring_time(start);
+
+      start = clock();
+      for (i = 0; i < DECIMATE_REDRAWS; i++)
+        IupSetAttribute(ring_plot, "REDRAW", NULL);
+      sprintf(msg + strlen(msg), "DS_DECIMATE=%s %d samples: first %.1f ms, redraw %.1f ms\n",
+              modes[m], count, first, ring_time(start) / DECIMATE_REDRAWS);
+    }
+  }
+}
+
+static double latency_now(void)
+{
+  /* wall time, the asynchronous frames are rendered in another thread */
+#ifdef WIN32
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (double)count.QuadPart * 1000.0 / (double)freq.QuadPart;
+#else
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (double)tv.tv_sec * 1000.0 + (double)tv.tv_usec / 1000.0;
+#endif
+}
+
+static int latency_postdraw_cb(Ihandle* ih, cdCanvas* cnv)
+{
+  (void)cnv;
+
+  /* the frame of the last view change is on the display */
+  if (latency_request != 0 && !IupGetInt(ih, "ASYNCRENDERPENDING"))
+  {
+    double latency = latency_now() - latency_request;
+    latency_total += latency;
+    if (latency > latency_max)
+      latency_max = latency;
+    latency_frames++;
+    latency_request = 0;
+  }
+  return IUP_DEFAULT;
+}
+
+static void latency_start(int async)
+{
+  latency_async = async;
+  latency_event = 0;
+  latency_frames = 0;
+  latency_cancelled = 0;
+  latency_request = 0;
+  latency_input_time = 0;
+  latency_total = 0;
+  latency_max = 0;
+  IupSetAttribute(ring_plot, "ASYNCRENDER", async ? "YES" : "NO");
+}
+
+static void latency_stop(void)
+{
+  IupSetAttribute(latency_timer, "RUN", "NO");
+  IupSetAttribute(ring_plot, "ASYNCRENDER", "NO");
+  IupSetAttribute(ring_plot, "AXS_XAUTOMIN", "YES");
+  IupSetAttribute(ring_plot, "AXS_XAUTOMAX", "YES");
+  IupSetCallback(ring_plot, "POSTDRAW_CB", NULL);
+}
+
+static void latency_report(void)
+{
+  sprintf(latency_msg + strlen(latency_msg), "ASYNCRENDER=%s %d events:\n  input %.2f ms/event\n  input to frame %.1f ms (max %.1f ms), %d cancelled\n",
+          latency_async ? "YES" : "NO", LATENCY_EVENTS, latency_input_time / LATENCY_EVENTS,
+          latency_frames ? latency_total / latency_frames : 0.0, latency_max, latency_cancelled);
+  if (latency_frames + latency_cancelled != LATENCY_EVENTS)
+    strcat(latency_msg, "FAILED: frames missing\n");
+}
+
+static int latency_timer_cb(Ihandle* ih)
+{
+  double start, xmin;
+  (void)ih;
+
+  if (latency_event == LATENCY_EVENTS)
+  {
+    /* wait for the last frame */
+    if (latency_request != 0 && latency_now() - latency_request < 10000)
+      return IUP_DEFAULT;
+
+    latency_report();
+    if (!latency_async)
+    {
+      latency_start(1);
+      return IUP_DEFAULT;
+    }
+
+    latency_stop();
+    printf("%s", latency_msg);
+    IupSetStrAttribute(ring_label, "TITLE", latency_msg);
+    IupRefresh(ring_label);
+    return IUP_DEFAULT;
+  }
+
+  /* a newer view change cancels the frame not displayed yet */
+  if (latency_request != 0)
+    latency_cancelled++;
+
+  /* the same work of a zoom or pan done with the keyboard or the mouse */
+  start = latency_now();
+  xmin = 0.1 * (latency_event % 5);
+  IupSetDouble(ring_plot, "AXS_XMIN", xmin);
+  IupSetDouble(ring_plot, "AXS_XMAX", xmin + 1.5);
+  latency_request = start;
+  IupSetAttribute(ring_plot, "REDRAW", NULL);
+  latency_input_time += latency_now() - start;
+
+  latency_event++;
+  return IUP_DEFAULT;
+}
+
+static int ring_timer_cb(Ihandle* ih)
+{
+  clock_t start, frame_start;
+  double frame_time;
+  int i;
+
+  frame_start = start = clock();
+  for (i = 0; i < RING_FRAME_SAMPLES; i += RING_BATCH)
+  {
+    int count = RING_FRAME_SAMPLES - i < RING_BATCH ? RING_FRAME_SAMPLES - i : RING_BATCH;
+    ring_fill_batch(ring_sample);
+    IupPlotAddSamples(ring_plot, ring_ds, ring_x, ring_y, count);
+    ring_sample += count;
+  }
+  ring_append_time += ring_time(start);
+
+  start = clock();
+  IupSetAttribute(ring_plot, "REDRAW", NULL);
+  ring_redraw_time += ring_time(start);
+
+  frame_time = ring_time(frame_start);
+  if (frame_time > ring_max_frame)
+    ring_max_frame = frame_time;
+
+  ring_frame++;
+  if (ring_frame == RING_FRAMES)
+  {
+    char msg[1024];
+    strcpy(msg, IupGetAttribute(ring_label, "TITLE"));
+    sprintf(msg + strlen(msg), "Ring %d frames of %d samples:\n  append %.2f ms/frame\n  redraw %.2f ms/frame\n  max frame %.2f ms",
+            RING_FRAMES, RING_FRAME_SAMPLES, ring_append_time / RING_FRAMES, ring_redraw_time / RING_FRAMES, ring_max_frame);
+    if (IupGetInt(ring_plot, "DS_COUNT") != RING_CAPACITY)
+      strcat(msg, "\nFAILED: ring dataset count is not the capacity");
+    printf("%s\n", msg);
+    IupSetStrAttribute(ring_label, "TITLE", msg);
+    IupRefresh(ring_label);
+
+    IupSetAttribute(ih, "RUN", "NO");
+  }
+
+  return IUP_DEFAULT;
+}
+
+static int ring_start_cb(Ihandle* ih)
+{
+  char msg[1024];
+  (void)ih;
+
+  IupSetAttribute(ring_timer, "RUN", "NO");
+  latency_stop();
+  IupSetAttribute(ring_plot, "CLEAR", NULL);
+
+  ring_grow_test(msg);
+  printf("%s", msg);
+  IupSetStrAttribute(ring_label, "TITLE", msg);
+
+  ring_ds = IupPlotNewRingDataSet(ring_plot, RING_CAPACITY);
+  IupSetAttribute(ring_plot, "DS_NAME", "Ring");
+  IupSetAttribute(ring_plot, "DS_DECIMATE", "MINMAX");
+
+  ring_frame = 0;
+  ring_sample = 0;
+  ring_append_time = 0;
+  ring_redraw_time = 0;
+  ring_max_frame = 0;
+
+  IupSetAttribute(ring_timer, "RUN", "YES");
+  return IUP_DEFAULT;
+}
+
+static int ring_decimate_cb(Ihandle* ih)
+{
+  char msg[1024];
+  (void)ih;
+
+  IupSetAttribute(ring_timer, "RUN", "NO");
+  latency_stop();  /* REDRAW must include the dataset rendering */
+
+  ring_decimate_test(msg);
+  printf("%s", msg);
+  IupSetStrAttribute(ring_label, "TITLE", msg);
+  IupRefresh(ring_label);
+  return IUP_DEFAULT;
+}
+
+static int ring_latency_cb(Ihandle* ih)
+{
+  int i, d, ds;
+  (void)ih;
+
+  IupSetAttribute(ring_timer, "RUN", "NO");
+  latency_stop();
+  IupSetAttribute(ring_plot, "CLEAR", NULL);
+
+  /* heavy datasets, not decimated */
+  for (d = 0; d < LATENCY_DATASETS; d++)
+  {
+    IupPlotBegin(ring_plot, 0);
+    ds = IupPlotEnd(ring_plot);
+    for (i = 0; i < LATENCY_SAMPLES; i += RING_BATCH)
+    {
+      ring_fill_batch(i);
+      if (d)
+      {
+        int j;
+        for (j = 0; j < RING_BATCH; j++)
+          ring_y[j] += d;
+      }
+      IupPlotAddSamples(ring_plot, ds, ring_x, ring_y, RING_BATCH);
+    }
+  }
+  IupSetAttribute(ring_plot, "AXS_XAUTOMIN", "NO");
+  IupSetAttribute(ring_plot, "AXS_XAUTOMAX", "NO");
+  IupSetCallback(ring_plot, "POSTDRAW_CB", (Icallback)latency_postdraw_cb);
+
+  latency_msg[0] = 0;
+  latency_start(0);
+  IupSetAttribute(latency_timer, "RUN", "YES");
+  return IUP_DEFAULT;
+}
+
+static int ring_close_cb(Ihandle* ih)
+{
+  (void)ih;
+  IupDestroy(ring_timer);
+  IupDestroy(latency_timer);
+  return IUP_DEFAULT;
+}
+
+void PlotRingTest(void)
+{
+  Ihandle *dlg, *button, *decimate, *latency;
+
+  IupPlotOpen();
+
+  ring_plot = IupPlot();
+  IupSetAttribute(ring_plot, "TITLE", "1 MHz Stream");
+  IupSetAttribute(ring_plot, "AXS_XLABEL", "Time (s)");
+  IupSetAttribute(ring_plot, "RASTERSIZE", "800x400");
+
+  ring_label = IupLabel("");
+  IupSetAttribute(ring_label, "EXPAND", "HORIZONTAL");
+  IupSetAttribute(ring_label, "SIZE", "x80");
+
+  button = IupButton("Start", NULL);
+  IupSetCallback(button, "ACTION", (Icallback)ring_start_cb);
+
+  decimate = IupButton("Decimate", NULL);
+  IupSetCallback(decimate, "ACTION", (Icallback)ring_decimate_cb);
+
+  latency = IupButton("Latency", NULL);
+  IupSetCallback(latency, "ACTION", (Icallback)ring_latency_cb);
+
+  ring_timer = IupTimer();
+  IupSetInt(ring_timer, "TIME", 1000 / RING_FPS);
+  IupSetCallback(ring_timer, "ACTION_CB", (Icallback)ring_timer_cb);
+
+  latency_timer = IupTimer();
+  IupSetInt(latency_timer, "TIME", LATENCY_INTERVAL);
+  IupSetCallback(latency_timer, "ACTION_CB", (Icallback)latency_timer_cb);
+
+  dlg = IupDialog(IupVbox(ring_plot, IupHbox(IupVbox(button, decimate, latency, NULL), ring_label, NULL), NULL));
+  IupSetAttribute(dlg, "TITLE", "IupPlot Streaming Test");
+  IupSetAttribute(dlg, "MARGIN", "10x10");
+  IupSetAttribute(dlg, "GAP", "10");
+  IupSetCallback(dlg, "DESTROY_CB", (Icallback)ring_close_cb);
+
+  IupShowXY(dlg, IUP_CENTER, IUP_CENTER);
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  IupOpen(&argc, &argv);
+  IupControlsOpen();
+
+  PlotRingTest();
+
+  IupMainLoop();
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
+
+#endif
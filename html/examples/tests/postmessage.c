@@ -6,8 +6,7 @@
 static Ihandle *timer1;
 static Ihandle *button;
 
-/* TODO: This callback signature will change when we decide on the final API. */
-static int postmessage_cb(Ihandle *ih, char* not_used_char, void *message_data, int not_used_int)
+static int postmessage_cb(Ihandle *ih, char* s, void *message_data, int i)
 {
 	IupLog("DEBUG", "In postmessage_cb\n");
 	int is_active = IupGetInt(ih, "ACTIVE");
@@ -0,0 +1,345 @@
+/* IupPostMessage benchmark.
+   N producer threads post messages to one element, delivered with
+   POSTMESSAGE_CB, with POSTMESSAGE_CB and POSTMESSAGECOALESCE=Yes,
+   and with POSTMESSAGEBATCH_CB.
+   Throughput is measured with the producers posting as fast as they can,
+   latency with paced producers, from the post to the callback. */
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "iup.h"
+#include "iupcbs.h"
+
+
+#define POSTBENCH_MAX_THREADS 8
+#define POSTBENCH_FLOOD 200000  /* messages per thread */
+#define POSTBENCH_PACED 2000    /* messages per thread */
+#define POSTBENCH_PACE 10       /* messages between 1 ms pauses */
+
+enum { POSTBENCH_SINGLE, POSTBENCH_COALESCE, POSTBENCH_BATCH, POSTBENCH_MODES };
+
+static const char* postbench_mode_names[POSTBENCH_MODES] = { "message", "coalesce", "batch" };
+
+typedef struct _PostBenchThread {
+  int index;
+  char key[10];
+  double times[POSTBENCH_PACED];
+} PostBenchThread;
+
+static PostBenchThread postbench_thread[POSTBENCH_MAX_THREADS];
+#ifdef WIN32
+static HANDLE postbench_handle[POSTBENCH_MAX_THREADS];
+#else
+static pthread_t postbench_handle[POSTBENCH_MAX_THREADS];
+#endif
+
+static Ihandle *postbench_target, *postbench_text, *postbench_timer;
+static char postbench_log[4096] = "";
+static int postbench_mode, postbench_threads, postbench_paced, postbench_count;
+static int postbench_received, postbench_calls, postbench_done, postbench_errors, postbench_running;
+static int postbench_last[POSTBENCH_MAX_THREADS];
+static double postbench_start, postbench_latency[POSTBENCH_MAX_THREADS * POSTBENCH_PACED];
+static int postbench_latency_count;
+
+static double postbench_time(void)
+{
+#ifdef WIN32
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (double)count.QuadPart * 1000.0 / (double)freq.QuadPart;
+#else
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (double)tv.tv_sec * 1000.0 + (double)tv.tv_usec / 1000.0;
+#endif
+}
+
+static void postbench_log_line(const char* line)
+{
+  printf("%s\n", line);
+  if (strlen(postbench_log) + strlen(line) + 2 < sizeof(postbench_log))
+  {
+    strcat(postbench_log, line);
+    strcat(postbench_log, "\n");
+  }
+}
+
+static void postbench_run(PostBenchThread* t)
+{
+  int k;
+
+  for (k = 0; k < postbench_count; k++)
+  {
+    /* the thread and the message number are both in i */
+    int i = k * POSTBENCH_MAX_THREADS + t->index;
+
+    if (postbench_paced)
+    {
+      t->times[k] = postbench_time();
+      IupPostMessage(postbench_target, t->key, t->times + k, i);
+
+      if (k % POSTBENCH_PACE == POSTBENCH_PACE - 1)
+      {
+#ifdef WIN32
+        Sleep(1);
+#else
+        usleep(1000);
+#endif
+      }
+    }
+    else
+      IupPostMessage(postbench_target, t->key, NULL, i);
+  }
+}
+
+#ifdef WIN32
+static DWORD WINAPI postbench_thread_func(LPVOID arg)
+{
+  postbench_run((PostBenchThread*)arg);
+  return 0;
+}
+#else
+static void* postbench_thread_func(void* arg)
+{
+  postbench_run((PostBenchThread*)arg);
+  return NULL;
+}
+#endif
+
+static int postbench_compare(const void* a, const void* b)
+{
+  double da = *(const double*)a, db = *(const double*)b;
+  return da < db ? -1 : (da > db ? 1 : 0);
+}
+
+static void postbench_finish(void)
+{
+  double time = postbench_time() - postbench_start;
+  char line[256];
+  int i;
+
+  for (i = 0; i < postbench_threads; i++)
+  {
+#ifdef WIN32
+    WaitForSingleObject(postbench_handle[i], INFINITE);
+    CloseHandle(postbench_handle[i]);
+#else
+    pthread_join(postbench_handle[i], NULL);
+#endif
+  }
+
+  if (postbench_paced)
+  {
+    qsort(postbench_latency, postbench_latency_count, sizeof(double), postbench_compare);
+    sprintf(line, "%-8s N=%d paced: latency median %.0f us, p99 %.0f us",
+            postbench_mode_names[postbench_mode], postbench_threads,
+            postbench_latency[postbench_latency_count / 2] * 1000.0,
+            postbench_latency[(postbench_latency_count * 99) / 100] * 1000.0);
+  }
+  else
+    sprintf(line, "%-8s N=%d: %.2f M msg/s, %d delivered in %d calls",
+            postbench_mode_names[postbench_mode], postbench_threads,
+            (double)postbench_threads * postbench_count / (time * 1000.0), postbench_received, postbench_calls);
+  postbench_log_line(line);
+
+  /* coalesced messages are not delivered */
+  if (postbench_mode != POSTBENCH_COALESCE && postbench_received != postbench_threads * postbench_count)
+  {
+    postbench_log_line("FAILED: messages lost");
+    postbench_errors++;
+  }
+
+  postbench_running = 0;
+  IupSetAttribute(postbench_timer, "RUN", "YES");  /* next run */
+}
+
+static void postbench_message(void* message_data, int i)
+{
+  int t = i % POSTBENCH_MAX_THREADS;
+  int k = i / POSTBENCH_MAX_THREADS;
+
+  if (!postbench_running)
+    return;
+
+  if (message_data)
+    postbench_latency[postbench_latency_count++] = postbench_time() - *(double*)message_data;
+
+  /* the messages of each thread are delivered in the order they were posted */
+  if (k <= postbench_last[t])
+    postbench_errors++;
+  postbench_last[t] = k;
+
+  postbench_received++;
+  if (k == postbench_count - 1)
+  {
+    postbench_done++;
+    if (postbench_done == postbench_threads)
+      postbench_finish();
+  }
+}
+
+static int postbench_cb(Ihandle* ih, char* s, void* message_data, int i)
+{
+  (void)ih;
+  (void)s;
+  postbench_calls++;
+  postbench_message(message_data, i);
+  return IUP_DEFAULT;
+}
+
+static int postbench_batch_cb(Ihandle* ih, char** s, void** message_data, int* i, int count)
+{
+  int m;
+  (void)ih;
+  (void)s;
+  postbench_calls++;
+  for (m = 0; m < count; m++)
+    postbench_message(message_data[m], i[m]);
+  return IUP_DEFAULT;
+}
+
+static void postbench_start_run(void)
+{
+  int i;
+
+  IupSetCallback(postbench_target, "POSTMESSAGE_CB", postbench_mode != POSTBENCH_BATCH ? (Icallback)postbench_cb : NULL);
+  IupSetCallback(postbench_target, "POSTMESSAGEBATCH_CB", postbench_mode == POSTBENCH_BATCH ? (Icallback)postbench_batch_cb : NULL);
+  IupSetAttribute(postbench_target, "POSTMESSAGECOALESCE", postbench_mode == POSTBENCH_COALESCE ? "Yes" : "No");
+
+  postbench_count = postbench_paced ? POSTBENCH_PACED : POSTBENCH_FLOOD;
+  postbench_received = 0;
+  postbench_calls = 0;
+  postbench_done = 0;
+  postbench_latency_count = 0;
+  for (i = 0; i < POSTBENCH_MAX_THREADS; i++)
+    postbench_last[i] = -1;
+  postbench_running = 1;
+
+  postbench_start = postbench_time();
+  for (i = 0; i < postbench_threads; i++)
+  {
+#ifdef WIN32
+    postbench_handle[i] = CreateThread(NULL, 0, postbench_thread_func, postbench_thread + i, 0, NULL);
+#else
+    pthread_create(postbench_handle + i, NULL, postbench_thread_func, postbench_thread + i);
+#endif
+  }
+}
+
+static int postbench_timer_cb(Ihandle* ih)
+{
+  char line[50];
+
+  IupSetAttribute(ih, "RUN", "NO");
+  IupSetAttribute(postbench_text, "VALUE", postbench_log);
+
+  /* flood and paced, for 1 to 8 threads, for each mode */
+  if (postbench_paced)
+  {
+    postbench_paced = 0;
+    postbench_threads *= 2;
+    if (postbench_threads > POSTBENCH_MAX_THREADS)
+    {
+      postbench_threads = 1;
+      postbench_mode++;
+    }
+  }
+  else
+    postbench_paced = 1;
+
+  if (postbench_mode == POSTBENCH_MODES)
+  {
+    sprintf(line, "Errors: %d", postbench_errors);
+    postbench_log_line(line);
+    IupSetAttribute(postbench_text, "VALUE", postbench_log);
+    return IUP_DEFAULT;
+  }
+
+  postbench_start_run();
+  return IUP_DEFAULT;
+}
+
+static int postbench_start_cb(Ihandle* ih)
+{
+  (void)ih;
+
+  if (postbench_running || IupGetInt(postbench_timer, "RUN"))
+    return IUP_DEFAULT;
+
+  postbench_log[0] = 0;
+  postbench_errors = 0;
+  postbench_mode = 0;
+  postbench_threads = 1;
+  postbench_paced = 0;
+  postbench_start_run();
+  return IUP_DEFAULT;
+}
+
+static int postbench_close_cb(Ihandle* ih)
+{
+  (void)ih;
+  IupDestroy(postbench_timer);
+  return IUP_DEFAULT;
+}
+
+void PostMessageBenchTest(void)
+{
+  Ihandle *dlg, *button;
+  int i;
+
+  for (i = 0; i < POSTBENCH_MAX_THREADS; i++)
+  {
+    postbench_thread[i].index = i;
+    sprintf(postbench_thread[i].key, "P%d", i);
+  }
+
+  postbench_target = IupLabel("Target");
+
+  postbench_text = IupText(NULL);
+  IupSetAttribute(postbench_text, "MULTILINE", "YES");
+  IupSetAttribute(postbench_text, "READONLY", "YES");
+  IupSetAttribute(postbench_text, "EXPAND", "YES");
+  IupSetAttribute(postbench_text, "VISIBLELINES", "25");
+  IupSetAttribute(postbench_text, "VISIBLECOLUMNS", "60");
+  IupSetAttribute(postbench_text, "FONT", "Courier, 10");
+
+  button = IupButton("Start", NULL);
+  IupSetCallback(button, "ACTION", (Icallback)postbench_start_cb);
+
+  postbench_timer = IupTimer();
+  IupSetAttribute(postbench_timer, "TIME", "100");
+  IupSetCallback(postbench_timer, "ACTION_CB", (Icallback)postbench_timer_cb);
+
+  dlg = IupDialog(IupVbox(IupHbox(button, postbench_target, NULL), postbench_text, NULL));
+  IupSetAttribute(dlg, "TITLE", "IupPostMessage Benchmark");
+  IupSetAttribute(dlg, "MARGIN", "10x10");
+  IupSetAttribute(dlg, "GAP", "10");
+  IupSetCallback(dlg, "DESTROY_CB", (Icallback)postbench_close_cb);
+
+  IupShow(dlg);
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  IupOpen(&argc, &argv);
+
+  PostMessageBenchTest();
+
+  IupMainLoop();
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
@@ -0,0 +1,325 @@
+/* Stress test for the internal Itable and Iarray containers.
+   Checks string keys with colliding hashes, remove and re-insert, iteration,
+   and the geometric growth of Iarray. Prints the timings of each step. */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "iup.h"
+
+#include "iup_table.h"
+#include "iup_array.h"
+
+
+#define TABLE_TEST_COUNT 200000
+#define TABLE_TEST_COLLISIONS 64
+
+static char table_test_log[4096] = "";
+static int table_test_errors = 0;
+
+static void iTableTestLog(const char* line)
+{
+  printf("%s\n", line);
+  if (strlen(table_test_log) + strlen(line) + 2 < sizeof(table_test_log))
+  {
+    strcat(table_test_log, line);
+    strcat(table_test_log, "\n");
+  }
+}
+
+static void iTableTestCheck(int ok, const char* name)
+{
+  if (!ok)
+  {
+    char line[256];
+    table_test_errors++;
+    sprintf(line, "FAILED: %s", name);
+    iTableTestLog(line);
+  }
+}
+
+static void iTableTestTime(const char* name, clock_t start)
+{
+  char line[256];
+  sprintf(line, "%s: %.1f ms", name, (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC);
+  iTableTestLog(line);
+}
+
+static void iTableTestKey(char* key, int i)
+{
+  /* same style of the attribute names that produced collisions */
+  sprintf(key, "BGCOLOR%d:%d", i % 1000, i / 1000);
+}
+
+static void iTableTestStringKeys(void)
+{
+  Itable* it = iupTableCreate(IUPTABLE_STRINGINDEXED);
+  char key[50], *k;
+  int i, found = 0, count;
+  clock_t start;
+
+  start = clock();
+  for (i = 0; i < TABLE_TEST_COUNT; i++)
+  {
+    iTableTestKey(key, i);
+    iupTableSet(it, key, (void*)(size_t)(i + 1), IUPTABLE_POINTER);
+  }
+  iTableTestTime("Itable set string keys", start);
+  iTableTestCheck(iupTableCount(it) == TABLE_TEST_COUNT, "Itable count after set");
+
+  start = clock();
+  for (i = 0; i < TABLE_TEST_COUNT; i++)
+  {
+    iTableTestKey(key, i);
+    if (iupTableGet(it, key) == (void*)(size_t)(i + 1))
+      found++;
+  }
+  iTableTestTime("Itable get string keys", start);
+  iTableTestCheck(found == TABLE_TEST_COUNT, "Itable get string keys");
+
+  /* remove the even keys, the odd ones must still be found */
+  start = clock();
+  for (i = 0; i < TABLE_TEST_COUNT; i += 2)
+  {
+    iTableTestKey(key, i);
+    iupTableRemove(it, key);
+  }
+  iTableTestTime("Itable remove string keys", start);
+  iTableTestCheck(iupTableCount(it) == TABLE_TEST_COUNT / 2, "Itable count after remove");
+
+  found = 0;
+  for (i = 0; i < TABLE_TEST_COUNT; i++)
+  {
+    void* value;
+    iTableTestKey(key, i);
+    value = iupTableGet(it, key);
+    if (i % 2 == 0 && value == NULL)
+      found++;
+    else if (i % 2 == 1 && value == (void*)(size_t)(i + 1))
+      found++;
+  }
+  iTableTestCheck(found == TABLE_TEST_COUNT, "Itable get after remove");
+
+  /* re-insert as duplicated strings */
+  for (i = 0; i < TABLE_TEST_COUNT; i += 2)
+  {
+    iTableTestKey(key, i);
+    iupTableSet(it, key, key, IUPTABLE_STRING);
+  }
+  iTableTestCheck(iupTableCount(it) == TABLE_TEST_COUNT, "Itable count after re-insert");
+
+  start = clock();
+  count = 0;
+  k = iupTableFirst(it);
+  while (k)
+  {
+    if (iupTableGetCurrType(it) == IUPTABLE_STRING)
+    {
+      if (strcmp((char*)iupTableGetCurr(it), k) == 0)
+        count++;
+    }
+    else
+      count++;
+
+    k = iupTableNext(it);
+  }
+  iTableTestTime("Itable iterate", start);
+  iTableTestCheck(count == TABLE_TEST_COUNT, "Itable iterate");
+
+  iupTableDestroy(it);
+}
+
+static void iTableTestCollisions(void)
+{
+  Itable* it = iupTableCreate(IUPTABLE_STRINGINDEXED);
+  unsigned int hash = iupTableGetStringHash("COLLISION");
+  char key[50];
+  int i, found = 0;
+
+  /* different keys forced to the same hash must not be confused */
+  for (i = 0; i < TABLE_TEST_COLLISIONS; i++)
+  {
+    sprintf(key, "KEY%d", i);
+    iupTableSetHashed(it, key, hash, (void*)(size_t)(i + 1), IUPTABLE_POINTER);
+  }
+  iTableTestCheck(iupTableCount(it) == TABLE_TEST_COLLISIONS, "Itable count with collisions");
+
+  for (i = 0; i < TABLE_TEST_COLLISIONS; i++)
+  {
+    sprintf(key, "KEY%d", i);
+    if (iupTableGetHashed(it, key, hash) == (void*)(size_t)(i + 1))
+      found++;
+  }
+  iTableTestCheck(found == TABLE_TEST_COLLISIONS, "Itable get with collisions");
+
+  iTableTestCheck(iupTableGetHashed(it, "COLLISION", hash) == NULL, "Itable get missing key with same hash");
+
+  for (i = 0; i < TABLE_TEST_COLLISIONS; i += 2)
+  {
+    sprintf(key, "KEY%d", i);
+    iupTableRemoveHashed(it, key, hash);
+  }
+
+  found = 0;
+  for (i = 0; i < TABLE_TEST_COLLISIONS; i++)
+  {
+    void* value;
+    sprintf(key, "KEY%d", i);
+    value = iupTableGetHashed(it, key, hash);
+    if ((i % 2 == 0 && value == NULL) || (i % 2 == 1 && value == (void*)(size_t)(i + 1)))
+      found++;
+  }
+  iTableTestCheck(found == TABLE_TEST_COLLISIONS, "Itable remove with collisions");
+
+  iupTableDestroy(it);
+}
+
+static void iTableTestPointerKeys(void)
+{
+  Itable* it = iupTableCreate(IUPTABLE_POINTERINDEXED);
+  char* keys = malloc(TABLE_TEST_COUNT);
+  int i, found = 0;
+  clock_t start;
+
+  start = clock();
+  for (i = 0; i < TABLE_TEST_COUNT; i++)
+    iupTableSet(it, keys + i, (void*)(size_t)(i + 1), IUPTABLE_POINTER);
+  for (i = 0; i < TABLE_TEST_COUNT; i++)
+  {
+    if (iupTableGet(it, keys + i) == (void*)(size_t)(i + 1))
+      found++;
+  }
+  iTableTestTime("Itable set+get pointer keys", start);
+  iTableTestCheck(found == TABLE_TEST_COUNT, "Itable get pointer keys");
+
+  for (i = 0; i < TABLE_TEST_COUNT; i++)
+    iupTableRemove(it, keys + i);
+  iTableTestCheck(iupTableCount(it) == 0, "Itable count after pointer remove");
+
+  iupTableDestroy(it);
+  free(keys);
+}
+
+static void iTableTestArray(void)
+{
+  Iarray* iarray = iupArrayCreate(10, sizeof(int));
+  int i, ok, *data = NULL;
+  clock_t start;
+
+  /* one element at a time, the growth must be geometric */
+  start = clock();
+  for (i = 0; i < TABLE_TEST_COUNT * 10; i++)
+  {
+    data = (int*)iupArrayInc(iarray);
+    data[i] = i;
+  }
+  iTableTestTime("Iarray inc", start);
+  iTableTestCheck(iupArrayCount(iarray) == TABLE_TEST_COUNT * 10, "Iarray count after inc");
+
+  /* insert at the start, remove from the middle */
+  data = (int*)iupArrayInsert(iarray, 0, 10);
+  for (i = 0; i < 10; i++)
+    data[i] = -1;
+  iupArrayRemove(iarray, 1000, 100);
+  iTableTestCheck(iupArrayCount(iarray) == TABLE_TEST_COUNT * 10 - 90, "Iarray count after insert and remove");
+
+  data = (int*)iupArrayGetData(iarray);
+  ok = 1;
+  for (i = 0; i < 10; i++)
+  {
+    if (data[i] != -1)
+      ok = 0;
+  }
+  for (i = 10; i < 1000; i++)
+  {
+    if (data[i] != i - 10)
+      ok = 0;
+  }
+  for (i = 1000; i < iupArrayCount(iarray); i++)
+  {
+    if (data[i] != i + 90)
+      ok = 0;
+  }
+  iTableTestCheck(ok, "Iarray data after insert and remove");
+
+  iupArrayShrink(iarray);
+  data = (int*)iupArrayGetData(iarray);
+  iTableTestCheck(data[iupArrayCount(iarray) - 1] == TABLE_TEST_COUNT * 10 - 1, "Iarray data after shrink");
+  iupArrayDestroy(iarray);
+
+  /* reserve once, then add in blocks without zero fill */
+  iarray = iupArrayCreate(10, sizeof(int));
+  iupArraySetZeroFill(iarray, 0);
+  start = clock();
+  iupArrayReserve(iarray, TABLE_TEST_COUNT * 10);
+  for (i = 0; i < TABLE_TEST_COUNT * 10; i += 100)
+  {
+    int j;
+    data = (int*)iupArrayAdd(iarray, 100);
+    for (j = 0; j < 100; j++)
+      data[i + j] = i + j;
+  }
+  iTableTestTime("Iarray reserve+add", start);
+  iTableTestCheck(data == (int*)iupArrayGetData(iarray) && data[TABLE_TEST_COUNT * 10 - 1] == TABLE_TEST_COUNT * 10 - 1, "Iarray reserve+add");
+
+  /* new elements after a remove must be zeroed again */
+  iupArraySetZeroFill(iarray, 1);
+  iupArrayRemove(iarray, 0, iupArrayCount(iarray));
+  data = (int*)iupArrayAdd(iarray, 100);
+  ok = 1;
+  for (i = 0; i < 100; i++)
+  {
+    if (data[i] != 0)
+      ok = 0;
+  }
+  iTableTestCheck(ok, "Iarray zero fill after remove");
+
+  iupArrayDestroy(iarray);
+}
+
+void TableTest(void)
+{
+  Ihandle *dlg, *text;
+  char line[50];
+
+  table_test_log[0] = 0;
+  table_test_errors = 0;
+
+  iTableTestStringKeys();
+  iTableTestCollisions();
+  iTableTestPointerKeys();
+  iTableTestArray();
+
+  sprintf(line, "Errors: %d", table_test_errors);
+  iTableTestLog(line);
+
+  text = IupText(NULL);
+  IupSetAttribute(text, "MULTILINE", "YES");
+  IupSetAttribute(text, "READONLY", "YES");
+  IupSetAttribute(text, "EXPAND", "YES");
+  IupSetAttribute(text, "VISIBLELINES", "15");
+  IupSetAttribute(text, "VISIBLECOLUMNS", "40");
+  IupSetAttribute(text, "VALUE", table_test_log);
+
+  dlg = IupDialog(IupVbox(text, NULL));
+  IupSetAttribute(dlg, "TITLE", "Itable and Iarray Test");
+  IupSetAttribute(dlg, "MARGIN", "10x10");
+
+  IupShow(dlg);
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  IupOpen(&argc, &argv);
+
+  TableTest();
+
+  IupMainLoop();
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
@@ -0,0 +1,192 @@
+/* Itable benchmark.
+   Compares the current Itable engine with the previous one (table_old.c)
+   for set, get, iterate and remove of 1e3 to 1e6 string keys. */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "iup.h"
+
+#include "iup_table.h"
+#include "table_old.h"
+
+
+#define TABLEBENCH_MAX 1000000
+#define TABLEBENCH_KEY_SIZE 24
+
+typedef struct _TableBenchEngine {
+  const char* name;
+  void* (*create)(void);
+  void (*set)(void* it, const char* key, void* value);
+  void* (*get)(void* it, const char* key);
+  void (*remove)(void* it, const char* key);
+  char* (*first)(void* it);
+  char* (*next)(void* it);
+  int (*count)(void* it);
+  void (*destroy)(void* it);
+} TableBenchEngine;
+
+static char table_bench_log[4096] = "";
+static int table_bench_errors = 0;
+
+static void* iTableBenchCreate(void) { return iupTableCreate(IUPTABLE_STRINGINDEXED); }
+static void iTableBenchSet(void* it, const char* key, void* value) { iupTableSet((Itable*)it, key, value, IUPTABLE_POINTER); }
+static void* iTableBenchGet(void* it, const char* key) { return iupTableGet((Itable*)it, key); }
+static void iTableBenchRemove(void* it, const char* key) { iupTableRemove((Itable*)it, key); }
+static char* iTableBenchFirst(void* it) { return iupTableFirst((Itable*)it); }
+static char* iTableBenchNext(void* it) { return iupTableNext((Itable*)it); }
+static int iTableBenchCount(void* it) { return iupTableCount((Itable*)it); }
+static void iTableBenchDestroy(void* it) { iupTableDestroy((Itable*)it); }
+
+static void* iOldTableBenchCreate(void) { return iupOldTableCreate(IUPTABLE_STRINGINDEXED); }
+static void iOldTableBenchSet(void* it, const char* key, void* value) { iupOldTableSet((IoldTable*)it, key, value, IUPTABLE_POINTER); }
+static void* iOldTableBenchGet(void* it, const char* key) { return iupOldTableGet((IoldTable*)it, key); }
+static void iOldTableBenchRemove(void* it, const char* key) { iupOldTableRemove((IoldTable*)it, key); }
+static char* iOldTableBenchFirst(void* it) { return iupOldTableFirst((IoldTable*)it); }
+static char* iOldTableBenchNext(void* it) { return iupOldTableNext((IoldTable*)it); }
+static int iOldTableBenchCount(void* it) { return iupOldTableCount((IoldTable*)it); }
+static void iOldTableBenchDestroy(void* it) { iupOldTableDestroy((IoldTable*)it); }
+
+static TableBenchEngine table_bench_engines[2] = {
+  { "previous", iOldTableBenchCreate, iOldTableBenchSet, iOldTableBenchGet, iOldTableBenchRemove,
+    iOldTableBenchFirst, iOldTableBenchNext, iOldTableBenchCount, iOldTableBenchDestroy },
+  { "current", iTableBenchCreate, iTableBenchSet, iTableBenchGet, iTableBenchRemove,
+    iTableBenchFirst, iTableBenchNext, iTableBenchCount, iTableBenchDestroy }
+};
+
+static void iTableBenchLog(const char* line)
+{
+  printf("%s\n", line);
+  if (strlen(table_bench_log) + strlen(line) + 2 < sizeof(table_bench_log))
+  {
+    strcat(table_bench_log, line);
+    strcat(table_bench_log, "\n");
+  }
+}
+
+static double iTableBenchTime(clock_t start, int count)
+{
+  /* nanoseconds per key */
+  return (double)(clock() - start) * 1.0e9 / CLOCKS_PER_SEC / count;
+}
+
+static void iTableBenchRun(TableBenchEngine* engine, char* keys, int* order, int count)
+{
+  void* it = engine->create();
+  double set_time, get_time, iterate_time, remove_time;
+  clock_t start;
+  char line[256], *k;
+  int i, found = 0, iterated = 0;
+
+  start = clock();
+  for (i = 0; i < count; i++)
+    engine->set(it, keys + i * TABLEBENCH_KEY_SIZE, (void*)(size_t)(i + 1));
+  set_time = iTableBenchTime(start, count);
+
+  start = clock();
+  for (i = 0; i < count; i++)
+  {
+    int k = order[i];
+    if (engine->get(it, keys + k * TABLEBENCH_KEY_SIZE) == (void*)(size_t)(k + 1))
+      found++;
+  }
+  get_time = iTableBenchTime(start, count);
+
+  start = clock();
+  k = engine->first(it);
+  while (k)
+  {
+    iterated++;
+    k = engine->next(it);
+  }
+  iterate_time = iTableBenchTime(start, count);
+
+  start = clock();
+  for (i = 0; i < count; i++)
+    engine->remove(it, keys + order[i] * TABLEBENCH_KEY_SIZE);
+  remove_time = iTableBenchTime(start, count);
+
+  sprintf(line, "%-8s %7d keys: set %6.1f, get %6.1f, iterate %5.1f, remove %6.1f ns/key",
+          engine->name, count, set_time, get_time, iterate_time, remove_time);
+  iTableBenchLog(line);
+
+  if (found != count || iterated != count || engine->count(it) != 0)
+  {
+    sprintf(line, "FAILED: %s engine with %d keys", engine->name, count);
+    iTableBenchLog(line);
+    table_bench_errors++;
+  }
+
+  engine->destroy(it);
+}
+
+void TableBenchTest(void)
+{
+  Ihandle *dlg, *text;
+  char* keys = malloc(TABLEBENCH_MAX * TABLEBENCH_KEY_SIZE);
+  int* order = malloc(TABLEBENCH_MAX * sizeof(int));
+  char line[50];
+  int i, count;
+
+  table_bench_log[0] = 0;
+  table_bench_errors = 0;
+
+  /* same style of the per cell attribute names */
+  for (i = 0; i < TABLEBENCH_MAX; i++)
+    sprintf(keys + i * TABLEBENCH_KEY_SIZE, "BGCOLOR%d:%d", i / 100, i % 100);
+
+  srand(1);
+  for (count = 1000; count <= TABLEBENCH_MAX; count *= 10)
+  {
+    /* get and remove in random order, as the application does */
+    for (i = 0; i < count; i++)
+      order[i] = i;
+    for (i = count - 1; i > 0; i--)
+    {
+      int j = (int)(((double)rand() / ((double)RAND_MAX + 1)) * (i + 1));
+      int t = order[i];
+      order[i] = order[j];
+      order[j] = t;
+    }
+
+    iTableBenchRun(table_bench_engines + 0, keys, order, count);
+    iTableBenchRun(table_bench_engines + 1, keys, order, count);
+  }
+
+  free(keys);
+  free(order);
+
+  sprintf(line, "Errors: %d", table_bench_errors);
+  iTableBenchLog(line);
+
+  text = IupText(NULL);
+  IupSetAttribute(text, "MULTILINE", "YES");
+  IupSetAttribute(text, "READONLY", "YES");
+  IupSetAttribute(text, "EXPAND", "YES");
+  IupSetAttribute(text, "VISIBLELINES", "10");
+  IupSetAttribute(text, "VISIBLECOLUMNS", "70");
+  IupSetAttribute(text, "FONT", "Courier, 10");
+  IupSetAttribute(text, "VALUE", table_bench_log);
+
+  dlg = IupDialog(IupVbox(text, NULL));
+  IupSetAttribute(dlg, "TITLE", "Itable Benchmark");
+  IupSetAttribute(dlg, "MARGIN", "10x10");
+
+  IupShow(dlg);
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  IupOpen(&argc, &argv);
+
+  TableBenchTest();
+
+  IupMainLoop();
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
@@ -0,0 +1,36 @@
+/* The previous Itable engine, see table_old.c.
+   Uses the index and item types of iup_table.h. */
+
+#ifndef __TABLE_OLD_H
+#define __TABLE_OLD_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct _IoldTable IoldTable;
+
+IoldTable *iupOldTableCreate(Itable_IndexTypes indexType);
+IoldTable *iupOldTableCreateSized(Itable_IndexTypes indexType, unsigned int initialSizeIndex);
+void iupOldTableDestroy(IoldTable *it);
+void iupOldTableClear(IoldTable *it);
+int iupOldTableCount(IoldTable *it);
+void iupOldTableSet(IoldTable *it, const char *key, void *value, Itable_Types itemType);
+void iupOldTableSetFunc(IoldTable *it, const char *key, Ifunc func);
+void *iupOldTableGet(IoldTable *it, const char *key);
+Ifunc iupOldTableGetFunc(IoldTable *it, const char *key, void **value);
+void *iupOldTableGetTyped(IoldTable *it, const char *key, Itable_Types *itemType);
+void iupOldTableRemove(IoldTable *it, const char *key);
+char *iupOldTableFirst(IoldTable *it);
+char *iupOldTableNext(IoldTable *it);
+void *iupOldTableGetCurr(IoldTable *it);
+int iupOldTableGetCurrType(IoldTable *it);
+void iupOldTableSetCurr(IoldTable *it, void* value, Itable_Types itemType);
+char *iupOldTableRemoveCurr(IoldTable *it);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,161 @@
+/* IupTree large data benchmark.
+   Adds many nodes with IupTreeAddNodes and one by one,
+   and finds nodes by userdata and by id. */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "iup.h"
+
+
+#define TREELARGE_NODES 100000
+#define TREELARGE_SINGLE 5000
+
+static Ihandle *treelarge_tree, *treelarge_text;
+static char treelarge_log[2048] = "";
+static char treelarge_userdata[TREELARGE_NODES];
+
+static void treelarge_log_line(const char* line)
+{
+  printf("%s\n", line);
+  if (strlen(treelarge_log) + strlen(line) + 2 < sizeof(treelarge_log))
+  {
+    strcat(treelarge_log, line);
+    strcat(treelarge_log, "\n");
+  }
+}
+
+static void treelarge_log_time(const char* name, clock_t start)
+{
+  char line[256];
+  sprintf(line, "%s: %.1f ms", name, (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC);
+  treelarge_log_line(line);
+}
+
+static int treelarge_start_cb(Ihandle* ih)
+{
+  Ihandle* tree = treelarge_tree;
+  const char** titles = malloc(TREELARGE_NODES * sizeof(char*));
+  void** userids = malloc(TREELARGE_NODES * sizeof(void*));
+  char* title_buffer = malloc(TREELARGE_NODES * 20);
+  clock_t start;
+  char line[256];
+  int i, count, found, errors = 0;
+  (void)ih;
+
+  treelarge_log[0] = 0;
+
+  for (i = 0; i < TREELARGE_NODES; i++)
+  {
+    titles[i] = title_buffer + i * 20;
+    sprintf(title_buffer + i * 20, "Node %d", i);
+    userids[i] = treelarge_userdata + i;
+  }
+
+  IupSetAttribute(tree, "DELNODE0", "CHILDREN");
+
+  start = clock();
+  count = IupTreeAddNodes(tree, 0, TREELARGE_NODES, NULL, titles, userids);
+  treelarge_log_time("IupTreeAddNodes", start);
+  if (count != TREELARGE_NODES || IupGetInt(tree, "COUNT") != TREELARGE_NODES + 1)
+  {
+    treelarge_log_line("FAILED: IupTreeAddNodes count");
+    errors++;
+  }
+
+  start = clock();
+  found = 0;
+  for (i = 0; i < TREELARGE_NODES; i++)
+  {
+    if (IupTreeGetId(tree, userids[i]) == i + 1)
+      found++;
+  }
+  treelarge_log_time("IupTreeGetId", start);
+  if (found != TREELARGE_NODES)
+  {
+    treelarge_log_line("FAILED: IupTreeGetId");
+    errors++;
+  }
+
+  start = clock();
+  found = 0;
+  for (i = 0; i < TREELARGE_NODES; i++)
+  {
+    if (IupTreeGetUserId(tree, i + 1) == userids[i])
+      found++;
+  }
+  treelarge_log_time("IupTreeGetUserId", start);
+  if (found != TREELARGE_NODES)
+  {
+    treelarge_log_line("FAILED: IupTreeGetUserId");
+    errors++;
+  }
+
+  /* one by one at the start, all the other ids move */
+  start = clock();
+  for (i = 0; i < TREELARGE_SINGLE; i++)
+    IupSetAttribute(tree, "ADDLEAF0", "Single");
+  sprintf(line, "ADDLEAF x %d", TREELARGE_SINGLE);
+  treelarge_log_time(line, start);
+
+  if (IupTreeGetId(tree, userids[0]) != TREELARGE_SINGLE + 1 ||
+      IupTreeGetId(tree, userids[TREELARGE_NODES - 1]) != TREELARGE_SINGLE + TREELARGE_NODES)
+  {
+    treelarge_log_line("FAILED: IupTreeGetId after ADDLEAF");
+    errors++;
+  }
+
+  start = clock();
+  IupSetAttribute(tree, "DELNODE0", "CHILDREN");
+  treelarge_log_time("DELNODE CHILDREN", start);
+
+  sprintf(line, "Errors: %d", errors);
+  treelarge_log_line(line);
+  IupSetAttribute(treelarge_text, "VALUE", treelarge_log);
+
+  free(titles);
+  free(userids);
+  free(title_buffer);
+  return IUP_DEFAULT;
+}
+
+void TreeLargeTest(void)
+{
+  Ihandle *dlg, *button;
+
+  treelarge_tree = IupTree();
+  IupSetAttribute(treelarge_tree, "RASTERSIZE", "300x400");
+
+  treelarge_text = IupText(NULL);
+  IupSetAttribute(treelarge_text, "MULTILINE", "YES");
+  IupSetAttribute(treelarge_text, "READONLY", "YES");
+  IupSetAttribute(treelarge_text, "EXPAND", "YES");
+  IupSetAttribute(treelarge_text, "VISIBLECOLUMNS", "30");
+
+  button = IupButton("Start", NULL);
+  IupSetCallback(button, "ACTION", (Icallback)treelarge_start_cb);
+
+  dlg = IupDialog(IupHbox(treelarge_tree, IupVbox(button, treelarge_text, NULL), NULL));
+  IupSetAttribute(dlg, "TITLE", "IupTree Large Data Test");
+  IupSetAttribute(dlg, "MARGIN", "10x10");
+  IupSetAttribute(dlg, "GAP", "10");
+
+  IupShowXY(dlg, IUP_CENTER, IUP_CENTER);
+  IupSetAttribute(treelarge_tree, "TITLE0", "Root");
+}
+
+#ifndef BIG_TEST
+int main(int argc, char* argv[])
+{
+  IupOpen(&argc, &argv);
+
+  TreeLargeTest();
+
+  IupMainLoop();
+
+  IupClose();
+
+  return EXIT_SUCCESS;
+}
+#endif
@@ -818,6 +818,10 @@ wb_usr.tree =
               name= {nl= "IupFlush"},
               link= "func/iupflush.html"
             },
+            {
+              name= {nl= "IupPostMessage"},
+              link= "func/iuppostmessage.html"
+            },
             { link= "", name= {en= "" } },
             {
               name= {nl= "IupGetCallback"},
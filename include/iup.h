@@ -63,7 +63,7 @@ IUP_EXPORT int       IupLoopStepWait  (void);
 IUP_EXPORT int       IupMainLoopLevel (void);
 IUP_EXPORT void      IupFlush         (void);
 IUP_EXPORT void      IupExitLoop      (void);
-IUP_EXPORT void      IupPostMessage   (Ihandle* ih, char*, void* message_data, int);
+IUP_EXPORT void      IupPostMessage   (Ihandle* ih, char* s, void* message_data, int i);
 
 IUP_EXPORT int       IupRecordInput(const char* filename, int mode);
 IUP_EXPORT int       IupPlayInput(const char* filename);
@@ -164,6 +164,12 @@ IUP_EXPORT float  IupGetFloatId2(Ihandle* ih, const char* name, int lin, int col
 IUP_EXPORT double IupGetDoubleId2(Ihandle* ih, const char* name, int lin, int col);
 IUP_EXPORT void   IupGetRGBId2(Ihandle* ih, const char* name, int lin, int col, unsigned char *r, unsigned char *g, unsigned char *b);
 
+IUP_EXPORT int       IupAtom(const char* name);
+IUP_EXPORT char*     IupAtomName(int atom);
+IUP_EXPORT void      IupSetAttributeAtom   (Ihandle* ih, int atom, const char* value);
+IUP_EXPORT void      IupSetStrAttributeAtom(Ihandle* ih, int atom, const char* value);
+IUP_EXPORT char*     IupGetAttributeAtom   (Ihandle* ih, int atom);
+
 IUP_EXPORT void      IupSetGlobal  (const char* name, const char* value);
 IUP_EXPORT void      IupSetStrGlobal(const char* name, const char* value);
 IUP_EXPORT char*     IupGetGlobal  (const char* name);
@@ -315,6 +321,7 @@ IUP_EXPORT void IupSetfAttributeId2(Ihandle* ih, const char* name, int lin, int
 IUP_EXPORT int   IupTreeSetUserId(Ihandle* ih, int id, void* userid);
 IUP_EXPORT void* IupTreeGetUserId(Ihandle* ih, int id);
 IUP_EXPORT int   IupTreeGetId(Ihandle* ih, void *userid);
+IUP_EXPORT int   IupTreeAddNodes(Ihandle* ih, int id, int count, const int* kinds, const char** titles, void** userids);
 IUP_EXPORT void  IupTreeSetAttributeHandle(Ihandle* ih, const char* name, int id, Ihandle* ih_named); /* deprecated, use IupSetAttributeHandleId */
 
 
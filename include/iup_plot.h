@@ -26,7 +26,11 @@ void IupPlotAddStr(Ihandle *ih, const char* x, double y);
 void IupPlotAddSegment(Ihandle *ih, double x, double y);
 int  IupPlotEnd(Ihandle *ih);
 
+int  IupPlotNewRingDataSet(Ihandle *ih, int capacity);
+
 int  IupPlotLoadData(Ihandle* ih, const char* filename, int strXdata);
+int  IupPlotLoadDataColumns(Ihandle* ih, const char* filename, int strXdata, const char* columns);
+int  IupPlotLoadDataBinary(Ihandle* ih, const char* filename, int col_count, int float_data, const char* columns);
 
 /* available only when linking with "iupluaplot" */
 int IupPlotSetFormula(Ihandle* ih, int sample_count, const char* formula, const char* init);
@@ -41,6 +45,9 @@ void IupPlotInsertSamples(Ihandle* ih, int ds_index, int sample_index, double *x
 void IupPlotAddSamples(Ihandle* ih, int ds_index, double *x, double *y, int count);
 void IupPlotAddStrSamples(Ihandle* ih, int ds_index, const char** x, double* y, int count);
 
+void IupPlotSetDataSetBuffers(Ihandle* ih, int ds_index, const double* x, const double* y, int count, int stride);
+void IupPlotAppendDataSetBuffers(Ihandle* ih, int ds_index, int count);
+
 void IupPlotGetSample(Ihandle* ih, int ds_index, int sample_index, double *x, double *y);
 void IupPlotGetSampleStr(Ihandle* ih, int ds_index, int sample_index, const char* *x, double *y);
 int  IupPlotGetSampleSelection(Ihandle* ih, int ds_index, int sample_index);
@@ -479,6 +479,7 @@ namespace Iup
     int SetUserId(int id, void* userid) { return IupTreeSetUserId(ih, id, userid); }
     void* GetUserId(int id) { return IupTreeGetUserId(ih, id); }
     int GetId(void *userid) { return IupTreeGetId(ih, userid); }
+    int AddNodes(int id, int count, const int* kinds, const char** titles, void** userids) { return IupTreeAddNodes(ih, id, count, kinds, titles, userids); }
   };
   class Val : public Control
   {
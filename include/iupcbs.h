@@ -48,6 +48,7 @@ typedef int (*IFniiiis)(Ihandle*, int, int, int, int, char*);  /* button_cb, mat
 typedef int (*IFniiiiiis)(Ihandle*, int, int, int, int, int, int, char*);  /* mouseclick_cb */
 
 typedef int (*IFnIi)(Ihandle*, int*, int); /* multiselection_cb, multiunselection_cb */
+typedef int (*IFnSVIi)(Ihandle*, char**, void**, int*, int); /* postmessagebatch_cb */
 typedef int (*IFnd)(Ihandle*, double);  /* mousemove_cb, button_press_cb, button_release_cb */
 typedef int (*IFniiIII)(Ihandle*, int, int, int*, int*, int*); /* fgcolor_cb, bgcolor_cb */
 typedef int (*IFniinsii)(Ihandle*, int, int, Ihandle*, char*, int, int); /* dropselect_cb */
@@ -55,6 +56,7 @@ typedef int (*IFnccc)(Ihandle*, unsigned char, unsigned char, unsigned char); /*
 typedef int (*IFniIIII)(Ihandle*, int, int*, int*, int*, int*); /* multitouch_cb */
 
 typedef int (*IFnC)(Ihandle*, struct _cdCanvas*); /* postdraw_cb, predraw_cb */
+typedef int (*IFnV)(Ihandle*, void*);  /* nodecount_cb */
 typedef int (*IFniiff)(Ihandle*, int, int, float, float); /* delete_cb (pplot) */
 typedef int (*IFniiffi)(Ihandle*, int, int, float, float, int); /* select_cb (pplot) */
 typedef int (*IFniidd)(Ihandle*, int, int, double, double); /* delete_cb */
@@ -68,6 +70,8 @@ typedef int (*IFndds)(Ihandle*, double, double, char*);    /* plotmotion_cb */
 typedef char* (*sIFnii)(Ihandle*, int, int);  /* value_cb, font_cb */
 typedef char* (*sIFni)(Ihandle*, int);  /* cell_cb */
 typedef char* (*sIFniis)(Ihandle*, int, int, char*);  /* translatevalue_cb */
+typedef char* (*sIFnV)(Ihandle*, void*);  /* nodetitle_cb */
+typedef void* (*VIFnVi)(Ihandle*, void*, int);  /* nodeuserdata_cb */
 
 typedef double (*dIFnii)(Ihandle*, int, int);  /* numericgetvalue_cb */
 typedef int    (*IFniid)(Ihandle*, int, int, double);  /* numericsetvalue_cb */
@@ -447,7 +447,7 @@ void iupdrvDrawImage(IdrawCanvas* dc, const char* name, int make_inactive, int x
 {
 //	NSLog(@"iupdrvDrawImage not implemented");
 	CGContextRef cg_context = dc->cgContext;
-	NSImage* user_image = (NSImage*)iupImageGetImage(name, dc->ih, make_inactive);
+	NSImage* user_image = (NSImage*)iupImageGetImageForDraw(name, dc->ih, make_inactive);
 //	[user_image autorelease]; // BAD: Iup is caching the value and returns the same pointer if cached. This results in a double autorelease.
 //	NSImageRep* user_image_rep = nil;
 
@@ -11,6 +11,8 @@
 
 #include "iup.h"
 #include "iupcbs.h"
+#include "iup_loop.h"
+
 #include "iupcocoa_drv.h"
 
 static IFidle mac_idle_cb = NULL;
@@ -197,19 +199,16 @@ void IupFlush(void)
 	[NSApp terminate:nil];
 }
 
-/* TODO: Make decision on final API. For now, this API is just to get a usable demo. */
-void IupPostMessage(Ihandle* ih, char* unusedchar, void* message_data, int unusedint)
+void IupPostMessage(Ihandle* ih, char* s, void* message_data, int i)
 {
-	dispatch_async(dispatch_get_main_queue(),
-		^{
-			//NSLog(@"dispatch_async fired on main_queue");
-			IFnsVi post_message_callback = (IFnsVi)IupGetCallback(ih, "POSTMESSAGE_CB");
-			if (post_message_callback)
-			{
-				//post_message_callback(ih, NULL, message_data, 0);
-				post_message_callback(ih, unusedchar, message_data, unusedint);
+	/* only the first message of a sequence is dispatched, the others are processed in the same call */
+	if (iupLoopPostMessage(ih, s, message_data, i))
+	{
+		dispatch_async(dispatch_get_main_queue(),
+			^{
+				iupLoopProcessMessages();
 			}
-		}
-	);
+		);
+	}
 }
 
@@ -1079,7 +1079,8 @@ static NSImage* helperGetActiveImageForTreeItem(IupCocoaTreeItem* tree_item, Iup
 		return;
 	}
 	
-
+	// In virtual mode, the children are created only now
+	iupTreeExpandVirtual([outline_view ih], (InodeHandle*)tree_item);
 
 	NSImage* expanded_image = [tree_item bitmapImage];
 	NSImage* collapsed_image = [tree_item collapsedImage];
@@ -2967,6 +2968,18 @@ void iupdrvTreeAddNode(Ihandle* ih, int prev_id, int kind, const char* title, in
 #endif
 }
 
+void iupdrvTreeBeginUpdate(Ihandle* ih)
+{
+	NSOutlineView* outline_view = cocoaTreeGetOutlineView(ih);
+	[outline_view beginUpdates];
+}
+
+void iupdrvTreeEndUpdate(Ihandle* ih)
+{
+	NSOutlineView* outline_view = cocoaTreeGetOutlineView(ih);
+	[outline_view endUpdates];
+}
+
 
 
 int iupdrvTreeTotalChildCount(Ihandle* ih, InodeHandle* node_handle)
@@ -3045,7 +3058,7 @@ static void cocoaTreeRemoveNodeDataRec(Ihandle* ih, IupCocoaTreeItem* tree_item,
 
 static void cocoaTreeRemoveNodeData(Ihandle* ih, IupCocoaTreeItem* tree_item, int call_cb)
 {
-  IFns cb = call_cb? (IFns)IupGetCallback(ih, "NODEREMOVED_CB"): NULL;
+  IFns cb = (call_cb && !iupAttribGet(ih, "_IUPTREE_IGNORE_NODEREMOVED_CB"))? (IFns)IupGetCallback(ih, "NODEREMOVED_CB"): NULL;
   int old_count = ih->data->node_count;
   int object_id = iupTreeFindNodeId(ih, tree_item);
   int start_id = object_id;
@@ -4930,6 +4943,8 @@ static int cocoaTreeMapMethod(Ihandle* ih)
 	{
 		iupdrvTreeAddNode(ih, -1, ITREE_BRANCH, "", 0);
 	}
+
+	iupTreeMapVirtual(ih);
 	
 	/* configure for DRAG&DROP of files */
 	if (IupGetCallback(ih, "DROPFILES_CB"))
@@ -37,10 +37,10 @@ INCLUDES = ../include .
 WIN32VER = 0x0501
 
 SRC = iup_array.c iup_callback.c iup_dlglist.c iup_attrib.c iup_focus.c iup_font.c \
-      iup_globalattrib.c iup_object.c iup_key.c iup_layout.c iup_ledlex.c iup_names.c \
+      iup_globalattrib.c iup_object.c iup_key.c iup_layout.c iup_ledlex.c iup_names.c iup_atom.c \
       iup_ledparse.c iup_predialogs.c iup_register.c iup_scanf.c iup_show.c iup_str.c \
       iup_func.c iup_childtree.c iup.c iup_classattrib.c iup_dialog.c iup_assert.c \
-      iup_messagedlg.c iup_timer.c iup_image.c iup_label.c iup_fill.c iup_zbox.c \
+      iup_messagedlg.c iup_timer.c iup_image.c iup_imageconv.c iup_imagecache.c iup_label.c iup_fill.c iup_zbox.c \
       iup_colordlg.c iup_fontdlg.c iup_filedlg.c iup_strmessage.c iup_menu.c iup_frame.c \
       iup_user.c iup_button.c iup_radio.c iup_toggle.c iup_progressbar.c iup_text.c iup_val.c \
       iup_box.c iup_hbox.c iup_vbox.c iup_cbox.c iup_class.c iup_classbase.c iup_maskmatch.c \
@@ -200,3 +200,8 @@ ifneq ($(findstring MacOS, $(TEC_UNAME)), )
     BUILD_DYLIB=Yes
   endif
 endif
+
+ifneq ($(findstring Linux, $(TEC_UNAME)), )
+  # Thread exit destructor of the returned strings memory
+  LIBS += pthread
+endif
@@ -365,7 +365,7 @@ void iupdrvDrawText(IdrawCanvas* dc, const char* text, int len, int x, int y, in
 void iupdrvDrawImage(IdrawCanvas* dc, const char* name, int make_inactive, int x, int y)
 {
   int bpp, img_w, img_h;
-  GdkPixbuf* pixbuf = iupImageGetImage(name, dc->ih, make_inactive);
+  GdkPixbuf* pixbuf = iupImageGetImageForDraw(name, dc->ih, make_inactive);
   if (!pixbuf)
     return;
 
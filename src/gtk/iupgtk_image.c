@@ -165,7 +165,7 @@ void* iupdrvImageCreateImage(Ihandle *ih, const char* bgcolor, int make_inactive
   guchar *pixdata, *pixline_data;
   int rowstride, channels;
   unsigned char *imgdata, *line_data, bg_r=0, bg_g=0, bg_b=0;
-  int x, y, i, bpp, colors_count = 0, has_alpha = 0;
+  int y, i, bpp, colors_count = 0, has_alpha = 0;
   iupColor colors[256];
 
   bpp = iupAttribGetInt(ih, "BPP");
@@ -211,22 +211,7 @@ void* iupdrvImageCreateImage(Ihandle *ih, const char* bgcolor, int make_inactive
       pixline_data = pixdata + y * rowstride;
       line_data = imgdata + y * ih->currentwidth;
 
-      for (x=0; x<ih->currentwidth; x++)
-      {
-        unsigned char index = line_data[x];
-        iupColor* c = &colors[index];
-        guchar *r = &pixline_data[channels*x],
-               *g = r+1,
-               *b = g+1,
-               *a = b+1;
-
-        *r = c->r;
-        *g = c->g;
-        *b = c->b;
-
-        if (has_alpha)
-          *a = c->a;
-      }
+      iupImageConvPalette(line_data, ih->currentwidth, colors, pixline_data, channels);
     }
   }
   else /* bpp == 32 or bpp == 24 */
@@ -240,28 +225,10 @@ void* iupdrvImageCreateImage(Ihandle *ih, const char* bgcolor, int make_inactive
 
       if (make_inactive)
       {
-        for (x=0; x<ih->currentwidth; x++)
-        {
-          guchar *r = &pixline_data[channels*x],
-                 *g = r+1,
-                 *b = g+1,
-                 *a = b+1;
-
-          if (has_alpha)
-          {
-            if (*a != 255)
-            {
-              *r = iupALPHABLEND(*r, bg_r, *a);
-              *g = iupALPHABLEND(*g, bg_g, *a);
-              *b = iupALPHABLEND(*b, bg_b, *a);
-            }
-            else
-              *a = 255;
-          }
+        if (has_alpha)
+          iupImageConvBlendBgColor(pixline_data, ih->currentwidth, bg_r, bg_g, bg_b, 0);
 
-          iupImageColorMakeInactive(r, g, b, 
-                                    bg_r, bg_g, bg_b);
-        }
+        iupImageConvMakeInactive(pixline_data, ih->currentwidth, channels, bg_r, bg_g, bg_b);
       }
     }
   }
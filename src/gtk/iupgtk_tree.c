@@ -86,6 +86,15 @@ static int gtkTreeTotalChildCount(Ihandle* ih, GtkTreeIter* iterItem)
   return iupdrvTreeTotalChildCount(ih, iterItem->user_data);
 }
 
+static int gtkTreeIsOnlyChild(GtkTreeModel* model, GtkTreeIter* iterParent, GtkTreeIter* iterItem)
+{
+  /* same as gtk_tree_model_iter_n_children()==1, but does not count all the children */
+  GtkTreeIter iterChild;
+  if (!gtk_tree_model_iter_children(model, &iterChild, iterParent) || iterChild.user_data != iterItem->user_data)
+    return 0;
+  return !gtk_tree_model_iter_next(model, &iterChild);
+}
+
 static int gtkTreeToggleGetCheck(Ihandle* ih, GtkTreeStore* store, GtkTreeIter iterItem)
 {
   int isChecked;
@@ -432,7 +441,7 @@ static void gtkTreeCallNodeRemoved(Ihandle* ih, GtkTreeModel* model, GtkTreeIter
   int id = gtkTreeFindNodeId(ih, iterItem);
   int start_id = id;
 
-  IFns cb = (IFns)IupGetCallback(ih, "NODEREMOVED_CB");
+  IFns cb = iupAttribGet(ih, "_IUPTREE_IGNORE_NODEREMOVED_CB")? NULL: (IFns)IupGetCallback(ih, "NODEREMOVED_CB");
   if (cb) 
     gtkTreeCallNodeRemovedRec(ih, model, iterItem, cb, &id);
   else
@@ -690,7 +699,7 @@ void iupdrvTreeAddNode(Ihandle* ih, int id, int kind, const char* title, int add
       return;
 
     /* If this is the first child of the parent, then handle the ADDEXPANDED attribute */
-    if (gtk_tree_model_iter_n_children(GTK_TREE_MODEL(store), &iterParent) == 1)
+    if (gtkTreeIsOnlyChild(GTK_TREE_MODEL(store), &iterParent, &iterNewItem))
     {
       path = gtk_tree_model_get_path(GTK_TREE_MODEL(store), &iterParent);
       iupAttribSet(ih, "_IUPTREE_IGNORE_BRANCH_CB", "1");
@@ -726,6 +735,18 @@ void iupdrvTreeAddNode(Ihandle* ih, int id, int kind, const char* title, int add
   }
 }
 
+void iupdrvTreeBeginUpdate(Ihandle* ih)
+{
+  /* GtkTreeView can not ignore the signals of the model while attached to it,
+     and detaching the model would lose the expanded and selected states */
+  (void)ih;
+}
+
+void iupdrvTreeEndUpdate(Ihandle* ih)
+{
+  (void)ih;
+}
+
 
 /*****************************************************************************/
 /* AUXILIAR FUNCTIONS                                                        */
@@ -2315,6 +2336,9 @@ static void gtkTreeRowExpanded(GtkTreeView* tree_view, GtkTreeIter *iterItem, Gt
 static gboolean gtkTreeTestExpandRow(GtkTreeView* tree_view, GtkTreeIter *iterItem, GtkTreePath *path, Ihandle* ih)
 {
   IFni cbBranchOpen = (IFni)IupGetCallback(ih, "BRANCHOPEN_CB");
+
+  iupTreeExpandVirtual(ih, iterItem->user_data);
+
   if (cbBranchOpen)
   {
     if (iupAttribGet(ih, "_IUPTREE_IGNORE_BRANCH_CB"))
@@ -2973,6 +2997,8 @@ static int gtkTreeMapMethod(Ihandle* ih)
   if (iupAttribGetInt(ih, "ADDROOT"))
     iupdrvTreeAddNode(ih, -1, ITREE_BRANCH, "", 0);
 
+  iupTreeMapVirtual(ih);
+
   /* configure for DRAG&DROP of files */
   if (IupGetCallback(ih, "DROPFILES_CB"))
     iupAttribSet(ih, "DROPFILESTARGET", "YES");
@@ -92,6 +92,16 @@ void iupdrvTreeAddNode(Ihandle* ih, int id, int kind, const char* title, int add
   // TODO FGCOLOR, default images, ADDEXPANDED
 }
 
+void iupdrvTreeBeginUpdate(Ihandle* ih)
+{
+  (void)ih;
+}
+
+void iupdrvTreeEndUpdate(Ihandle* ih)
+{
+  (void)ih;
+}
+
 
 /*****************************************************************************/
 /* AUXILIAR FUNCTIONS                                                        */
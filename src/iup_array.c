@@ -20,15 +20,19 @@ struct _Iarray
   int max_count;
   int elem_size;
   int start_count;
+  int zero_fill;
 };
 
 Iarray* iupArrayCreate(int start_count, int elem_size)
 {
   Iarray* iarray = (Iarray*)malloc(sizeof(Iarray));
+  if (start_count <= 0)
+    start_count = 1;
   iarray->count = 0;
   iarray->elem_size = elem_size;
   iarray->max_count = start_count;
   iarray->start_count = start_count;
+  iarray->zero_fill = 1;
   iarray->data = malloc(elem_size*start_count);
   iupASSERT(iarray->data!=NULL);
   if (!iarray->data)
@@ -47,7 +51,8 @@ void iupArrayDestroy(Iarray* iarray)
     return;
   if (iarray->data) 
   {
-    memset(iarray->data, 0, iarray->elem_size*iarray->max_count);
+    if (iarray->zero_fill)
+      memset(iarray->data, 0, iarray->elem_size*iarray->max_count);
     free(iarray->data);
   }
   free(iarray);
@@ -61,21 +66,70 @@ void* iupArrayGetData(Iarray* iarray)
   return iarray->data;
 }
 
+void iupArraySetZeroFill(Iarray* iarray, int zero_fill)
+{
+  iupASSERT(iarray!=NULL);
+  if (!iarray)
+    return;
+  iarray->zero_fill = zero_fill;
+}
+
+static int iArrayResize(Iarray* iarray, int new_max_count)
+{
+  int old_count = iarray->max_count;
+  void* new_data = realloc(iarray->data, (size_t)iarray->elem_size*new_max_count);
+  iupASSERT(new_data!=NULL);
+  if (!new_data)
+    return 0;  /* keep the previous data */
+  iarray->data = new_data;
+  iarray->max_count = new_max_count;
+  if (iarray->zero_fill && new_max_count > old_count)
+    memset((unsigned char*)iarray->data + (size_t)iarray->elem_size*old_count, 0, (size_t)iarray->elem_size*(new_max_count-old_count));
+  return 1;
+}
+
+static int iArrayGrow(Iarray* iarray, int new_count)
+{
+  int new_max_count;
+
+  if (new_count <= iarray->max_count)
+    return 1;
+
+  /* geometric growth (1.5x), so a sequence of N increments costs O(N) */
+  new_max_count = iarray->max_count + iarray->max_count/2;
+  if (new_max_count < iarray->max_count + iarray->start_count)
+    new_max_count = iarray->max_count + iarray->start_count;
+  if (new_max_count < new_count)
+    new_max_count = new_count;
+
+  return iArrayResize(iarray, new_max_count);
+}
+
+void iupArrayReserve(Iarray* iarray, int max_count)
+{
+  iupASSERT(iarray!=NULL);
+  if (!iarray)
+    return;
+  if (max_count > iarray->max_count)
+    iArrayResize(iarray, max_count);
+}
+
+void iupArrayShrink(Iarray* iarray)
+{
+  iupASSERT(iarray!=NULL);
+  if (!iarray)
+    return;
+  if (iarray->max_count > iarray->count)
+    iArrayResize(iarray, iarray->count > 0? iarray->count: 1);
+}
+
 void* iupArrayInc(Iarray* iarray)
 {
   iupASSERT(iarray!=NULL);
   if (!iarray)
     return NULL;
-  if (iarray->count >= iarray->max_count)
-  {
-    int old_count = iarray->max_count;
-    iarray->max_count += iarray->start_count;
-    iarray->data = realloc(iarray->data, iarray->elem_size*iarray->max_count);
-    iupASSERT(iarray->data!=NULL);
-    if (!iarray->data)
-      return NULL;
-    memset((unsigned char*)iarray->data + iarray->elem_size*old_count, 0, iarray->elem_size*(iarray->max_count-old_count));
-  }
+  if (!iArrayGrow(iarray, iarray->count + 1))
+    return NULL;
   iarray->count++;
   return iarray->data;
 }
@@ -85,16 +139,8 @@ void* iupArrayAdd(Iarray* iarray, int add_count)
   iupASSERT(iarray!=NULL);
   if (!iarray)
     return NULL;
-  if (iarray->count+add_count > iarray->max_count)
-  {
-    int old_count = iarray->max_count;
-    iarray->max_count += add_count;
-    iarray->data = realloc(iarray->data, iarray->elem_size*iarray->max_count);
-    iupASSERT(iarray->data!=NULL);
-    if (!iarray->data)
-      return NULL;
-    memset((unsigned char*)iarray->data + iarray->elem_size*old_count, 0, iarray->elem_size*(iarray->max_count-old_count));
-  }
+  if (!iArrayGrow(iarray, iarray->count + add_count))
+    return NULL;
   iarray->count += add_count;
   return iarray->data;
 }
@@ -106,13 +152,15 @@ void* iupArrayInsert(Iarray* iarray, int index, int insert_count)
     return NULL;
   if (index < 0 || index > iarray->count)
     return NULL;
-  iupArrayAdd(iarray, insert_count);
+  if (!iupArrayAdd(iarray, insert_count))
+    return NULL;
   if (index < iarray->count)  /* if equal, insert at the end, no need to move data */
     memmove((unsigned char*)iarray->data + iarray->elem_size*(index + insert_count), 
             (unsigned char*)iarray->data + iarray->elem_size*index, 
             iarray->elem_size*(iarray->count - insert_count - index));
   /* clear new data */
-  memset((unsigned char*)iarray->data + iarray->elem_size*index, 0, iarray->elem_size*insert_count);
+  if (iarray->zero_fill)
+    memset((unsigned char*)iarray->data + iarray->elem_size*index, 0, iarray->elem_size*insert_count);
   return iarray->data;
 }
 
@@ -128,7 +176,8 @@ void iupArrayRemove(Iarray* iarray, int index, int remove_count)
             (unsigned char*)iarray->data + iarray->elem_size*(index + remove_count), 
             iarray->elem_size*(iarray->count - remove_count - index));
   /* clear old data */
-  memset((unsigned char*)iarray->data + iarray->elem_size*(iarray->count - remove_count), 0, iarray->elem_size*remove_count);
+  if (iarray->zero_fill)
+    memset((unsigned char*)iarray->data + iarray->elem_size*(iarray->count - remove_count), 0, iarray->elem_size*remove_count);
   iarray->count -= remove_count;
 }
 
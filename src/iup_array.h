@@ -25,8 +25,9 @@ typedef struct _Iarray Iarray;
 
 /** Creates an array with an initial room for elements, and the element size.
  * The array count starts at 0. And the maximum number of elements starts at the given count.
- * The maximum number of elements is increased by the start_max_count, every time it needs more memory.
- * Data is always initialized with zeros.
+ * The maximum number of elements is increased by half of the current maximum (at least start_max_count), 
+ * every time it needs more memory.
+ * Data is initialized with zeros, unless disabled by \ref iupArraySetZeroFill.
  * Must call \ref iupArrayInc, \ref iupArrayAdd or \ref iupArrayInsert to properly increase the number of elements.
  * \ingroup iarray */
 IUP_EXPORTI Iarray* iupArrayCreate(int start_max_count, int elem_size);
@@ -41,24 +42,26 @@ IUP_EXPORTI void* iupArrayGetData(Iarray* iarray);
 
 /** Increments the number of elements in the array.
  * The array count starts at 0. 
- * If the maximum number of elements is reached, the memory allocated is increased by the initial start count.
- * Data is always initialized with zeros.
+ * If the maximum number of elements is reached, the memory allocated is increased geometrically.
+ * Data is initialized with zeros, unless disabled by \ref iupArraySetZeroFill.
  * Returns the pointer that contains the array.
  * \ingroup iarray */
 IUP_EXPORTI void* iupArrayInc(Iarray* iarray);
 
 /** Increments the number of elements in the array by a given count.
  * New space is allocated at the end of the array.
- * If the maximum number of elements is reached, the memory allocated is increased by the given count.
- * Data is always initialized with zeros.
+ * If the maximum number of elements is reached, the memory allocated is increased geometrically, 
+ * or at least by the given count.
+ * Data is initialized with zeros, unless disabled by \ref iupArraySetZeroFill.
  * Returns the pointer that contains the array.
  * \ingroup iarray */
 IUP_EXPORTI void* iupArrayAdd(Iarray* iarray, int add_count);
 
 /** Increments the number of elements in the array by a given count
  * and moves the data so the new space starts at index.
- * If the maximum number of elements is reached, the memory allocated is increased by the given count.
- * Data is always initialized with zeros.
+ * If the maximum number of elements is reached, the memory allocated is increased geometrically, 
+ * or at least by the given count.
+ * Data is initialized with zeros, unless disabled by \ref iupArraySetZeroFill.
  * Returns the pointer that contains the array.
  * \ingroup iarray */
 IUP_EXPORTI void* iupArrayInsert(Iarray* iarray, int index, int insert_count);
@@ -67,6 +70,21 @@ IUP_EXPORTI void* iupArrayInsert(Iarray* iarray, int index, int insert_count);
  * \ingroup iarray */
 IUP_EXPORTI void iupArrayRemove(Iarray* iarray, int index, int remove_count);
 
+/** Allocates memory for at least the given maximum number of elements.
+ * The number of elements is not changed.
+ * Use it before adding a large number of elements.
+ * \ingroup iarray */
+IUP_EXPORTI void iupArrayReserve(Iarray* iarray, int max_count);
+
+/** Releases the memory not used by the current number of elements.
+ * \ingroup iarray */
+IUP_EXPORTI void iupArrayShrink(Iarray* iarray);
+
+/** Enables or disables the initialization of new elements with zeros. Default: enabled.
+ * Disable it when new elements are always overwritten after they are added.
+ * \ingroup iarray */
+IUP_EXPORTI void iupArraySetZeroFill(Iarray* iarray, int zero_fill);
+
 /** Returns the actual number of elements in the array.
  * \ingroup iarray */
 IUP_EXPORTI int iupArrayCount(Iarray* iarray);
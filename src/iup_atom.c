@@ -0,0 +1,114 @@
+/** \file
+ * \brief Attribute name atoms.
+ *
+ * See Copyright Notice in "iup.h"
+ */
+
+#include <stdlib.h>
+#include <memory.h>
+
+#include "iup.h"
+
+#include "iup_str.h"
+#include "iup_table.h"
+#include "iup_array.h"
+#include "iup_atom.h"
+#include "iup_assert.h"
+
+
+typedef struct _IatomInfo
+{
+  char* name;
+  unsigned int hash;
+} IatomInfo;
+
+static Itable *iatom_table = NULL;   /* table indexed by name containing the atom */
+static Iarray *iatom_array = NULL;   /* array indexed by atom containing IatomInfo */
+
+void iupAtomInit(void)
+{
+  iatom_table = iupTableCreateSized(IUPTABLE_STRINGINDEXED, 3);  /* there are about 1000 registered attributes */
+  iatom_array = iupArrayCreate(1024, sizeof(IatomInfo));
+
+  iupArrayInc(iatom_array);  /* atom 0 is invalid */
+}
+
+void iupAtomFinish(void)
+{
+  IatomInfo* info = (IatomInfo*)iupArrayGetData(iatom_array);
+  int i, count = iupArrayCount(iatom_array);
+
+  for (i = 1; i < count; i++)
+    free(info[i].name);
+
+  iupArrayDestroy(iatom_array);
+  iatom_array = NULL;
+
+  iupTableDestroy(iatom_table);
+  iatom_table = NULL;
+}
+
+int iupAtomFind(const char* name)
+{
+  if (!name || !iatom_table)
+    return 0;
+
+  return (int)(size_t)iupTableGet(iatom_table, name);
+}
+
+int iupAtomGet(const char* name)
+{
+  IatomInfo* info;
+  int atom;
+
+  if (!name || !iatom_table)
+    return 0;
+
+  atom = (int)(size_t)iupTableGet(iatom_table, name);
+  if (atom)
+    return atom;
+
+  atom = iupArrayCount(iatom_array);
+  info = (IatomInfo*)iupArrayInc(iatom_array);
+  info[atom].name = iupStrDup(name);
+  info[atom].hash = iupTableGetStringHash(name);
+
+  iupTableSet(iatom_table, name, (void*)(size_t)atom, IUPTABLE_POINTER);
+  return atom;
+}
+
+const char* iupAtomGetName(int atom)
+{
+  IatomInfo* info;
+
+  if (!iatom_array || atom <= 0 || atom >= iupArrayCount(iatom_array))
+    return NULL;
+
+  info = (IatomInfo*)iupArrayGetData(iatom_array);
+  return info[atom].name;
+}
+
+unsigned int iupAtomGetHash(int atom)
+{
+  IatomInfo* info;
+
+  if (!iatom_array || atom <= 0 || atom >= iupArrayCount(iatom_array))
+    return 0;
+
+  info = (IatomInfo*)iupArrayGetData(iatom_array);
+  return info[atom].hash;
+}
+
+int IupAtom(const char* name)
+{
+  iupASSERT(name!=NULL);
+  if (!name)
+    return 0;
+
+  return iupAtomGet(name);
+}
+
+char* IupAtomName(int atom)
+{
+  return (char*)iupAtomGetName(atom);
+}
@@ -0,0 +1,55 @@
+/** \file
+ * \brief Attribute name atoms (not exported API).
+ *
+ * See Copyright Notice in "iup.h"
+ */
+ 
+#ifndef __IUP_ATOM_H 
+#define __IUP_ATOM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \defgroup atom Attribute Atoms
+ * \par
+ * Attribute names can be interned into small integer ids, called atoms.
+ * The atom stores the name hash, so the attribute table of the element
+ * is accessed without hashing the name again,
+ * and the class attribute functions are indexed directly by the atom.
+ * \par
+ * Atom 0 is invalid. Atoms are valid between IupOpen and IupClose.
+ * \par
+ * See \ref iup_atom.h
+ * \ingroup util */
+
+/* called only in IupOpen and IupClose */
+void iupAtomInit(void);
+void iupAtomFinish(void);
+
+/** Returns the atom of the given name, creates a new one if not found.
+ * \ingroup atom */
+int iupAtomGet(const char* name);
+
+/** Returns the atom of the given name, or 0 if not found.
+ * \ingroup atom */
+int iupAtomFind(const char* name);
+
+/** Returns the name of the atom, or NULL if invalid.
+ * \ingroup atom */
+const char* iupAtomGetName(int atom);
+
+/** Returns the name hash of the atom, as computed by \ref iupTableGetStringHash.
+ * \ingroup atom */
+unsigned int iupAtomGetHash(int atom);
+
+/* Other functions declared in <iup.h> and implemented here. 
+IupAtom
+IupAtomName
+*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -20,6 +20,7 @@
 #include "iup_attrib.h"
 #include "iup_assert.h"
 #include "iup_varg.h"
+#include "iup_atom.h"
 
 
 #define iupATTRIB_LANGUAGE_STRING(_v)  (_v && _v[0] == '_' && _v[1] == '@') 
@@ -688,6 +689,112 @@ char* IupGetAttribute(Ihandle *ih, const char* name)
   }
 }
 
+static void iAttribSetAtom(Ihandle* ih, const char* name, unsigned int hash, const char* value, Itable_Types itemType)
+{
+  if (!value)
+    iupTableRemoveHashed(ih->attrib, name, hash);
+  else
+    iupTableSetHashed(ih->attrib, name, hash, (void*)value, itemType);
+}
+
+static void iAttribSetAtomValue(Ihandle *ih, int atom, const char *value, int store)
+{
+  int inherit;
+  const char* name = iupAtomGetName(atom);
+  unsigned int hash = iupAtomGetHash(atom);
+
+  iupASSERT(name!=NULL);
+  if (!name)
+    return;
+
+  if (!ih)
+  {
+    if (store)
+      IupStoreGlobal(name, value);
+    else
+      IupSetGlobal(name, value);
+    return;
+  }
+
+  iupASSERT(iupObjectCheck(ih));
+  if (!iupObjectCheck(ih))
+    return;
+
+  if (iupATTRIB_ISINTERNAL(name))
+    iAttribSetAtom(ih, name, hash, value, store? IUPTABLE_STRING: IUPTABLE_POINTER);
+  else
+  {
+    int ret, is_string = store;
+
+    if (is_string && iupATTRIB_LANGUAGE_STRING(value))
+      iupATTRIB_GET_LANGUAGE_STRING(value, store);
+
+    ret = iupClassObjectSetAttributeAtom(ih, atom, value, &inherit);
+    if (is_string? ret==1: ret!=0) /* store only strings, or strings and pointers */
+      iAttribSetAtom(ih, name, hash, value, store? IUPTABLE_STRING: IUPTABLE_POINTER);
+
+    if (inherit)
+      iAttribNotifyChildren(ih, name, value);
+  }
+}
+
+void IupSetAttributeAtom(Ihandle *ih, int atom, const char *value)
+{
+  iAttribSetAtomValue(ih, atom, value, 0);
+}
+
+void IupSetStrAttributeAtom(Ihandle *ih, int atom, const char *value)
+{
+  iAttribSetAtomValue(ih, atom, value, 1);
+}
+
+char* IupGetAttributeAtom(Ihandle *ih, int atom)
+{
+  const char* name = iupAtomGetName(atom);
+  unsigned int hash = iupAtomGetHash(atom);
+
+  iupASSERT(name!=NULL);
+  if (!name)
+    return NULL;
+
+  if (!ih)
+    return IupGetGlobal(name);
+
+  iupASSERT(iupObjectCheck(ih));
+  if (!iupObjectCheck(ih))
+    return NULL;
+
+  if (iupATTRIB_ISINTERNAL(name))
+    return iupTableGetHashed(ih->attrib, name, hash);
+  else
+  {
+    int inherit;
+    char *value, *def_value;
+
+    value = iupClassObjectGetAttributeAtom(ih, atom, &def_value, &inherit);
+
+    if (!value)
+      value = iupTableGetHashed(ih->attrib, name, hash);
+
+    if (!value && inherit)
+    {
+      while (!value)
+      {
+        ih = ih->parent;
+        if (!ih)
+          break;
+
+        value = iupTableGetHashed(ih->attrib, name, hash);
+      }
+    }
+
+    if (!value)
+      value = def_value;
+
+    return value;
+  }
+}
+
 float IupGetFloat(Ihandle *ih, const char* name)
 {
   float f = 0;
@@ -233,6 +233,7 @@ static void iClassReleaseAttribFuncTable(Iclass* ic)
   }
 
   iupTableDestroy(ic->attrib_func);
+  iupArrayDestroy(ic->attrib_atom_func);
 }
 
 Iclass* iupClassNew(Iclass* parent)
@@ -244,10 +245,14 @@ Iclass* iupClassNew(Iclass* parent)
   {
     parent = parent->New();
     ic->attrib_func = parent->attrib_func;
+    ic->attrib_atom_func = parent->attrib_atom_func;
     ic->parent = parent;
   }
   else
+  {
     ic->attrib_func = iupTableCreate(IUPTABLE_STRINGINDEXED);
+    ic->attrib_atom_func = iupArrayCreate(256, sizeof(void*));
+  }
 
   return ic;
 }
@@ -8,6 +8,7 @@
 #define __IUP_CLASS_H
 
 #include "iup_table.h"
+#include "iup_array.h"
 #include "iup_export.h"
 
 #ifdef __cplusplus
@@ -77,6 +78,7 @@ struct Iclass_
                    * All methods can be changed, set to NULL, switched, etc. */
 
   Itable* attrib_func; /**< table of functions to handle attributes, only one per class tree */
+  Iarray* attrib_atom_func; /**< same functions of attrib_func indexed by the attribute name atom, only one per class tree */
 
   /* Class methods. */
 
@@ -442,6 +444,13 @@ char* iupClassObjectGetAttributeId(Ihandle* ih, const char* name, int id);
 int   iupClassObjectSetAttributeId2(Ihandle* ih, const char* name, int id1, int id2, const char* value);
 char* iupClassObjectGetAttributeId2(Ihandle* ih, const char* name, int id1, int id2);
 
+/* Same as iupClassObjectSetAttribute and iupClassObjectGetAttribute,
+ * but the attribute function is retrieved by the name atom, without hashing the name.
+ * Called from IupSetAttributeAtom, IupSetStrAttributeAtom and IupGetAttributeAtom.
+ */
+int   iupClassObjectSetAttributeAtom(Ihandle* ih, int atom, const char* value, int *inherit);
+char* iupClassObjectGetAttributeAtom(Ihandle* ih, int atom, char* *def_value, int *inherit);
+
 /* Used only in iupAttribGetStr */
 void  iupClassObjectGetAttributeInfo(Ihandle* ih, const char* name, char* *def_value, int *inherit);
 
@@ -19,6 +19,7 @@
 #include "iup_assert.h"
 #include "iup_register.h"
 #include "iup_globalattrib.h"
+#include "iup_atom.h"
 
 
 typedef struct _IattribFunc
@@ -173,6 +174,60 @@ int iupClassObjectSetAttributeId(Ihandle* ih, const char* name, int id, const ch
   return 1;  /* function not found, default to string */
 }
 
+static int iClassObjectSetAttributeFunc(Ihandle* ih, IattribFunc* afunc, const char* name, const char * value, int *inherit)
+{
+  *inherit = 1; /* default is inheritable */
+  if (afunc)
+  {
+    *inherit = !(afunc->flags & IUPAF_NO_INHERIT) &&   /* is inheritable */
+               !(afunc->flags & IUPAF_NO_STRING);      /* is a string */
+
+    if (afunc->flags & IUPAF_READONLY)
+    {
+      if (afunc->flags & IUPAF_NO_STRING)
+        return -1;  /* value is NOT a string, can NOT call iupAttribSetStr */
+      return 0;
+    }
+
+    if (afunc->set && (ih->handle || afunc->flags & IUPAF_NOT_MAPPED))
+    {
+      int ret;
+      if (!value)
+      {
+        /* inheritable attributes when reset must check the parent value */
+        if (*inherit && ih->parent)   
+          value = iupAttribGetInherit(ih->parent, name); 
+
+        if (!value)
+          value = iClassGetDefaultValue(afunc);
+      }
+
+      if (afunc->flags & IUPAF_HAS_ID2)
+      {
+        IattribSetId2Func id2_set = (IattribSetId2Func)afunc->set;
+        return id2_set(ih, IUP_INVALID_ID, IUP_INVALID_ID, value);  /* empty Id */
+      }
+      else if (afunc->flags & IUPAF_HAS_ID)
+      {
+        IattribSetIdFunc id_set = (IattribSetIdFunc)afunc->set;
+        return id_set(ih, IUP_INVALID_ID, value);  /* empty Id */
+      }
+      else
+        ret = afunc->set(ih, value);
+
+      if (ret == 1 && afunc->flags & IUPAF_NO_STRING)
+        return -1;  /* value is NOT a string, can NOT call iupAttribSetStr */
+
+      if (*inherit)
+        return 1;   /* inheritable attributes are always stored in the hash table, */
+      else          /* to indicate that they are set at the control.               */
+        return ret;
+    }
+  }
+
+  return 1;  /* function not found, default to string */
+}
+
 int iupClassObjectSetAttribute(Ihandle* ih, const char* name, const char * value, int *inherit)
 {
   IattribFunc* afunc;
@@ -227,56 +282,7 @@ int iupClassObjectSetAttribute(Ihandle* ih, const char* name, const char * value
   /* if not has_attrib_id, or not found an ID, or not found the partial name, check using the full name */
 
   afunc = (IattribFunc*)iupTableGet(ih->iclass->attrib_func, name);
-  *inherit = 1; /* default is inheritable */
-  if (afunc)
-  {
-    *inherit = !(afunc->flags & IUPAF_NO_INHERIT) &&   /* is inheritable */
-               !(afunc->flags & IUPAF_NO_STRING);      /* is a string */
-
-    if (afunc->flags & IUPAF_READONLY)
-    {
-      if (afunc->flags & IUPAF_NO_STRING)
-        return -1;  /* value is NOT a string, can NOT call iupAttribSetStr */
-      return 0;
-    }
-
-    if (afunc->set && (ih->handle || afunc->flags & IUPAF_NOT_MAPPED))
-    {
-      int ret;
-      if (!value)
-      {
-        /* inheritable attributes when reset must check the parent value */
-        if (*inherit && ih->parent)   
-          value = iupAttribGetInherit(ih->parent, name); 
-
-        if (!value)
-          value = iClassGetDefaultValue(afunc);
-      }
-
-      if (afunc->flags & IUPAF_HAS_ID2)
-      {
-        IattribSetId2Func id2_set = (IattribSetId2Func)afunc->set;
-        return id2_set(ih, IUP_INVALID_ID, IUP_INVALID_ID, value);  /* empty Id */
-      }
-      else if (afunc->flags & IUPAF_HAS_ID)
-      {
-        IattribSetIdFunc id_set = (IattribSetIdFunc)afunc->set;
-        return id_set(ih, IUP_INVALID_ID, value);  /* empty Id */
-      }
-      else
-        ret = afunc->set(ih, value);
-
-      if (ret == 1 && afunc->flags & IUPAF_NO_STRING)
-        return -1;  /* value is NOT a string, can NOT call iupAttribSetStr */
-
-      if (*inherit)
-        return 1;   /* inheritable attributes are always stored in the hash table, */
-      else          /* to indicate that they are set at the control.               */
-        return ret;
-    }
-  }
-
-  return 1;  /* function not found, default to string */
+  return iClassObjectSetAttributeFunc(ih, afunc, name, value, inherit);
 }
 
 char* iupClassObjectGetAttributeId2(Ihandle* ih, const char* name, int id1, int id2)
@@ -342,6 +348,38 @@ char* iupClassObjectGetAttributeId(Ihandle* ih, const char* name, int id)
   return NULL;
 }
 
+static char* iClassObjectGetAttributeFunc(Ihandle* ih, IattribFunc* afunc, char* *def_value, int *inherit)
+{
+  *def_value = NULL;
+  *inherit = 1; /* default is inheritable */
+  if (afunc)
+  {
+    *def_value = iClassGetDefaultValue(afunc);
+    *inherit = !(afunc->flags & IUPAF_NO_INHERIT) &&   /* is inheritable */
+               !(afunc->flags & IUPAF_NO_STRING);      /* is a string */
+
+    if (afunc->flags & IUPAF_WRITEONLY)
+      return NULL;
+
+    if (afunc->get && (ih->handle || afunc->flags & IUPAF_NOT_MAPPED))
+    {
+      if (afunc->flags & IUPAF_HAS_ID2)
+      {
+        IattribGetId2Func id2_get = (IattribGetId2Func)afunc->get;
+        return id2_get(ih, IUP_INVALID_ID, IUP_INVALID_ID);  /* empty Id */
+      }
+      else if (afunc->flags & IUPAF_HAS_ID)
+      {
+        IattribGetIdFunc id_get = (IattribGetIdFunc)afunc->get;
+        return id_get(ih, IUP_INVALID_ID);  /* empty Id */
+      }
+      else
+        return afunc->get(ih);
+    }
+  }
+  return NULL;
+}
+
 char* iupClassObjectGetAttribute(Ihandle* ih, const char* name, char* *def_value, int *inherit)
 {
   IattribFunc* afunc;
@@ -390,34 +428,59 @@ char* iupClassObjectGetAttribute(Ihandle* ih, const char* name, char* *def_value
   /* if not has_attrib_id, or not found an ID, or not found the partial name, check using the full name */
 
   afunc = (IattribFunc*)iupTableGet(ih->iclass->attrib_func, name);
-  *def_value = NULL;
-  *inherit = 1; /* default is inheritable */
-  if (afunc)
+  return iClassObjectGetAttributeFunc(ih, afunc, def_value, inherit);
+}
+
+static IattribFunc* iClassGetAtomFunc(Iclass* ic, int atom)
+{
+  if (atom <= 0 || atom >= iupArrayCount(ic->attrib_atom_func))
+    return NULL;
+  else
   {
-    *def_value = iClassGetDefaultValue(afunc);
-    *inherit = !(afunc->flags & IUPAF_NO_INHERIT) &&   /* is inheritable */
-               !(afunc->flags & IUPAF_NO_STRING);      /* is a string */
+    IattribFunc** atom_func = (IattribFunc**)iupArrayGetData(ic->attrib_atom_func);
+    return atom_func[atom];
+  }
+}
 
-    if (afunc->flags & IUPAF_WRITEONLY)
-      return NULL;
+static void iClassSetAtomFunc(Iclass* ic, const char* name, IattribFunc* afunc)
+{
+  int atom = iupAtomGet(name);
+  int count = iupArrayCount(ic->attrib_atom_func);
+  IattribFunc** atom_func;
 
-    if (afunc->get && (ih->handle || afunc->flags & IUPAF_NOT_MAPPED))
-    {
-      if (afunc->flags & IUPAF_HAS_ID2)
-      {
-        IattribGetId2Func id2_get = (IattribGetId2Func)afunc->get;
-        return id2_get(ih, IUP_INVALID_ID, IUP_INVALID_ID);  /* empty Id */
-      }
-      else if (afunc->flags & IUPAF_HAS_ID)
-      {
-        IattribGetIdFunc id_get = (IattribGetIdFunc)afunc->get;
-        return id_get(ih, IUP_INVALID_ID);  /* empty Id */
-      }
-      else
-        return afunc->get(ih);
-    }
+  if (atom <= 0)
+    return;
+
+  if (atom >= count)
+    atom_func = (IattribFunc**)iupArrayAdd(ic->attrib_atom_func, atom + 1 - count);  /* new space is zero initialized */
+  else
+    atom_func = (IattribFunc**)iupArrayGetData(ic->attrib_atom_func);
+
+  atom_func[atom] = afunc;
+}
+
+int iupClassObjectSetAttributeAtom(Ihandle* ih, int atom, const char* value, int *inherit)
+{
+  const char* name = iupAtomGetName(atom);
+
+  /* numbered attributes must parse the name */
+  if (ih->iclass->has_attrib_id!=0 && iClassFindId(name))
+    return iupClassObjectSetAttribute(ih, name, value, inherit);
+
+  return iClassObjectSetAttributeFunc(ih, iClassGetAtomFunc(ih->iclass, atom), name, value, inherit);
+}
+
+char* iupClassObjectGetAttributeAtom(Ihandle* ih, int atom, char* *def_value, int *inherit)
+{
+  /* numbered attributes must parse the name */
+  if (ih->iclass->has_attrib_id!=0)
+  {
+    const char* name = iupAtomGetName(atom);
+    if (iClassFindId(name))
+      return iupClassObjectGetAttribute(ih, name, def_value, inherit);
   }
-  return NULL;
+
+  return iClassObjectGetAttributeFunc(ih, iClassGetAtomFunc(ih->iclass, atom), def_value, inherit);
 }
 
 void iupClassObjectGetAttributeInfo(Ihandle* ih, const char* name, char* *def_value, int *inherit)
@@ -542,6 +605,7 @@ void iupClassRegisterAttribute(Iclass* ic, const char* name,
     afunc->call_global_default = 0;
 
   iupTableSet(ic->attrib_func, name, (void*)afunc, IUPTABLE_POINTER);
+  iClassSetAtomFunc(ic, name, afunc);
 }
 
 void iupClassRegisterAttributeId(Iclass* ic, const char* name, 
@@ -561,6 +625,7 @@ void iupClassRegisterAttributeId(Iclass* ic, const char* name,
   afunc->call_global_default = 0;
 
   iupTableSet(ic->attrib_func, name, (void*)afunc, IUPTABLE_POINTER);
+  iClassSetAtomFunc(ic, name, afunc);
 }
 
 void iupClassRegisterAttributeId2(Iclass* ic, const char* name, 
@@ -580,6 +645,7 @@ void iupClassRegisterAttributeId2(Iclass* ic, const char* name,
   afunc->call_global_default = 0;
 
   iupTableSet(ic->attrib_func, name, (void*)afunc, IUPTABLE_POINTER);
+  iClassSetAtomFunc(ic, name, afunc);
 }
 
 void iupClassRegisterGetAttribute(Iclass* ic, const char* name, 
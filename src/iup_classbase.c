@@ -572,6 +572,7 @@ void iupBaseRegisterCommonCallbacks(Iclass* ic)
   iupClassRegisterCallback(ic, "LEAVEWINDOW_CB", "");
   iupClassRegisterCallback(ic, "HELP_CB", "");
   iupClassRegisterCallback(ic, "POSTMESSAGE_CB", "");
+  iupClassRegisterCallback(ic, "POSTMESSAGEBATCH_CB", "");
   iupClassRegisterCallback(ic, "K_ANY", "i");
 }
 
@@ -17,6 +17,7 @@
 #include "iup_drv.h"
 #include "iup_drvfont.h"
 #include "iup_drvinfo.h"
+#include "iup_image.h"
 #include "iup_assert.h"
 #include "iup_str.h"
 #include "iup_strmessage.h"
@@ -141,6 +142,13 @@ static void iGlobalSet(const char *name, const char *value, int store)
     return;
   }
 
+  if (iupStrEqual(name, "IMAGECACHEMAXSIZE"))
+  {
+    iGlobalTableSet(name, value, store);
+    iupImageCacheSetMaxSize(value);
+    return;
+  }
+
   if (iGlobalChangingDefaultColor(name) || 
       iupdrvSetGlobal(name, value))
     iGlobalTableSet(name, value, store);
@@ -225,6 +233,12 @@ char* IupGetGlobal(const char *name)
     return iupdrvLocaleInfo();
   if (iupStrEqual(name, "SCROLLBARSIZE"))
     return iupStrReturnInt(iupdrvGetScrollbarSize());
+  if (iupStrEqualPartial(name, "IMAGECACHE"))
+  {
+    value = iupImageCacheGetGlobal(name);
+    if (value)
+      return value;
+  }
 
   value = iupdrvGetGlobal(name);
 
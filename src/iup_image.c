@@ -20,64 +20,6 @@
 #include "iup_drvinfo.h"
 
 
-static void iDataResize(int src_width, int src_height, unsigned char *src_map, int dst_width, int dst_height, unsigned char *dst_map, int depth)
-{
-  /* Do bilinear interpolation */
-
-  unsigned char *line_mapl, *line_maph;
-  double t, u, src_x, src_y, factor;
-  int xl, yl, xh, yh, x, y;
-  unsigned char *fhh, *fll, *fhl, *flh;
-
-  int *XL = (int*)malloc(dst_width * sizeof(int));
-  double *T = (double*)malloc(dst_width * sizeof(double));
-
-  factor = (double)src_width / (double)dst_width;
-  for (x = 0; x < dst_width; x++)
-  {
-    src_x = x * factor;
-    xl = (int)(src_x);
-    T[x] = src_x - xl;
-    XL[x] = xl;
-  }
-
-  factor = (double)src_height / (double)dst_height;
-
-  for (y = 0; y < dst_height; y++)
-  {
-    src_y = y * factor;
-    yl = (int)(src_y);
-    yh = (yl == src_height - 1) ? yl : yl + 1;
-    u = src_y - yl;
-
-    line_mapl = src_map + yl * src_width * depth;
-    line_maph = src_map + yh * src_width * depth;
-
-    for (x = 0; x < dst_width; x++)
-    {
-      xl = XL[x];
-      xh = (xl == src_width - 1) ? xl : xl + 1;
-      t = T[x];
-
-      fll = line_mapl + xl * depth;
-      fhl = line_mapl + xh * depth;
-      flh = line_maph + xl * depth;
-      fhh = line_maph + xh * depth;
-
-      dst_map[0] = (unsigned char)(u * t * (fhh[0] - flh[0] - fhl[0] + fll[0]) + t * (fhl[0] - fll[0]) + u * (flh[0] - fll[0]) + fll[0]);
-      dst_map[1] = (unsigned char)(u * t * (fhh[1] - flh[1] - fhl[1] + fll[1]) + t * (fhl[1] - fll[1]) + u * (flh[1] - fll[1]) + fll[1]);
-      dst_map[2] = (unsigned char)(u * t * (fhh[2] - flh[2] - fhl[2] + fll[2]) + t * (fhl[2] - fll[2]) + u * (flh[2] - fll[2]) + fll[2]);
-      if (depth == 4)
-        dst_map[3] = (unsigned char)(u * t * (fhh[3] - flh[3] - fhl[3] + fll[3]) + t * (fhl[3] - fll[3]) + u * (flh[3] - fll[3]) + fll[3]);
-
-      dst_map += depth;
-    }
-  }
-
-  free(XL);
-  free(T);
-}
-
 static void iImageResize(Ihandle* ih, int width, int height)
 {
   unsigned char* imgdata = (unsigned char*)iupAttribGet(ih, "WID");
@@ -85,7 +27,7 @@ static void iImageResize(Ihandle* ih, int width, int height)
   int count = width*height*channels;
   unsigned char* new_imgdata = (unsigned char *)malloc(count);
 
-  iDataResize(ih->currentwidth, ih->currentheight, imgdata, width, height, new_imgdata, channels);
+  iupImageConvResize(ih->currentwidth, ih->currentheight, imgdata, width, height, new_imgdata, channels);
 
   ih->currentwidth = width;
   ih->currentheight = height;
@@ -495,7 +437,7 @@ void* iupImageGetMask(const char* name)
     return NULL;
   
   /* Check for an already created icon */
-  mask = iupAttribGet(ih, "_IUPIMAGE_MASK");
+  mask = iupImageCacheGet(ih, IUPIMAGE_MASK, NULL, 0, 0);
   if (mask)
     return mask;
 
@@ -503,7 +445,7 @@ void* iupImageGetMask(const char* name)
   mask = iupdrvImageCreateMask(ih);
 
   /* save the mask */
-  iupAttribSet(ih, "_IUPIMAGE_MASK", (char*)mask);
+  iupImageCacheSet(ih, IUPIMAGE_MASK, NULL, 0, 0, mask);
 
   return mask;
 }
@@ -539,7 +481,7 @@ void* iupImageGetIcon(const char* name)
   }
   
   /* Check for an already created icon */
-  icon = iupAttribGet(ih, "_IUPIMAGE_ICON");
+  icon = iupImageCacheGet(ih, IUPIMAGE_ICON, NULL, 0, 0);
   if (icon)
     return icon;
 
@@ -547,7 +489,7 @@ void* iupImageGetIcon(const char* name)
   icon = iupdrvImageCreateIcon(ih);
 
   /* save the icon */
-  iupAttribSet(ih, "_IUPIMAGE_ICON", (char*)icon);
+  iupImageCacheSet(ih, IUPIMAGE_ICON, NULL, 0, 0, icon);
 
   return icon;
 }
@@ -572,7 +514,7 @@ void* iupImageGetCursor(const char* name)
   }
   
   /* Check for an already created cursor */
-  cursor = iupAttribGet(ih, "_IUPIMAGE_CURSOR");
+  cursor = iupImageCacheGet(ih, IUPIMAGE_CURSOR, NULL, 0, 0);
   if (cursor)
     return cursor;
 
@@ -580,18 +522,16 @@ void* iupImageGetCursor(const char* name)
   cursor = iupdrvImageCreateCursor(ih);
 
   /* save the cursor */
-  iupAttribSet(ih, "_IUPIMAGE_CURSOR", (char*)cursor);
+  iupImageCacheSet(ih, IUPIMAGE_CURSOR, NULL, 0, 0, cursor);
 
   return cursor;
 }
 
-void* iupImageGetImage(const char* name, Ihandle* ih_parent, int make_inactive)
+static void* iImageGetImage(const char* name, Ihandle* ih_parent, int make_inactive, int for_draw)
 {
-  char cache_name[100] = "_IUPIMAGE_IMAGE";
   char* bgcolor;
   void* handle;
   Ihandle *ih;
-  int bg_concat = 0;
 
   if (!name)
     return NULL;
@@ -633,19 +573,8 @@ void* iupImageGetImage(const char* name, Ihandle* ih_parent, int make_inactive)
   if (ih_parent && !bgcolor)
     bgcolor = IupGetAttribute(ih_parent, "BGCOLOR"); /* Use IupGetAttribute to use inheritance and native implementation */
 
-  if (make_inactive)
-    strcat(cache_name, "_INACTIVE");
-
-  if (iupAttribGet(ih, "_IUP_BGCOLOR_DEPEND") && bgcolor)
-  {
-    strcat(cache_name, "(");
-    strcat(cache_name, bgcolor);
-    strcat(cache_name, ")");
-    bg_concat = 1;
-  }
-  
   /* Check for an already created native image */
-  handle = (void*)iupAttribGet(ih, cache_name);
+  handle = iupImageCacheGet(ih, IUPIMAGE_IMAGE, iupAttribGet(ih, "_IUP_BGCOLOR_DEPEND") ? bgcolor : NULL, make_inactive, for_draw);
   if (handle)
     return handle;
 
@@ -658,19 +587,22 @@ void* iupImageGetImage(const char* name, Ihandle* ih_parent, int make_inactive)
   if (ih_parent && iupAttribGetStr(ih_parent, "FLAT_ALPHA"))
     iupAttribSet(ih, "FLAT_ALPHA", NULL);
 
-  if (iupAttribGet(ih, "_IUP_BGCOLOR_DEPEND") && bgcolor && !bg_concat)  /* _IUP_BGCOLOR_DEPEND could be set during creation */
-  {
-    strcat(cache_name, "(");
-    strcat(cache_name, bgcolor);
-    strcat(cache_name, ")");
-  }
-
-  /* save the native image in the cache */
-  iupAttribSet(ih, cache_name, (char*)handle);
+  /* save the native image in the cache, _IUP_BGCOLOR_DEPEND could be set during creation */
+  iupImageCacheSet(ih, IUPIMAGE_IMAGE, iupAttribGet(ih, "_IUP_BGCOLOR_DEPEND") ? bgcolor : NULL, make_inactive, for_draw, handle);
 
   return handle;
 }
 
+void* iupImageGetImage(const char* name, Ihandle* ih_parent, int make_inactive)
+{
+  return iImageGetImage(name, ih_parent, make_inactive, 0);
+}
+
+void* iupImageGetImageForDraw(const char* name, Ihandle* ih_parent, int make_inactive)
+{
+  return iImageGetImage(name, ih_parent, make_inactive, 1);
+}
+
 void iupImageGetInfo(const char* name, int *w, int *h, int *bpp)
 {
   void* handle;
@@ -806,68 +738,15 @@ Ihandle* iupImageGetHandle(const char* name)
 
 void iupImageRemoveFromCache(Ihandle* ih, void* handle)
 {
-  char *name;
-  void* cur_handle;
-
-  name = iupTableFirst(ih->attrib);
-  while (name)
-  {
-    if (iupStrEqualPartial(name, "_IUPIMAGE_"))
-    {
-      cur_handle = iupTableGetCurr(ih->attrib);
-      if (cur_handle == handle)
-      {
-        iupTableRemoveCurr(ih->attrib);
-        return;
-      }
-    }
-
-    name = iupTableNext(ih->attrib);
-  }
+  iupImageCacheRemove(ih, handle);
 }
 
 static void iImageClearCache(Ihandle* ih)
 {
-  char *name;
   void* handle;
 
-  handle = iupAttribGet(ih, "_IUPIMAGE_MASK");
-  if (handle)
-  {
-    iupdrvImageDestroy(handle, IUPIMAGE_IMAGE);
-    iupAttribSet(ih, "_IUPIMAGE_MASK", NULL);
-  }
-
-  handle = iupAttribGet(ih, "_IUPIMAGE_ICON");
-  if (handle)
-  {
-    iupdrvImageDestroy(handle, IUPIMAGE_ICON);
-    iupAttribSet(ih, "_IUPIMAGE_ICON", NULL);
-  }
-
-  handle = iupAttribGet(ih, "_IUPIMAGE_CURSOR");
-  if (handle)
-  {
-    iupdrvImageDestroy(handle, IUPIMAGE_CURSOR);
-    iupAttribSet(ih, "_IUPIMAGE_CURSOR", NULL);
-  }
-
-  /* the remaining native images are all IUPIMAGE_IMAGE(*) - depends on BGCOLOR/INACTIVE/etc  */
-  name = iupTableFirst(ih->attrib);
-  while (name)
-  {
-    if (iupStrEqualPartial(name, "_IUPIMAGE_IMAGE"))
-    {
-      handle = iupTableGetCurr(ih->attrib);
-      if (handle)
-      {
-        iupdrvImageDestroy(handle, IUPIMAGE_IMAGE);
-        iupTableSetCurr(ih->attrib, NULL, IUPTABLE_POINTER);
-      }
-    }
-
-    name = iupTableNext(ih->attrib);
-  }
+  /* all native images, icons, cursors and masks created from this image */
+  iupImageCacheClear(ih);
 
   handle = iupAttribGet(ih, "_IUPIMAGE_LOADED_HANDLE");
   if (handle)
@@ -18,7 +18,7 @@ void* iupdrvImageCreateIcon(Ihandle *ih);
 void* iupdrvImageCreateCursor(Ihandle *ih);
 void* iupdrvImageCreateImage(Ihandle *ih, const char* bgcolor, int make_inactive);
 
-enum {IUPIMAGE_IMAGE, IUPIMAGE_ICON, IUPIMAGE_CURSOR};
+enum {IUPIMAGE_IMAGE, IUPIMAGE_ICON, IUPIMAGE_CURSOR, IUPIMAGE_MASK};  /* IUPIMAGE_MASK only for the image cache */
 void* iupdrvImageLoad(const char* name, int type);
 void  iupdrvImageDestroy(void* handle, int type);
 int   iupdrvImageGetInfo(void* handle, int *w, int *h, int *bpp);  /* only for IUPIMAGE_IMAGE */
@@ -28,6 +28,7 @@ void* iupImageGetMask(const char* name);
 void* iupImageGetIcon(const char* name);
 void* iupImageGetCursor(const char* name);
 void* iupImageGetImage(const char* name, Ihandle* parent, int make_inactive);
+void* iupImageGetImageForDraw(const char* name, Ihandle* parent, int make_inactive);  /* handle used only while drawing, can be evicted from the cache later */
 void iupImageGetInfo(const char* name, int *w, int *h, int *bpp);
 void iupImageRemoveFromCache(Ihandle* ih, void* handle);
 
@@ -43,6 +44,15 @@ IUP_EXPORTI void iupImageColorMakeInactive(unsigned char *r, unsigned char *g, u
                                unsigned char bg_r, unsigned char bg_g, unsigned char bg_b);
 int iupImageNormBpp(int bpp);
 
+/* Pixel conversion kernels, see iup_imageconv.c.
+   count is in pixels. RGBA data is 4 bytes per pixel in R,G,B,A order. */
+void iupImageConvResize(int src_width, int src_height, const unsigned char *src_map, int dst_width, int dst_height, unsigned char *dst_map, int depth);
+void iupImageConvPalette(const unsigned char* index, int count, const iupColor* colors, unsigned char* dst, int dst_channels);
+void iupImageConvBlendBgColor(unsigned char* rgba, int count, unsigned char bg_r, unsigned char bg_g, unsigned char bg_b, int flat_alpha);
+void iupImageConvPremultiply(unsigned char* rgba, int count);
+void iupImageConvSwapRB(unsigned char* data, int count, int channels);
+void iupImageConvMakeInactive(unsigned char* data, int count, int channels, unsigned char bg_r, unsigned char bg_g, unsigned char bg_b);
+
 #define iupALPHABLEND(_src,_dst,_alpha) (unsigned char)(((_src) * (_alpha) + (_dst) * (255 - (_alpha))) / 255)
 
 /* In Windows, RAW data is a DIB handle. 
@@ -52,6 +62,17 @@ void* iupdrvImageCreateImageRaw(int width, int height, int bpp, iupColor* colors
 int iupdrvImageGetRawInfo(void* handle, int *w, int *h, int *bpp, iupColor* colors, int *colors_count);
 void iupdrvImageGetRawData(void* handle, unsigned char* imgdata);
 
+/* Process-wide cache of the native handles created from IupImage handles, see iup_imagecache.c.
+   bgcolor is NULL when the native handle does not depend on the background color. */
+void iupImageCacheInit(void);
+void iupImageCacheFinish(void);
+void* iupImageCacheGet(Ihandle* ih, int type, const char* bgcolor, int make_inactive, int for_draw);
+void iupImageCacheSet(Ihandle* ih, int type, const char* bgcolor, int make_inactive, int for_draw, void* handle);
+void iupImageCacheRemove(Ihandle* ih, void* handle);
+void iupImageCacheClear(Ihandle* ih);
+void iupImageCacheSetMaxSize(const char* value);
+char* iupImageCacheGetGlobal(const char* name);
+
 void iupImageStockInit(void);
 void iupImageStockFinish(void);
 typedef Ihandle* (*iupImageStockCreateFunc)(void);
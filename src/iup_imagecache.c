@@ -0,0 +1,298 @@
+/** \file
+ * \brief Native Image Cache.
+ *
+ * All native images, icons, cursors and masks created from IupImage handles
+ * are kept here, instead of in the attribute table of each image.
+ *
+ * See Copyright Notice in "iup.h"
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <memory.h>
+
+#include "iup.h"
+
+#include "iup_object.h"
+#include "iup_str.h"
+#include "iup_table.h"
+#include "iup_image.h"
+
+
+/* Entries created for drawing only (iupImageGetImageForDraw) are released by the callers
+   right after drawing, so they are kept in a LRU list and can be evicted.
+   Entries returned to the controls are retained until the image is destroyed,
+   because the controls store the native handle. */
+typedef struct _IimageCacheEntry
+{
+  char key[80];
+  Ihandle* ih;
+  void* handle;
+  int type;     /* IUPIMAGE_IMAGE, IUPIMAGE_ICON, IUPIMAGE_CURSOR or IUPIMAGE_MASK */
+  int size;     /* estimated memory size in bytes */
+  int retained;
+  struct _IimageCacheEntry *lru_prev, *lru_next;  /* not retained only, most recent first */
+  struct _IimageCacheEntry *ih_next;  /* all entries of the same image */
+} IimageCacheEntry;
+
+static Itable *iimagecache_table = NULL;  /* key -> IimageCacheEntry */
+static Itable *iimagecache_owner_table = NULL;  /* Ihandle* -> first IimageCacheEntry of the image */
+static IimageCacheEntry *iimagecache_lru_first = NULL, *iimagecache_lru_last = NULL;
+static int iimagecache_hits = 0, iimagecache_misses = 0, iimagecache_evictions = 0, iimagecache_count = 0;
+static double iimagecache_size = 0;
+static double iimagecache_lru_size = 0;  /* only the entries that can be evicted */
+
+#define IIMAGECACHE_DEFAULT_MAXSIZE (16*1024*1024)
+static double iimagecache_max_size = IIMAGECACHE_DEFAULT_MAXSIZE;  /* IMAGECACHEMAXSIZE, parsed when set */
+
+void iupImageCacheInit(void)
+{
+  iimagecache_table = iupTableCreate(IUPTABLE_STRINGINDEXED);
+  iimagecache_owner_table = iupTableCreate(IUPTABLE_POINTERINDEXED);
+}
+
+void iupImageCacheFinish(void)
+{
+  /* all images were already destroyed, so here there are only entries that the drivers failed to release */
+  char* key = iupTableFirst(iimagecache_table);
+  while (key)
+  {
+    free(iupTableGetCurr(iimagecache_table));
+    key = iupTableNext(iimagecache_table);
+  }
+
+  iupTableDestroy(iimagecache_table);
+  iimagecache_table = NULL;
+  iupTableDestroy(iimagecache_owner_table);
+  iimagecache_owner_table = NULL;
+
+  iimagecache_lru_first = NULL;
+  iimagecache_lru_last = NULL;
+  iimagecache_count = 0;
+  iimagecache_size = 0;
+  iimagecache_lru_size = 0;
+}
+
+static void iImageCacheGetKey(char* key, Ihandle* ih, int type, const char* bgcolor, int make_inactive)
+{
+  unsigned char r, g, b;
+
+  /* the image size is part of the key, so images scaled by AUTOSCALE or RESIZE get a new entry */
+  if (bgcolor && iupStrToRGB(bgcolor, &r, &g, &b))
+    sprintf(key, "%p:%d:%d:%dx%d:%d %d %d", (void*)ih, type, make_inactive, ih->currentwidth, ih->currentheight, (int)r, (int)g, (int)b);
+  else
+    sprintf(key, "%p:%d:%d:%dx%d", (void*)ih, type, make_inactive, ih->currentwidth, ih->currentheight);
+}
+
+static void iImageCacheLruRemove(IimageCacheEntry* entry)
+{
+  if (entry->lru_prev)
+    entry->lru_prev->lru_next = entry->lru_next;
+  else
+    iimagecache_lru_first = entry->lru_next;
+
+  if (entry->lru_next)
+    entry->lru_next->lru_prev = entry->lru_prev;
+  else
+    iimagecache_lru_last = entry->lru_prev;
+
+  entry->lru_prev = NULL;
+  entry->lru_next = NULL;
+
+  iimagecache_lru_size -= entry->size;
+}
+
+static void iImageCacheLruAddFirst(IimageCacheEntry* entry)
+{
+  entry->lru_prev = NULL;
+  entry->lru_next = iimagecache_lru_first;
+
+  if (iimagecache_lru_first)
+    iimagecache_lru_first->lru_prev = entry;
+  else
+    iimagecache_lru_last = entry;
+
+  iimagecache_lru_first = entry;
+
+  iimagecache_lru_size += entry->size;
+}
+
+/* removes the entry from the tables and the lists, but does not release it */
+static void iImageCacheUnlink(IimageCacheEntry* entry)
+{
+  IimageCacheEntry* first = (IimageCacheEntry*)iupTableGet(iimagecache_owner_table, (const char*)entry->ih);
+
+  if (first == entry)
+  {
+    if (entry->ih_next)
+      iupTableSet(iimagecache_owner_table, (const char*)entry->ih, entry->ih_next, IUPTABLE_POINTER);
+    else
+      iupTableRemove(iimagecache_owner_table, (const char*)entry->ih);
+  }
+  else
+  {
+    while (first && first->ih_next != entry)
+      first = first->ih_next;
+
+    if (first)
+      first->ih_next = entry->ih_next;
+  }
+
+  if (!entry->retained)
+    iImageCacheLruRemove(entry);
+
+  iupTableRemove(iimagecache_table, entry->key);
+
+  iimagecache_count--;
+  iimagecache_size -= entry->size;
+}
+
+static void iImageCacheRelease(IimageCacheEntry* entry)
+{
+  if (entry->handle)
+    iupdrvImageDestroy(entry->handle, entry->type == IUPIMAGE_MASK ? IUPIMAGE_IMAGE : entry->type);
+
+  free(entry);
+}
+
+static void iImageCacheTrim(void)
+{
+  /* retained entries can not be evicted, so they are not counted in the limit */
+  while (iimagecache_lru_size > iimagecache_max_size && iimagecache_lru_last)
+  {
+    IimageCacheEntry* entry = iimagecache_lru_last;
+    iImageCacheUnlink(entry);
+    iImageCacheRelease(entry);
+    iimagecache_evictions++;
+  }
+}
+
+void iupImageCacheSetMaxSize(const char* value)
+{
+  iimagecache_max_size = IIMAGECACHE_DEFAULT_MAXSIZE;
+  if (value)
+    iupStrToDouble(value, &iimagecache_max_size);
+
+  if (iimagecache_table)
+    iImageCacheTrim();
+}
+
+void* iupImageCacheGet(Ihandle* ih, int type, const char* bgcolor, int make_inactive, int for_draw)
+{
+  IimageCacheEntry* entry;
+  char key[80];
+
+  iImageCacheGetKey(key, ih, type, bgcolor, make_inactive);
+
+  entry = (IimageCacheEntry*)iupTableGet(iimagecache_table, key);
+  if (!entry)
+  {
+    iimagecache_misses++;
+    return NULL;
+  }
+
+  iimagecache_hits++;
+
+  if (!entry->retained)
+  {
+    iImageCacheLruRemove(entry);
+
+    if (for_draw)
+      iImageCacheLruAddFirst(entry);
+    else
+      entry->retained = 1;  /* now a control may store the handle */
+  }
+
+  return entry->handle;
+}
+
+void iupImageCacheSet(Ihandle* ih, int type, const char* bgcolor, int make_inactive, int for_draw, void* handle)
+{
+  IimageCacheEntry *entry, *old_entry;
+
+  if (!handle)
+    return;
+
+  entry = (IimageCacheEntry*)calloc(1, sizeof(IimageCacheEntry));
+  iImageCacheGetKey(entry->key, ih, type, bgcolor, make_inactive);
+  entry->ih = ih;
+  entry->handle = handle;
+  entry->type = type;
+  entry->size = ih->currentwidth * ih->currentheight * 4;
+  entry->retained = !for_draw;
+
+  old_entry = (IimageCacheEntry*)iupTableGet(iimagecache_table, entry->key);
+  if (old_entry)
+  {
+    iImageCacheUnlink(old_entry);
+
+    /* a retained handle can not be released, it could be in use by a control,
+       draw only handles are not used after drawing */
+    if (old_entry->retained || old_entry->handle == handle)
+      free(old_entry);
+    else
+      iImageCacheRelease(old_entry);
+  }
+
+  entry->ih_next = (IimageCacheEntry*)iupTableGet(iimagecache_owner_table, (const char*)ih);
+  iupTableSet(iimagecache_owner_table, (const char*)ih, entry, IUPTABLE_POINTER);
+  iupTableSet(iimagecache_table, entry->key, entry, IUPTABLE_POINTER);
+
+  iimagecache_count++;
+  iimagecache_size += entry->size;
+
+  /* trim before adding the new entry to the LRU list, it is going to be used right away */
+  iImageCacheTrim();
+
+  if (!entry->retained)
+    iImageCacheLruAddFirst(entry);
+}
+
+void iupImageCacheRemove(Ihandle* ih, void* handle)
+{
+  IimageCacheEntry* entry = (IimageCacheEntry*)iupTableGet(iimagecache_owner_table, (const char*)ih);
+  while (entry)
+  {
+    if (entry->handle == handle)
+    {
+      iImageCacheUnlink(entry);
+      free(entry);
+      return;
+    }
+
+    entry = entry->ih_next;
+  }
+}
+
+void iupImageCacheClear(Ihandle* ih)
+{
+  IimageCacheEntry* entry;
+
+  if (!iimagecache_owner_table)
+    return;
+
+  entry = (IimageCacheEntry*)iupTableGet(iimagecache_owner_table, (const char*)ih);
+  while (entry)
+  {
+    IimageCacheEntry* next = entry->ih_next;
+    iImageCacheUnlink(entry);
+    iImageCacheRelease(entry);
+    entry = next;
+  }
+}
+
+char* iupImageCacheGetGlobal(const char* name)
+{
+  if (iupStrEqual(name, "IMAGECACHEHITS"))
+    return iupStrReturnInt(iimagecache_hits);
+  if (iupStrEqual(name, "IMAGECACHEMISSES"))
+    return iupStrReturnInt(iimagecache_misses);
+  if (iupStrEqual(name, "IMAGECACHEEVICTIONS"))
+    return iupStrReturnInt(iimagecache_evictions);
+  if (iupStrEqual(name, "IMAGECACHECOUNT"))
+    return iupStrReturnInt(iimagecache_count);
+  if (iupStrEqual(name, "IMAGECACHESIZE"))
+    return iupStrReturnStrf("%.0f", iimagecache_size);
+  return NULL;
+}
@@ -0,0 +1,636 @@
+/** \file
+ * \brief Image pixel conversion kernels (resize, palette, alpha, inactive).
+ *
+ * Each kernel has a scalar loop that is also used for the tail of the vectorized loops.
+ * SSE2 (always available in x64) or NEON code is selected at compile time.
+ * AVX2 code is compiled only for the functions that use it, and selected at run time,
+ * so it is used even when the library is built for the baseline x86 instruction set.
+ *
+ * See Copyright Notice in "iup.h"
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <memory.h>
+
+#include "iup.h"
+
+#include "iup_object.h"
+#include "iup_image.h"
+
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IIMAGE_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define IIMAGE_NEON
+#endif
+
+#if defined(IIMAGE_SSE2) && defined(_MSC_VER) && _MSC_VER >= 1700
+#include <immintrin.h>
+#include <intrin.h>
+#define IIMAGE_AVX2
+#define IIMAGE_AVX2_FUNC
+#elif defined(IIMAGE_SSE2) && (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#include <immintrin.h>
+#define IIMAGE_AVX2
+#define IIMAGE_AVX2_FUNC __attribute__((target("avx2")))
+#endif
+
+/* x/255 for x in [0, 255*255], exact */
+#define iDIV255(_x) (((_x) + 1 + ((_x) >> 8)) >> 8)
+
+/* bilinear weights have 7 bits, so 16 bits intermediate values are never negative when signed */
+#define IIMAGE_WBITS 7
+#define IIMAGE_WONE (1 << IIMAGE_WBITS)
+
+
+#ifdef IIMAGE_AVX2
+static int iimage_has_avx2 = -1;  /* concurrent first calls will store the same value */
+
+static int iImageHasAVX2(void)
+{
+  if (iimage_has_avx2 < 0)
+  {
+#if defined(__AVX2__)
+    iimage_has_avx2 = 1;
+#elif defined(_MSC_VER)
+    int info[4];
+    iimage_has_avx2 = 0;
+    __cpuid(info, 0);
+    if (info[0] >= 7)
+    {
+      __cpuid(info, 1);
+      /* OSXSAVE and AVX, then check if the OS saves the YMM registers */
+      if ((info[2] & (3 << 27)) == (3 << 27) && (_xgetbv(0) & 6) == 6)
+      {
+        __cpuidex(info, 7, 0);
+        iimage_has_avx2 = (info[1] & (1 << 5)) != 0;
+      }
+    }
+#else
+    __builtin_cpu_init();
+    iimage_has_avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+  }
+
+  return iimage_has_avx2;
+}
+#endif
+
+
+/**************************************************************************************************/
+/* Resize                                                                                         */
+/**************************************************************************************************/
+
+
+#ifdef IIMAGE_AVX2
+/* returns the number of processed bytes */
+static IIMAGE_AVX2_FUNC int iImageLerpRowsAVX2(const unsigned char* l, const unsigned char* h, unsigned short* tmp, int n, int u)
+{
+  int i = 0;
+  __m256i wl = _mm256_set1_epi16((short)(IIMAGE_WONE - u)),
+          wh = _mm256_set1_epi16((short)u);
+  for (; i + 16 <= n; i += 16)
+  {
+    __m256i a = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(l + i)));
+    __m256i b = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(h + i)));
+    __m256i s = _mm256_add_epi16(_mm256_mullo_epi16(a, wl), _mm256_mullo_epi16(b, wh));
+    _mm256_storeu_si256((__m256i*)(tmp + i), s);
+  }
+  return i;
+}
+#endif
+
+/* tmp = l*(1-u) + h*u, with the result scaled by IIMAGE_WONE */
+static void iImageLerpRows(const unsigned char* l, const unsigned char* h, unsigned short* tmp, int n, int u)
+{
+  int i = 0;
+
+#ifdef IIMAGE_AVX2
+  if (iImageHasAVX2())
+    i = iImageLerpRowsAVX2(l, h, tmp, n, u);
+#endif
+
+#if defined(IIMAGE_SSE2)
+  {
+    __m128i zero = _mm_setzero_si128(),
+            wl = _mm_set1_epi16((short)(IIMAGE_WONE - u)),
+            wh = _mm_set1_epi16((short)u);
+    for (; i + 16 <= n; i += 16)
+    {
+      __m128i a = _mm_loadu_si128((const __m128i*)(l + i));
+      __m128i b = _mm_loadu_si128((const __m128i*)(h + i));
+      __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), wl),
+                                 _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), wh));
+      __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), wl),
+                                 _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), wh));
+      _mm_storeu_si128((__m128i*)(tmp + i), lo);
+      _mm_storeu_si128((__m128i*)(tmp + i + 8), hi);
+    }
+  }
+#elif defined(IIMAGE_NEON)
+  {
+    uint8x8_t wl = vdup_n_u8((uint8_t)(IIMAGE_WONE - u)),
+              wh = vdup_n_u8((uint8_t)u);
+    for (; i + 8 <= n; i += 8)
+    {
+      uint16x8_t s = vmull_u8(vld1_u8(l + i), wl);
+      s = vmlal_u8(s, vld1_u8(h + i), wh);
+      vst1q_u16(tmp + i, s);
+    }
+  }
+#endif
+
+  for (; i < n; i++)
+    tmp[i] = (unsigned short)(l[i] * (IIMAGE_WONE - u) + h[i] * u);
+}
+
+static void iImageLerpColumns(const unsigned short* tmp, unsigned char* dst, int dst_width, int depth, const int* XL, const int* XH, const int* T)
+{
+  int x, c;
+
+  if (depth == 4)
+  {
+#if defined(IIMAGE_SSE2)
+    for (x = 0; x < dst_width; x++)
+    {
+      int t = T[x];
+      __m128i a = _mm_loadl_epi64((const __m128i*)(tmp + XL[x] * 4));
+      __m128i b = _mm_loadl_epi64((const __m128i*)(tmp + XH[x] * 4));
+      __m128i w = _mm_set1_epi32((t << 16) | (IIMAGE_WONE - t));
+      __m128i s = _mm_srli_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(a, b), w), 2 * IIMAGE_WBITS);
+      int p;
+      s = _mm_packs_epi32(s, s);
+      s = _mm_packus_epi16(s, s);
+      p = _mm_cvtsi128_si32(s);
+      memcpy(dst, &p, 4);
+      dst += 4;
+    }
+    return;
+#elif defined(IIMAGE_NEON)
+    for (x = 0; x < dst_width; x++)
+    {
+      int t = T[x];
+      uint32x4_t s = vmull_n_u16(vld1_u16(tmp + XL[x] * 4), (uint16_t)(IIMAGE_WONE - t));
+      uint16x4_t r;
+      s = vmlal_n_u16(s, vld1_u16(tmp + XH[x] * 4), (uint16_t)t);
+      r = vshrn_n_u32(s, 2 * IIMAGE_WBITS);
+      vst1_lane_u32((uint32_t*)dst, vreinterpret_u32_u8(vmovn_u16(vcombine_u16(r, r))), 0);
+      dst += 4;
+    }
+    return;
+#endif
+  }
+
+  for (x = 0; x < dst_width; x++)
+  {
+    const unsigned short *fl = tmp + XL[x] * depth,
+                         *fh = tmp + XH[x] * depth;
+    int t = T[x];
+
+    for (c = 0; c < depth; c++)
+      dst[c] = (unsigned char)((fl[c] * (IIMAGE_WONE - t) + fh[c] * t) >> (2 * IIMAGE_WBITS));
+
+    dst += depth;
+  }
+}
+
+static void iImageResizeBilinear(int src_width, int src_height, const unsigned char *src_map, int dst_width, int dst_height, unsigned char *dst_map, int depth)
+{
+  int x, y, line_size = src_width * depth;
+  double factor;
+
+  int *XL = (int*)malloc(3 * dst_width * sizeof(int));
+  int *XH = XL + dst_width;
+  int *T = XH + dst_width;
+  unsigned short *tmp = (unsigned short*)malloc(line_size * sizeof(unsigned short));
+
+  factor = (double)src_width / (double)dst_width;
+  for (x = 0; x < dst_width; x++)
+  {
+    double src_x = x * factor;
+    int xl = (int)(src_x);
+    XL[x] = xl;
+    XH[x] = (xl == src_width - 1) ? xl : xl + 1;
+    T[x] = (int)((src_x - xl) * IIMAGE_WONE);
+  }
+
+  factor = (double)src_height / (double)dst_height;
+
+  for (y = 0; y < dst_height; y++)
+  {
+    double src_y = y * factor;
+    int yl = (int)(src_y);
+    int yh = (yl == src_height - 1) ? yl : yl + 1;
+    int u = (int)((src_y - yl) * IIMAGE_WONE);
+
+    iImageLerpRows(src_map + yl * line_size, src_map + yh * line_size, tmp, line_size, u);
+    iImageLerpColumns(tmp, dst_map, dst_width, depth, XL, XH, T);
+
+    dst_map += dst_width * depth;
+  }
+
+  free(XL);
+  free(tmp);
+}
+
+/* sum += line, as 32 bits integers */
+static void iImageAccumRow(const unsigned char* line, unsigned int* sum, int n)
+{
+  int i = 0;
+
+#if defined(IIMAGE_SSE2)
+  {
+    __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16)
+    {
+      __m128i a = _mm_loadu_si128((const __m128i*)(line + i));
+      __m128i lo = _mm_unpacklo_epi8(a, zero),
+              hi = _mm_unpackhi_epi8(a, zero);
+      __m128i* s = (__m128i*)(sum + i);
+      _mm_storeu_si128(s + 0, _mm_add_epi32(_mm_loadu_si128(s + 0), _mm_unpacklo_epi16(lo, zero)));
+      _mm_storeu_si128(s + 1, _mm_add_epi32(_mm_loadu_si128(s + 1), _mm_unpackhi_epi16(lo, zero)));
+      _mm_storeu_si128(s + 2, _mm_add_epi32(_mm_loadu_si128(s + 2), _mm_unpacklo_epi16(hi, zero)));
+      _mm_storeu_si128(s + 3, _mm_add_epi32(_mm_loadu_si128(s + 3), _mm_unpackhi_epi16(hi, zero)));
+    }
+  }
+#elif defined(IIMAGE_NEON)
+  for (; i + 8 <= n; i += 8)
+  {
+    uint16x8_t a = vmovl_u8(vld1_u8(line + i));
+    vst1q_u32(sum + i, vaddw_u16(vld1q_u32(sum + i), vget_low_u16(a)));
+    vst1q_u32(sum + i + 4, vaddw_u16(vld1q_u32(sum + i + 4), vget_high_u16(a)));
+  }
+#endif
+
+  for (; i < n; i++)
+    sum[i] += line[i];
+}
+
+/* area average, used when both dimensions are reduced */
+static void iImageResizeBox(int src_width, int src_height, const unsigned char *src_map, int dst_width, int dst_height, unsigned char *dst_map, int depth)
+{
+  int x, y, c, line_size = src_width * depth;
+  int *X0 = (int*)malloc((dst_width + 1) * sizeof(int));
+  unsigned int *sum = (unsigned int*)malloc(line_size * sizeof(unsigned int));
+
+  for (x = 0; x <= dst_width; x++)
+    X0[x] = (int)(((double)x * src_width) / dst_width);
+
+  for (y = 0; y < dst_height; y++)
+  {
+    int y0 = (int)(((double)y * src_height) / dst_height),
+        y1 = (int)(((double)(y + 1) * src_height) / dst_height),
+        sy;
+
+    memset(sum, 0, line_size * sizeof(unsigned int));
+    for (sy = y0; sy < y1; sy++)
+      iImageAccumRow(src_map + sy * line_size, sum, line_size);
+
+    for (x = 0; x < dst_width; x++)
+    {
+      int x0 = X0[x], x1 = X0[x + 1];
+      unsigned int area = (unsigned int)((x1 - x0) * (y1 - y0));
+
+#if defined(IIMAGE_SSE2)
+      if (depth == 4)
+      {
+        /* the 4 channels of a pixel are summed at once */
+        unsigned int s[4];
+        __m128i vs = _mm_setzero_si128();
+        int sx;
+        for (sx = x0; sx < x1; sx++)
+          vs = _mm_add_epi32(vs, _mm_loadu_si128((const __m128i*)(sum + sx * 4)));
+        _mm_storeu_si128((__m128i*)s, vs);
+
+        for (c = 0; c < 4; c++)
+          dst_map[c] = (unsigned char)((s[c] + area / 2) / area);
+
+        dst_map += 4;
+        continue;
+      }
+#elif defined(IIMAGE_NEON)
+      if (depth == 4)
+      {
+        unsigned int s[4];
+        uint32x4_t vs = vdupq_n_u32(0);
+        int sx;
+        for (sx = x0; sx < x1; sx++)
+          vs = vaddq_u32(vs, vld1q_u32(sum + sx * 4));
+        vst1q_u32(s, vs);
+
+        for (c = 0; c < 4; c++)
+          dst_map[c] = (unsigned char)((s[c] + area / 2) / area);
+
+        dst_map += 4;
+        continue;
+      }
+#endif
+
+      for (c = 0; c < depth; c++)
+      {
+        unsigned int s = 0;
+        int sx;
+        for (sx = x0; sx < x1; sx++)
+          s += sum[sx * depth + c];
+
+        dst_map[c] = (unsigned char)((s + area / 2) / area);
+      }
+
+      dst_map += depth;
+    }
+  }
+
+  free(X0);
+  free(sum);
+}
+
+void iupImageConvResize(int src_width, int src_height, const unsigned char *src_map, int dst_width, int dst_height, unsigned char *dst_map, int depth)
+{
+  if (dst_width < src_width && dst_height < src_height)
+    iImageResizeBox(src_width, src_height, src_map, dst_width, dst_height, dst_map, depth);
+  else
+    iImageResizeBilinear(src_width, src_height, src_map, dst_width, dst_height, dst_map, depth);
+}
+
+
+/**************************************************************************************************/
+/* Color conversion                                                                               */
+/**************************************************************************************************/
+
+
+#ifdef IIMAGE_AVX2
+/* returns the number of processed pixels */
+static IIMAGE_AVX2_FUNC int iImagePaletteAVX2(const unsigned char* index, int count, const iupColor* colors, unsigned char* dst)
+{
+  int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256i idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(index + i)));
+    _mm256_storeu_si256((__m256i*)(dst + 4 * i), _mm256_i32gather_epi32((const int*)colors, idx, 4));
+  }
+  return i;
+}
+#endif
+
+void iupImageConvPalette(const unsigned char* index, int count, const iupColor* colors, unsigned char* dst, int dst_channels)
+{
+  int i = 0;
+
+  if (dst_channels == 4)
+  {
+    /* a local copy, so the compiler knows it does not alias dst */
+    unsigned int table[256];
+    memcpy(table, colors, sizeof(table));
+
+#ifdef IIMAGE_AVX2
+    if (iImageHasAVX2())
+      i = iImagePaletteAVX2(index, count, colors, dst);
+#endif
+
+    /* without gathers a 32 bits table copy is already the fastest way */
+    for (; i < count; i++)
+      memcpy(dst + 4 * i, table + index[i], 4);
+  }
+  else
+  {
+    for (; i < count; i++)
+    {
+      const iupColor* c = colors + index[i];
+      dst[0] = c->r;
+      dst[1] = c->g;
+      dst[2] = c->b;
+      dst += 3;
+    }
+  }
+}
+
+/* RGB = RGB*A + BG*(1-A) for RGBA pixels.
+   alpha_mode: 0 keep alpha, 1 set alpha to 255 */
+static void iImageBlendRGBA(unsigned char* data, int count, unsigned char bg_r, unsigned char bg_g, unsigned char bg_b, int alpha_mode)
+{
+  int i = 0;
+
+#if defined(IIMAGE_SSE2)
+  {
+    __m128i zero = _mm_setzero_si128(),
+            one = _mm_set1_epi16(1),
+            c255 = _mm_set1_epi16(255),
+            bg = _mm_set_epi16(0, bg_b, bg_g, bg_r, 0, bg_b, bg_g, bg_r),
+            amask = _mm_set1_epi32((int)0xFF000000),
+            aset = alpha_mode ? amask : zero;
+    for (; i + 4 <= count; i += 4)
+    {
+      __m128i p = _mm_loadu_si128((const __m128i*)(data + 4 * i));
+      __m128i r[2];
+      int h;
+
+      for (h = 0; h < 2; h++)
+      {
+        __m128i c = h ? _mm_unpackhi_epi8(p, zero) : _mm_unpacklo_epi8(p, zero);
+        __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(c, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        __m128i x = _mm_add_epi16(_mm_mullo_epi16(c, a), _mm_mullo_epi16(bg, _mm_sub_epi16(c255, a)));
+        r[h] = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, one), _mm_srli_epi16(x, 8)), 8);
+      }
+
+      p = alpha_mode ? zero : _mm_and_si128(p, amask);
+      p = _mm_or_si128(_mm_or_si128(_mm_andnot_si128(amask, _mm_packus_epi16(r[0], r[1])), p), aset);
+      _mm_storeu_si128((__m128i*)(data + 4 * i), p);
+    }
+  }
+#elif defined(IIMAGE_NEON)
+  {
+    uint8x8_t vbg_r = vdup_n_u8(bg_r), vbg_g = vdup_n_u8(bg_g), vbg_b = vdup_n_u8(bg_b);
+    for (; i + 8 <= count; i += 8)
+    {
+      uint8x8x4_t p = vld4_u8(data + 4 * i);
+      uint8x8_t na = vmvn_u8(p.val[3]);
+      uint16x8_t x;
+
+#define IIMAGE_NEON_BLEND(_c, _bg)                          \
+      x = vmlal_u8(vmull_u8(p.val[_c], p.val[3]), _bg, na); \
+      p.val[_c] = vshrn_n_u16(vaddq_u16(vaddq_u16(x, vdupq_n_u16(1)), vshrq_n_u16(x, 8)), 8);
+
+      IIMAGE_NEON_BLEND(0, vbg_r)
+      IIMAGE_NEON_BLEND(1, vbg_g)
+      IIMAGE_NEON_BLEND(2, vbg_b)
+#undef IIMAGE_NEON_BLEND
+
+      if (alpha_mode)
+        p.val[3] = vdup_n_u8(255);
+
+      vst4_u8(data + 4 * i, p);
+    }
+  }
+#endif
+
+  for (; i < count; i++)
+  {
+    unsigned char* p = data + 4 * i;
+    int a = p[3];
+    p[0] = (unsigned char)iDIV255(p[0] * a + bg_r * (255 - a));
+    p[1] = (unsigned char)iDIV255(p[1] * a + bg_g * (255 - a));
+    p[2] = (unsigned char)iDIV255(p[2] * a + bg_b * (255 - a));
+    if (alpha_mode)
+      p[3] = 255;
+  }
+}
+
+void iupImageConvBlendBgColor(unsigned char* rgba, int count, unsigned char bg_r, unsigned char bg_g, unsigned char bg_b, int flat_alpha)
+{
+  iImageBlendRGBA(rgba, count, bg_r, bg_g, bg_b, flat_alpha);
+}
+
+void iupImageConvPremultiply(unsigned char* rgba, int count)
+{
+  iImageBlendRGBA(rgba, count, 0, 0, 0, 0);
+}
+
+void iupImageConvSwapRB(unsigned char* data, int count, int channels)
+{
+  int i = 0;
+
+  if (channels == 4)
+  {
+#if defined(IIMAGE_SSE2)
+    __m128i ga = _mm_set1_epi32((int)0xFF00FF00),
+            low = _mm_set1_epi32(0x000000FF);
+    for (; i + 4 <= count; i += 4)
+    {
+      __m128i p = _mm_loadu_si128((const __m128i*)(data + 4 * i));
+      __m128i r = _mm_and_si128(_mm_srli_epi32(p, 16), low);
+      __m128i b = _mm_slli_epi32(_mm_and_si128(p, low), 16);
+      _mm_storeu_si128((__m128i*)(data + 4 * i), _mm_or_si128(_mm_and_si128(p, ga), _mm_or_si128(r, b)));
+    }
+#elif defined(IIMAGE_NEON)
+    for (; i + 8 <= count; i += 8)
+    {
+      uint8x8x4_t p = vld4_u8(data + 4 * i);
+      uint8x8_t t = p.val[0];
+      p.val[0] = p.val[2];
+      p.val[2] = t;
+      vst4_u8(data + 4 * i, p);
+    }
+#endif
+  }
+
+  for (; i < count; i++)
+  {
+    unsigned char* p = data + channels * i;
+    unsigned char t = p[0];
+    p[0] = p[2];
+    p[2] = t;
+  }
+}
+
+#ifdef IIMAGE_AVX2
+/* returns the number of processed pixels */
+static IIMAGE_AVX2_FUNC int iImageMakeInactiveAVX2(unsigned char* data, int count, const unsigned int* lut, int bg)
+{
+  int i = 0;
+  __m256i low = _mm256_set1_epi32(0xFF),
+          rgb = _mm256_set1_epi32(0x00FFFFFF),
+          vbg = _mm256_set1_epi32(bg),
+          div3 = _mm256_set1_epi32(21846);
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256i p = _mm256_loadu_si256((const __m256i*)(data + 4 * i));
+    __m256i s = _mm256_add_epi32(_mm256_add_epi32(_mm256_and_si256(p, low),
+                                                  _mm256_and_si256(_mm256_srli_epi32(p, 8), low)),
+                                 _mm256_and_si256(_mm256_srli_epi32(p, 16), low));
+    /* the sum has 16 bits, so the high 16 bits of each lane are 0 */
+    __m256i v = _mm256_i32gather_epi32((const int*)lut, _mm256_mulhi_epu16(s, div3), 4);
+    v = _mm256_or_si256(v, _mm256_andnot_si256(rgb, p));
+    v = _mm256_blendv_epi8(v, p, _mm256_cmpeq_epi32(_mm256_and_si256(p, rgb), vbg));
+    _mm256_storeu_si256((__m256i*)(data + 4 * i), v);
+  }
+  return i;
+}
+#endif
+
+/* Same result as iupImageColorMakeInactive, but the per pixel divisions are replaced by a table
+   indexed by the pixel intensity, that is computed once for the background color.
+   Each entry has the 3 channels, so the vector code can use a single 32 bits lookup per pixel. */
+void iupImageConvMakeInactive(unsigned char* data, int count, int channels, unsigned char bg_r, unsigned char bg_g, unsigned char bg_b)
+{
+  unsigned int lut[256];
+  int i = 0, bg_i = (bg_r + bg_g + bg_b) / 3;
+
+  for (i = 0; i < 256; i++)
+  {
+    int ir = 0, ig = 0, ib = 0;
+
+    if (bg_i)
+    {
+      ir = (bg_r*i) / bg_i;
+      ig = (bg_g*i) / bg_i;
+      ib = (bg_b*i) / bg_i;
+    }
+
+    ir = (255 + ir) / 2;
+    ig = (255 + ig) / 2;
+    ib = (255 + ib) / 2;
+
+    /* in memory order, the same as the pixels */
+    ((unsigned char*)(lut + i))[0] = iupBYTECROP(ir);
+    ((unsigned char*)(lut + i))[1] = iupBYTECROP(ig);
+    ((unsigned char*)(lut + i))[2] = iupBYTECROP(ib);
+    ((unsigned char*)(lut + i))[3] = 0;
+  }
+
+  i = 0;
+
+#if defined(IIMAGE_SSE2)
+  if (channels == 4)
+  {
+    /* x86 is little endian, the pixel is A<<24|B<<16|G<<8|R */
+    int bg = bg_r | (bg_g << 8) | (bg_b << 16);
+
+#ifdef IIMAGE_AVX2
+    if (iImageHasAVX2())
+      i = iImageMakeInactiveAVX2(data, count, lut, bg);
+#endif
+
+    {
+      /* SSE2 has no gathers, only the lookup is done per pixel */
+      __m128i low = _mm_set1_epi32(0xFF),
+              rgb = _mm_set1_epi32(0x00FFFFFF),
+              vbg = _mm_set1_epi32(bg),
+              div3 = _mm_set1_epi32(21846);
+      for (; i + 4 <= count; i += 4)
+      {
+        __m128i p = _mm_loadu_si128((const __m128i*)(data + 4 * i));
+        __m128i s = _mm_add_epi32(_mm_add_epi32(_mm_and_si128(p, low),
+                                                _mm_and_si128(_mm_srli_epi32(p, 8), low)),
+                                  _mm_and_si128(_mm_srli_epi32(p, 16), low));
+        __m128i v, eq;
+        int idx[4];
+
+        _mm_storeu_si128((__m128i*)idx, _mm_mulhi_epu16(s, div3));
+        v = _mm_set_epi32((int)lut[idx[3]], (int)lut[idx[2]], (int)lut[idx[1]], (int)lut[idx[0]]);
+        v = _mm_or_si128(v, _mm_andnot_si128(rgb, p));
+
+        eq = _mm_cmpeq_epi32(_mm_and_si128(p, rgb), vbg);
+        v = _mm_or_si128(_mm_and_si128(eq, p), _mm_andnot_si128(eq, v));
+        _mm_storeu_si128((__m128i*)(data + 4 * i), v);
+      }
+    }
+  }
+#endif
+
+  for (; i < count; i++)
+  {
+    unsigned char* p = data + channels * i;
+
+    /* preserve colors identical to the background color */
+    if (p[0] != bg_r || p[1] != bg_g || p[2] != bg_b)
+    {
+      const unsigned char* l = (const unsigned char*)(lut + (((p[0] + p[1] + p[2]) * 21846) >> 16));   /* exact division by 3 */
+      p[0] = l[0];
+      p[1] = l[1];
+      p[2] = l[2];
+    }
+  }
+}
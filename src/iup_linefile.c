@@ -9,15 +9,40 @@
 #include <memory.h>
 #include <string.h>
 
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include "iup_linefile.h"
 
 #define LINEFILE_STRING_BLOCK 80
+#define LINEFILE_READ_BLOCK 65536
 
 struct _IlineFile
 {
-  FILE* file;
+  FILE* file;          /* NULL when the file is mapped */
+
+  /* file data, the read block or the mapped view */
+  char* data;
+  size_t data_size,    /* allocated size of the read block */
+         data_pos,     /* start of the next line */
+         data_end;     /* end of valid data */
+
+  int eof;
+
+  /* copy of the last line, returned by iupLineFileGetBuffer */
   char* line_buffer;
   int buffer_maxsize;
+
+#ifdef WIN32
+  HANDLE map_handle;
+#endif
 };
 
 const char* iupLineFileGetBuffer(IlineFile* line_file)
@@ -27,7 +52,19 @@ const char* iupLineFileGetBuffer(IlineFile* line_file)
 
 int iupLineFileEOF(IlineFile* line_file)
 {
-  return feof(line_file->file);
+  return line_file->eof;
+}
+
+static IlineFile* iLineFileCreate(void)
+{
+  IlineFile* line_file = malloc(sizeof(IlineFile));
+  memset(line_file, 0, sizeof(IlineFile));
+
+  line_file->buffer_maxsize = LINEFILE_STRING_BLOCK;
+  line_file->line_buffer = (char*)malloc(line_file->buffer_maxsize);
+  line_file->line_buffer[0] = 0;
+
+  return line_file;
 }
 
 IlineFile* iupLineFileOpen(const char* filename)
@@ -37,55 +74,213 @@ IlineFile* iupLineFileOpen(const char* filename)
     return NULL;
 
   {
-    IlineFile* line_file = malloc(sizeof(IlineFile));
-    memset(line_file, 0, sizeof(IlineFile));
+    IlineFile* line_file = iLineFileCreate();
 
     line_file->file = file;
-    line_file->buffer_maxsize = LINEFILE_STRING_BLOCK;
-    line_file->line_buffer = (char*)malloc(line_file->buffer_maxsize);
+    line_file->data_size = LINEFILE_READ_BLOCK;
+    line_file->data = (char*)malloc(line_file->data_size);
 
     return line_file;
   }
 }
 
+IlineFile* iupLineFileOpenMapped(const char* filename)
+{
+  IlineFile* line_file;
+  char* data;
+  size_t size;
+
+#ifdef WIN32
+  HANDLE map_handle;
+  LARGE_INTEGER file_size;
+  HANDLE file_handle = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  if (file_handle == INVALID_HANDLE_VALUE)
+    return NULL;
+
+  if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart == 0 ||
+      (unsigned __int64)file_size.QuadPart > (size_t)-1)
+  {
+    CloseHandle(file_handle);
+    return iupLineFileOpen(filename);  /* can not map empty files */
+  }
+  size = (size_t)file_size.QuadPart;
+
+  map_handle = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+  CloseHandle(file_handle);  /* the mapping keeps its own reference */
+  if (!map_handle)
+    return iupLineFileOpen(filename);
+
+  data = (char*)MapViewOfFile(map_handle, FILE_MAP_READ, 0, 0, 0);
+  if (!data)
+  {
+    CloseHandle(map_handle);
+    return iupLineFileOpen(filename);
+  }
+#else
+  struct stat st;
+  int fd = open(filename, O_RDONLY);
+  if (fd == -1)
+    return NULL;
+
+  if (fstat(fd, &st) != 0 || st.st_size == 0 || !S_ISREG(st.st_mode))
+  {
+    close(fd);
+    return iupLineFileOpen(filename);  /* can not map empty files or pipes */
+  }
+  size = (size_t)st.st_size;
+
+  data = (char*)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);  /* the mapping keeps its own reference */
+  if (data == (char*)MAP_FAILED)
+    return iupLineFileOpen(filename);
+
+#ifdef MADV_SEQUENTIAL
+  madvise(data, size, MADV_SEQUENTIAL);
+#endif
+#endif
+
+  line_file = iLineFileCreate();
+  line_file->data = data;
+  line_file->data_end = size;
+#ifdef WIN32
+  line_file->map_handle = map_handle;
+#endif
+
+  return line_file;
+}
+
 void iupLineFileClose(IlineFile* line_file)
 {
-  fclose(line_file->file);
+  if (line_file->file)
+  {
+    fclose(line_file->file);
+    free(line_file->data);
+  }
+  else
+  {
+#ifdef WIN32
+    UnmapViewOfFile(line_file->data);
+    CloseHandle(line_file->map_handle);
+#else
+    munmap(line_file->data, line_file->data_end);
+#endif
+  }
+
   free(line_file->line_buffer);  /* use free because of realloc */
   free(line_file);
 }
 
-int iupLineFileReadLine(IlineFile* line_file)
+static int iLineFileFill(IlineFile* line_file)
 {
-  char char_buffer[1];
-  int ret, count = 0;
-  
-  do 
+  size_t count;
+
+  if (line_file->data_pos > 0)  /* discard the lines already returned */
   {
-    ret = (int)fread(char_buffer, 1, 1, line_file->file);
-    if (ret == 0)
-    {
-      if (feof(line_file->file))  /* last line */
-        break;
+    line_file->data_end -= line_file->data_pos;
+    memmove(line_file->data, line_file->data + line_file->data_pos, line_file->data_end);
+    line_file->data_pos = 0;
+  }
+
+  if (line_file->data_end == line_file->data_size)  /* line larger than the block */
+  {
+    char* data = (char*)realloc(line_file->data, 2 * line_file->data_size);
+    if (!data)
+      return -1;
+    line_file->data = data;
+    line_file->data_size *= 2;
+  }
+
+  count = fread(line_file->data + line_file->data_end, 1, line_file->data_size - line_file->data_end, line_file->file);
+  if (count == 0 && ferror(line_file->file))
+    return -1;  /* error reading */
 
-      return -1;  /* error reading */
+  line_file->data_end += count;
+  return (int)count;
+}
+
+const char* iupLineFileReadLineView(IlineFile* line_file, int *line_len)
+{
+  size_t scanned = 0;
+  const char* line;
+  char* nl;
+  size_t len;
+
+  *line_len = 0;
+
+  if (line_file->eof)  /* nothing else to read */
+    return line_file->data + line_file->data_pos;
+
+  for (;;)
+  {
+    nl = memchr(line_file->data + line_file->data_pos + scanned, '\n', line_file->data_end - line_file->data_pos - scanned);
+    if (nl)
+    {
+      line = line_file->data + line_file->data_pos;
+      len = nl - line;
+      line_file->data_pos += len + 1;
+      break;
     }
 
-    if (count+1 > line_file->buffer_maxsize)
+    if (line_file->file)
     {
-      line_file->buffer_maxsize += LINEFILE_STRING_BLOCK;
-      line_file->line_buffer = (char*)realloc(line_file->line_buffer, line_file->buffer_maxsize);
-      memset(line_file->line_buffer + line_file->buffer_maxsize - LINEFILE_STRING_BLOCK, 0, LINEFILE_STRING_BLOCK);
+      int count;
+      scanned = line_file->data_end - line_file->data_pos;
+      count = iLineFileFill(line_file);
+      if (count < 0)
+        return NULL;
+      if (count > 0)
+        continue;
     }
 
-    if (char_buffer[0] != '\r' && char_buffer[0] != '\n')
+    /* last line */
+    line_file->eof = 1;
+    line = line_file->data + line_file->data_pos;
+    len = line_file->data_end - line_file->data_pos;
+    line_file->data_pos = line_file->data_end;
+    break;
+  }
+
+  if (len > 0 && line[len - 1] == '\r')
+    len--;
+
+  *line_len = (int)len;
+  return line;
+}
+
+int iupLineFileReadLine(IlineFile* line_file)
+{
+  int i, line_len, count = 0;
+  const char* line = iupLineFileReadLineView(line_file, &line_len);
+  if (!line)
+    return -1;
+
+  if (line_len + 1 > line_file->buffer_maxsize)
+  {
+    char* line_buffer = (char*)realloc(line_file->line_buffer, line_len + LINEFILE_STRING_BLOCK);
+    if (!line_buffer)
+      return -1;
+    line_file->line_buffer = line_buffer;
+    line_file->buffer_maxsize = line_len + LINEFILE_STRING_BLOCK;
+  }
+
+  if (memchr(line, '\r', line_len))
+  {
+    /* ignore all '\r' inside the line */
+    for (i = 0; i < line_len; i++)
     {
-      line_file->line_buffer[count] = char_buffer[0];
-      count++;
+      if (line[i] != '\r')
+      {
+        line_file->line_buffer[count] = line[i];
+        count++;
+      }
     }
-  } while (char_buffer[0] != '\n');
+  }
+  else
+  {
+    memcpy(line_file->line_buffer, line, line_len);
+    count = line_len;
+  }
 
   line_file->line_buffer[count] = 0;
   return count;
 }
-
@@ -19,10 +19,17 @@ extern "C" {
 typedef struct _IlineFile IlineFile;
 
 /** Opens an existing file. 
+* The file is read in large blocks.
 * Returns NULL if failed.
 * \ingroup linefile */
 IlineFile* iupLineFileOpen(const char* filename);
 
+/** Opens an existing file mapping it in memory. Best for large files. \n
+* If the file can not be mapped it is opened with \ref iupLineFileOpen.
+* Returns NULL if failed.
+* \ingroup linefile */
+IlineFile* iupLineFileOpenMapped(const char* filename);
+
 /** Closes the file.
 * \ingroup linefile */
 void iupLineFileClose(IlineFile* line_file);
@@ -36,6 +43,14 @@ int iupLineFileReadLine(IlineFile* line_file);
 * \ingroup linefile */
 const char* iupLineFileGetBuffer(IlineFile* line_file);
 
+/** Reads a line from the file without copying it. \n
+* Returns a pointer to the line inside the file data and its size in line_len, or NULL if failed.
+* The line is NOT terminated by zero and the '\n' and a final '\r' are not included.
+* It is valid until the next read or until the file is closed.
+* Can be mixed with \ref iupLineFileReadLine.
+* \ingroup linefile */
+const char* iupLineFileReadLineView(IlineFile* line_file, int *line_len);
+
 /** Returns a non zero value if reached the end of the file.
 * \ingroup linefile */
 int iupLineFileEOF(IlineFile* line_file);
@@ -3,9 +3,23 @@
 *
 * See Copyright Notice in "iup.h"
 */
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef WIN32
+#include <windows.h>
+#endif
+
 #include "iup.h"
 #include "iupcbs.h"
 
+#include "iup_loop.h"
+#include "iup_object.h"
+#include "iup_attrib.h"
+#include "iup_table.h"
+
+
 void iupLoopCallEntryCb(void)
 {
   IFentry entry_callback = (IFentry)IupGetFunction("ENTRY_POINT");
@@ -24,3 +38,219 @@ void iupLoopCallExitCb(void)
   }
 }
 
+
+/****************************************************************************************
+                                     IupPostMessage
+ Any thread pushes the message in a lock free list (newest first).
+ Only the first message after the list was taken asks the driver to wake up the main thread,
+ that takes the whole list at once and dispatches it grouped by handle.
+*****************************************************************************************/
+
+#ifdef WIN32
+#define iLoopAtomicExchangePtr(_p, _v) InterlockedExchangePointer((PVOID volatile*)(_p), (PVOID)(_v))
+#define iLoopAtomicCompareExchangePtr(_p, _v, _cmp) InterlockedCompareExchangePointer((PVOID volatile*)(_p), (PVOID)(_v), (PVOID)(_cmp))
+#define iLoopAtomicExchangeInt(_p, _v) InterlockedExchange((LONG volatile*)(_p), (LONG)(_v))
+#else
+#define iLoopAtomicExchangePtr(_p, _v) __atomic_exchange_n((_p), (_v), __ATOMIC_SEQ_CST)
+#define iLoopAtomicCompareExchangePtr(_p, _v, _cmp) __sync_val_compare_and_swap((_p), (_cmp), (_v))
+#define iLoopAtomicExchangeInt(_p, _v) __atomic_exchange_n((_p), (_v), __ATOMIC_SEQ_CST)
+#endif
+
+typedef struct _IloopMessage {
+  struct _IloopMessage* next;        /* in the posted list, or in the list of the same handle */
+  Ihandle* ih;
+  char* s;
+  void* message_data;
+  int i;
+} IloopMessage;
+
+static IloopMessage* volatile iloop_message_list = NULL;
+static volatile long iloop_message_wakeup = 0;
+
+int iupLoopPostMessage(Ihandle* ih, char* s, void* message_data, int i)
+{
+  IloopMessage* head;
+  IloopMessage* msg = (IloopMessage*)malloc(sizeof(IloopMessage));
+  if (!msg)
+    return 0;
+
+  msg->ih = ih;
+  msg->s = s;
+  msg->message_data = message_data;
+  msg->i = i;
+
+  /* the main thread only removes the whole list, so there is no ABA problem */
+  do
+  {
+    head = iloop_message_list;
+    msg->next = head;
+  } while (iLoopAtomicCompareExchangePtr(&iloop_message_list, msg, head) != head);
+
+  /* only one wake up until the list is taken */
+  return iLoopAtomicExchangeInt(&iloop_message_wakeup, 1) == 0;
+}
+
+void iupLoopPostMessageWakeupFailed(void)
+{
+  /* the main thread was not notified, so the next posted message must wake it up */
+  iLoopAtomicExchangeInt(&iloop_message_wakeup, 0);
+}
+
+static int iLoopCoalesceMessages(char** s_array, void** data_array, int* i_array, int count)
+{
+  /* latest wins, in the position of the first message with the same string */
+  Itable* index = iupTableCreate(IUPTABLE_STRINGINDEXED);
+  int m, new_count = 0;
+
+  for (m = 0; m < count; m++)
+  {
+    int pos = s_array[m]? (int)(size_t)iupTableGet(index, s_array[m]): 0;
+    if (pos)
+    {
+      data_array[pos - 1] = data_array[m];
+      i_array[pos - 1] = i_array[m];
+    }
+    else
+    {
+      s_array[new_count] = s_array[m];
+      data_array[new_count] = data_array[m];
+      i_array[new_count] = i_array[m];
+      new_count++;
+
+      if (s_array[m])
+        iupTableSet(index, s_array[m], (void*)(size_t)new_count, IUPTABLE_POINTER);
+    }
+  }
+
+  iupTableDestroy(index);
+  return new_count;
+}
+
+static void iLoopDispatchHandleMessages(IloopMessage* msg, int count, char** s_array, void** data_array, int* i_array)
+{
+  Ihandle* ih = msg->ih;
+  IFnSVIi batch_cb;
+  int m;
+
+  if (!iupObjectCheck(ih))  /* destroyed after the messages were posted */
+    return;
+
+  for (m = 0; msg; msg = msg->next, m++)
+  {
+    s_array[m] = msg->s;
+    data_array[m] = msg->message_data;
+    i_array[m] = msg->i;
+  }
+
+  if (count > 1 && iupAttribGetBoolean(ih, "POSTMESSAGECOALESCE"))
+    count = iLoopCoalesceMessages(s_array, data_array, i_array, count);
+
+  batch_cb = (IFnSVIi)IupGetCallback(ih, "POSTMESSAGEBATCH_CB");
+  if (batch_cb)
+    batch_cb(ih, s_array, data_array, i_array, count);
+  else
+  {
+    IFnsVi cb = (IFnsVi)IupGetCallback(ih, "POSTMESSAGE_CB");
+    if (!cb)
+      return;
+
+    for (m = 0; m < count; m++)
+    {
+      cb(ih, s_array[m], data_array[m], i_array[m]);
+
+      if (!iupObjectCheck(ih))  /* destroyed by the callback */
+        return;
+    }
+  }
+}
+
+void iupLoopProcessMessages(void)
+{
+  IloopMessage *list, *msg, *next;
+  IloopMessage **handle_first, **handle_last;
+  int *handle_count;
+  char** s_array;
+  void** data_array;
+  int* i_array;
+  Itable* handle_index = NULL;
+  int count = 0, handle_num = 0, h, last_h = -1;
+
+  /* posted messages from now on will wake up again */
+  iLoopAtomicExchangeInt(&iloop_message_wakeup, 0);
+  list = (IloopMessage*)iLoopAtomicExchangePtr(&iloop_message_list, NULL);
+  if (!list)
+    return;
+
+  /* restore the posting order */
+  msg = list;
+  list = NULL;
+  while (msg)
+  {
+    next = msg->next;
+    msg->next = list;
+    list = msg;
+    msg = next;
+    count++;
+  }
+
+  handle_first = (IloopMessage**)malloc(count * sizeof(IloopMessage*));
+  handle_last = (IloopMessage**)malloc(count * sizeof(IloopMessage*));
+  handle_count = (int*)malloc(count * sizeof(int));
+  s_array = (char**)malloc(count * sizeof(char*));
+  data_array = (void**)malloc(count * sizeof(void*));
+  i_array = (int*)malloc(count * sizeof(int));
+
+  /* split the list by handle, keeping the order of each handle */
+  for (msg = list; msg; msg = next)
+  {
+    next = msg->next;
+    msg->next = NULL;
+
+    if (last_h != -1 && handle_first[last_h]->ih == msg->ih)  /* usually many messages of the same handle in sequence */
+      h = last_h;
+    else
+    {
+      if (!handle_index)
+        handle_index = iupTableCreate(IUPTABLE_POINTERINDEXED);
+
+      h = (int)(size_t)iupTableGet(handle_index, (char*)msg->ih) - 1;
+      if (h < 0)  /* first message of this handle */
+      {
+        h = handle_num;
+        handle_num++;
+        handle_first[h] = NULL;
+        handle_count[h] = 0;
+        iupTableSet(handle_index, (char*)msg->ih, (void*)(size_t)(h + 1), IUPTABLE_POINTER);
+      }
+    }
+
+    if (handle_first[h])
+      handle_last[h]->next = msg;
+    else
+      handle_first[h] = msg;
+    handle_last[h] = msg;
+    handle_count[h]++;
+    last_h = h;
+  }
+
+  for (h = 0; h < handle_num; h++)
+    iLoopDispatchHandleMessages(handle_first[h], handle_count[h], s_array, data_array, i_array);
+
+  for (h = 0; h < handle_num; h++)
+  {
+    for (msg = handle_first[h]; msg; msg = next)
+    {
+      next = msg->next;
+      free(msg);
+    }
+  }
+
+  if (handle_index)
+    iupTableDestroy(handle_index);
+  free(handle_first);
+  free(handle_last);
+  free(handle_count);
+  free(s_array);
+  free(data_array);
+  free(i_array);
+}
@@ -14,6 +14,15 @@ extern "C" {
 void iupLoopCallEntryCb(void);
 void iupLoopCallExitCb(void);
 
+/* IupPostMessage queue, shared by all the handles.
+   iupLoopPostMessage can be called from any thread, it returns non zero when the driver must
+   wake up the main thread to call iupLoopProcessMessages, once for many posted messages. 
+   If the driver fails to wake up the main thread it must call iupLoopPostMessageWakeupFailed, 
+   so the next posted message tries again. The messages stay in the queue until then. */
+int iupLoopPostMessage(Ihandle* ih, char* s, void* message_data, int i);
+void iupLoopPostMessageWakeupFailed(void);
+void iupLoopProcessMessages(void);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -12,6 +12,7 @@
 #include "iup_str.h"
 #include "iup_globalattrib.h"
 #include "iup_names.h"
+#include "iup_atom.h"
 #include "iup_func.h"
 #include "iup_drv.h"
 #include "iup_drvinfo.h"
@@ -48,12 +49,14 @@ int IupOpen(int *argc, char ***argv)
   }
 
   iupNamesInit();
+  iupAtomInit();
   iupFuncInit();
   iupStrMessageInit();
   iupGlobalAttribInit(); 
   iupRegisterInit();
   iupKeyInit();
   iupImageStockInit();
+  iupImageCacheInit();
 
   IupSetLanguage("ENGLISH");
   IupSetGlobal("VERSION", IupVersion());
@@ -107,6 +110,7 @@ void IupClose(void)
   iupDlgListDestroyAll();    /* destroy all dialogs and their children */
   iupNamesDestroyHandles();  /* destroy everything that do not belong to a dialog */
   iupImageStockFinish();     /* release stock images hash table and the images */
+  iupImageCacheFinish();     /* release native image cache, after all images */
 
   iupRegisterFinish();  /* release native classes */
 
@@ -117,6 +121,7 @@ void IupClose(void)
   iupStrMessageFinish();    /* release messages hash table */
   iupFuncFinish();          /* release callbacks hash table */
   iupNamesFinish();         /* release names hash table */
+  iupAtomFinish();          /* release attribute atoms, after the classes */
 
   iupStrGetMemory(-1); /* Frees internal buffer */
 }
@@ -12,6 +12,12 @@
 #include <stdarg.h>
 #include <locale.h>
 
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__GNUC__) || defined(__clang__)
+#include <pthread.h>
+#endif
+
 #include "iup_str.h"
 
 
@@ -312,129 +318,333 @@ static char *iStrDupUntilNoCase(char **str, char sep)
   }
 }
 
+/* Returned strings memory.
+   Each thread has its own context with rotating buffers by size class:
+   small (for numbers), medium (any size) and large (for unknown size).
+   Inside a scope (iupStrScopeBegin/iupStrScopeEnd) buffers are not reused,
+   they are allocated sequentially from an arena and released all at once at the end of the scope.
+   The context of a thread is released when the thread exits, using a FLS callback in Windows
+   or a pthread key destructor elsewhere. The main thread releases it in IupClose. */
+
+#if defined(_MSC_VER)
+#define ISTR_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__) || defined(__clang__)
+#define ISTR_THREAD_LOCAL __thread
+#else
+#define ISTR_THREAD_LOCAL   /* not thread-safe */
+#endif
+
+#define ISTR_SMALL_MAX_BUFFERS 100
+#define ISTR_SMALL_SIZE 80  /* maximum for iupStrReturnFloat and iupStrReturnDouble */
+#define ISTR_MAX_BUFFERS 50
+#define ISTR_LARGE_MAX_BUFFERS 10
+#define ISTR_LARGE_SIZE SHRT_MAX
+#define ISTR_ARENA_BLOCK_SIZE 65536
+
+typedef struct _IstrArenaBlock
+{
+  struct _IstrArenaBlock* next;  /* previous allocated block */
+  int start;   /* arena position of the first byte */
+  int size;
+  int used;
+  int dummy;   /* keep data aligned */
+  /* data follows */
+} IstrArenaBlock;
+
+typedef struct _IstrMemContext
+{
+  char small_buffers[ISTR_SMALL_MAX_BUFFERS][ISTR_SMALL_SIZE];
+  int small_index;
+
+  char* buffers[ISTR_MAX_BUFFERS];
+  int buffers_sizes[ISTR_MAX_BUFFERS];
+  int buffers_index;
+
+  char* large_buffers[ISTR_LARGE_MAX_BUFFERS];
+  int large_index;
+
+  int scope_level;
+  IstrArenaBlock* arena;   /* last allocated block */
+} IstrMemContext;
+
+static ISTR_THREAD_LOCAL IstrMemContext* istr_mem_context = NULL;
+
+static void iStrReleaseMemContext(IstrMemContext* ctx);
+
+#if defined(_WIN32)
+static DWORD istr_mem_key = FLS_OUT_OF_INDEXES;
+static INIT_ONCE istr_mem_key_once = INIT_ONCE_STATIC_INIT;
+
+static void WINAPI iStrMemContextDestructor(void* ctx)
+{
+  if (ctx)
+    iStrReleaseMemContext((IstrMemContext*)ctx);
+}
+
+static BOOL CALLBACK iStrMemKeyCreate(PINIT_ONCE once, void* param, void** context)
+{
+  (void)once; (void)param; (void)context;
+  istr_mem_key = FlsAlloc(iStrMemContextDestructor);
+  return TRUE;
+}
+
+static void iStrSetMemKey(IstrMemContext* ctx)
+{
+  InitOnceExecuteOnce(&istr_mem_key_once, iStrMemKeyCreate, NULL, NULL);
+  if (istr_mem_key != FLS_OUT_OF_INDEXES)
+    FlsSetValue(istr_mem_key, ctx);
+}
+#elif defined(__GNUC__) || defined(__clang__)
+static pthread_key_t istr_mem_key;
+static pthread_once_t istr_mem_key_once = PTHREAD_ONCE_INIT;
+static int istr_mem_key_created = 0;
+
+static void iStrMemContextDestructor(void* ctx)
+{
+  if (ctx)
+    iStrReleaseMemContext((IstrMemContext*)ctx);
+}
+
+static void iStrMemKeyCreate(void)
+{
+  istr_mem_key_created = (pthread_key_create(&istr_mem_key, iStrMemContextDestructor) == 0);
+}
+
+static void iStrSetMemKey(IstrMemContext* ctx)
+{
+  pthread_once(&istr_mem_key_once, iStrMemKeyCreate);
+  if (istr_mem_key_created)
+    pthread_setspecific(istr_mem_key, ctx);
+}
+#else
+#define iStrSetMemKey(_ctx)
+#endif
+
+static IstrMemContext* iStrGetMemContext(void)
+{
+  if (!istr_mem_context)
+  {
+    istr_mem_context = (IstrMemContext*)calloc(1, sizeof(IstrMemContext));
+    if (istr_mem_context)
+      iStrSetMemKey(istr_mem_context);  /* so it is released when the thread exits */
+  }
+  return istr_mem_context;
+}
+
+static int iStrArenaGetPosition(IstrMemContext* ctx)
+{
+  if (!ctx->arena)
+    return 0;
+  return ctx->arena->start + ctx->arena->used;
+}
+
+static char* iStrArenaAlloc(IstrMemContext* ctx, int size)
+{
+  IstrArenaBlock* block = ctx->arena;
+  char* ret_str;
+
+  size = (size + 7) & ~7;  /* keep alignment */
+
+  if (!block || block->used + size > block->size)
+  {
+    int block_size = size > ISTR_ARENA_BLOCK_SIZE? size: ISTR_ARENA_BLOCK_SIZE;
+    IstrArenaBlock* new_block = (IstrArenaBlock*)malloc(sizeof(IstrArenaBlock) + block_size);
+    if (!new_block)
+      return NULL;
+    new_block->start = iStrArenaGetPosition(ctx);
+    new_block->size = block_size;
+    new_block->used = 0;
+    new_block->next = block;
+    ctx->arena = block = new_block;
+  }
+
+  ret_str = (char*)(block + 1) + block->used;
+  block->used += size;
+  return ret_str;
+}
+
+static void iStrArenaRelease(IstrMemContext* ctx, int position)
+{
+  /* release all the blocks that start after the position,
+     the first block is kept for the next scope */
+  while (ctx->arena && ctx->arena->next && ctx->arena->start >= position)
+  {
+    IstrArenaBlock* block = ctx->arena;
+    ctx->arena = block->next;
+    free(block);
+  }
+
+  if (ctx->arena)
+  {
+    if (position < ctx->arena->start)
+      position = ctx->arena->start;
+    ctx->arena->used = position - ctx->arena->start;
+  }
+}
+
+static void iStrReleaseMemContext(IstrMemContext* ctx)
+{
+  int i;
+
+  for (i = 0; i < ISTR_MAX_BUFFERS; i++)
+  {
+    if (ctx->buffers[i])
+      free(ctx->buffers[i]);
+  }
+
+  for (i = 0; i < ISTR_LARGE_MAX_BUFFERS; i++)
+  {
+    if (ctx->large_buffers[i])
+      free(ctx->large_buffers[i]);
+  }
+
+  while (ctx->arena)
+  {
+    IstrArenaBlock* block = ctx->arena;
+    ctx->arena = block->next;
+    free(block);
+  }
+
+  free(ctx);
+
+  if (ctx == istr_mem_context)
+    istr_mem_context = NULL;
+}
+
+static void iStrFreeMemContext(void)
+{
+  IstrMemContext* ctx = istr_mem_context;
+  if (!ctx)
+    return;
+
+  iStrSetMemKey(NULL);  /* the thread exit must not release it again */
+  iStrReleaseMemContext(ctx);
+}
+
+int iupStrScopeBegin(void)
+{
+  IstrMemContext* ctx = iStrGetMemContext();
+  if (!ctx)
+    return 0;
+
+  ctx->scope_level++;
+  return iStrArenaGetPosition(ctx);
+}
+
+void iupStrScopeEnd(int scope)
+{
+  IstrMemContext* ctx = istr_mem_context;
+  if (!ctx || ctx->scope_level == 0)
+    return;
+
+  ctx->scope_level--;
+  iStrArenaRelease(ctx, scope);
+}
+
 char *iupStrGetLargeMem(int *size)
 {
-#define LARGE_MAX_BUFFERS 10
-#define LARGE_SIZE SHRT_MAX
-  static char buffers[LARGE_MAX_BUFFERS][LARGE_SIZE];
-  static int buffers_index = -1;
+  IstrMemContext* ctx = iStrGetMemContext();
   char* ret_str;
 
-  /* init buffers array */
-  if (buffers_index == -1)
+  if (size) *size = ISTR_LARGE_SIZE;
+
+  if (!ctx)
+    return NULL;
+
+  if (ctx->scope_level)
+    ret_str = iStrArenaAlloc(ctx, ISTR_LARGE_SIZE);
+  else
   {
-    int i;
-    /* clear all memory */
-    for (i=0; i<LARGE_MAX_BUFFERS; i++)
-      memset(buffers[i], 0, sizeof(char)*LARGE_SIZE);
+    /* allocated only when used */
+    if (!ctx->large_buffers[ctx->large_index])
+      ctx->large_buffers[ctx->large_index] = (char*)malloc(ISTR_LARGE_SIZE);
+
+    ret_str = ctx->large_buffers[ctx->large_index];
 
-    buffers_index = 0;
+    ctx->large_index++;
+    if (ctx->large_index == ISTR_LARGE_MAX_BUFFERS)
+      ctx->large_index = 0;
   }
 
   /* DON'T clear memory everytime because the buffer is too large */
-  ret_str = buffers[buffers_index];
-  ret_str[0] = 0;
+  if (ret_str)
+    ret_str[0] = 0;
 
-  buffers_index++;
-  if (buffers_index == LARGE_MAX_BUFFERS)
-    buffers_index = 0;
-
-  if (size) *size = LARGE_SIZE;
   return ret_str;
-#undef LARGE_MAX_BUFFERS
-#undef LARGE_SIZE 
 }
 
 static char* iupStrGetSmallMem(void)
 {
-#define SMALL_MAX_BUFFERS 100
-#define SMALL_SIZE 80  /* maximum for iupStrReturnFloat and iupStrReturnDouble */
-  static char buffers[SMALL_MAX_BUFFERS][SMALL_SIZE];
-  static int buffers_index = -1;
+  IstrMemContext* ctx = iStrGetMemContext();
   char* ret_str;
 
-  /* init buffers array */
-  if (buffers_index == -1)
+  if (!ctx)
+    return NULL;
+
+  if (ctx->scope_level)
+    ret_str = iStrArenaAlloc(ctx, ISTR_SMALL_SIZE);
+  else
   {
-    int i;
-    /* clear all memory */
-    for (i = 0; i<SMALL_MAX_BUFFERS; i++)
-      memset(buffers[i], 0, sizeof(char)*SMALL_SIZE);
-    
-    buffers_index = 0;
-  }
+    ret_str = ctx->small_buffers[ctx->small_index];
 
-  /* always clear memory before returning a new buffer */
-  memset(buffers[buffers_index], 0, SMALL_SIZE);
-  ret_str = buffers[buffers_index];
+    ctx->small_index++;
+    if (ctx->small_index == ISTR_SMALL_MAX_BUFFERS)
+      ctx->small_index = 0;
+  }
 
-  buffers_index++;
-  if (buffers_index == SMALL_MAX_BUFFERS)
-    buffers_index = 0;
+  /* always filled by sprintf, no need to clear all the buffer */
+  if (ret_str)
+    ret_str[0] = 0;
 
   return ret_str;
-#undef SMALL_MAX_BUFFERS
-#undef SMALL_SIZE 
 }
 
 char *iupStrGetMemory(int size)
 {
-#define MAX_BUFFERS 50
-  static char* buffers[MAX_BUFFERS];
-  static int buffers_sizes[MAX_BUFFERS];
-  static int buffers_index = -1;
-
-  int i;
+  IstrMemContext* ctx;
+  char* ret_str;
 
   if (size == -1) /* Frees memory */
   {
-    buffers_index = -1;
-    for (i = 0; i < MAX_BUFFERS; i++)
-    {
-      if (buffers[i]) 
-      {
-        free(buffers[i]);
-        buffers[i] = NULL;
-      }
-      buffers_sizes[i] = 0;
-    }
+    iStrFreeMemContext();
     return NULL;
   }
+
+  ctx = iStrGetMemContext();
+  if (!ctx)
+    return NULL;
+
+  if (ctx->scope_level)
+    ret_str = iStrArenaAlloc(ctx, size+1);
   else
   {
-    char* ret_str;
-
-    /* init buffers array */
-    if (buffers_index == -1)
-    {
-      memset(buffers, 0, sizeof(char*)*MAX_BUFFERS);
-      memset(buffers_sizes, 0, sizeof(int)*MAX_BUFFERS);
-      buffers_index = 0;
-    }
+    int index = ctx->buffers_index;
 
     /* first alocation */
-    if (!(buffers[buffers_index]))
+    if (!(ctx->buffers[index]))
     {
-      buffers_sizes[buffers_index] = size+1;
-      buffers[buffers_index] = (char*)malloc(buffers_sizes[buffers_index]);
+      ctx->buffers_sizes[index] = size+1;
+      ctx->buffers[index] = (char*)malloc(ctx->buffers_sizes[index]);
     }
-    else if (buffers_sizes[buffers_index] < size+1)  /* reallocate if necessary */
+    else if (ctx->buffers_sizes[index] < size+1)  /* reallocate if necessary */
     {
-      buffers_sizes[buffers_index] = size+1;
-      buffers[buffers_index] = (char*)realloc(buffers[buffers_index], buffers_sizes[buffers_index]);
+      ctx->buffers_sizes[index] = size+1;
+      ctx->buffers[index] = (char*)realloc(ctx->buffers[index], ctx->buffers_sizes[index]);
     }
 
-    /* always clear memory before returning a new buffer */
-    memset(buffers[buffers_index], 0, buffers_sizes[buffers_index]);
-    ret_str = buffers[buffers_index];
+    ret_str = ctx->buffers[index];
 
-    buffers_index++;
-    if (buffers_index == MAX_BUFFERS)
-      buffers_index = 0;
-
-    return ret_str;
+    ctx->buffers_index++;
+    if (ctx->buffers_index == ISTR_MAX_BUFFERS)
+      ctx->buffers_index = 0;
   }
-#undef MAX_BUFFERS
+
+  /* always clear memory before returning a new buffer,
+     but only the requested size, the buffer can be larger */
+  if (ret_str)
+    memset(ret_str, 0, size+1);
+
+  return ret_str;
 }
 
 char* iupStrReturnStrf(const char* format, ...)
@@ -1423,6 +1633,66 @@ int iupStrCompare(const char *l, const char *r, int casesensitive, int utf8)
   return 0;
 }
 
+int iupStrCollationKey(const char *str, unsigned short *key, int casesensitive, int utf8)
+{
+  /* Key codes:
+     0 - end of string
+     1 - start of a number, followed by the number of digits+1 and the digits (leading zeros are ignored)
+     map+2 - any other character */
+  unsigned char* map;
+  int count = 0;
+
+  if (!Latin1_map)
+    iStrInitLatin1_map();
+
+  map = casesensitive? Latin1_map: Latin1_map_nocase;
+
+  if (str)
+  {
+    while (*str)
+    {
+      if (iup_isdigit(*str))
+      {
+        int len = 0;
+
+        while (*str == '0')
+          str++;
+
+        while (iup_isdigit(str[len]))
+          len++;
+
+        if (len > 65533)
+          len = 65533;
+
+        key[count++] = 1;
+        key[count++] = (unsigned short)(len + 1);
+        while (len > 0)
+        {
+          key[count++] = (unsigned short)*str;
+          str++;
+          len--;
+        }
+
+        while (iup_isdigit(*str))  /* too many digits */
+          str++;
+      }
+      else
+      {
+        char c = *str;
+
+        if (utf8)
+          c = iStrUTF8toLatin1(&str);  /* increment n-1 an utf8 character */
+
+        key[count++] = (unsigned short)(map[(unsigned char)c] + 2);
+        str++;
+      }
+    }
+  }
+
+  key[count++] = 0;
+  return count;
+}
+
 int iupStrCompareEqual(const char *l, const char *r, int casesensitive, int utf8, int partial)
 {
   if (!l || !r)
@@ -106,8 +106,10 @@ IUP_EXPORTI void iupStrCopyN(char* dst_str, int dst_max_size, const char* src_st
 
 
 /** Returns a buffer with the specified size+1. \n
- * The buffer is resused after 50 calls. It must NOT be freed.
- * Use size=-1 to free all the internal buffers.
+ * The buffer is resused after 50 calls. It must NOT be freed. \n
+ * Buffers are allocated per thread, so it can be used by any thread.
+ * Use size=-1 to free all the internal buffers of the current thread,
+ * they are also freed automatically when the thread ends.
  * \ingroup str */
 IUP_EXPORTI char *iupStrGetMemory(int size);
 
@@ -116,6 +118,18 @@ IUP_EXPORTI char *iupStrGetMemory(int size);
  * \ingroup str */
 char *iupStrGetLargeMem(int *size);
 
+/** Begins a scope for the buffers returned by \ref iupStrGetMemory, \ref iupStrGetLargeMem and iupStrReturn*. \n
+ * Inside a scope buffers are not reused, so any number of returned strings remain valid
+ * until \ref iupStrScopeEnd is called, when they are all released at once. \n
+ * Scopes can be nested. Returns a value that must be passed to \ref iupStrScopeEnd.
+ * \ingroup str */
+IUP_EXPORTI int iupStrScopeBegin(void);
+
+/** Ends a scope started with \ref iupStrScopeBegin.
+ * All buffers returned inside the scope are released.
+ * \ingroup str */
+IUP_EXPORTI void iupStrScopeEnd(int scope);
+
 
 
 /** Converts a string into lower case. Can be used in-place. \n
@@ -376,6 +390,12 @@ int iupStrFindMnemonic(const char* str);
  * \ingroup str */
 IUP_EXPORTI int iupStrCompare(const char* str1, const char* str2, int casesensitive, int utf8);
 
+/** Builds a collation key for the string, so keys of two strings compared code by code
+ *  give the same order as \ref iupStrCompare. The key ends with a 0 code. \n
+ *  key must have room for at least 3*strlen(str)+1 codes. Returns the number of codes used, including the terminator.
+ * \ingroup str */
+IUP_EXPORTI int iupStrCollationKey(const char *str, unsigned short *key, int casesensitive, int utf8);
+
 /** Returns a non zero value if the two strings are equal. \n
  *  If partial=1 the compare up to a number of characters defined by the strlen of the second string. \n
  *  Case insensitive will work only for Latin-1 characters, even when using utf8=1.
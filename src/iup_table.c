@@ -1,6 +1,6 @@
 /** \file
  * \brief iupTable functions.
- * Implementation by Danny Reinhold and Antonio Scuri. 
+ * Implementation by Danny Reinhold and Antonio Scuri.
  *
  * See Copyright Notice in "iup.h"
  */
@@ -18,103 +18,94 @@
 
 /* Adjust these parameters for optimal performance and memory usage */
 static const unsigned int itable_maxTableSizeIndex = 8;
-static const unsigned int itable_hashTableSize[] = { 31, 101, 401, 1601, 4001, 8009, 16001, 32003, 64007 };
-static const unsigned int itable_resizeLimit = 2;
-static const unsigned int itable_itemGrow = 5;
+static const unsigned int itable_hashTableSize[] = { 32, 128, 512, 2048, 4096, 8192, 16384, 32768, 65536 };
+static const unsigned int itable_maxLoadNum = 3;   /* maximum load factor is 3/4, */
+static const unsigned int itable_maxLoadDen = 4;   /* counting the removed slots */
+static const unsigned int itable_rehashStep = 8;   /* old slots moved at each insert while rehashing */
+
+/* Marks a slot whose item was removed.
+ * The probe sequence must continue over it.
+ */
+static char itable_removedKey;
+#define ITABLE_REMOVED ((const char*)&itable_removedKey)
 
 /* Iteration context.
  */
 typedef struct _ItableContext
 {
-  unsigned int entryIndex;  /* index at the Itable::entries array */
-  unsigned int itemIndex;   /* index at the ItableEntry::items array */
+  unsigned int oldSlots;   /* 1 if iterating the old slots array (rehash in progress) */
+  unsigned int slotIndex;  /* index at the slots array */
 } ItableContext;
 
-/* A key of an item.
+/* An item in the hash table.
+ * The table uses open addressing,
+ * so items are stored directly in the slots array.
+ * An empty slot has keyStr==NULL.
  * To avoid lots of string comparisions we store
- * a keyindex as an integer.
- * To find a key in an item list we only have to
- * do integer comparisions.
- * Additionally the key itself is stored in
- * keyStr. In a string indexed hashtable this is
+ * the full key hash as an integer,
+ * the key string is compared only when the hashes are equal.
+ * In a string indexed hashtable keyStr is
  * a duplicated string, in a pointer indexed hash table
- * this is simply the pointer (in this case keyIndex
- * and keyStr are equal).
-*/
-typedef struct _ItableKey
-{
-  unsigned long keyIndex;  /* the secondary hash number */
-  const char   *keyStr;
-}
-ItableKey;
-
-/* An item in the hash table.
- * Such an item is stored in the item list of
- * an entry.
+ * this is simply the pointer.
  */
 typedef struct _ItableItem
 {
+  const char   *keyStr;
+  void         *value;
+  unsigned int  keyHash;
   Itable_Types  itemType;
-  ItableKey     key;
-  void*         value;
 }
 ItableItem;
 
-/* An entry in the hash table.
- * An entry is chosen by an index in the hash table
- * and contains a list of items.
- * The number of items in this list is stored
- * in nextItemIndex.
- * size is the current size of the items array.
+/* A set of slots.
+ * size is always a power of 2, so mask = size-1
+ * is used instead of the % operator.
+ * used counts the valid items and also the removed slots.
  */
-typedef struct _ItableEntry
+typedef struct _ItableSlots
 {
-  unsigned int  nextItemIndex;
-  unsigned int  itemsSize;
-  ItableItem*   items;
+  unsigned int  size;
+  unsigned int  mask;
+  unsigned int  count;
+  unsigned int  used;
+  ItableItem   *items;
 }
-ItableEntry;
-
+ItableSlots;
 
 /* A hash table.
- * entries is an array of entries. Select an
- * entry by its index.
- * size is the number of entries in the hash table...
+ * When the table grows a new slots array is allocated
+ * and the old items are moved incrementally at each insert,
+ * so no single iupTableSet pays for the whole rehash.
+ * While rehashing, items can be in slots or in oldSlots.
  */
 struct _Itable
 {
-  unsigned int         entriesSize;
-  unsigned int         numberOfEntries;
-  unsigned int         tableSizeIndex;  /* index into itable_hashTableSize array */
   Itable_IndexTypes    indexType;  /* type of the index: string or pointer. */
-  ItableEntry          *entries;
+  ItableSlots          slots;
+  ItableSlots          oldSlots;   /* oldSlots.items!=NULL while rehashing */
+  unsigned int         rehashIndex;  /* next index at oldSlots to be moved */
   ItableContext        context;
 };
 
 
 /* Prototypes of private functions */
 
-static void iTableFreeItemArray(Itable_IndexTypes indexType, unsigned int nextFreeIndex, 
-                                                            ItableItem *items);
-static unsigned int iTableGetEntryIndex(Itable *it, const char *key, unsigned long *keyIndex);
-static unsigned int iTableFindItem(Itable *it, const char *key, ItableEntry **entry, 
-                                                          unsigned int *itemIndex,
-                                                          unsigned long *keyIndex);
-static unsigned int iTableResize(Itable *it);
-static void iTableAdd(Itable *it, ItableKey *key, void *value, Itable_Types itemType);
-static void iTableUpdateArraySize(ItableEntry *entry);   
+static unsigned int iTableGetKeyHash(Itable *it, const char *key);
+static ItableItem* iTableFindItem(Itable *it, const char *key, unsigned int keyHash, unsigned int *oldSlots);
+static ItableItem* iTableInsertSlot(ItableSlots *slots, unsigned int keyHash);
+static int iTableSlotsInit(ItableSlots *slots, unsigned int size);
+static void iTableSlotsFree(Itable_IndexTypes indexType, ItableSlots *slots);
+static void iTableResize(Itable *it);
+static void iTableRehashStep(Itable *it, unsigned int count);
 
 #ifdef DEBUGTABLE
 static void iTableShowStatistics(Itable *it);
-static void iTableCheckDuplicated(ItableItem *item, unsigned int nextItemIndex, 
-                                              const char *key, 
-                                              unsigned long keyIndex);
 #endif
 
 
 Itable *iupTableCreate(Itable_IndexTypes indexType)
 {
-  return iupTableCreateSized(indexType, 1);  /* 101 shows to be a better start for IUP */
+  return iupTableCreateSized(indexType, 1);  /* 128 shows to be a better start for IUP */
 }
 
 
@@ -125,53 +116,45 @@ Itable *iupTableCreateSized(Itable_IndexTypes indexType, unsigned int initialSiz
   if (!it)
     return 0;
 
+  memset(it, 0, sizeof(Itable));
+
   if (initialSizeIndex > itable_maxTableSizeIndex)
     initialSizeIndex = itable_maxTableSizeIndex;
 
-  it->entriesSize    = itable_hashTableSize[initialSizeIndex];
-  it->tableSizeIndex  = initialSizeIndex;
-  it->numberOfEntries = 0;
-  it->indexType       = indexType;
+  it->indexType = indexType;
 
-  it->entries = (ItableEntry *)malloc(it->entriesSize * sizeof(ItableEntry));
-  iupASSERT(it->entries!=NULL);
-  if (!it->entries)
+  if (!iTableSlotsInit(&(it->slots), itable_hashTableSize[initialSizeIndex]))
   {
     free(it);
     return 0;
   }
 
-  memset(it->entries, 0, it->entriesSize * sizeof(ItableEntry));
-
-  it->context.entryIndex = (unsigned int)-1;
-  it->context.itemIndex = (unsigned int)-1;
+  it->context.slotIndex = (unsigned int)-1;
 
   return it;
 }
 
 void iupTableClear(Itable *it)
 {
-  unsigned int i;
-
   if (!it)
     return;
 
-  for (i = 0; i < it->entriesSize; i++)
+  if (it->oldSlots.items)
   {
-    ItableEntry *entry = &(it->entries[i]);
-    if (entry->items)
-    {
-      iTableFreeItemArray(it->indexType, entry->nextItemIndex, entry->items);
-      entry->items = NULL;
-    }
+    iTableSlotsFree(it->indexType, &(it->oldSlots));
+    free(it->oldSlots.items);
+    memset(&(it->oldSlots), 0, sizeof(ItableSlots));
   }
 
-  it->numberOfEntries = 0;
+  iTableSlotsFree(it->indexType, &(it->slots));
 
-  memset(it->entries, 0, it->entriesSize * sizeof(ItableEntry));
+  memset(it->slots.items, 0, it->slots.size * sizeof(ItableItem));
+  it->slots.count = 0;
+  it->slots.used = 0;
+  it->rehashIndex = 0;
 
-  it->context.entryIndex = (unsigned int)-1;
-  it->context.itemIndex = (unsigned int)-1;
+  it->context.oldSlots = 0;
+  it->context.slotIndex = (unsigned int)-1;
 }
 
 void iupTableDestroy(Itable *it)
@@ -185,10 +168,10 @@ void iupTableDestroy(Itable *it)
 
   iupTableClear(it);
 
-  if (it->entries)
+  if (it->slots.items)
   {
-    free(it->entries);
-    it->entries = NULL;
+    free(it->slots.items);
+    it->slots.items = NULL;
   }
 
   free(it);
@@ -199,7 +182,7 @@ int iupTableCount(Itable *it)
   iupASSERT(it!=NULL);
   if (!it)
     return 0;
-  return it->numberOfEntries;
+  return (int)(it->slots.count + it->oldSlots.count);
 }
 
 void iupTableSetFunc(Itable *it, const char *key, Ifunc func)
@@ -207,148 +190,148 @@ void iupTableSetFunc(Itable *it, const char *key, Ifunc func)
   iupTableSet(it, key, (void*)func, IUPTABLE_FUNCPOINTER); /* type cast from function pointer to void* */
 }
 
-void iupTableSet(Itable *it, const char *key, void *value, Itable_Types itemType)
+static void iTableSetItemValue(ItableItem *item, void *value, Itable_Types itemType)
 {
-  unsigned int  itemIndex,
-                itemFound;
-  unsigned long keyIndex;
-  ItableEntry  *entry;
-  ItableItem   *item;
-  void         *v;
-
-  iupASSERT(it!=NULL);
-  iupASSERT(key!=NULL);
-  if (!it || !key || !value)
-    return;
+  void *v;
 
-  itemFound = iTableFindItem(it, key, &entry, &itemIndex, &keyIndex);
+  if (itemType == IUPTABLE_STRING && item->itemType == IUPTABLE_STRING)
+  {
+    /* this will avoid to free + alloc of a new pointer */
+    if (iupStrEqual((char*)item->value, (char*)value))
+      return;
+  }
 
-#ifdef DEBUGTABLE
-  if (it->indexType == IUPTABLE_STRINGINDEXED)
-    iTableCheckDuplicated(&(entry->items[0]), entry->nextItemIndex, key, keyIndex);
-#endif
+  if (itemType == IUPTABLE_STRING)
+    v = iupStrDup(value);
+  else
+    v = value;
 
-  if (!itemFound)
-  {
-    /* create a new item */
+  if (item->itemType == IUPTABLE_STRING)
+    free(item->value);
 
-    /* first check if the hash table has to be reorganized */
-    if (iTableResize(it))
-    {
-      /* We have to search for the entry again, since it may
-       * have been moved by iTableResize. */
-      iTableFindItem(it, key, &entry, &itemIndex, &keyIndex);
-    }
+  item->value    = v;
+  item->itemType = itemType;
+}
 
-    iTableUpdateArraySize(entry);
+void iupTableSet(Itable *it, const char *key, void *value, Itable_Types itemType)
+{
+  iupASSERT(it!=NULL);
+  iupASSERT(key!=NULL);
+  if (!it || !key || !value)
+    return;
 
-    /* add the item at the end of the item array */
-    if (itemType == IUPTABLE_STRING)
-      v = iupStrDup(value);
-    else
-      v = value;
+  iupTableSetHashed(it, key, iTableGetKeyHash(it, key), value, itemType);
+}
 
-    item = &(entry->items[entry->nextItemIndex]);
+void iupTableSetHashed(Itable *it, const char *key, unsigned int keyHash, void *value, Itable_Types itemType)
+{
+  unsigned int  oldSlots;
+  ItableItem   *item;
 
-    item->itemType     = itemType;
-    item->key.keyIndex = keyIndex;
-    item->key.keyStr   = it->indexType == IUPTABLE_STRINGINDEXED? iupStrDup(key) : key;
-    item->value        = v;
+  iupASSERT(it!=NULL);
+  iupASSERT(key!=NULL);
+  if (!it || !key || !value)
+    return;
 
-    entry->nextItemIndex++;
-    it->numberOfEntries++;
-  }
-  else
+  item = iTableFindItem(it, key, keyHash, &oldSlots);
+  if (item)
   {
     /* change an existing item */
-    void *v;
-    item = &(entry->items[itemIndex]);
+    iTableSetItemValue(item, value, itemType);
+    return;
+  }
 
-    if (itemType == IUPTABLE_STRING && item->itemType == IUPTABLE_STRING)
-    {
-      /* this will avoid to free + alloc of a new pointer */
-      if (iupStrEqual((char*)item->value, (char*)value))
-        return;
-    }
+  /* create a new item */
 
-    if (itemType == IUPTABLE_STRING)
-      v = iupStrDup(value);
-    else
-      v = value;
+  /* first move some items from the old slots,
+     then check if the hash table has to be reorganized */
+  if (it->oldSlots.items)
+    iTableRehashStep(it, itable_rehashStep);
 
-    if (item->itemType == IUPTABLE_STRING)
-      free(item->value);
+  if ((it->slots.used + 1) * itable_maxLoadDen > it->slots.size * itable_maxLoadNum)
+    iTableResize(it);
 
-    item->value    = v;
-    item->itemType = itemType;
-  }
+  item = iTableInsertSlot(&(it->slots), keyHash);
+  if (!item->keyStr)
+    it->slots.used++;  /* a removed slot is already counted */
+
+  item->itemType = itemType;
+  item->keyHash  = keyHash;
+  item->keyStr   = it->indexType == IUPTABLE_STRINGINDEXED? iupStrDup(key) : key;
+  item->value    = itemType == IUPTABLE_STRING? iupStrDup(value): value;
+
+  it->slots.count++;
 }
 
-static void iTableRemoveItem(Itable *it, ItableEntry *entry, unsigned int itemIndex)
+static void iTableRemoveItem(Itable *it, ItableItem *item, unsigned int oldSlots)
 {
-  ItableItem   *item;
-  unsigned int  i;
-
-  item = &(entry->items[itemIndex]);
+  ItableSlots *slots = oldSlots? &(it->oldSlots): &(it->slots);
 
   if (it->indexType == IUPTABLE_STRINGINDEXED)
-  {
-    free((void *)item->key.keyStr);
-    item->key.keyStr = NULL;
-  }
+    free((void *)item->keyStr);
 
   if (item->itemType == IUPTABLE_STRING)
-  {
     free(item->value);
-    item->value = NULL;
-  }
-
-  /* re-order the remaining items */
-  for (i = itemIndex; i < entry->nextItemIndex-1; i++)
-    entry->items[i] = entry->items[i+1];
 
-  /* clear the released item */
-  memset(entry->items + entry->nextItemIndex-1, 0, sizeof (ItableItem));
+  /* the slot is not released,
+     so the probe sequence of other items is not broken
+     and the iteration is not affected. */
+  item->keyStr = ITABLE_REMOVED;
+  item->value = NULL;
 
-  entry->nextItemIndex--;
-  it->numberOfEntries--;
+  slots->count--;
 }
 
 void iupTableRemove(Itable *it, const char *key)
 {
-  unsigned int itemFound,
-               itemIndex;
-  unsigned long keyIndex;
-  ItableEntry  *entry;
+  iupASSERT(it!=NULL);
+  iupASSERT(key!=NULL);
+  if (!it || !key)
+    return;
+
+  iupTableRemoveHashed(it, key, iTableGetKeyHash(it, key));
+}
+
+void iupTableRemoveHashed(Itable *it, const char *key, unsigned int keyHash)
+{
+  unsigned int oldSlots;
+  ItableItem  *item;
 
   iupASSERT(it!=NULL);
   iupASSERT(key!=NULL);
   if (!it || !key)
     return;
 
-  itemFound = iTableFindItem(it, key, &entry, &itemIndex, &keyIndex);
-  if (itemFound)
-    iTableRemoveItem(it, entry, itemIndex);
+  item = iTableFindItem(it, key, keyHash, &oldSlots);
+  if (item)
+    iTableRemoveItem(it, item, oldSlots);
 }
 
 void *iupTableGet(Itable *it, const char *key)
 {
-  unsigned int  itemFound,
-                itemIndex;
-  unsigned long keyIndex;
-  ItableEntry  *entry;
-  void         *value = 0;
+  iupASSERT(it!=NULL);
+  iupASSERT(key!=NULL);
+  if (!it || !key)
+    return 0;
+
+  return iupTableGetHashed(it, key, iTableGetKeyHash(it, key));
+}
+
+void *iupTableGetHashed(Itable *it, const char *key, unsigned int keyHash)
+{
+  unsigned int oldSlots;
+  ItableItem  *item;
 
   iupASSERT(it!=NULL);
   iupASSERT(key!=NULL);
   if (!it || !key)
     return 0;
 
-  itemFound = iTableFindItem(it, key, &entry, &itemIndex, &keyIndex);
-  if (itemFound)
-    value = entry->items[itemIndex].value;
+  item = iTableFindItem(it, key, keyHash, &oldSlots);
+  if (item)
+    return item->value;
 
-  return value;
+  return 0;
 }
 
 Ifunc iupTableGetFunc(Itable *it, const char *key, void **value)
@@ -363,180 +346,157 @@ Ifunc iupTableGetFunc(Itable *it, const char *key, void **value)
 
 void *iupTableGetTyped(Itable *it, const char *key, Itable_Types *itemType)
 {
-  unsigned int  itemFound,
-                itemIndex;
-  unsigned long keyIndex;
-  ItableEntry  *entry;
-  void         *value = 0;
+  unsigned int oldSlots;
+  ItableItem  *item;
 
   iupASSERT(it!=NULL);
   iupASSERT(key!=NULL);
   if (!it || !key)
     return 0;
 
-  itemFound = iTableFindItem(it, key, &entry, &itemIndex, &keyIndex);
-  if (itemFound)
+  item = iTableFindItem(it, key, iTableGetKeyHash(it, key), &oldSlots);
+  if (item)
   {
-    value = entry->items[itemIndex].value;
-    if (itemType) 
-      *itemType = entry->items[itemIndex].itemType;
+    if (itemType)
+      *itemType = item->itemType;
+    return item->value;
   }
 
-  return value;
+  return 0;
 }
 
-void iupTableSetCurr(Itable *it, void* value, Itable_Types itemType)
+static ItableItem* iTableGetCurrItem(Itable *it)
 {
-  void* v;
+  ItableSlots *slots;
   ItableItem *item;
 
-  iupASSERT(it!=NULL);
-  if (!it || it->context.entryIndex == (unsigned int)-1
-         || it->context.itemIndex == (unsigned int)-1)
-    return;
+  if (it->context.slotIndex == (unsigned int)-1)
+    return NULL;
 
-  item = &(it->entries[it->context.entryIndex].items[it->context.itemIndex]);
+  slots = it->context.oldSlots? &(it->oldSlots): &(it->slots);
+  if (!slots->items || it->context.slotIndex >= slots->size)
+    return NULL;
 
-  if (itemType == IUPTABLE_STRING && item->itemType == IUPTABLE_STRING)
-  {
-    /* this will avoid to free + alloc of a new pointer */
-    if (iupStrEqual((char*)item->value, (char*)value))
-      return;
-  }
+  item = &(slots->items[it->context.slotIndex]);
+  if (!item->keyStr || item->keyStr == ITABLE_REMOVED)
+    return NULL;
 
-  if (itemType == IUPTABLE_STRING)
-    v = iupStrDup(value);
-  else
-    v = value;
+  return item;
+}
 
-  if (item->itemType == IUPTABLE_STRING)
-    free(item->value);
+void iupTableSetCurr(Itable *it, void* value, Itable_Types itemType)
+{
+  ItableItem *item;
 
-  item->value    = v;
-  item->itemType = itemType;
+  iupASSERT(it!=NULL);
+  if (!it)
+    return;
+
+  item = iTableGetCurrItem(it);
+  if (!item)
+    return;
 
+  iTableSetItemValue(item, value, itemType);
 }
 
 void* iupTableGetCurr(Itable *it)
 {
+  ItableItem *item;
+
   iupASSERT(it!=NULL);
-  if (!it || it->context.entryIndex == (unsigned int)-1
-         || it->context.itemIndex == (unsigned int)-1)
+  if (!it)
     return 0;
 
-  return it->entries[it->context.entryIndex].items[it->context.itemIndex].value;
+  item = iTableGetCurrItem(it);
+  if (!item)
+    return 0;
+
+  return item->value;
 }
 
 int iupTableGetCurrType(Itable *it)
 {
+  ItableItem *item;
+
   iupASSERT(it!=NULL);
-  if (!it || it->context.entryIndex == (unsigned int)-1
-         || it->context.itemIndex == (unsigned int)-1)
+  if (!it)
+    return -1;
+
+  item = iTableGetCurrItem(it);
+  if (!item)
     return -1;
 
-  return it->entries[it->context.entryIndex].items[it->context.itemIndex].itemType;
+  return item->itemType;
 }
 
-char *iupTableFirst(Itable *it)
+static char *iTableNextItem(Itable *it, unsigned int oldSlots, unsigned int slotIndex)
 {
-  unsigned int entryIndex;
-
-  iupASSERT(it!=NULL);
-  if (!it)
-    return 0;
-
-  it->context.entryIndex = (unsigned int)-1;
-  it->context.itemIndex = (unsigned int)-1;
-
-  /* find the first used entry */
-  for (entryIndex = 0; entryIndex < it->entriesSize; entryIndex++)
+  /* iterate the old slots first (if any), then the current slots */
+  for (;;)
   {
-    if (it->entries[entryIndex].nextItemIndex > 0)
+    ItableSlots *slots = oldSlots? &(it->oldSlots): &(it->slots);
+
+    if (slots->items)
     {
-      it->context.entryIndex = entryIndex;
-      it->context.itemIndex = 0;
-      return (char*)it->entries[entryIndex].items[0].key.keyStr;
+      for (; slotIndex < slots->size; slotIndex++)
+      {
+        const char* keyStr = slots->items[slotIndex].keyStr;
+        if (keyStr && keyStr != ITABLE_REMOVED)
+        {
+          it->context.oldSlots = oldSlots;
+          it->context.slotIndex = slotIndex;
+          return (char*)keyStr;
+        }
+      }
     }
+
+    if (!oldSlots)
+      break;
+
+    oldSlots = 0;
+    slotIndex = 0;
   }
 
+  it->context.oldSlots = 0;
+  it->context.slotIndex = (unsigned int)-1;
   return 0;
 }
 
+char *iupTableFirst(Itable *it)
+{
+  iupASSERT(it!=NULL);
+  if (!it)
+    return 0;
+
+  return iTableNextItem(it, 1, 0);
+}
 
 char *iupTableNext(Itable *it)
 {
-  unsigned int entryIndex;
-
   iupASSERT(it!=NULL);
-  if (!it || it->context.entryIndex == (unsigned int)-1
-         || it->context.itemIndex == (unsigned int)-1)
+  if (!it || it->context.slotIndex == (unsigned int)-1)
     return 0;
 
-  if (it->context.itemIndex + 1 < it->entries[it->context.entryIndex].nextItemIndex)
-  {
-    /* key in the current entry */
-    it->context.itemIndex++;
-    return (char*)it->entries[it->context.entryIndex].items[it->context.itemIndex].key.keyStr;
-  }
-  else
-  {
-    /* find the next used entry */
-    for (entryIndex = it->context.entryIndex+1; entryIndex < it->entriesSize; entryIndex++)
-    {
-      if (it->entries[entryIndex].nextItemIndex > 0)
-      {
-        it->context.entryIndex = entryIndex;
-        it->context.itemIndex = 0;
-        return (char*)it->entries[entryIndex].items[0].key.keyStr;
-      }
-    }
-  }
-
-  return 0;
+  return iTableNextItem(it, it->context.oldSlots, it->context.slotIndex + 1);
 }
 
 char *iupTableRemoveCurr(Itable *it)
 {
-  char* key;
-  unsigned int entryIndex;
-  ItableEntry  *entry;
-  unsigned int itemIndex;
+  ItableItem *item;
 
   iupASSERT(it!=NULL);
-  if (!it || it->context.entryIndex == (unsigned int)-1
-         || it->context.itemIndex == (unsigned int)-1)
+  if (!it)
     return 0;
 
-  entry = &it->entries[it->context.entryIndex];
-  itemIndex = it->context.itemIndex;
-
-  if (it->context.itemIndex + 1 < it->entries[it->context.entryIndex].nextItemIndex)
-  {
-    /* key in the current entry */
-    it->context.itemIndex++;
-    key = (char*)it->entries[it->context.entryIndex].items[it->context.itemIndex].key.keyStr;
-
-    iTableRemoveItem(it, entry, itemIndex);
-    return key;
-  }
-  else
-  {
-    /* find the next used entry */
-    for (entryIndex = it->context.entryIndex+1; entryIndex < it->entriesSize; entryIndex++)
-    {
-      if (it->entries[entryIndex].nextItemIndex > 0)
-      {
-        it->context.entryIndex = entryIndex;
-        it->context.itemIndex = 0;
-        key = (char*)it->entries[entryIndex].items[0].key.keyStr;
+  item = iTableGetCurrItem(it);
+  if (!item)
+    return 0;
 
-        iTableRemoveItem(it, entry, itemIndex);
-        return key;
-       }
-    }
-  }
+  /* items are not moved when removed,
+     so the iteration can continue from the same position */
+  iTableRemoveItem(it, item, it->context.oldSlots);
 
-  return 0;
+  return iupTableNext(it);
 }
 
 
@@ -545,213 +505,227 @@ char *iupTableRemoveCurr(Itable *it)
 /********************************************/
 
 
-static void iTableFreeItemArray(Itable_IndexTypes indexType, unsigned int nextFreeIndex, ItableItem *items)
+static int iTableSlotsInit(ItableSlots *slots, unsigned int size)
+{
+  slots->items = (ItableItem *)calloc(size, sizeof(ItableItem));
+  iupASSERT(slots->items!=NULL);
+  if (!slots->items)
+    return 0;
+
+  slots->size  = size;
+  slots->mask  = size - 1;
+  slots->count = 0;
+  slots->used  = 0;
+  return 1;
+}
+
+static void iTableSlotsFree(Itable_IndexTypes indexType, ItableSlots *slots)
 {
   unsigned int i;
+  ItableItem *item;
 
-  /* Used only in iupTableClear */
+  /* Used only in iupTableClear.
+     Releases only the contents, the array is not released. */
 
-  iupASSERT(items!=NULL);
-  if (!items)
+  iupASSERT(slots->items!=NULL);
+  if (!slots->items)
     return;
 
-  if (indexType == IUPTABLE_STRINGINDEXED)
+  item = slots->items;
+  for (i = 0; i < slots->size; i++, item++)
   {
-    for (i = 0; i < nextFreeIndex; i++)
-    {
-      free((void *)(items[i].key.keyStr));
-      items[i].key.keyStr = NULL;
-    }
-  }
+    if (!item->keyStr || item->keyStr == ITABLE_REMOVED)
+      continue;
 
-  for (i = 0; i < nextFreeIndex; i++)
-  {
-    if (items[i].itemType == IUPTABLE_STRING)
-    {
-      free(items[i].value);
-      items[i].value = NULL;
-    }
-  }
+    if (indexType == IUPTABLE_STRINGINDEXED)
+      free((void *)item->keyStr);
 
-  free(items);
+    if (item->itemType == IUPTABLE_STRING)
+      free(item->value);
+  }
 }
 
-
-static unsigned int iTableGetEntryIndex(Itable *it, const char *key, unsigned long *keyIndex)
+static unsigned int iTableMixHash(register unsigned int h)
 {
-  if (it->indexType == IUPTABLE_STRINGINDEXED)
-  {
-    register unsigned int checksum = 0;
-
-/*     Orignal version
-    unsigned int i;
-    for (i = 0; key[i]; i++)
-      checksum = checksum*31 + key[i];  
-*/
-
-    while (*key)
-    {
-      checksum *= 31;
-      checksum += *key;
-      key++;
-    }
+  /* final mix (from MurmurHash3),
+     since the table index uses only the lower bits */
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+  return h;
+}
 
-    *keyIndex = checksum;            /* this could NOT be dependent from table size */
-  }
-  else
+unsigned int iupTableGetStringHash(const char *key)
+{
+  /* FNV-1a, much better distribution than the original *31 loop,
+     specially for keys that differ only at the end like "BGCOLOR12:3" */
+  register const unsigned char* k = (const unsigned char*)key;
+  register unsigned int h = 2166136261u;
+  while (*k)
   {
-    /* Pointer indexed */
-    *keyIndex = (unsigned long)key;   /* this could NOT be dependent from table size */
+    h ^= *k;
+    h *= 16777619u;
+    k++;
   }
 
-  return (unsigned int)((*keyIndex) % it->entriesSize);
+  return iTableMixHash(h);
 }
 
-#ifdef DEBUGTABLE
-static void iTableCheckDuplicated(ItableItem *item, unsigned int nextItemIndex, const char *key, 
-                                                                          unsigned long keyIndex)
+static unsigned int iTableGetKeyHash(Itable *it, const char *key)
 {
-  unsigned int i;
-  for (i = 0; i < nextItemIndex; i++, item++)
+  if (it->indexType == IUPTABLE_STRINGINDEXED)
+    return iupTableGetStringHash(key);
+  else
   {
-    if (!iupStrEqual((char*)item->key.keyStr, (char*)key) && 
-        item->key.keyIndex == keyIndex)
-    {
-      fprintf(stderr, "#ERROR# Duplicated key index (%ld): %s %s \n", keyIndex, 
-                                                                     (char*)item->key.keyStr, 
-                                                                     (char*)key);
-    }
+    /* Pointer indexed,
+       fold the upper bits of 64 bits pointers */
+    size_t p = (size_t)key;
+    unsigned int h = (unsigned int)p;
+    if (sizeof(size_t) > sizeof(unsigned int))
+      h ^= (unsigned int)((p >> 16) >> 16);
+    return iTableMixHash(h);
   }
 }
-#endif
 
-static unsigned int iTableFindItem(Itable *it, const char *key, ItableEntry **entry, 
-                                                          unsigned int *itemIndex,
-                                                          unsigned long *keyIndex)
+static int iTableKeyEqual(const char *keyStr, const char *key)
 {
-  unsigned int entryIndex,
-               itemFound,
-               i;
-  ItableItem  *item;
-
-  entryIndex = iTableGetEntryIndex(it, key, keyIndex);
-
-  *entry = &(it->entries[entryIndex]);
-
-  item = &((*entry)->items[0]);
-  for (i = 0; i < (*entry)->nextItemIndex; i++, item++)
+  /* same as strcmp()==0, but inline since it is called at every successful search */
+  while (*keyStr == *key)
   {
-    if (it->indexType == IUPTABLE_STRINGINDEXED)
-      itemFound = item->key.keyIndex == *keyIndex; 
-/*    itemFound = iupStrEqual(item->key.keyStr, key);  This is the original safe version */
-    else
-      itemFound = item->key.keyStr == key;
-
-    if (itemFound)
-    {
-      *itemIndex = i;
+    if (*keyStr == 0)
       return 1;
-    }
+    keyStr++;
+    key++;
   }
-
-  /* if not found "entry", "itemIndex" and "keyIndex" will have the new insert position. */
-
-  *itemIndex = i;
   return 0;
 }
 
-static void iTableUpdateArraySize(ItableEntry *entry)
+static ItableItem* iTableFindSlotItem(Itable *it, ItableSlots *slots, const char *key, unsigned int keyHash)
 {
-  if (entry->nextItemIndex >= entry->itemsSize)
-  {
-    /* we have to expand the item array */
-    unsigned int newSize;
+  unsigned int i = keyHash & slots->mask;
+  ItableItem *item;
 
-    newSize = entry->itemsSize + itable_itemGrow;
+  /* there is always at least one empty slot, so the loop will end */
+  for (;;)
+  {
+    item = &(slots->items[i]);
 
-    entry->items = (ItableItem *)realloc(entry->items, newSize * sizeof(ItableItem));
-    iupASSERT(entry->items!=NULL);
-    if (!entry->items)
-      return;
+    if (!item->keyStr)
+      return NULL;
 
-    memset(entry->items + entry->itemsSize, 0, itable_itemGrow * sizeof(ItableItem));
+    if (item->keyStr != ITABLE_REMOVED)
+    {
+      if (it->indexType == IUPTABLE_STRINGINDEXED)
+      {
+        /* the full hash is compared first,
+           the string is compared only to avoid a wrong match when two keys collide */
+        if (item->keyHash == keyHash && iTableKeyEqual(item->keyStr, key))
+          return item;
+      }
+      else if (item->keyStr == key)
+        return item;
+    }
 
-    entry->itemsSize = newSize;
+    i = (i + 1) & slots->mask;
   }
 }
 
-static void iTableAdd(Itable *it, ItableKey *key, void *value, Itable_Types itemType)
+static ItableItem* iTableFindItem(Itable *it, const char *key, unsigned int keyHash, unsigned int *oldSlots)
 {
-  unsigned int entryIndex;
-  unsigned long keyIndex;
-  ItableEntry *entry;
-  ItableItem* item;
-
-  entryIndex = iTableGetEntryIndex(it, key->keyStr, &keyIndex);
-
-  entry = &(it->entries[entryIndex]);
-  iTableUpdateArraySize(entry);
+  ItableItem *item = iTableFindSlotItem(it, &(it->slots), key, keyHash);
+  if (item)
+  {
+    *oldSlots = 0;
+    return item;
+  }
 
-  /* add a new item at the end of the item array without duplicating memory. */
-  item = &(entry->items[entry->nextItemIndex]);
-  item->itemType     = itemType;
-  item->key.keyIndex = keyIndex;
-  item->key.keyStr   = key->keyStr;
-  item->value        = value;
+  if (it->oldSlots.items)
+  {
+    item = iTableFindSlotItem(it, &(it->oldSlots), key, keyHash);
+    if (item)
+    {
+      *oldSlots = 1;
+      return item;
+    }
+  }
 
-  entry->nextItemIndex++;
-  it->numberOfEntries++;
+  return NULL;
 }
 
-static unsigned int iTableResize(Itable *it)
+static ItableItem* iTableInsertSlot(ItableSlots *slots, unsigned int keyHash)
 {
-  unsigned int   newSizeIndex,
-                 entryIndex,
-                 i;
-  Itable        *newTable;
-  ItableEntry   *entry;
-  ItableItem    *item;
+  /* linear probing, reuses the first empty or removed slot */
+  unsigned int i = keyHash & slots->mask;
+  ItableItem *item;
 
-  /* check if we do not need to resize the hash table */
-  if (it->numberOfEntries == 0 ||
-     it->tableSizeIndex >= itable_maxTableSizeIndex ||
-     it->entriesSize / it->numberOfEntries >= itable_resizeLimit)
-    return 0;
+  for (;;)
+  {
+    item = &(slots->items[i]);
+    if (!item->keyStr || item->keyStr == ITABLE_REMOVED)
+      return item;
+    i = (i + 1) & slots->mask;
+  }
+}
 
-  /* create a new hash table and copy the contents of
-   * the current table into the new one
-   */
-  newSizeIndex = it->tableSizeIndex + 1;
-  newTable = iupTableCreateSized(it->indexType, newSizeIndex);
+static void iTableRehashStep(Itable *it, unsigned int count)
+{
+  ItableSlots *oldSlots = &(it->oldSlots);
 
-  for (entryIndex = 0; entryIndex < it->entriesSize; entryIndex++)
+  /* move at most count slots from the old array to the current array */
+  while (count && it->rehashIndex < oldSlots->size)
   {
-    entry = &(it->entries[entryIndex]);
-
-    if (entry->items)
+    ItableItem *item = &(oldSlots->items[it->rehashIndex]);
+    if (item->keyStr && item->keyStr != ITABLE_REMOVED)
     {
-      item = &(entry->items[0]);
+      ItableItem *newItem = iTableInsertSlot(&(it->slots), item->keyHash);
+      if (!newItem->keyStr)
+        it->slots.used++;
+      *newItem = *item;
+      it->slots.count++;
+
+      /* keep the probe sequence of the remaining old items */
+      item->keyStr = ITABLE_REMOVED;
+      item->value = NULL;
+      oldSlots->count--;
+    }
 
-      for (i = 0; i < entry->nextItemIndex; i++, item++)
-      {
-        iTableAdd(newTable, &(item->key), item->value, item->itemType);
-      }     
+    it->rehashIndex++;
+    count--;
+  }
 
-      free(entry->items);
-      entry->items = NULL;
-    }
+  if (it->rehashIndex == oldSlots->size)
+  {
+    free(oldSlots->items);
+    memset(oldSlots, 0, sizeof(ItableSlots));
+    it->rehashIndex = 0;
   }
+}
 
-  free(it->entries);
+static void iTableResize(Itable *it)
+{
+  unsigned int newSize;
+  ItableSlots newSlots;
 
-  it->entriesSize    = newTable->entriesSize;
-  it->tableSizeIndex  = newTable->tableSizeIndex;
-  it->numberOfEntries = newTable->numberOfEntries;
-  it->entries         = newTable->entries;
+  /* an unfinished rehash must be completed first.
+     Should not happen because the new slots array starts at most half full. */
+  if (it->oldSlots.items)
+    iTableRehashStep(it, (unsigned int)-1);
 
-  free(newTable);
+  /* the new array must be at most half full,
+     if there are too many removed slots it will keep the same size */
+  newSize = it->slots.size;
+  while ((it->slots.count + 1) * 2 > newSize)
+    newSize *= 2;
 
-  return 1;
+  if (!iTableSlotsInit(&newSlots, newSize))
+    return;
+
+  /* the current items will be moved incrementally */
+  it->oldSlots = it->slots;
+  it->slots = newSlots;
+  it->rehashIndex = 0;
 }
 
 #ifdef DEBUGTABLE
@@ -759,11 +733,11 @@ static void iTableShowStatistics(Itable *it)
 {
   unsigned int nofSlots        = 0;
   unsigned int nofKeys         = 0;
-  double optimalNofKeysPerSlot = 0.0;
-  unsigned int nofSlotsWithMoreKeys = 0;
-  unsigned int nofSlotsWithLessKeys = 0;
+  unsigned int nofRemoved      = 0;
+  unsigned int maxProbe        = 0;
+  double sumProbe              = 0;
+  unsigned int i;
 
-  unsigned int entryIndex;
   fprintf(stderr, "\n--- HASH TABLE STATISTICS ---\n");
   if (!it)
   {
@@ -771,25 +745,26 @@ static void iTableShowStatistics(Itable *it)
     return;
   }
 
-  nofSlots = it->entriesSize;
-  nofKeys  = it->numberOfEntries;
-  optimalNofKeysPerSlot = (double)nofKeys / (double)nofSlots;
+  nofSlots = it->slots.size;
+  nofKeys  = it->slots.count;
+  nofRemoved = it->slots.used - it->slots.count;
 
-  for (entryIndex = 0; entryIndex < it->entriesSize; entryIndex++)
+  for (i = 0; i < it->slots.size; i++)
   {
-    ItableEntry *entry = &(it->entries[entryIndex]);
-
-    if (entry->nextItemIndex > optimalNofKeysPerSlot + 3)
-      nofSlotsWithMoreKeys++;
-    else if (entry->nextItemIndex < optimalNofKeysPerSlot - 3)
-      nofSlotsWithLessKeys++;
+    ItableItem *item = &(it->slots.items[i]);
+    if (item->keyStr && item->keyStr != ITABLE_REMOVED)
+    {
+      unsigned int probe = (i - (item->keyHash & it->slots.mask)) & it->slots.mask;
+      if (probe > maxProbe) maxProbe = probe;
+      sumProbe += probe;
+    }
   }
 
   fprintf(stderr, "Number of slots: %d\n", nofSlots);
   fprintf(stderr, "Number of keys: %d\n", nofKeys);
-  fprintf(stderr, "Optimal number of keys per slot: %f\n", optimalNofKeysPerSlot);
-  fprintf(stderr, "Number of slots with much more keys: %d\n", nofSlotsWithMoreKeys);
-  fprintf(stderr, "Number of slots with far less keys: %d\n", nofSlotsWithLessKeys);
+  fprintf(stderr, "Number of removed slots: %d\n", nofRemoved);
+  fprintf(stderr, "Average probe length: %f\n", nofKeys? sumProbe / nofKeys: 0.0);
+  fprintf(stderr, "Maximum probe length: %d\n", maxProbe);
   fprintf(stderr, "\n");
 }
 #endif
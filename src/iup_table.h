@@ -56,9 +56,11 @@ IUP_EXPORTI Itable *iupTableCreate(Itable_IndexTypes indexType);
 /** Creates a hash table with the specified initial size.
  * Use this function if you expect the table to become very large.
  * initialSizeIndex is an array into the (internal) list of
- * possible hash table sizes. Currently only indexes from 0 to 8
+ * possible initial hash table sizes. Currently only indexes from 0 to 8
  * are supported. If you specify a higher value here, the maximum
- * allowed value will be used.
+ * allowed value will be used. \n
+ * The table will grow without limit, rehashing incrementally
+ * at each insert of a new key.
  * \ingroup table */
 Itable *iupTableCreateSized(Itable_IndexTypes indexType, unsigned int initialSizeIndex);
 
@@ -106,6 +108,29 @@ void *iupTableGetTyped(Itable *it, const char *key, Itable_Types *itemType);
  * \ingroup table */
 void iupTableRemove(Itable *it, const char *key);
 
+/** Returns the hash of a key for a string indexed table.
+ * The hash does not depend on the table,
+ * so it can be computed once and used with
+ * \ref iupTableSetHashed, \ref iupTableGetHashed and \ref iupTableRemoveHashed
+ * for any string indexed table.
+ * \ingroup table */
+unsigned int iupTableGetStringHash(const char *key);
+
+/** Same as \ref iupTableSet but uses a pre-computed key hash.
+ * Used only for string indexed tables.
+ * \ingroup table */
+void iupTableSetHashed(Itable *it, const char *key, unsigned int keyHash, void *value, Itable_Types itemType);
+
+/** Same as \ref iupTableGet but uses a pre-computed key hash.
+ * Used only for string indexed tables.
+ * \ingroup table */
+void *iupTableGetHashed(Itable *it, const char *key, unsigned int keyHash);
+
+/** Same as \ref iupTableRemove but uses a pre-computed key hash.
+ * Used only for string indexed tables.
+ * \ingroup table */
+void iupTableRemoveHashed(Itable *it, const char *key, unsigned int keyHash);
+
 /** Key iteration function. Returns a key.
  * To iterate over all keys call iupTableFirst at the first
  * and call iupTableNext in a loop
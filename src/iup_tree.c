@@ -235,16 +235,49 @@ int iupTreeForEach(Ihandle* ih, iupTreeNodeFunc func, void* userdata)
   return 1;
 }
 
-int iupTreeFindNodeId(Ihandle* ih, InodeHandle* node_handle)
+static void iTreeIndexSetNode(Ihandle* ih, int id)
+{
+  iupTableSet(ih->data->node_index, (const char*)ih->data->node_cache[id].node_handle, (void*)(size_t)(id + 1), IUPTABLE_POINTER);
+}
+
+static void iTreeIndexUpdate(Ihandle* ih)
 {
-  /* Unoptimized version:
+  /* ids after node_index_start were shifted in the cache, 
+     or their node handles were set directly by the driver */
   int i;
-  for (i = 0; i < ih->data->node_count; i++)
+  for (i = ih->data->node_index_start; i < ih->data->node_count; i++)
+  {
+    if (ih->data->node_cache[i].node_handle)
+      iTreeIndexSetNode(ih, i);
+  }
+
+  ih->data->node_index_start = ih->data->node_count;
+}
+
+static void iTreeIndexInvalidate(Ihandle* ih, int id)
+{
+  if (id < ih->data->node_index_start)
+    ih->data->node_index_start = id;
+}
+
+static void iTreeIndexRemoveNodes(Ihandle* ih, int id, int count)
+{
+  int i;
+  for (i = id; i < id + count; i++)
   {
-    if (ih->data->node_cache[i].node_handle == node_handle)
-      return i;
+    InodeHandle* node_handle = ih->data->node_cache[i].node_handle;
+    void* userdata = ih->data->node_cache[i].userdata;
+
+    if (node_handle)
+      iupTableRemove(ih->data->node_index, (const char*)node_handle);
+
+    if (userdata && iupTableGet(ih->data->userdata_index, (const char*)userdata) == node_handle)
+      iupTableRemove(ih->data->userdata_index, (const char*)userdata);
   }
-  */
+}
+
+static int iTreeFindNodeIdLinear(Ihandle* ih, InodeHandle* node_handle)
+{
   InodeData *node_cache = ih->data->node_cache;
   while(node_cache->node_handle != node_handle && 
         node_cache->node_handle != NULL)   /* the cache always have zeros at the end */
@@ -256,25 +289,89 @@ int iupTreeFindNodeId(Ihandle* ih, InodeHandle* node_handle)
     return -1;
 }
 
-static int iTreeFindUserDataId(Ihandle* ih, void* userdata)
+int iupTreeFindNodeId(Ihandle* ih, InodeHandle* node_handle)
 {
-  /* Unoptimized version:
-  int i;
-  for (i = 0; i < ih->data->node_count; i++)
+  int id;
+
+  if (!node_handle)
+    return -1;
+
+  /* the index stores id+1, it is validated against the cache because it can be outdated */
+  id = (int)(size_t)iupTableGet(ih->data->node_index, (const char*)node_handle) - 1;
+  if (id >= 0 && id < ih->data->node_count && ih->data->node_cache[id].node_handle == node_handle)
+    return id;
+
+  if (ih->data->node_index_start < ih->data->node_count)
   {
-    if (ih->data->node_cache[i].node_handle == node_handle)
-      return i;
+    iTreeIndexUpdate(ih);
+
+    id = (int)(size_t)iupTableGet(ih->data->node_index, (const char*)node_handle) - 1;
+    if (id >= 0 && id < ih->data->node_count && ih->data->node_cache[id].node_handle == node_handle)
+      return id;
   }
-  */
-  InodeData *node_cache = ih->data->node_cache;
-  while(node_cache->userdata != userdata && 
-        node_cache->node_handle != NULL)   /* the cache always have zeros at the end */
-    node_cache++;
 
-  if (node_cache->node_handle != NULL)
-    return (int)(node_cache - ih->data->node_cache);
+  /* node handles can be changed directly by the driver after the last update */
+  id = iTreeFindNodeIdLinear(ih, node_handle);
+  if (id != -1)
+    iTreeIndexSetNode(ih, id);
+  return id;
+}
+
+static int iTreeFindUserDataId(Ihandle* ih, void* userdata)
+{
+  int id = -1;
+  InodeHandle* node_handle = NULL;
+  
+  /* the first node with the userdata is returned, 
+     the index can be used only while each userdata is in a single node */
+  if (!ih->data->userdata_dup)
+    node_handle = (InodeHandle*)iupTableGet(ih->data->userdata_index, (const char*)userdata);
+  if (node_handle)
+    id = iupTreeFindNodeId(ih, node_handle);
+
+  if (id >= 0 && ih->data->node_cache[id].userdata == userdata)
+    return id;
   else
-    return -1;
+  {
+    InodeData *node_cache = ih->data->node_cache;
+    while(node_cache->userdata != userdata && 
+          node_cache->node_handle != NULL)   /* the cache always have zeros at the end */
+      node_cache++;
+
+    if (node_cache->node_handle != NULL)
+    {
+      id = (int)(node_cache - ih->data->node_cache);
+      if (userdata)
+        iupTableSet(ih->data->userdata_index, (const char*)userdata, node_cache->node_handle, IUPTABLE_POINTER);
+      return id;
+    }
+    else
+      return -1;
+  }
+}
+
+static void iTreeSetUserData(Ihandle* ih, int id, void* userdata)
+{
+  void* old_userdata = ih->data->node_cache[id].userdata;
+  InodeHandle* node_handle = ih->data->node_cache[id].node_handle;
+
+  if (old_userdata && iupTableGet(ih->data->userdata_index, (const char*)old_userdata) == node_handle)
+    iupTableRemove(ih->data->userdata_index, (const char*)old_userdata);
+
+  ih->data->node_cache[id].userdata = userdata;
+
+  if (userdata && node_handle)
+  {
+    InodeHandle* other_handle = (InodeHandle*)iupTableGet(ih->data->userdata_index, (const char*)userdata);
+    if (other_handle && other_handle != node_handle && !ih->data->userdata_dup)
+    {
+      int other_id = iupTreeFindNodeId(ih, other_handle);
+      if (other_id >= 0 && ih->data->node_cache[other_id].userdata == userdata)
+        ih->data->userdata_dup = 1;
+    }
+
+    iupTableSet(ih->data->userdata_index, (const char*)userdata, node_handle, IUPTABLE_POINTER);
+  }
 }
 
 InodeHandle* iupTreeGetNode(Ihandle* ih, int id)
@@ -302,7 +399,14 @@ static void iTreeAddToCache(Ihandle* ih, int id, InodeHandle* node_handle)
 
   /* node_count here already contains the final count */
 
-  if (id == ih->data->node_count-1)
+  if (ih->data->node_cache_gap)
+  {
+    /* space already reserved by IupTreeAddNodes */
+    iupASSERT(ih->data->node_cache[id].node_handle == NULL);
+    ih->data->node_cache[id].node_handle = node_handle;
+    ih->data->node_cache_gap--;
+  }
+  else if (id == ih->data->node_count-1)
     ih->data->node_cache[id].node_handle = node_handle;
   else
   {
@@ -310,9 +414,18 @@ static void iTreeAddToCache(Ihandle* ih, int id, InodeHandle* node_handle)
     int remain_count = ih->data->node_count-id;
     memmove(ih->data->node_cache+id+1, ih->data->node_cache+id, remain_count*sizeof(InodeData));
     ih->data->node_cache[id].node_handle = node_handle;
+
+    /* the following ids were shifted */
+    iTreeIndexInvalidate(ih, id+1);
   }
 
   ih->data->node_cache[id].userdata = NULL;
+  ih->data->node_cache[id].virtual_state = 0;
+
+  /* id is updated below, the following ids are still outdated when they were shifted */
+  if (ih->data->node_index_start == id)
+    ih->data->node_index_start = id+1;
+  iTreeIndexSetNode(ih, id);
 }
 
 /* no longer static because needed by Cocoa implemenetation */
@@ -322,16 +435,20 @@ void iTreeIncCacheMem(Ihandle* ih)
 
   if (ih->data->node_count+10 > ih->data->node_cache_max)
   {
+    /* grow geometrically, so adding many nodes is not quadratic */
     int old_node_cache_max = ih->data->node_cache_max;
-    ih->data->node_cache_max += 20;
+    ih->data->node_cache_max *= 2;
+    if (ih->data->node_count+10 > ih->data->node_cache_max)
+      ih->data->node_cache_max = ih->data->node_count+20;
     ih->data->node_cache = realloc(ih->data->node_cache, ih->data->node_cache_max*sizeof(InodeData));
-    memset(ih->data->node_cache+old_node_cache_max, 0, 20*sizeof(InodeData));
+    memset(ih->data->node_cache+old_node_cache_max, 0, (ih->data->node_cache_max-old_node_cache_max)*sizeof(InodeData));
   }
 }
 
 void iupTreeAddToCache(Ihandle* ih, int add, int kindPrev, InodeHandle* prevNode, InodeHandle* node_handle)
 {
   int new_id = 0;
+  int in_batch = ih->data->node_cache_gap;
 
   ih->data->node_count++;
 
@@ -357,7 +474,43 @@ void iupTreeAddToCache(Ihandle* ih, int add, int kindPrev, InodeHandle* prevNode
   }
 
   iTreeAddToCache(ih, new_id, node_handle);
-  iupAttribSetInt(ih, "LASTADDNODE", new_id);
+
+  if (!in_batch)  /* IupTreeAddNodes will set it only once */
+    iupAttribSetInt(ih, "LASTADDNODE", new_id);
+}
+
+static void iTreeReserveCache(Ihandle* ih, int id, int count)
+{
+  /* open space for count nodes starting at id, the following nodes are moved only once */
+  int remain_count = ih->data->node_count - id;
+
+  if (ih->data->node_count + count + 10 > ih->data->node_cache_max)
+  {
+    int old_node_cache_max = ih->data->node_cache_max;
+    ih->data->node_cache_max = 2 * (ih->data->node_count + count + 10);
+    ih->data->node_cache = realloc(ih->data->node_cache, ih->data->node_cache_max*sizeof(InodeData));
+    memset(ih->data->node_cache+old_node_cache_max, 0, (ih->data->node_cache_max-old_node_cache_max)*sizeof(InodeData));
+  }
+
+  if (remain_count > 0)
+    memmove(ih->data->node_cache+id+count, ih->data->node_cache+id, remain_count*sizeof(InodeData));
+  memset(ih->data->node_cache+id, 0, count*sizeof(InodeData));
+
+  ih->data->node_cache_gap = count;
+  iTreeIndexInvalidate(ih, id);
+}
+
+static void iTreeReleaseCacheGap(Ihandle* ih, int id)
+{
+  /* remove the reserved space not used, id is the first free entry */
+  int gap = ih->data->node_cache_gap;
+  int remain_count = ih->data->node_count - id;
+
+  if (remain_count > 0)
+    memmove(ih->data->node_cache+id, ih->data->node_cache+id+gap, remain_count*sizeof(InodeData));
+  memset(ih->data->node_cache+ih->data->node_count, 0, gap*sizeof(InodeData));
+
+  ih->data->node_cache_gap = 0;
 }
 
 void iupTreeDelFromCache(Ihandle* ih, int id, int count)
@@ -378,6 +531,9 @@ void iupTreeDelFromCache(Ihandle* ih, int id, int count)
 
   /* node_count here already contains the final count */
 
+  iTreeIndexRemoveNodes(ih, id, count);
+  iTreeIndexInvalidate(ih, id);
+
   /* remove id+count */
   remain_count = ih->data->node_count-id;
   memmove(ih->data->node_cache+id, ih->data->node_cache+id+count, remain_count*sizeof(InodeData));
@@ -388,7 +544,7 @@ void iupTreeDelFromCache(Ihandle* ih, int id, int count)
 
 void iupTreeCopyMoveCache(Ihandle* ih, int id_src, int id_dst, int count, int is_copy)
 {
-  int remain_count;
+  int i, remain_count;
 
   iupASSERT(id_src >= 0 && id_src < ih->data->node_count);
   if (id_src < 0 || id_src >= ih->data->node_count)
@@ -407,6 +563,8 @@ void iupTreeCopyMoveCache(Ihandle* ih, int id_src, int id_dst, int count, int is
   /* node_count here contains the final count for a copy operation */
   iTreeIncCacheMem(ih);
 
+  iTreeIndexInvalidate(ih, id_src < id_dst? id_src: id_dst);
+
   /* add space for new nodes */
   remain_count = ih->data->node_count - (id_dst + count);
   memmove(ih->data->node_cache+id_dst+count, ih->data->node_cache+id_dst, remain_count*sizeof(InodeData));
@@ -419,9 +577,26 @@ void iupTreeCopyMoveCache(Ihandle* ih, int id_src, int id_dst, int count, int is
   {
     /* during a copy, the userdata is not reused, so clear it */
     memset(ih->data->node_cache+id_dst, 0, count*sizeof(InodeData));
+
+    /* except for virtual branches, their children are still created from the userdata */
+    for (i = 0; i < count; i++)
+    {
+      InodeData* node_src = ih->data->node_cache + id_src + i;
+      InodeData* node_dst = ih->data->node_cache + id_dst + i;
+
+      node_dst->virtual_state = node_src->virtual_state;
+      if (node_src->virtual_state == ITREE_VIRTUAL_BRANCH && node_src->userdata)
+      {
+        node_dst->userdata = node_src->userdata;
+        ih->data->userdata_dup = 1;
+      }
+    }
   }
   else /* move = copy + delete */
   {
+    /* the src nodes will be removed by the driver */
+    iTreeIndexRemoveNodes(ih, id_src, count);
+
     /* copy userdata from src to dst */
     memcpy(ih->data->node_cache+id_dst, ih->data->node_cache+id_src, count*sizeof(InodeData));
 
@@ -620,13 +795,13 @@ static char* iTreeGetUserDataAttrib(Ihandle* ih, int id)
 static int iTreeSetUserDataAttrib(Ihandle* ih, int id, const char* value)
 {
   if (id >= 0 && id < ih->data->node_count)
-    ih->data->node_cache[id].userdata = (void*)value;
+    iTreeSetUserData(ih, id, (void*)value);
   else if (id == IUP_INVALID_ID && ih->data->node_count!=0)
   {
     InodeHandle* node_handle = iupdrvTreeGetFocusNode(ih);
     id = iupTreeFindNodeId(ih, node_handle);
     if (id >= 0 && id < ih->data->node_count)
-      ih->data->node_cache[id].userdata = (void*)value;
+      iTreeSetUserData(ih, id, (void*)value);
   }
   return 0;
 }
@@ -652,6 +827,8 @@ void iupTreeDragDropCopyCache(Ihandle* ih, int id_src, int id_dst, int count)
   /* node_count here contains the final count for a copy operation */
   iTreeIncCacheMem(ih);
 
+  iTreeIndexInvalidate(ih, id_dst);
+
   /* add space for new nodes */
   remain_count = ih->data->node_count - (id_dst + count);
   memmove(ih->data->node_cache+id_dst+count, ih->data->node_cache+id_dst, remain_count*sizeof(InodeData));
@@ -878,6 +1055,8 @@ static int iTreeCreateMethod(Ihandle* ih, void **params)
   ih->data->add_expanded = 1;
   ih->data->node_cache_max = 20;
   ih->data->node_cache = calloc(ih->data->node_cache_max, sizeof(InodeData));
+  ih->data->node_index = iupTableCreate(IUPTABLE_POINTERINDEXED);
+  ih->data->userdata_index = iupTableCreate(IUPTABLE_POINTERINDEXED);
 
   return IUP_NOERROR;
 }
@@ -886,6 +1065,9 @@ static void iTreeDestroyMethod(Ihandle* ih)
 {
   if (ih->data->node_cache)
     free(ih->data->node_cache);
+
+  iupTableDestroy(ih->data->node_index);
+  iupTableDestroy(ih->data->userdata_index);
 }
 
 /*************************************************************************/
@@ -924,6 +1106,9 @@ Iclass* iupTreeNewClass(void)
   iupClassRegisterCallback(ic, "RENAME_CB",         "is");
   iupClassRegisterCallback(ic, "DRAGDROP_CB",       "iiii");
   iupClassRegisterCallback(ic, "RIGHTCLICK_CB",     "i");
+  iupClassRegisterCallback(ic, "NODECOUNT_CB",      "V");
+  iupClassRegisterCallback(ic, "NODETITLE_CB",      "V=s");
+  iupClassRegisterCallback(ic, "NODEUSERDATA_CB",   "Vi=V");
   iupClassRegisterCallback(ic, "MOTION_CB", "iis");
   iupClassRegisterCallback(ic, "BUTTON_CB", "iiiis");
 
@@ -988,7 +1173,7 @@ int IupTreeSetUserId(Ihandle* ih, int id, void* userdata)
 
   if (id >= 0 && id < ih->data->node_count)
   {
-    ih->data->node_cache[id].userdata = userdata;
+    iTreeSetUserData(ih, id, userdata);
     return 1;
   }
 
@@ -1004,6 +1189,218 @@ int IupTreeGetId(Ihandle* ih, void *userdata)
   return iTreeFindUserDataId(ih, userdata);
 }
 
+static int iTreeAddNodes(Ihandle* ih, int id, int count, const int* kinds, const char** titles, void** userids, int virtual_branches)
+{
+  int i, first_id, new_id, prev_id, reserve_count = count;
+
+  /* all the new nodes will be at depth+1 of a branch, or at the same depth of a leaf,
+     with consecutive ids after the reference node */
+  first_id = id + 1;
+
+  if (virtual_branches && kinds)
+  {
+    /* each virtual branch has also a placeholder child */
+    for (i = 0; i < count; i++)
+    {
+      if (kinds[i])
+        reserve_count++;
+    }
+  }
+
+  iupdrvTreeBeginUpdate(ih);
+  iTreeReserveCache(ih, first_id, reserve_count);
+
+  new_id = first_id;
+  prev_id = id;
+  for (i = 0; i < count; i++)
+  {
+    int old_count = ih->data->node_count;
+    int kind = (kinds && kinds[i])? ITREE_BRANCH: ITREE_LEAF;
+    const char* title = titles? titles[i]: NULL;
+
+    if (i == 0)
+      iupdrvTreeAddNode(ih, id, kind, title, 1);
+    else
+      iupdrvTreeAddNode(ih, prev_id, kind, title, 0);  /* insert after the previous new node, even if it is a branch */
+
+    if (ih->data->node_count == old_count)
+      break;
+
+    if (userids && userids[i])
+      iTreeSetUserData(ih, new_id, userids[i]);
+
+    prev_id = new_id;
+    new_id++;
+
+    if (virtual_branches && kind == ITREE_BRANCH)
+    {
+      /* an empty child so the branch can be expanded,
+         it will be replaced by the actual children in iupTreeExpandVirtual */
+      iupdrvTreeAddNode(ih, prev_id, ITREE_LEAF, "", 1);
+      if (ih->data->node_count == old_count + 1)
+      {
+        i++;
+        break;
+      }
+
+      ih->data->node_cache[prev_id].virtual_state = ITREE_VIRTUAL_BRANCH;
+      ih->data->node_cache[new_id].virtual_state = ITREE_VIRTUAL_PLACEHOLDER;
+      new_id++;
+    }
+  }
+
+  if (ih->data->node_cache_gap)
+    iTreeReleaseCacheGap(ih, new_id);
+
+  /* the nodes after the new ones were moved */
+  iTreeIndexInvalidate(ih, new_id);
+
+  iupdrvTreeEndUpdate(ih);
+
+  if (i > 0)
+    iupAttribSetInt(ih, "LASTADDNODE", prev_id);
+
+  return i;
+}
+
+int IupTreeAddNodes(Ihandle* ih, int id, int count, const int* kinds, const char** titles, void** userids)
+{
+  iupASSERT(iupObjectCheck(ih));
+  if (!iupObjectCheck(ih))
+    return 0;
+
+  if (!ih->handle || count <= 0)  /* do not do the action before map */
+    return 0;
+
+  if (id == IUP_INVALID_ID && ih->data->node_count != 0)
+    id = iupTreeFindNodeId(ih, iupdrvTreeGetFocusNode(ih));
+
+  /* the previous node is not necessary only 
+     if adding the root in an empty tree or before the root. */
+  if (id < -1 || id >= ih->data->node_count)
+    return 0;
+
+  return iTreeAddNodes(ih, id, count, kinds, titles, userids, 0);
+}
+
+static int iTreeAddVirtualNodes(Ihandle* ih, int id, void* userdata)
+{
+  IFnV count_cb = (IFnV)IupGetCallback(ih, "NODECOUNT_CB");
+  sIFnV title_cb = (sIFnV)IupGetCallback(ih, "NODETITLE_CB");
+  VIFnVi userdata_cb = (VIFnVi)IupGetCallback(ih, "NODEUSERDATA_CB");
+  int i, count, add_expanded, old_count = ih->data->node_count;
+  int* kinds;
+  char** titles;
+  void** userids;
+
+  if (!count_cb || !userdata_cb)  /* a virtual branch copied to a tree that is not virtual */
+    return 0;
+
+  count = count_cb(ih, userdata);
+  if (count <= 0)
+    return 0;
+
+  kinds = (int*)malloc(count*sizeof(int));
+  titles = (char**)calloc(count, sizeof(char*));
+  userids = (void**)malloc(count*sizeof(void*));
+
+  for (i = 0; i < count; i++)
+  {
+    /* the userdata identifies the node in the other callbacks, ids change when nodes are added or removed */
+    userids[i] = userdata_cb(ih, userdata, i);
+    kinds[i] = count_cb(ih, userids[i]) > 0;
+
+    /* the callback can return the same buffer for all the nodes */
+    if (title_cb)
+      titles[i] = iupStrDup(title_cb(ih, userids[i]));
+  }
+
+  /* a new branch must not be expanded when its placeholder is added,
+     or all the hierarchy would be created */
+  add_expanded = ih->data->add_expanded;
+  ih->data->add_expanded = 0;
+
+  iTreeAddNodes(ih, id, count, kinds, (const char**)titles, userids, 1);
+
+  ih->data->add_expanded = add_expanded;
+
+  for (i = 0; i < count; i++)
+  {
+    if (titles[i])
+      free(titles[i]);
+  }
+  free(titles);
+  free(kinds);
+  free(userids);
+
+  return ih->data->node_count - old_count;
+}
+
+void iupTreeMapVirtual(Ihandle* ih)
+{
+  if (!IupGetCallback(ih, "NODECOUNT_CB") || !IupGetCallback(ih, "NODEUSERDATA_CB"))
+    return;
+
+  if (ih->data->node_count == 1)  /* ADDROOT=Yes, the top level nodes are children of the root */
+  {
+    iTreeAddVirtualNodes(ih, 0, NULL);
+
+    if (ih->data->add_expanded)
+      IupSetAttributeId(ih, "STATE", 0, "EXPANDED");
+  }
+  else
+    iTreeAddVirtualNodes(ih, -1, NULL);
+}
+
+static InodeHandle* iTreeFindVirtualPlaceholder(Ihandle* ih, int id, InodeHandle* node_handle)
+{
+  /* usually the first child, but the application can add nodes before it */
+  int child_id = id + 1;
+  int last_id = id + iupdrvTreeTotalChildCount(ih, node_handle);
+
+  while (child_id <= last_id)
+  {
+    InodeData* node = ih->data->node_cache + child_id;
+    if (node->virtual_state == ITREE_VIRTUAL_PLACEHOLDER)
+      return node->node_handle;
+
+    /* skip the descendants, they may be copies of other virtual branches */
+    child_id += 1 + iupdrvTreeTotalChildCount(ih, node->node_handle);
+  }
+
+  return NULL;
+}
+
+void iupTreeExpandVirtual(Ihandle* ih, InodeHandle* node_handle)
+{
+  InodeHandle* placeholder;
+  int id;
+
+  id = iupTreeFindNodeId(ih, node_handle);
+  if (id < 0 || ih->data->node_cache[id].virtual_state != ITREE_VIRTUAL_BRANCH)
+    return;  /* not virtual or children already created */
+
+  ih->data->node_cache[id].virtual_state = 0;
+
+  placeholder = iTreeFindVirtualPlaceholder(ih, id, node_handle);
+
+  /* add the children before removing the placeholder, 
+     so the branch is never empty while it is being expanded */
+  iTreeAddVirtualNodes(ih, id, ih->data->node_cache[id].userdata);
+
+  if (placeholder)
+  {
+    int placeholder_id = iupTreeFindNodeId(ih, placeholder);
+    if (placeholder_id >= 0)
+    {
+      /* internal node, the application is not notified */
+      iupAttribSet(ih, "_IUPTREE_IGNORE_NODEREMOVED_CB", "1");
+      IupSetAttributeId(ih, "DELNODE", placeholder_id, "SELECTED");
+      iupAttribSet(ih, "_IUPTREE_IGNORE_NODEREMOVED_CB", NULL);
+    }
+  }
+}
+
 void* IupTreeGetUserId(Ihandle* ih, int id)
 {
   iupASSERT(iupObjectCheck(ih));
@@ -25,6 +25,8 @@ extern "C" {
 void iupdrvTreeInitClass(Iclass* ic);
 void iupTreeUpdateImages(Ihandle *ih);
 void iupdrvTreeAddNode(Ihandle* ih, int id, int kind, const char* title, int add);
+void iupdrvTreeBeginUpdate(Ihandle* ih);  /* called before adding many nodes at once */
+void iupdrvTreeEndUpdate(Ihandle* ih);
 void iupdrvTreeUpdateMarkMode(Ihandle *ih);
 
 char* iupTreeGetSpacingAttrib(Ihandle* ih);
@@ -41,10 +43,14 @@ typedef void InodeHandle;   /* should be id, but don't want Obj-C in C header, a
 typedef struct _InodeData InodeHandle;
 #endif
 
+#define ITREE_VIRTUAL_BRANCH      1  /* children not created yet, the userdata is passed to the virtual mode callbacks */
+#define ITREE_VIRTUAL_PLACEHOLDER 2  /* empty child of a virtual branch, removed when the branch is expanded */
+
 typedef struct _InodeData
 {
   InodeHandle* node_handle;
   void* userdata;
+  int virtual_state;  /* 0, ITREE_VIRTUAL_BRANCH or ITREE_VIRTUAL_PLACEHOLDER */
 } InodeData;
 
 typedef int (*iupTreeNodeFunc)(Ihandle* ih, InodeHandle* node_handle, int id, void* userdata);
@@ -63,6 +69,9 @@ void iupTreeAddToCache(Ihandle* ih, int add, int kindPrev, InodeHandle* prevNode
 void iupTreeCopyMoveCache(Ihandle* ih, int id_src, int id_dst, int count, int is_copy);
 void iupTreeDragDropCopyCache(Ihandle* ih, int id_src, int id_dst, int count);
 
+void iupTreeMapVirtual(Ihandle* ih);  /* called by the driver at the end of map, after ADDROOT */
+void iupTreeExpandVirtual(Ihandle* ih, InodeHandle* node_handle);  /* called by the driver before a branch is expanded */
+
 void iupdrvTreeDragDropCopyNode(Ihandle *src, Ihandle *dst, InodeHandle *itemSrc, InodeHandle *itemDst);
 
 /* Structure of the tree */
@@ -86,6 +95,12 @@ struct _IcontrolData
 
   InodeData *node_cache;
   int node_cache_max, node_count;
+
+  Itable* node_index;      /* node_handle -> id+1, can be outdated after node_index_start */
+  Itable* userdata_index;  /* userdata -> node_handle */
+  int userdata_dup;        /* the same userdata was set in more than one node, the index is not used to find the first one */
+  int node_index_start;    /* first id that may have changed since the last index update */
+  int node_cache_gap;      /* free entries reserved in the cache by IupTreeAddNodes */
 };
 
 
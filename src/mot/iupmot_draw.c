@@ -307,7 +307,7 @@ void iupdrvDrawImage(IdrawCanvas* dc, const char* name, int make_inactive, int x
 {
   int img_w, img_h;
   int bpp;
-  Pixmap pixmap = (Pixmap)iupImageGetImage(name, dc->ih, make_inactive);
+  Pixmap pixmap = (Pixmap)iupImageGetImageForDraw(name, dc->ih, make_inactive);
   if (!pixmap)
     return;
 
@@ -547,7 +547,7 @@ static void motTreeRemoveNodeRec(Ihandle* ih, Widget wItem, int del_data, IFns c
 
 static void motTreeRemoveNode(Ihandle* ih, Widget wItem, int del_data, int call_cb)
 {
-  IFns cb = call_cb? (IFns)IupGetCallback(ih, "NODEREMOVED_CB"): NULL;
+  IFns cb = (call_cb && !iupAttribGet(ih, "_IUPTREE_IGNORE_NODEREMOVED_CB"))? (IFns)IupGetCallback(ih, "NODEREMOVED_CB"): NULL;
   int old_count = ih->data->node_count;
   int id = iupTreeFindNodeId(ih, wItem);
   int start_id = id;
@@ -752,6 +752,16 @@ void iupdrvTreeAddNode(Ihandle* ih, int id, int kind, const char* title, int add
   XmStringFree(itemTitle);
 }
 
+void iupdrvTreeBeginUpdate(Ihandle* ih)
+{
+  (void)ih;
+}
+
+void iupdrvTreeEndUpdate(Ihandle* ih)
+{
+  (void)ih;
+}
+
 /*****************************************************************************/
 
 static int motTreeSetImageExpandedAttrib(Ihandle* ih, int id, const char* value)
@@ -946,6 +956,9 @@ static int motTreeSetStateAttrib(Ihandle* ih, int id, const char* value)
   XtVaGetValues(wItem, XmNuserData, &itemData, NULL);
   if (itemData->kind == ITREE_BRANCH)
   {
+    if (iupStrEqualNoCase(value, "EXPANDED"))
+      iupTreeExpandVirtual(ih, wItem);
+
     iupAttribSet(ih, "_IUP_IGNORE_BRANCH_CB", "1");
     if (iupStrEqualNoCase(value, "EXPANDED"))
       XtVaSetValues(wItem, XmNoutlineState, XmEXPANDED, NULL);
@@ -2221,6 +2234,8 @@ static void motTreeOutlineChangedCallback(Widget w, Ihandle* ih, XmContainerOutl
 
   if (nptr->reason == XmCR_EXPANDED)
   {
+    iupTreeExpandVirtual(ih, nptr->item);
+
     if (motTreeCallBranchOpenCb(ih, nptr->item) == IUP_IGNORE)
       nptr->new_outline_state = XmCOLLAPSED; /* prevent the change */
     else
@@ -2919,6 +2934,8 @@ static int motTreeMapMethod(Ihandle* ih)
   if (iupAttribGetInt(ih, "ADDROOT"))
     iupdrvTreeAddNode(ih, -1, ITREE_BRANCH, "", 0);
 
+  iupTreeMapVirtual(ih);
+
   IupSetCallback(ih, "_IUP_XY2POS_CB", (Icallback)motTreeConvertXYToPos);
 
   iupdrvTreeUpdateMarkMode(ih);
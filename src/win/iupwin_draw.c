@@ -676,7 +676,7 @@ void iupdrvDrawImage(IdrawCanvas* dc, const char* name, int make_inactive, int x
 {
   int bpp, img_w, img_h;
   HBITMAP hMask = NULL;
-  HBITMAP hBitmap = (HBITMAP)iupImageGetImage(name, dc->ih, make_inactive);
+  HBITMAP hBitmap = (HBITMAP)iupImageGetImageForDraw(name, dc->ih, make_inactive);
   if (!hBitmap)
     return;
 
@@ -516,7 +516,7 @@ static HBITMAP winImageCreateBitmap(Ihandle *ih, int width, int height, int bpp,
 void* iupdrvImageCreateImage(Ihandle *ih, const char* bgcolor, int make_inactive)
 {
   unsigned char bg_r = 0, bg_g = 0, bg_b = 0;
-  int y,x,bmp_line_size,data_line_size,
+  int y,bmp_line_size,data_line_size,
       width = ih->currentwidth,
       height = ih->currentheight,
       channels = iupAttribGetInt(ih, "CHANNELS"),
@@ -540,57 +540,33 @@ void* iupdrvImageCreateImage(Ihandle *ih, const char* bgcolor, int make_inactive
 
   for (y=0; y<height; y++)
   {
-    for (x=0; x<width; x++)
+    if (bpp != 8) /* (bpp == 32 || bpp == 24) */
     {
-      if (bpp != 8) /* (bpp == 32 || bpp == 24) */
+      memcpy(bits, imgdata, data_line_size);
+
+      if (channels == 4)  /* bpp==32 */
       {
-        int offset = channels*x;
-        /* Windows Bitmap order is BGRA */
-        BYTE *b = &bits[offset],
-             *g = b+1,
-             *r = g+1,
-             *a = r+1,
-             *dat = &imgdata[offset];
+        if (flat_alpha)
+          iupImageConvBlendBgColor(bits, width, bg_r, bg_g, bg_b, 1);
 
-        *r = *(dat);
-        *g = *(dat+1);
-        *b = *(dat+2);
+        if (make_inactive)
+          iupImageConvMakeInactive(bits, width, 4, bg_r, bg_g, bg_b);
 
-        if (channels == 4)  /* bpp==32 */
-        {
-          if (flat_alpha)
-          {
-            *a = *(dat+3);
-            *r = iupALPHABLEND(*r, bg_r, *a);
-            *g = iupALPHABLEND(*g, bg_g, *a);
-            *b = iupALPHABLEND(*b, bg_b, *a);
-            *a = 255;
-          }
-
-          if (make_inactive)
-            iupImageColorMakeInactive(r, g, b, bg_r, bg_g, bg_b);
-
-          if (!flat_alpha)
-          {
-            *a = *(dat+3);
-
-            /* RGB in RGBA DIBs are pre-multiplied by alpha to AlphaBlend usage. */
-            *r = iupALPHAPRE(*r,*a);
-            *g = iupALPHAPRE(*g,*a);
-            *b = iupALPHAPRE(*b,*a);
-          }
-        }
-        else
-        {
-          if (make_inactive)
-            iupImageColorMakeInactive(r, g, b, bg_r, bg_g, bg_b);
-        }
+        /* RGB in RGBA DIBs are pre-multiplied by alpha to AlphaBlend usage. */
+        if (!flat_alpha)
+          iupImageConvPremultiply(bits, width);
       }
-      else /* bpp == 8 */
+      else
       {
-        bits[x] = imgdata[x];
+        if (make_inactive)
+          iupImageConvMakeInactive(bits, width, 3, bg_r, bg_g, bg_b);
       }
+
+      /* Windows Bitmap order is BGRA */
+      iupImageConvSwapRB(bits, width, channels);
     }
+    else /* bpp == 8 */
+      memcpy(bits, imgdata, width);
 
     bits += bmp_line_size;
     imgdata -= data_line_size;    /* iupimage is top down */
@@ -188,13 +188,16 @@ void IupFlush(void)
 
 /* Based on Raymond Chen's discussion of PostThreadMessage
 https://blogs.msdn.microsoft.com/oldnewthing/20050428-00/?p=35753
-TODO: Make decision on final API. For now, this API is just to get a usable demo.
 */
-void IupPostMessage(Ihandle* ih, char* unusedchar, void* message_data, int unusedint)
+void IupPostMessage(Ihandle* ih, char* s, void* message_data, int i)
 {
-  /* REVIEW: I am passing the Ihandle* ih into the WPARAM field because I'm using the LPARAM field for message_data. */
-  /* I think this is okay because the size of WPARAM should be the same as LPARAM. */
-  PostThreadMessage(iupwin_mainthreadid, WM_APP, (WPARAM)ih, (LPARAM)message_data);
+  /* only the first message of a sequence is posted, the others are processed in the same call */
+  if (iupLoopPostMessage(ih, s, message_data, i))
+  {
+    /* it fails when the thread message queue is full */
+    if (!PostThreadMessage(iupwin_mainthreadid, WM_APP, 0, 0))
+      iupLoopPostMessageWakeupFailed();
+  }
 }
 
 LRESULT CALLBACK iupwinPostMessageFilterProc(int code, WPARAM wParam, LPARAM lParam)
@@ -217,14 +220,7 @@ LRESULT CALLBACK iupwinPostMessageFilterProc(int code, WPARAM wParam, LPARAM lPa
     {
       case WM_APP: 
       {
-        Ihandle* ih = (Ihandle*)pmsg->wParam;
-        /* TODO: Figure out callback type. For now, I'm reusing an existing type so I don't have to add one until we decide. */
-        IFnsVi post_message_callback = (IFnsVi)IupGetCallback(ih, "POSTMESSAGE_CB");
-        if (post_message_callback)
-        {
-          void* message_data = (Ihandle*)pmsg->lParam;
-          post_message_callback(ih, NULL, message_data, 0);
-        }
+        iupLoopProcessMessages();
         return TRUE;
       }
     }
@@ -261,6 +261,17 @@ void iupdrvTreeAddNode(Ihandle* ih, int id, int kind, const char* title, int add
   }
 }
 
+void iupdrvTreeBeginUpdate(Ihandle* ih)
+{
+  SendMessage(ih->handle, WM_SETREDRAW, FALSE, 0);  /* disable redraw */
+}
+
+void iupdrvTreeEndUpdate(Ihandle* ih)
+{
+  SendMessage(ih->handle, WM_SETREDRAW, TRUE, 0);
+  iupdrvRedrawNow(ih);
+}
+
 static int winTreeIsItemExpanded(Ihandle* ih, HTREEITEM hItem)
 {
   TVITEM item;
@@ -288,6 +299,9 @@ static void winTreeExpandItem(Ihandle* ih, HTREEITEM hItem, int expand)
   TVITEM item;
   winTreeItemData* itemData;
 
+  if (expand)
+    iupTreeExpandVirtual(ih, hItem);  /* TVM_EXPAND does not send TVN_ITEMEXPANDING */
+
   iupAttribSet(ih, "_IUPTREE_IGNORE_BRANCH_CB", "1");
   /* it only works if the branch has children */
   SendMessage(ih->handle, TVM_EXPAND, expand? TVE_EXPAND: TVE_COLLAPSE, (LPARAM)hItem);
@@ -317,6 +331,9 @@ static void winTreeExpandTree(Ihandle* ih, HTREEITEM hItem, int expand)
   HTREEITEM hItemChild;
   while(hItem != NULL)
   {
+    if (expand)
+      iupTreeExpandVirtual(ih, hItem);  /* before the first child is retrieved, it can be a placeholder */
+
     hItemChild = (HTREEITEM)SendMessage(ih->handle, TVM_GETNEXTITEM, TVGN_CHILD, (LPARAM)hItem);
 
     /* Check whether we have child items */
@@ -820,6 +837,9 @@ static int winTreeCallBranchLeafCb(Ihandle* ih, HTREEITEM hItem)
 
   if (itemData->kind == ITREE_BRANCH)
   {
+    if (!(item.state & TVIS_EXPANDED))
+      iupTreeExpandVirtual(ih, hItem);
+
     if (iupAttribGet(ih, "_IUPTREE_IGNORE_BRANCH_CB"))
       return IUP_DEFAULT;
 
@@ -1660,7 +1680,7 @@ static void winTreeRemoveNodeDataRec(Ihandle* ih, HTREEITEM hItem, IFns cb, int
 
 static void winTreeRemoveNodeData(Ihandle* ih, HTREEITEM hItem, int call_cb)
 {
-  IFns cb = call_cb? (IFns)IupGetCallback(ih, "NODEREMOVED_CB"): NULL;
+  IFns cb = (call_cb && !iupAttribGet(ih, "_IUPTREE_IGNORE_NODEREMOVED_CB"))? (IFns)IupGetCallback(ih, "NODEREMOVED_CB"): NULL;
   int old_count = ih->data->node_count;
   int id = iupTreeFindNodeId(ih, hItem);
   int start_id = id;
@@ -3142,6 +3162,8 @@ static int winTreeMapMethod(Ihandle* ih)
   if (iupAttribGetInt(ih, "ADDROOT"))
     iupdrvTreeAddNode(ih, -1, ITREE_BRANCH, "", 0);
 
+  iupTreeMapVirtual(ih);
+
   /* configure for DROP of files */
   if (IupGetCallback(ih, "DROPFILES_CB"))
     iupAttribSet(ih, "DROPFILESTARGET", "YES");
@@ -30,3 +30,8 @@ ifneq ($(findstring MacOS, $(TEC_UNAME)), )
     BUILD_DYLIB=Yes
   endif
 endif
+
+ifneq ($(findstring Linux, $(TEC_UNAME)), )
+  # Large IupMatrix sorts use worker threads
+  LIBS += pthread
+endif
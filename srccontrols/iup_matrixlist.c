@@ -265,13 +265,13 @@ static void iMatrixListInitSize(Ihandle* ih, ImatrixListData* mtxList)
 
   if (mtxList->color_col != 0)
   {
-    if (!iupAttribGetId(ih, "WIDTH", mtxList->color_col))
+    if (!iupMatrixGetAttribCol(ih, "WIDTH", mtxList->color_col))
       IupSetIntId(ih, "WIDTH", mtxList->color_col, IMTXL_COLOR_WIDTH);
   }
 
   if (mtxList->image_col != 0)
   {
-    if (!iupAttribGetId(ih, "WIDTH", mtxList->image_col))
+    if (!iupMatrixGetAttribCol(ih, "WIDTH", mtxList->image_col))
       IupSetIntId(ih, "WIDTH", mtxList->image_col, IMTXL_IMAGE_WIDTH);
   }
 }
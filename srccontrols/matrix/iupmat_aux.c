@@ -26,17 +26,60 @@
 #include "iupmat_numlc.h"
 
 
-int iupMatrixAuxIsFullVisibleLast(ImatLinColData *p)
+static void iMatrixAuxUpdatePos(ImatLinColData *p)
 {
-  int i, sum = 0;
+  int i;
+
+  if (p->pos_alloc < p->num + 1)
+  {
+    p->pos_alloc = p->num_alloc + 1;
+    p->pos = (int*)realloc(p->pos, p->pos_alloc * sizeof(int));
+  }
+
+  p->pos[0] = 0;
+  for (i = 0; i < p->num; i++)
+    p->pos[i + 1] = p->pos[i] + p->dt[i].size;
+
+  p->pos_valid = 1;
+}
+
+int iupMatrixAuxGetPos(ImatLinColData *p, int index)
+{
+  if (!p->pos_valid)
+    iMatrixAuxUpdatePos(p);
 
-  for(i = p->first; i <= p->last; i++)
+  if (index > p->num)
+    index = p->num;
+
+  return p->pos[index];
+}
+
+int iupMatrixAuxGetIndex(ImatLinColData *p, int pos, int start, int end)
+{
+  /* binary search in the prefix sum, 
+     returns the first index in [start,end) that ends after pos, or end if none */
+  if (!p->pos_valid)
+    iMatrixAuxUpdatePos(p);
+
+  while (start < end)
   {
-    sum += p->dt[i].size;
-    if (i==p->first)
-      sum -= p->first_offset;
+    int mid = (start + end) / 2;
+    if (p->pos[mid + 1] > pos)
+      end = mid;
+    else
+      start = mid + 1;
   }
 
+  return start;
+}
+
+int iupMatrixAuxIsFullVisibleLast(ImatLinColData *p)
+{
+  int sum = 0;
+
+  if (p->last >= p->first)
+    sum = iupMatrixAuxGetPos(p, p->last + 1) - iupMatrixAuxGetPos(p, p->first) - p->first_offset;
+
   if (sum > p->current_visible_size)
     return 0;
   else
@@ -87,13 +130,15 @@ void iupMatrixAuxAdjustFirstFromLast(ImatLinColData* p)
 
   /* adjust "first" according to "last" */
 
+  /* find the last "i" where the sum of the sizes from "i" to "last" is at least the visible size */
   i = p->last;
-  sum = p->dt[i].size;
-  while (i>p->num_noscroll && sum < p->current_visible_size)
+  if (i > p->num_noscroll)
   {
-    i--;
-    sum += p->dt[i].size;
+    i = iupMatrixAuxGetIndex(p, iupMatrixAuxGetPos(p, p->last + 1) - p->current_visible_size, p->num_noscroll, p->last + 1);
+    if (i > p->last)  /* no visible size */
+      i = p->last;
   }
+  sum = iupMatrixAuxGetPos(p, p->last + 1) - iupMatrixAuxGetPos(p, i);
 
   if (i == p->num_noscroll && sum < p->current_visible_size)
   {
@@ -103,7 +148,7 @@ void iupMatrixAuxAdjustFirstFromLast(ImatLinColData* p)
   }
   else
   {
-    /* the "while" found an index for first */
+    /* found an index for first */
     p->first = i;
 
     /* position at the remaing space */
@@ -113,32 +158,24 @@ void iupMatrixAuxAdjustFirstFromLast(ImatLinColData* p)
 
 void iupMatrixAuxAdjustFirstFromScrollPos(ImatLinColData* p, int scroll_pos)
 {
-  int index, sp, offset = 0;
-
-  sp = 0;
-  for(index = p->num_noscroll; index < p->num; index++)
-  {
-    sp += p->dt[index].size;
-    if (sp > scroll_pos)
-    {
-      sp -= p->dt[index].size; /* get the previous value */
-      offset = scroll_pos - sp;
-      break;
-    }
-  }
+  int index, offset = 0;
+  int start_pos = iupMatrixAuxGetPos(p, p->num_noscroll);
 
-  if (index == p->num)
+  index = iupMatrixAuxGetIndex(p, start_pos + scroll_pos, p->num_noscroll, p->num);
+  if (index < p->num)
+    offset = scroll_pos - (iupMatrixAuxGetPos(p, index) - start_pos);
+  else
   {
     if (p->num == p->num_noscroll)
     {
-      /* did NOT go trough the "for" above */
+      /* there are no scrollable columns/lines */
       offset = scroll_pos;
       index = p->num_noscroll;
     }
     else
     {
-      /* go all the way trough the "for" above, but still sp < scroll_pos */
-      offset = scroll_pos - sp;
+      /* scroll_pos is after the end */
+      offset = scroll_pos - (iupMatrixAuxGetPos(p, p->num) - start_pos);
       index = p->num-1;
     }
   }
@@ -155,7 +192,7 @@ void iupMatrixAuxAdjustFirstFromScrollPos(ImatLinColData* p, int scroll_pos)
 */
 void iupMatrixAuxUpdateScrollPos(Ihandle* ih, int m)
 {
-  int i, sb, SB, scroll_pos;
+  int sb, SB, scroll_pos;
   char* POS;
   ImatLinColData *p;
 
@@ -191,8 +228,8 @@ void iupMatrixAuxUpdateScrollPos(Ihandle* ih, int m)
 
   /* must check if it is a valid position */
   scroll_pos = 0;
-  for(i = p->num_noscroll; i < p->first; i++)
-    scroll_pos += p->dt[i].size;
+  if (p->first > p->num_noscroll)
+    scroll_pos = iupMatrixAuxGetPos(p, p->first) - iupMatrixAuxGetPos(p, p->num_noscroll);
   scroll_pos += p->first_offset;
 
   if (scroll_pos + p->current_visible_size > p->total_visible_size)
@@ -216,22 +253,15 @@ void iupMatrixAuxUpdateScrollPos(Ihandle* ih, int m)
    Depends on the first visible column/line.  */
 void iupMatrixAuxUpdateLast(ImatLinColData *p)
 {
-  int i, sum = 0;
+  int i;
 
   if (p->current_visible_size > 0)
   {
     /* Find which is the last column/line.
-       Start in the first visible and continue adding the widths
-       up to the visible size */
-    for(i = p->first; i < p->num; i++)
-    {
-      sum += p->dt[i].size;
-      if (i==p->first)
-        sum -= p->first_offset;
-
-      if(sum >= p->current_visible_size)
-        break;
-    }
+       Start in the first visible and find where the sum of the widths
+       reaches the visible size */
+    int end_pos = iupMatrixAuxGetPos(p, p->first) + p->first_offset + p->current_visible_size;
+    i = iupMatrixAuxGetIndex(p, end_pos - 1, p->first, p->num);
 
     if (i == p->num)
     {
@@ -277,13 +307,16 @@ static void iMatrixAuxFillSizeVec(Ihandle* ih, int m)
 
     p->total_size += p->dt[i].size;
   }
+
+  /* update the prefix sum used to convert between positions and indices */
+  iMatrixAuxUpdatePos(p);
 }
 
 static void iMatrixAuxUpdateVisibleSize(Ihandle* ih, int m)
 {
   char *D, *AUTOHIDE, *MAX;
   ImatLinColData *p;
-  int canvas_size, fixed_size, i, SB;
+  int canvas_size, fixed_size, SB;
 
   if (m == IMAT_PROCESS_LIN)
   {
@@ -310,9 +343,7 @@ static void iMatrixAuxUpdateVisibleSize(Ihandle* ih, int m)
     canvas_size = iupMatrixGetWidth(ih);
   }
 
-  fixed_size = 0;
-  for (i=0; i<p->num_noscroll; i++)
-    fixed_size += p->dt[i].size;
+  fixed_size = iupMatrixAuxGetPos(p, p->num_noscroll);
 
   /* Matrix useful area is the current size minus the non scrollable area */
   p->current_visible_size = canvas_size - fixed_size;
@@ -18,6 +18,9 @@ int   iupMatrixAuxIsCellVisible(Ihandle* ih, int lin, int col);
 
 void  iupMatrixAuxCalcSizes(Ihandle* ih);
 
+int   iupMatrixAuxGetPos(ImatLinColData *p, int index);
+int   iupMatrixAuxGetIndex(ImatLinColData *p, int pos, int start, int end);
+
 void  iupMatrixAuxAdjustFirstFromLast(ImatLinColData* p);
 void  iupMatrixAuxAdjustFirstFromScrollPos(ImatLinColData* p, int scroll_pos);
 void  iupMatrixAuxUpdateScrollPos(Ihandle* ih, int m);
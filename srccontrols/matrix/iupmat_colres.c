@@ -28,6 +28,7 @@
 #include "iupmat_draw.h"
 #include "iupmat_aux.h"
 #include "iupmat_edit.h"
+#include "iupmat_getset.h"
 
 #define IMAT_COLRES_TOL       3
 
@@ -88,8 +89,8 @@ void iupMatrixColResFinish(Ihandle* ih, int x)
 
   ih->data->colres_dragging = 0;
 
-  iupAttribSetIntId(ih, "RASTERWIDTH", ih->data->colres_drag_col, width-IMAT_PADDING_W-IMAT_FRAME_W);
-  iupAttribSetId(ih, "WIDTH", ih->data->colres_drag_col, NULL);
+  iupMatrixSetAttribCol(ih, "RASTERWIDTH", ih->data->colres_drag_col, iupStrReturnInt(width-IMAT_PADDING_W-IMAT_FRAME_W));
+  iupMatrixSetAttribCol(ih, "WIDTH", ih->data->colres_drag_col, NULL);
 
   ih->data->need_calcsize = 1;
 
@@ -42,6 +42,13 @@ enum{IMAT_TYPE_TEXT,
      IMAT_TYPE_IMAGE,
      IMAT_TYPE_FILL};
 
+/* Column storage types */
+enum{IMAT_STORAGE_TEXT,     /* one string per cell (default) */
+     IMAT_STORAGE_REAL,     /* double */
+     IMAT_STORAGE_INTEGER,  /* long long */
+     IMAT_STORAGE_STRING,   /* interned strings, for columns with repeated values */
+     IMAT_STORAGE_BOOLEAN}; /* unsigned char */
+
 enum{IMAT_EDITNEXT_LIN, 
      IMAT_EDITNEXT_COL, 
      IMAT_EDITNEXT_LINCR, 
@@ -92,6 +99,15 @@ typedef struct _ImatLinColData
   int total_size;   /* Sum of the widths/heights of all columns/lines */
 
   int focus_cell;   /* index of the current cell */
+
+  int* pos;         /* Prefix sum of the sizes, pos[i] is the sum of the widths/heights from 0 to i-1, num+1 items */
+  int pos_alloc;    /* Number of items allocated in pos */
+  int pos_valid;    /* pos is consistent with dt, reset when columns/lines are added or removed */
+
+  int* slot;        /* Storage id of the attributes of each column/line, num items, NULL while the storage id is the index itself */
+  int slot_alloc;   /* Number of items allocated in slot */
+  int slot_next;    /* Next storage id to be used by a new column/line */
+  int slot_dead;    /* Number of storage ids removed since the last compaction */
 } ImatLinColData;
 
 typedef struct _ImatNumericData
@@ -110,6 +126,15 @@ typedef struct _ImatMergedData
   unsigned char used;
 } ImatMergedData;
 
+typedef struct _ImatColumnData
+{
+  int type;               /* IMAT_STORAGE_* */
+  void* values;           /* typed values, lines.num_alloc items */
+  unsigned char* valid;   /* validity bitmap, one bit per line, if not set the value is in ImatCell */
+  Itable* str_table;      /* interned string -> index+1, only for IMAT_STORAGE_STRING */
+  Iarray* str_array;      /* index -> interned string, only for IMAT_STORAGE_STRING */
+} ImatColumnData;
+
 struct _IcontrolData
 {
   iupCanvas canvas; /* from IupCanvas (must reserve it) */
@@ -180,6 +205,9 @@ struct _IcontrolData
   ImatNumericData* numeric_columns;   /* information for numeric columns (allocated after map) */
   ImatNumericConvertFunc numeric_convert_func;
 
+  /* Column Storage */
+  ImatColumnData* column_data;   /* typed storage of columns, NULL if all columns store text (allocated after map) */
+
   /* Column Sort */
   int* sort_line_index;     /* Remap index of the line */
   int sort_has_index;       /* has a remap index of columns/lines */
@@ -187,6 +215,9 @@ struct _IcontrolData
   /* merged ranges */
   ImatMergedData* merge_info;  /* must free if not NULL */
   int merge_info_max, merge_info_count;
+
+  /* Attributes with column/line ids, stored using the storage ids of the columns/lines */
+  Itable* attrib_table;
 };
 
 
@@ -447,7 +447,7 @@ static int iMatrixDrawSortSign(Ihandle* ih, int x2, int y1, int y2, int col, int
 {
   int x1;
 
-  char* sort = iupAttribGetId(ih, "SORTSIGN", col);
+  char* sort = iupMatrixGetAttribCol(ih, "SORTSIGN", col);
   if (!sort || iupStrEqualNoCase(sort, "NO"))
     return 0;
 
@@ -485,7 +485,7 @@ static void iMatrixDrawToggle(Ihandle* ih, int x1, int x2, int y1, int y2, int l
     togglevalue = iupStrBoolean(value);
   }
   else
-    togglevalue = iupAttribGetIntId2(ih, "TOGGLEVALUE", lin, col);
+    togglevalue = iupMatrixGetIntAttribId2(ih, "TOGGLEVALUE", lin, col);
 
   /* toggle check */
   if (togglevalue)
@@ -10,6 +10,14 @@
 #include <stdarg.h>
 #include <string.h>
 
+#ifdef WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <unistd.h>
+#include <pthread.h>
+#endif
+
 #include "iup.h"
 #include "iupcbs.h"
 #include "iupcontrols.h"
@@ -27,6 +35,7 @@
 #include "iupmat_getset.h"
 #include "iupmat_draw.h"
 #include "iupmat_aux.h"
+#include "iupmat_mem.h"
 
 
 /* Exported to IupMatrixEx */
@@ -84,7 +93,14 @@ static int iMatrixSetNumericQuantityIndexAttrib(Ihandle* ih, int col, const char
 
 static int iMatrixSetNumericFormatAttrib(Ihandle* ih, int col, const char* value)
 {
-  return iMatrixSetNumericFlag(ih, col, IMAT_HAS_FORMAT, value!=NULL);
+  if (iMatrixSetNumericFlag(ih, col, IMAT_HAS_FORMAT, value!=NULL))
+    iupMatrixSetAttribCol(ih, "NUMERICFORMAT", col, value);
+  return 0;
+}
+
+static char* iMatrixGetNumericFormatAttrib(Ihandle* ih, int col)
+{
+  return iupMatrixGetAttribCol(ih, "NUMERICFORMAT", col);
 }
 
 static int iMatrixSetNumericFormatPrecisionAttrib(Ihandle* ih, int col, const char* value)
@@ -118,7 +134,7 @@ static char* iMatrixGetNumericDecimalSymbolAttrib(Ihandle* ih)
 static char* iMatrixGetNumericFormatPrecisionAttrib(Ihandle* ih, int col)
 {
   int precision;
-  char* value = iupAttribGetId(ih, "NUMERICFORMAT", col);
+  char* value = iupMatrixGetAttribCol(ih, "NUMERICFORMAT", col);
   if (!value)
     value = iupMatrixGetNumericFormatDef(ih);
 
@@ -134,7 +150,14 @@ static char* iMatrixGetNumericFormatPrecisionAttrib(Ihandle* ih, int col)
 
 static int iMatrixSetNumericFormatTitleAttrib(Ihandle* ih, int col, const char* value)
 {
-  return iMatrixSetNumericFlag(ih, col, IMAT_HAS_FORMATTITLE, value!=NULL);
+  if (iMatrixSetNumericFlag(ih, col, IMAT_HAS_FORMATTITLE, value!=NULL))
+    iupMatrixSetAttribCol(ih, "NUMERICFORMATTITLE", col, value);
+  return 0;
+}
+
+static char* iMatrixGetNumericFormatTitleAttrib(Ihandle* ih, int col)
+{
+  return iupMatrixGetAttribCol(ih, "NUMERICFORMATTITLE", col);
 }
 
 static int iMatrixSetNumericUnitIndexAttrib(Ihandle* ih, int col, const char* value)
@@ -167,49 +190,350 @@ static int iMatrixSetNumericUnitShownIndexAttrib(Ihandle* ih, int col, const cha
   return 0;
 }
 
-static IFniii   iMatrixQSort_sort_cb = NULL;
-static Ihandle* iMatrixQSort_ih = NULL;
-static int      iMatrixQSort_col = 0;
+typedef struct _ImatSortKey {
+  int col;
+  double* numbers;              /* numeric columns, one value for each sorted line */
+  int* text_offset;             /* text columns, start of the collation key of each sorted line */
+  unsigned short* text_keys;
+} ImatSortKey;
+
+typedef struct _ImatSort {
+  Ihandle* ih;
+  IFniii sort_cb;
+  int ascending;
+  int* lines;                   /* line of each sorted item, as given to the callback */
+  int key_count;
+  ImatSortKey* keys;
+} ImatSort;
+
+static int iMatrixSortCompareText(const unsigned short* key1, const unsigned short* key2)
+{
+  while (*key1 && *key1 == *key2)
+  {
+    key1++;
+    key2++;
+  }
+  return (int)*key1 - (int)*key2;
+}
+
+static int iMatrixSortCompare(ImatSort* sort, int item1, int item2)
+{
+  int k, ret = 0;
+
+  for (k = 0; k < sort->key_count && ret == 0; k++)
+  {
+    ImatSortKey* key = sort->keys + k;
+
+    if (sort->sort_cb)
+      ret = sort->sort_cb(sort->ih, key->col, sort->lines[item1], sort->lines[item2]);
+    else if (key->numbers)
+    {
+      if (key->numbers[item1] < key->numbers[item2])
+        ret = -1;
+      else if (key->numbers[item1] > key->numbers[item2])
+        ret = 1;
+    }
+    else
+      ret = iMatrixSortCompareText(key->text_keys + key->text_offset[item1], key->text_keys + key->text_offset[item2]);
+  }
+
+  if (!sort->sort_cb && !sort->ascending)
+    ret = -ret;
 
-static int iMatrixCompareCallbackFunc(const void* elem1, const void* elem2)
+  return ret;
+}
+
+static void iMatrixSortMergeRuns(ImatSort* sort, int* items, int* tmp, int half, int count)
 {
-  int lin1 = *((int*)elem1);
-  int lin2 = *((int*)elem2);
-  return iMatrixQSort_sort_cb(iMatrixQSort_ih, iMatrixQSort_col, lin1, lin2);
+  int i, j, k;
+
+  if (iMatrixSortCompare(sort, items[half - 1], items[half]) <= 0)
+    return;  /* already in order */
+
+  /* merge back into items, equal items keep the order of the first half (stable) */
+  memcpy(tmp, items, half*sizeof(int));
+  i = 0; j = half; k = 0;
+  while (i < half && j < count)
+  {
+    if (iMatrixSortCompare(sort, items[j], tmp[i]) < 0)
+      items[k++] = items[j++];
+    else
+      items[k++] = tmp[i++];
+  }
+  while (i < half)
+    items[k++] = tmp[i++];
 }
 
-typedef struct _ImatSortNumber {
-  int lin;
-  double number;
-} ImatSortNumber;
+static void iMatrixSortMerge(ImatSort* sort, int* items, int* tmp, int count)
+{
+  int half, i, j;
 
-static int iMatrixCompareNumberFunc(const void* elem1, const void* elem2)
+  if (count <= 16)
+  {
+    /* insertion sort for small intervals */
+    for (i = 1; i < count; i++)
+    {
+      int item = items[i];
+      for (j = i; j > 0 && iMatrixSortCompare(sort, items[j - 1], item) > 0; j--)
+        items[j] = items[j - 1];
+      items[j] = item;
+    }
+    return;
+  }
+
+  half = count / 2;
+  iMatrixSortMerge(sort, items, tmp, half);
+  iMatrixSortMerge(sort, items + half, tmp, count - half);
+
+  iMatrixSortMergeRuns(sort, items, tmp, half, count);
+}
+
+/* Large sorts without SORTCOLUMNCOMPARE_CB are split in chunks sorted in worker threads, 
+   then the sorted runs are merged in pairs, also in parallel. 
+   The comparisons use only the precomputed keys, so they do not access the matrix. */
+#define IMAT_SORT_PARALLEL_MIN 50000   /* minimum number of lines */
+#define IMAT_SORT_MAX_THREADS 8
+
+typedef struct _ImatSortJob {
+  ImatSort* sort;
+  int* items;
+  int* tmp;
+  int half;    /* 0 to sort the interval, or the size of the first run to merge */
+  int count;
+  int started;
+#ifdef WIN32
+  HANDLE thread;
+#else
+  pthread_t thread;
+#endif
+} ImatSortJob;
+
+static void iMatrixSortJobRun(ImatSortJob* job)
 {
-  ImatSortNumber* num1 = (ImatSortNumber*)elem1;
-  ImatSortNumber* num2 = (ImatSortNumber*)elem2;
-  if (num1->number < num2->number)
-    return -1;
-  if (num1->number > num2->number)
-    return 1;
+  if (job->half)
+    iMatrixSortMergeRuns(job->sort, job->items, job->tmp, job->half, job->count);
+  else
+    iMatrixSortMerge(job->sort, job->items, job->tmp, job->count);
+}
+
+#ifdef WIN32
+static unsigned __stdcall iMatrixSortJobThreadFunc(void* user_data)
+#else
+static void* iMatrixSortJobThreadFunc(void* user_data)
+#endif
+{
+  iMatrixSortJobRun((ImatSortJob*)user_data);
   return 0;
 }
 
-static int iMatrixQSort_utf8 = 0;
-static int iMatrixQSort_casesensitive = 1;
+static void iMatrixSortRunJobs(ImatSortJob* jobs, int job_count)
+{
+  int j;
+
+  /* the first job runs in the calling thread, 
+     jobs whose thread could not be created also run here */
+  for (j = 1; j < job_count; j++)
+  {
+#ifdef WIN32
+    jobs[j].thread = (HANDLE)_beginthreadex(NULL, 0, iMatrixSortJobThreadFunc, jobs + j, 0, NULL);
+    jobs[j].started = jobs[j].thread != NULL;
+#else
+    jobs[j].started = pthread_create(&jobs[j].thread, NULL, iMatrixSortJobThreadFunc, jobs + j) == 0;
+#endif
+  }
+
+  iMatrixSortJobRun(jobs);
+
+  for (j = 1; j < job_count; j++)
+  {
+    if (jobs[j].started)
+    {
+#ifdef WIN32
+      WaitForSingleObject(jobs[j].thread, INFINITE);
+      CloseHandle(jobs[j].thread);
+#else
+      pthread_join(jobs[j].thread, NULL);
+#endif
+    }
+    else
+      iMatrixSortJobRun(jobs + j);
+  }
+}
+
+static int iMatrixSortGetThreadCount(int count)
+{
+  int thread_count;
+#ifdef WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  thread_count = (int)info.dwNumberOfProcessors;
+#else
+  thread_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+  if (thread_count > IMAT_SORT_MAX_THREADS)
+    thread_count = IMAT_SORT_MAX_THREADS;
+  if (thread_count > count / (IMAT_SORT_PARALLEL_MIN / 2))
+    thread_count = count / (IMAT_SORT_PARALLEL_MIN / 2);  /* at least 25000 lines per chunk */
+  return thread_count;
+}
+
+static void iMatrixSortParallel(ImatSort* sort, int* items, int* tmp, int count, int thread_count)
+{
+  ImatSortJob jobs[IMAT_SORT_MAX_THREADS];
+  int run_start[IMAT_SORT_MAX_THREADS + 1];
+  int run_count = thread_count, r, j;
+
+  /* tmp has count items here, each job uses the part of its own interval */
+  for (r = 0; r <= run_count; r++)
+    run_start[r] = (int)(((double)count * r) / run_count);
+
+  for (r = 0; r < run_count; r++)
+  {
+    jobs[r].sort = sort;
+    jobs[r].items = items + run_start[r];
+    jobs[r].tmp = tmp + run_start[r];
+    jobs[r].half = 0;
+    jobs[r].count = run_start[r + 1] - run_start[r];
+  }
+  iMatrixSortRunJobs(jobs, run_count);
+
+  while (run_count > 1)
+  {
+    /* merge the runs two by two, an odd last run is kept as is */
+    for (j = 0, r = 0; r + 1 < run_count; j++, r += 2)
+    {
+      jobs[j].sort = sort;
+      jobs[j].items = items + run_start[r];
+      jobs[j].tmp = tmp + run_start[r];
+      jobs[j].half = run_start[r + 1] - run_start[r];
+      jobs[j].count = run_start[r + 2] - run_start[r];
+    }
+    iMatrixSortRunJobs(jobs, j);
+
+    for (j = 0, r = 0; r < run_count; j++, r += 2)
+      run_start[j] = run_start[r];
+    run_start[j] = count;
+    run_count = j;
+  }
+}
+
+static void iMatrixSortInitKey(Ihandle* ih, ImatSortKey* key, int lin1, int count, int casesensitive, int utf8)
+{
+  int i;
+
+  /* values are retrieved only once for each line, 
+     the comparison uses only the stored numbers or collation keys */
+
+  if (ih->data->numeric_columns && ih->data->numeric_columns[key->col].flags & IMAT_IS_NUMERIC)
+  {
+    key->numbers = (double*)malloc(count*sizeof(double));
+
+    for (i = 0; i < count; i++)
+      key->numbers[i] = iupMatrixGetValueNumeric(ih, lin1 + i, key->col);
+  }
+  else
+  {
+    int keys_size = 0, keys_max = count * 8;
+
+    key->text_offset = (int*)malloc(count*sizeof(int));
+    key->text_keys = (unsigned short*)malloc(keys_max*sizeof(unsigned short));
+
+    for (i = 0; i < count; i++)
+    {
+      char* text = iupMatrixGetValueDisplay(ih, lin1 + i, key->col);
+      int max_size = text? 3 * (int)strlen(text) + 1: 1;
+
+      if (keys_size + max_size > keys_max)
+      {
+        keys_max = (keys_size + max_size) * 2;
+        key->text_keys = (unsigned short*)realloc(key->text_keys, keys_max*sizeof(unsigned short));
+      }
+
+      key->text_offset[i] = keys_size;
+      keys_size += iupStrCollationKey(text, key->text_keys + keys_size, casesensitive, utf8);
+    }
+  }
+}
+
+static void iMatrixSortLines(Ihandle* ih, int* cols, int col_count, int lin1, int lin2, int ascending)
+{
+  int* sort_line_index = ih->data->sort_line_index;
+  int count = lin2 - lin1 + 1;
+  int *items, *tmp, i, k, thread_count = 0;
+  ImatSort sort;
+
+  sort.ih = ih;
+  sort.sort_cb = (IFniii)IupGetCallback(ih, "SORTCOLUMNCOMPARE_CB");
+  sort.ascending = ascending;
+  sort.key_count = col_count;
+  sort.keys = (ImatSortKey*)calloc(col_count, sizeof(ImatSortKey));
+  sort.lines = (int*)malloc(count*sizeof(int));
+  items = (int*)malloc(count*sizeof(int));
+
+  /* the callback can only be called from the main thread */
+  if (!sort.sort_cb && count >= IMAT_SORT_PARALLEL_MIN)
+    thread_count = iMatrixSortGetThreadCount(count);
+
+  if (thread_count > 1)
+    tmp = (int*)malloc(count*sizeof(int));
+  else
+    tmp = (int*)malloc((count / 2 + 1)*sizeof(int));
+
+  for (i = 0; i < count; i++)
+  {
+    sort.lines[i] = sort_line_index[lin1 + i];
+    items[i] = i;
+  }
+
+  for (k = 0; k < col_count; k++)
+  {
+    sort.keys[k].col = cols[k];
+
+    if (!sort.sort_cb)
+      iMatrixSortInitKey(ih, sort.keys + k, lin1, count, iupAttribGetInt(ih, "SORTCOLUMNCASESENSITIVE"), IupGetInt(NULL, "UTF8MODE"));
+  }
+
+  if (thread_count > 1)
+    iMatrixSortParallel(&sort, items, tmp, count, thread_count);
+  else
+    iMatrixSortMerge(&sort, items, tmp, count);
+
+  for (i = 0; i < count; i++)
+    sort_line_index[lin1 + i] = sort.lines[items[i]];
+
+  for (k = 0; k < col_count; k++)
+  {
+    if (sort.keys[k].numbers) free(sort.keys[k].numbers);
+    if (sort.keys[k].text_offset) free(sort.keys[k].text_offset);
+    if (sort.keys[k].text_keys) free(sort.keys[k].text_keys);
+  }
 
-typedef struct _ImatSortText {
-  int lin;
-  char* text;
-} ImatSortText;
+  free(sort.keys);
+  free(sort.lines);
+  free(items);
+  free(tmp);
+}
 
-static int iMatrixCompareTextFunc(const void* elem1, const void* elem2)
+static int iMatrixGetSortColumns(Ihandle* ih, const char* value, int* cols)
 {
-  ImatSortText* txt1 = (ImatSortText*)elem1;
-  ImatSortText* txt2 = (ImatSortText*)elem2;
-  if ((!txt1->text || txt1->text[0]==0) && (!txt2->text || txt2->text[0]==0)) return 0;
-  if (!txt1->text || txt1->text[0]==0) return -1;    /* txt1 < txt2 => -1 */
-  if (!txt2->text || txt2->text[0]==0) return 1;
-  return iupStrCompare(txt1->text, txt2->text, iMatrixQSort_casesensitive, iMatrixQSort_utf8);
+  int col_count = 0;
+
+  /* list of columns separated by commas, like "3,1,5" */
+  while (value && *value && col_count < ih->data->columns.num)
+  {
+    int len, col;
+    const char* next_value = iupStrNextValue(value, (int)strlen(value), &len, ',');
+
+    if (!iupStrToInt(value, &col) || !iupMATRIX_CHECK_COL(ih, col))
+      return 0;
+
+    cols[col_count] = col;
+    col_count++;
+    value = next_value;
+  }
+
+  return col_count;
 }
 
 static int iMatrixSetSortColumnAttrib(Ihandle* ih, int col, const char* value)
@@ -218,7 +542,8 @@ static int iMatrixSetSortColumnAttrib(Ihandle* ih, int col, const char* value)
   int lin, lin1=1, lin2=lines_num-1;   /* ALL */
   int ascending;
   int* sort_line_index;
-  IFniii sort_cb;
+  int* cols;
+  int col_count;
 
   /* Notice that sort_line_index[0] is always 0 */
 
@@ -236,7 +561,7 @@ static int iMatrixSetSortColumnAttrib(Ihandle* ih, int col, const char* value)
   if (iupStrEqualNoCase(value, "RESET"))
   {
     ih->data->sort_has_index = 0;
-    iupAttribSetId(ih, "SORTSIGN", ih->data->last_sort_col, NULL);
+    iupMatrixSetAttribCol(ih, "SORTSIGN", ih->data->last_sort_col, NULL);
     ih->data->last_sort_col = 0;
 
     iupMatrixDraw(ih, 1);
@@ -260,97 +585,56 @@ static int iMatrixSetSortColumnAttrib(Ihandle* ih, int col, const char* value)
       sort_line_index[l2] = tmp;
     }
 
-    if (iupStrEqualNoCase(iupAttribGetId(ih, "SORTSIGN", ih->data->last_sort_col), "UP"))
-      iupAttribSetId(ih, "SORTSIGN", ih->data->last_sort_col, "DOWN");
+    if (iupStrEqualNoCase(iupMatrixGetAttribCol(ih, "SORTSIGN", ih->data->last_sort_col), "UP"))
+      iupMatrixSetAttribCol(ih, "SORTSIGN", ih->data->last_sort_col, "DOWN");
     else
-      iupAttribSetId(ih, "SORTSIGN", ih->data->last_sort_col, "UP");
+      iupMatrixSetAttribCol(ih, "SORTSIGN", ih->data->last_sort_col, "UP");
 
     iupMatrixDraw(ih, 1);
     return 0;
   }
 
-  if (!iupMATRIX_CHECK_COL(ih, col))
-    return 0;
-
-  if (!iupStrEqualNoCase(value, "ALL"))
-    iupStrToIntInt(value, &lin1, &lin2, '-');
-
-  iupAttribSetStrf(ih, "SORTCOLUMNINTERVAL", "%d,%d", lin1, lin2);
-
-  if (lin1 < 1) lin1 = 1;
-  if (lin2 < lin1) lin2 = lin1;
-
-  ascending = iupStrEqualNoCase(iupAttribGetStr(ih, "SORTCOLUMNORDER"), "ASCENDING");
-  
-  sort_cb = (IFniii)IupGetCallback(ih, "SORTCOLUMNCOMPARE_CB");
-  if (sort_cb)
+  if (col == IUP_INVALID_ID)
   {
-    iMatrixQSort_sort_cb = sort_cb;
-    iMatrixQSort_ih = ih;
-    iMatrixQSort_col = col;
-    qsort(sort_line_index+lin1,lin2-lin1+1,sizeof(int),iMatrixCompareCallbackFunc);
+    /* multiple columns, all lines */
+    cols = (int*)malloc(ih->data->columns.num*sizeof(int));
+    col_count = iMatrixGetSortColumns(ih, value, cols);
+    if (col_count == 0)
+    {
+      free(cols);
+      return 0;
+    }
+
+    col = cols[0];
   }
   else
   {
-    if (ih->data->numeric_columns && ih->data->numeric_columns[col].flags & IMAT_IS_NUMERIC)
-    {
-      ImatSortNumber* sort_line_number = (ImatSortNumber*)malloc((lin2-lin1+1)*sizeof(ImatSortNumber));
-
-      for (lin=lin1; lin<=lin2; lin++)
-      {
-        sort_line_number[lin-lin1].lin = sort_line_index[lin];
-        sort_line_number[lin-lin1].number = iupMatrixGetValueNumeric(ih, lin, col);
-      }
-
-      qsort(sort_line_number,lin2-lin1+1,sizeof(ImatSortNumber), iMatrixCompareNumberFunc);
-
-      for (lin=lin1; lin<=lin2; lin++)
-      {
-        if (ascending)
-          sort_line_index[lin] = sort_line_number[lin-lin1].lin;
-        else
-          sort_line_index[lin2 - (lin-lin1)] = sort_line_number[lin-lin1].lin;
-      }
-
-      free(sort_line_number);
-    }
-    else
-    {
-      ImatSortText* sort_line_text = (ImatSortText*)malloc((lin2-lin1+1)*sizeof(ImatSortText));
+    if (!iupMATRIX_CHECK_COL(ih, col))
+      return 0;
 
-      for (lin=lin1; lin<=lin2; lin++)
-      {
-        sort_line_text[lin-lin1].lin = sort_line_index[lin];
-        sort_line_text[lin-lin1].text = iupMatrixGetValueDisplay(ih, lin, col);
+    if (!iupStrEqualNoCase(value, "ALL"))
+      iupStrToIntInt(value, &lin1, &lin2, '-');
 
-        if (ih->data->callback_mode)
-          sort_line_text[lin-lin1].text = iupStrDup(sort_line_text[lin-lin1].text);
-      }
+    cols = (int*)malloc(sizeof(int));
+    cols[0] = col;
+    col_count = 1;
+  }
 
-      iMatrixQSort_utf8 = IupGetInt(NULL, "UTF8MODE");
-      iMatrixQSort_casesensitive = iupAttribGetInt(ih, "SORTCOLUMNCASESENSITIVE");
-      qsort(sort_line_text,lin2-lin1+1,sizeof(ImatSortText), iMatrixCompareTextFunc);
+  iupAttribSetStrf(ih, "SORTCOLUMNINTERVAL", "%d,%d", lin1, lin2);
 
-      for (lin=lin1; lin<=lin2; lin++)
-      {
-        if (ascending)
-          sort_line_index[lin] = sort_line_text[lin-lin1].lin;
-        else
-          sort_line_index[lin2 - (lin-lin1)] = sort_line_text[lin-lin1].lin;
+  if (lin1 < 1) lin1 = 1;
+  if (lin2 < lin1) lin2 = lin1;
 
-        if (ih->data->callback_mode && sort_line_text[lin-lin1].text)
-          free(sort_line_text[lin-lin1].text);
-      }
+  ascending = iupStrEqualNoCase(iupAttribGetStr(ih, "SORTCOLUMNORDER"), "ASCENDING");
 
-      free(sort_line_text);
-    }
-  }
+  iMatrixSortLines(ih, cols, col_count, lin1, lin2, ascending);
+  free(cols);
 
-  iupAttribSetId(ih, "SORTSIGN", ih->data->last_sort_col, NULL);
+  iupMatrixSetAttribCol(ih, "SORTSIGN", ih->data->last_sort_col, NULL);
   if (ascending)
-    iupAttribSetId(ih, "SORTSIGN", col, "DOWN");
+    iupMatrixSetAttribCol(ih, "SORTSIGN", col, "DOWN");
   else
-    iupAttribSetId(ih, "SORTSIGN", col, "UP");
+    iupMatrixSetAttribCol(ih, "SORTSIGN", col, "UP");
 
   ih->data->sort_has_index = 1;
   ih->data->last_sort_col = col;
@@ -371,6 +655,33 @@ static char* iMatrixGetSortLineIndexAttrib(Ihandle* ih, int lin)
     return NULL;
 }
 
+static char* imatrix_storage_names[] = {"TEXT", "REAL", "INTEGER", "STRING", "BOOLEAN"};
+
+static int iMatrixSetColumnStorageAttrib(Ihandle* ih, int col, const char* value)
+{
+  int type;
+
+  if (col == 0 || !iupMATRIX_CHECK_COL(ih, col))  /* title column is always text */
+    return 0;
+
+  for (type = IMAT_STORAGE_BOOLEAN; type > IMAT_STORAGE_TEXT; type--)
+  {
+    if (iupStrEqualNoCase(value, imatrix_storage_names[type]))
+      break;
+  }
+
+  iupMatrixMemSetColumnStorage(ih, col, type);
+  return 0;
+}
+
+static char* iMatrixGetColumnStorageAttrib(Ihandle* ih, int col)
+{
+  if (!iupMATRIX_CHECK_COL(ih, col))
+    return NULL;
+
+  return imatrix_storage_names[iupMatrixMemGetColumnStorage(ih, col)];
+}
+
 static int iMatrixSetUndoRedoAttrib(Ihandle* ih, const char* value)
 {
   if (iupStrBoolean(value))
@@ -391,9 +702,9 @@ void iupMatrixRegisterEx(Iclass* ic)
 
   /* IupMatrixEx Attributes - Numeric Columns */
   iupClassRegisterAttributeId(ic, "NUMERICQUANTITYINDEX", NULL, iMatrixSetNumericQuantityIndexAttrib, IUPAF_NO_INHERIT);
-  iupClassRegisterAttributeId(ic, "NUMERICFORMAT", NULL, iMatrixSetNumericFormatAttrib, IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId(ic, "NUMERICFORMAT", iMatrixGetNumericFormatAttrib, iMatrixSetNumericFormatAttrib, IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId(ic, "NUMERICFORMATPRECISION", iMatrixGetNumericFormatPrecisionAttrib, iMatrixSetNumericFormatPrecisionAttrib, IUPAF_NO_INHERIT);
-  iupClassRegisterAttributeId(ic, "NUMERICFORMATTITLE", NULL, iMatrixSetNumericFormatTitleAttrib, IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId(ic, "NUMERICFORMATTITLE", iMatrixGetNumericFormatTitleAttrib, iMatrixSetNumericFormatTitleAttrib, IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId(ic, "NUMERICUNITINDEX", NULL, iMatrixSetNumericUnitIndexAttrib, IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId(ic, "NUMERICUNITSHOWNINDEX", NULL, iMatrixSetNumericUnitShownIndexAttrib, IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "NUMERICFORMATDEF", NULL, NULL, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
@@ -412,6 +723,9 @@ void iupMatrixRegisterEx(Iclass* ic)
 
   iupClassRegisterCallback(ic, "SORTCOLUMNCOMPARE_CB", "iii");
 
+  /* IupMatrixEx Attributes - Column Storage */
+  iupClassRegisterAttributeId(ic, "COLUMNSTORAGE", iMatrixGetColumnStorageAttrib, iMatrixSetColumnStorageAttrib, IUPAF_NO_INHERIT);
+
   /* IupMatrixEx Attributes - Undo/Redo */
   iupClassRegisterAttribute(ic, "UNDOREDO", iMatrixGetUndoRedoAttrib, iMatrixSetUndoRedoAttrib, NULL, NULL, IUPAF_NOT_MAPPED|IUPAF_NO_INHERIT);
 }
@@ -31,6 +31,7 @@
 #include "iupmat_edit.h"
 #include "iupmat_draw.h"
 #include "iupmat_aux.h"
+#include "iupmat_mem.h"
 
 
 
@@ -106,10 +107,15 @@ void iupMatrixSetValue(Ihandle* ih, int lin, int col, const char* value, int use
 
   if (!ih->data->callback_mode)
   {
-    if (ih->data->cells[lin][col].value)
-      free(ih->data->cells[lin][col].value);
+    if (lin != 0 && ih->data->column_data && ih->data->column_data[col].type != IMAT_STORAGE_TEXT)
+      iupMatrixMemSetTypedValue(ih, lin, col, value);
+    else
+    {
+      if (ih->data->cells[lin][col].value)
+        free(ih->data->cells[lin][col].value);
 
-    ih->data->cells[lin][col].value = iupStrDup(value);
+      ih->data->cells[lin][col].value = iupStrDup(value);
+    }
   }
 
   if (user_edited)
@@ -143,37 +149,57 @@ static char* iMatrixGetValueText(Ihandle* ih, int lin, int col)
     else
       value = NULL; /* application error!!!! value_cb must exist */
   }
+  else if (lin != 0 && ih->data->column_data && ih->data->column_data[col].type != IMAT_STORAGE_TEXT)
+    value = iupMatrixMemGetTypedValue(ih, lin, col);  /* formatted only when requested */
   else
     value = ih->data->cells[lin][col].value;
 
   return value;
 }
 
+static int iMatrixGetValueTypedNumber(Ihandle* ih, int lin, int col, double *number)
+{
+  /* here lin!=0 */
+
+  if (ih->data->callback_mode || !ih->data->column_data || ih->data->column_data[col].type == IMAT_STORAGE_TEXT)
+    return 0;
+
+  if (ih->data->sort_has_index)
+    lin = ih->data->sort_line_index[lin];
+
+  return iupMatrixMemGetTypedNumber(ih, lin, col, number);
+}
+
 double iupMatrixGetValueNumeric(Ihandle* ih, int lin, int col)
 {
   sIFniis translate_cb;
   double number;
+  char* value;
 
   /* here lin!=0 */
 
-  char* value = iMatrixGetValueText(ih, lin, col);
-
   translate_cb = (sIFniis)IupGetCallback(ih, "TRANSLATEVALUE_CB");
-  if (translate_cb)
-    value = translate_cb(ih, lin, col, value);
 
-  if (!value)
+  if (translate_cb || !iMatrixGetValueTypedNumber(ih, lin, col, &number))
   {
-    dIFnii getvalue_cb = (dIFnii)IupGetCallback(ih, "NUMERICGETVALUE_CB");
-    if (getvalue_cb)
-      number = getvalue_cb(ih, lin, col);
+    value = iMatrixGetValueText(ih, lin, col);
+
+    if (translate_cb)
+      value = translate_cb(ih, lin, col, value);
+
+    if (!value)
+    {
+      dIFnii getvalue_cb = (dIFnii)IupGetCallback(ih, "NUMERICGETVALUE_CB");
+      if (getvalue_cb)
+        number = getvalue_cb(ih, lin, col);
+      else
+        return 0;
+    }
     else
-      return 0;
-  }
-  else
-  {
-    if (!iupStrToDouble(value, &number))
-      return 0;
+    {
+      if (!iupStrToDouble(value, &number))
+        return 0;
+    }
   }
 
   if (ih->data->numeric_columns[col].unit_shown != ih->data->numeric_columns[col].unit)
@@ -230,7 +256,7 @@ static char* iMatrixGetValueNumericTitle(Ihandle* ih, int col, const char* value
   /* here lin==0 */
 
   if (ih->data->numeric_columns[col].flags & IMAT_HAS_FORMATTITLE)
-    format = iupAttribGetId(ih, "NUMERICFORMATTITLE", col);
+    format = iupMatrixGetAttribCol(ih, "NUMERICFORMATTITLE", col);
 
   if (format)
   {
@@ -248,9 +274,27 @@ static char* iMatrixGetValueNumericTitle(Ihandle* ih, int col, const char* value
   return (char*)value;
 }
 
-static char* iMatrixGetValueNumericFormatted(Ihandle* ih, int lin, int col, const char* value)
+static char* iMatrixFormatValueNumeric(Ihandle* ih, int col, double number)
 {
   char *format = NULL;
+
+  if (ih->data->numeric_columns[col].unit_shown != ih->data->numeric_columns[col].unit)
+    number = ih->data->numeric_convert_func(number, ih->data->numeric_columns[col].quantity,
+    ih->data->numeric_columns[col].unit, /* from */
+    ih->data->numeric_columns[col].unit_shown);  /* to */
+
+  if (ih->data->numeric_columns[col].flags & IMAT_HAS_FORMAT)
+    format = iupMatrixGetAttribCol(ih, "NUMERICFORMAT", col);
+
+  if (format == NULL)
+    format = iupMatrixGetNumericFormatDef(ih);
+
+  iupStrPrintfDoubleLocale(ih->data->numeric_buffer_get, format, number, IupGetAttribute(ih, "NUMERICDECIMALSYMBOL"));  /* this will also check for global "DEFAULTDECIMALSYMBOL" */
+  return ih->data->numeric_buffer_get;
+}
+
+static char* iMatrixGetValueNumericFormatted(Ihandle* ih, int lin, int col, const char* value)
+{
   double number;
 
   /* here lin!=0 */
@@ -269,19 +313,7 @@ static char* iMatrixGetValueNumericFormatted(Ihandle* ih, int lin, int col, cons
       return (char*)value;
   }
 
-  if (ih->data->numeric_columns[col].unit_shown != ih->data->numeric_columns[col].unit)
-    number = ih->data->numeric_convert_func(number, ih->data->numeric_columns[col].quantity,
-    ih->data->numeric_columns[col].unit, /* from */
-    ih->data->numeric_columns[col].unit_shown);  /* to */
-
-  if (ih->data->numeric_columns[col].flags & IMAT_HAS_FORMAT)
-    format = iupAttribGetId(ih, "NUMERICFORMAT", col);
-
-  if (format == NULL)
-    format = iupMatrixGetNumericFormatDef(ih);
-
-  iupStrPrintfDoubleLocale(ih->data->numeric_buffer_get, format, number, IupGetAttribute(ih, "NUMERICDECIMALSYMBOL"));  /* this will also check for global "DEFAULTDECIMALSYMBOL" */
-  return ih->data->numeric_buffer_get;
+  return iMatrixFormatValueNumeric(ih, col, number);
 }
 
 char* iupMatrixGetValueDisplay(Ihandle* ih, int lin, int col)
@@ -291,11 +323,18 @@ char* iupMatrixGetValueDisplay(Ihandle* ih, int lin, int col)
     return iupAttribGetId2(ih, "", lin, col);
   else
   {
-    sIFniis translate_cb;
+    sIFniis translate_cb = (sIFniis)IupGetCallback(ih, "TRANSLATEVALUE_CB");
+    char* value;
 
-    char* value = iMatrixGetValueText(ih, lin, col);
+    if (lin != 0 && !translate_cb && ih->data->numeric_columns && ih->data->numeric_columns[col].flags & IMAT_IS_NUMERIC)
+    {
+      double number;
+      if (iMatrixGetValueTypedNumber(ih, lin, col, &number))
+        return iMatrixFormatValueNumeric(ih, col, number);  /* no need to format and parse the text */
+    }
+
+    value = iMatrixGetValueText(ih, lin, col);
 
-    translate_cb = (sIFniis)IupGetCallback(ih, "TRANSLATEVALUE_CB");
     if (translate_cb)
       value = translate_cb(ih, lin, col, value);
 
@@ -409,14 +448,14 @@ static char* iMatrixGetCellAttribute(Ihandle* ih, unsigned char attr, int lin, i
 
   /* 1 -  check for this cell */
   if (ih->data->callback_mode || ih->data->cells[lin][col].flags & attr)
-    value = iupAttribGetId2(ih, attrib, lin, col);
+    value = iupMatrixGetAttribId2(ih, attrib, lin, col);
   if (!value)
   {
     /* 2 - check for this line, if not title col */
     if (col != 0)
     {
       if (ih->data->lines.dt[lin].flags & attr)
-        value = iupAttribGetId2(ih, attrib, lin, IUP_INVALID_ID);
+        value = iupMatrixGetAttribId2(ih, attrib, lin, IUP_INVALID_ID);
     }
 
     if (!value)
@@ -425,7 +464,7 @@ static char* iMatrixGetCellAttribute(Ihandle* ih, unsigned char attr, int lin, i
       if (lin != 0)
       {
         if (ih->data->columns.dt[col].flags & attr)
-          value = iupAttribGetId2(ih, attrib, IUP_INVALID_ID, col);
+          value = iupMatrixGetAttribId2(ih, attrib, IUP_INVALID_ID, col);
       }
 
       if (!value)
@@ -572,12 +611,12 @@ void iupMatrixGetBgRGB(Ihandle* ih, int lin, int col, unsigned char *r, unsigned
 
 char* iupMatrixGetMaskStr(Ihandle* ih, const char* name, int lin, int col)
 {
-  char* value = iupAttribGetId2(ih, name, lin, col);
+  char* value = iupMatrixGetAttribId2(ih, name, lin, col);
   if (!value)
   {
-    value = iupAttribGetId2(ih, name, lin, IUP_INVALID_ID);
+    value = iupMatrixGetAttribId2(ih, name, lin, IUP_INVALID_ID);
     if (!value)
-      value = iupAttribGetId2(ih, name, IUP_INVALID_ID, col);
+      value = iupMatrixGetAttribId2(ih, name, IUP_INVALID_ID, col);
   }
 
   return value;
@@ -624,14 +663,14 @@ int iupMatrixGetFrameHorizColor(Ihandle* ih, int lin, int col, long *framecolor,
     unsigned char r, g, b;
     if (check_title && lin == 0)
     {
-      color = iupAttribGetId2(ih, "FRAMETITLEHORIZCOLOR", 0, col);
+      color = iupMatrixGetAttribId2(ih, "FRAMETITLEHORIZCOLOR", 0, col);
       if (!color)
-        color = iupAttribGetId2(ih, "FRAMETITLEHORIZCOLOR", 0, IUP_INVALID_ID);
+        color = iupMatrixGetAttribId2(ih, "FRAMETITLEHORIZCOLOR", 0, IUP_INVALID_ID);
     }
     if (!color)
-      color = iupAttribGetId2(ih, "FRAMEHORIZCOLOR", lin, col);
+      color = iupMatrixGetAttribId2(ih, "FRAMEHORIZCOLOR", lin, col);
     if (!color)
-      color = iupAttribGetId2(ih, "FRAMEHORIZCOLOR", lin, IUP_INVALID_ID);
+      color = iupMatrixGetAttribId2(ih, "FRAMEHORIZCOLOR", lin, IUP_INVALID_ID);
     if (iupStrEqual(color, "BGCOLOR"))
       return 1;
     if (iupStrToRGB(color, &r, &g, &b))
@@ -650,14 +689,14 @@ int iupMatrixGetFrameVertColor(Ihandle* ih, int lin, int col, long *framecolor,
     unsigned char r, g, b;
     if (check_title && col == 0)
     {
-      color = iupAttribGetId2(ih, "FRAMETITLEVERTCOLOR", lin, 0);
+      color = iupMatrixGetAttribId2(ih, "FRAMETITLEVERTCOLOR", lin, 0);
       if (!color)
-        color = iupAttribGetId2(ih, "FRAMETITLEVERTCOLOR", IUP_INVALID_ID, 0);
+        color = iupMatrixGetAttribId2(ih, "FRAMETITLEVERTCOLOR", IUP_INVALID_ID, 0);
     }
     if (!color)
-      color = iupAttribGetId2(ih, "FRAMEVERTCOLOR", lin, col);
+      color = iupMatrixGetAttribId2(ih, "FRAMEVERTCOLOR", lin, col);
     if (!color)
-      color = iupAttribGetId2(ih, "FRAMEVERTCOLOR", IUP_INVALID_ID, col);
+      color = iupMatrixGetAttribId2(ih, "FRAMEVERTCOLOR", IUP_INVALID_ID, col);
     if (iupStrEqual(color, "BGCOLOR"))
       return 1;
     if (framecolor && iupStrToRGB(color, &r, &g, &b))
@@ -682,7 +721,7 @@ int iupMatrixGetColAlignmentLin0(Ihandle* ih)
 
 int iupMatrixGetColAlignment(Ihandle* ih, int col)
 {
-  char* align = iupAttribGetId(ih, "ALIGNMENT", col);
+  char* align = iupMatrixGetAttribCol(ih, "ALIGNMENT", col);
   if (!align)
     align = iupAttribGet(ih, "ALIGNMENT");
   if (!align)
@@ -702,7 +741,7 @@ int iupMatrixGetColAlignment(Ihandle* ih, int col)
 
 int iupMatrixGetLinAlignment(Ihandle* ih, int lin)
 {
-  char* align = iupAttribGetId(ih, "LINEALIGNMENT", lin);
+  char* align = iupMatrixGetAttribLin(ih, "LINEALIGNMENT", lin);
   if (!align)
     align = iupAttribGet(ih, "LINEALIGNMENT");
   if (!align)
@@ -717,7 +756,7 @@ int iupMatrixGetLinAlignment(Ihandle* ih, int lin)
 
 void iupMatrixGetCellAlign(Ihandle* ih, int lin, int col, int *col_alignment, int *lin_alignment)
 {
-  char* align = iupAttribGetId2(ih, "ALIGN", lin, col);
+  char* align = iupMatrixGetAttribId2(ih, "ALIGN", lin, col);
   if (align)
   {
     char col_align[30], lin_align[30];
@@ -747,10 +786,10 @@ int iupMatrixGetColumnWidth(Ihandle* ih, int col, int use_value)
 
   /* can be called for invalid columns (col>numcol) */
 
-  value = iupAttribGetId(ih, "WIDTH", col);
+  value = iupMatrixGetAttribCol(ih, "WIDTH", col);
   if (!value)
   {
-    value = iupAttribGetId(ih, "RASTERWIDTH", col);
+    value = iupMatrixGetAttribCol(ih, "RASTERWIDTH", col);
     if (value)
       pixels = 1;
   }
@@ -816,10 +855,10 @@ int iupMatrixGetLineHeight(Ihandle* ih, int lin, int use_value)
 
   /* can be called for invalid lines (lin>numlin) */
 
-  value = iupAttribGetId(ih, "HEIGHT", lin);
+  value = iupMatrixGetAttribLin(ih, "HEIGHT", lin);
   if (!value)
   {
-    value = iupAttribGetId(ih, "RASTERHEIGHT", lin);
+    value = iupMatrixGetAttribLin(ih, "RASTERHEIGHT", lin);
     if (value)
       pixels = 1;
   }
@@ -920,8 +959,6 @@ char *iupMatrixGetSize(Ihandle* ih, int index, int m, int pixels_unit)
 
 static int iMatrixGetOffset(int index, int *offset, ImatLinColData *p)
 {
-  int i;
-
   *offset = 0;
 
   /* check if the cell is not empty */
@@ -929,23 +966,18 @@ static int iMatrixGetOffset(int index, int *offset, ImatLinColData *p)
     return 0;
 
   if (index < p->num_noscroll)
-  {
-    for (i = 0; i < index; i++)
-      *offset += p->dt[i].size;
-  }
+    *offset = iupMatrixAuxGetPos(p, index);
   else
   {
     if (index < p->first ||
         index > p->last)
         return 0;
 
-    for (i = 0; i < p->num_noscroll; i++)
-      *offset += p->dt[i].size;
+    *offset = iupMatrixAuxGetPos(p, p->num_noscroll);
 
     /* Find the initial position */
     *offset -= p->first_offset;  /* index is always greater or equal to first */
-    for (i = p->first; i < index; i++)
-      *offset += p->dt[i].size;
+    *offset += iupMatrixAuxGetPos(p, index) - iupMatrixAuxGetPos(p, p->first);
   }
 
   return 1;
@@ -964,30 +996,20 @@ int iupMatrixGetCellOffset(Ihandle* ih, int lin, int col, int *x, int *y)
 
 static int iMatrixGetIndexFromOffset(int pos, ImatLinColData *p)
 {
-  int offset = 0, i;
+  int offset, i;
 
   if (pos < 0)
     return -1;  /* invalid */
 
-  for (i = 0; i < p->num_noscroll; i++)  /* for all non scrollable cells */
-  {
-    offset += p->dt[i].size;
-
-    if (pos < offset)
-      break;
-  }
+  /* for all non scrollable cells */
+  i = iupMatrixAuxGetIndex(p, pos, 0, p->num_noscroll);
+  offset = iupMatrixAuxGetPos(p, p->num_noscroll);
 
   if (pos >= offset)
   {
-    for (i = p->first; i <= p->last; i++)  /* for all visible cells */
-    {
-      offset += p->dt[i].size;
-      if (i == p->first)
-        offset -= p->first_offset;
-
-      if (pos < offset)
-        break;
-    }
+    /* for all visible cells, convert pos to the position without scroll */
+    pos += iupMatrixAuxGetPos(p, p->first) + p->first_offset - offset;
+    i = iupMatrixAuxGetIndex(p, pos, p->first, p->last + 1);
 
     if (i > p->last)
       i = -1;    /* invisible */
@@ -1027,25 +1049,18 @@ int iupMatrixGetCellFromXY(Ihandle* ih, int x, int y, int* l, int* c)
 
 static int iMatrixGetCellDim(int index, int* offset, int* size, ImatLinColData *p)
 {
-  int i, visible = 1;
+  int visible = 1;
 
-  *offset = 0;
   if (index < p->num_noscroll)
-  {
-    for (i = 0; i < index; i++)
-      *offset += p->dt[i].size;
-  }
+    *offset = iupMatrixAuxGetPos(p, index);
   else
   {
-    for (i = 0; i < p->num_noscroll; i++)
-      *offset += p->dt[i].size;
+    *offset = iupMatrixAuxGetPos(p, p->num_noscroll);
 
-    for (i = p->first; i < index; i++)
+    if (index > p->first)
     {
-      *offset += p->dt[i].size;
-
-      if (i == p->first)
-        *offset -= p->first_offset;  /* add only when index greater than first */
+      *offset += iupMatrixAuxGetPos(p, index) - iupMatrixAuxGetPos(p, p->first);
+      *offset -= p->first_offset;  /* add only when index greater than first */
     }
 
     if (index < p->first)
@@ -1171,7 +1186,7 @@ static int iMatrixMergeAddRange(Ihandle* ih, int startLin, int endLin, int start
 
 int iupMatrixGetMerged(Ihandle* ih, int lin, int col)
 {
-  return iupAttribGetIntId2(ih, "MERGED", lin, col);
+  return iupMatrixGetIntAttribId2(ih, "MERGED", lin, col);
 }
 
 void iupMatrixMergeRange(Ihandle* ih, int startLin, int endLin, int startCol, int endCol)
@@ -1184,7 +1199,7 @@ void iupMatrixMergeRange(Ihandle* ih, int startLin, int endLin, int startCol, in
   {
     for (col = startCol; col <= endCol; col++)
     {
-      iupAttribSetIntId2(ih, "MERGED", lin, col, merged);
+      iupMatrixSetAttribId2(ih, "MERGED", lin, col, iupStrReturnInt(merged));
     }
   }
 }
@@ -1200,7 +1215,7 @@ void iupMatrixMergeSplitRange(Ihandle* ih, int merged)
   {
     for (col = startCol; col <= endCol; col++)
     {
-      iupAttribSetId2(ih, "MERGED", lin, col, NULL);
+      iupMatrixSetAttribId2(ih, "MERGED", lin, col, NULL);
     }
   }
 
@@ -1219,3 +1234,123 @@ void iupMatrixGetMergedRect(Ihandle *ih, int merged, int *startLin, int *endLin,
     if (endCol)   *endCol   = merged_data->end_col;
   }
 }
+
+/* Attributes with column/line ids are stored in attrib_table using the storage id 
+   of the column/line instead of its index, so they do not need to be renamed 
+   when columns/lines are added or removed (see iupmat_numlc.c). */
+
+static int iMatrixGetSlot(ImatLinColData* lincol, int id)
+{
+  if (!lincol->slot || id < 0)  /* storage id is the index, or IUP_INVALID_ID */
+    return id;
+
+  if (id < lincol->num)
+    return lincol->slot[id];
+
+  return -2 - id;  /* after the last column/line, not related to any column/line */
+}
+
+static void iMatrixSetNameSlot(char* nameid, const char* name, int lin, int col)
+{
+  if (lin == IUP_INVALID_ID)
+    sprintf(nameid, "%s*:%d", name, col);
+  else if (col == IUP_INVALID_ID)
+    sprintf(nameid, "%s%d:*", name, lin);
+  else
+    sprintf(nameid, "%s%d:%d", name, lin, col);
+}
+
+static void iMatrixSetAttribSlot(Ihandle* ih, const char* nameid, const char* value)
+{
+  if (!value)
+  {
+    if (ih->data->attrib_table)
+      iupTableRemove(ih->data->attrib_table, nameid);
+  }
+  else
+  {
+    if (!ih->data->attrib_table)
+      ih->data->attrib_table = iupTableCreate(IUPTABLE_STRINGINDEXED);
+
+    iupTableSet(ih->data->attrib_table, nameid, (void*)value, IUPTABLE_STRING);
+  }
+}
+
+static char* iMatrixGetAttribId(Ihandle* ih, const char* name, int id, ImatLinColData* lincol)
+{
+  char nameid[100];
+
+  if (!ih->data->attrib_table || id == IUP_INVALID_ID)
+    return NULL;
+
+  sprintf(nameid, "%s%d", name, iMatrixGetSlot(lincol, id));
+  return (char*)iupTableGet(ih->data->attrib_table, nameid);
+}
+
+static void iMatrixSetAttribId(Ihandle* ih, const char* name, int id, ImatLinColData* lincol, const char* value)
+{
+  char nameid[100];
+
+  if (id == IUP_INVALID_ID)
+    return;
+
+  sprintf(nameid, "%s%d", name, iMatrixGetSlot(lincol, id));
+  iMatrixSetAttribSlot(ih, nameid, value);
+}
+
+char* iupMatrixGetAttribLin(Ihandle* ih, const char* name, int lin)
+{
+  return iMatrixGetAttribId(ih, name, lin, &(ih->data->lines));
+}
+
+char* iupMatrixGetAttribCol(Ihandle* ih, const char* name, int col)
+{
+  return iMatrixGetAttribId(ih, name, col, &(ih->data->columns));
+}
+
+void iupMatrixSetAttribLin(Ihandle* ih, const char* name, int lin, const char* value)
+{
+  iMatrixSetAttribId(ih, name, lin, &(ih->data->lines), value);
+}
+
+void iupMatrixSetAttribCol(Ihandle* ih, const char* name, int col, const char* value)
+{
+  iMatrixSetAttribId(ih, name, col, &(ih->data->columns), value);
+}
+
+char* iupMatrixGetAttribId2(Ihandle* ih, const char* name, int lin, int col)
+{
+  char nameid[100];
+
+  if (!ih->data->attrib_table || (lin == IUP_INVALID_ID && col == IUP_INVALID_ID))
+    return NULL;
+
+  iMatrixSetNameSlot(nameid, name, iMatrixGetSlot(&(ih->data->lines), lin), iMatrixGetSlot(&(ih->data->columns), col));
+  return (char*)iupTableGet(ih->data->attrib_table, nameid);
+}
+
+void iupMatrixSetAttribId2(Ihandle* ih, const char* name, int lin, int col, const char* value)
+{
+  char nameid[100];
+
+  if (lin == IUP_INVALID_ID && col == IUP_INVALID_ID)
+    return;
+
+  iMatrixSetNameSlot(nameid, name, iMatrixGetSlot(&(ih->data->lines), lin), iMatrixGetSlot(&(ih->data->columns), col));
+  iMatrixSetAttribSlot(ih, nameid, value);
+}
+
+int iupMatrixGetIntAttribId2(Ihandle* ih, const char* name, int lin, int col)
+{
+  int i = 0;
+  char* value = iupMatrixGetAttribId2(ih, name, lin, col);
+  if (value)
+  {
+    if (!iupStrToInt(value, &i))
+    {
+      if (iupStrBoolean(value))
+        i = 1;
+    }
+  }
+  return i;
+}
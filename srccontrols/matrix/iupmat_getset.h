@@ -62,6 +62,16 @@ int iupMatrixCheckCellPos(Ihandle* ih, int lin, int col);
 
 char* iupMatrixGetNumericFormatDef(Ihandle* ih);
 
+/* Attributes with column/line ids (BGCOLOR, WIDTH, MARK, ...) are not stored in the hash table.
+   value is duplicated, NULL removes the attribute. */
+char* iupMatrixGetAttribLin(Ihandle* ih, const char* name, int lin);
+char* iupMatrixGetAttribCol(Ihandle* ih, const char* name, int col);
+void  iupMatrixSetAttribLin(Ihandle* ih, const char* name, int lin, const char* value);
+void  iupMatrixSetAttribCol(Ihandle* ih, const char* name, int col, const char* value);
+char* iupMatrixGetAttribId2(Ihandle* ih, const char* name, int lin, int col);
+void  iupMatrixSetAttribId2(Ihandle* ih, const char* name, int lin, int col, const char* value);
+int   iupMatrixGetIntAttribId2(Ihandle* ih, const char* name, int lin, int col);
+
 
 #ifdef __cplusplus
 }
@@ -54,7 +54,7 @@ static void iMatrixMarkColSet(Ihandle* ih, int col, int mark)
     ih->data->columns.dt[col].flags &= ~IMAT_IS_MARKED;
 }
 
-static int iMatrixSetMarkCell(Ihandle* ih, int lin, int col, int mark, IFniii markedit_cb)
+static void iMatrixSetMarkCell(Ihandle* ih, int lin, int col, int mark, IFniii markedit_cb)
 {
   if (ih->data->callback_mode)
   {
@@ -67,12 +67,9 @@ static int iMatrixSetMarkCell(Ihandle* ih, int lin, int col, int mark, IFniii ma
     else
     {
       if (mark)
-      {
-        iupAttribSetId2(ih, "MARK", lin, col, "1");
-        return 1;
-      }
+        iupMatrixSetAttribId2(ih, "MARK", lin, col, "1");
       else
-        iupAttribSetId2(ih, "MARK", lin, col, NULL);
+        iupMatrixSetAttribId2(ih, "MARK", lin, col, NULL);
     }
   }
   else
@@ -82,8 +79,6 @@ static int iMatrixSetMarkCell(Ihandle* ih, int lin, int col, int mark, IFniii ma
     else
       ih->data->cells[lin][col].flags &= ~IMAT_IS_MARKED;
   }
-
-  return 0;
 }
 
 static void iMatrixMarkCell(Ihandle* ih, int lin, int col, int mark, IFniii markedit_cb, IFnii mark_cb)
@@ -110,7 +105,7 @@ int iupMatrixGetMark(Ihandle* ih, int lin, int col, IFnii mark_cb)
       if (mark_cb)
         return mark_cb(ih, lin, col);
       else
-        return iupAttribGetIntId2(ih, "MARK", lin, col);
+        return iupMatrixGetIntAttribId2(ih, "MARK", lin, col);
     }
     else
       return ih->data->cells[lin][col].flags & IMAT_IS_MARKED;
@@ -622,15 +617,14 @@ int iupMatrixSetMarkAttrib(Ihandle* ih, int lin, int col, const char* value)
     if (ih->data->mark_mode == IMAT_MARK_CELL)
     {
       IFniii markedit_cb = (IFniii)IupGetCallback(ih, "MARKEDIT_CB");
-      int mark, ret = 0;
+      int mark;
 
       if (lin == 0 || col == 0) /* title can NOT have a mark */
         return 0;
 
       mark = iupStrBoolean(value);
 
-      if (iMatrixSetMarkCell(ih, lin, col, mark, markedit_cb))
-        ret = 1;
+      iMatrixSetMarkCell(ih, lin, col, mark, markedit_cb);
 
       if (ih->handle)
       {
@@ -639,7 +633,7 @@ int iupMatrixSetMarkAttrib(Ihandle* ih, int lin, int col, const char* value)
         iupMatrixDrawCells(ih, lin, col, lin, col);
       }
 
-      return ret;
+      return 0;
     }
     else
     {
@@ -27,6 +27,228 @@
 #include "iupmat_mem.h"
 
 
+/**************************************************************************/
+/* Typed column storage                                                   */
+/**************************************************************************/
+
+#define iMatrixBitsSize(_num) (((_num) + 7) / 8)
+#define iMatrixBitIsSet(_bits, _i) ((_bits)[(_i) >> 3] & (1 << ((_i) & 7)))
+
+static void iMatrixBitSet(unsigned char* bits, int i, int set)
+{
+  if (set)
+    bits[i >> 3] |= (unsigned char)(1 << (i & 7));
+  else
+    bits[i >> 3] &= (unsigned char)~(1 << (i & 7));
+}
+
+static void iMatrixBitsMove(unsigned char* bits, int dst, int src, int count)
+{
+  int i;
+  if (dst > src)  /* do it in reverse order to avoid overlapping */
+  {
+    for (i = count - 1; i >= 0; i--)
+      iMatrixBitSet(bits, dst + i, iMatrixBitIsSet(bits, src + i));
+  }
+  else
+  {
+    for (i = 0; i < count; i++)
+      iMatrixBitSet(bits, dst + i, iMatrixBitIsSet(bits, src + i));
+  }
+}
+
+static int iMatrixColumnValueSize(int type)
+{
+  switch (type)
+  {
+  case IMAT_STORAGE_REAL:
+    return sizeof(double);
+  case IMAT_STORAGE_INTEGER:
+    return sizeof(long long);
+  case IMAT_STORAGE_STRING:
+    return sizeof(int);
+  case IMAT_STORAGE_BOOLEAN:
+    return sizeof(unsigned char);
+  }
+  return 0;
+}
+
+static void iMatrixColumnDataFree(ImatColumnData* column)
+{
+  if (column->values)
+    free(column->values);
+  if (column->valid)
+    free(column->valid);
+
+  if (column->str_array)
+  {
+    char** str_array = (char**)iupArrayGetData(column->str_array);
+    int i, count = iupArrayCount(column->str_array);
+    for (i = 0; i < count; i++)
+      free(str_array[i]);
+    iupArrayDestroy(column->str_array);
+  }
+
+  if (column->str_table)
+    iupTableDestroy(column->str_table);
+
+  memset(column, 0, sizeof(ImatColumnData));
+}
+
+static void iMatrixColumnDataReAllocLines(Ihandle* ih, int old_alloc)
+{
+  int col, num_alloc = ih->data->lines.num_alloc;
+
+  for (col = 0; col < ih->data->columns.num_alloc; col++)
+  {
+    ImatColumnData* column = &(ih->data->column_data[col]);
+    if (column->type != IMAT_STORAGE_TEXT)
+    {
+      column->values = realloc(column->values, num_alloc*iMatrixColumnValueSize(column->type));
+      column->valid = (unsigned char*)realloc(column->valid, iMatrixBitsSize(num_alloc));
+      memset(column->valid + iMatrixBitsSize(old_alloc), 0, iMatrixBitsSize(num_alloc) - iMatrixBitsSize(old_alloc));
+    }
+  }
+}
+
+static void iMatrixColumnDataMoveLines(Ihandle* ih, int dst, int src, int count, int clear_start, int clear_count)
+{
+  int col, lin;
+
+  for (col = 0; col < ih->data->columns.num_alloc; col++)
+  {
+    ImatColumnData* column = &(ih->data->column_data[col]);
+    if (column->type != IMAT_STORAGE_TEXT)
+    {
+      int value_size = iMatrixColumnValueSize(column->type);
+      if (count)
+      {
+        memmove((char*)column->values + dst*value_size, (char*)column->values + src*value_size, count*value_size);
+        iMatrixBitsMove(column->valid, dst, src, count);
+      }
+
+      for (lin = clear_start; lin < clear_start + clear_count; lin++)
+        iMatrixBitSet(column->valid, lin, 0);
+    }
+  }
+}
+
+static int iMatrixColumnInternString(ImatColumnData* column, const char* value)
+{
+  int index = (int)(size_t)iupTableGet(column->str_table, value);
+  if (!index)
+  {
+    char** str = (char**)iupArrayInc(column->str_array);
+    index = iupArrayCount(column->str_array);  /* index+1 */
+    str[index - 1] = iupStrDup(value);
+    iupTableSet(column->str_table, value, (void*)(size_t)index, IUPTABLE_POINTER);
+  }
+  return index - 1;
+}
+
+static char* iMatrixColumnFormatValue(ImatColumnData* column, int lin)
+{
+  char* str;
+
+  switch (column->type)
+  {
+  case IMAT_STORAGE_REAL:
+    {
+      double number = ((double*)column->values)[lin];
+      str = iupStrGetMemory(30);
+      sprintf(str, "%.15g", number);
+      if (strtod(str, NULL) != number)  /* use maximum precision only when necessary */
+        sprintf(str, "%.17g", number);
+      return str;
+    }
+  case IMAT_STORAGE_INTEGER:
+    str = iupStrGetMemory(30);
+    sprintf(str, "%lld", ((long long*)column->values)[lin]);
+    return str;
+  case IMAT_STORAGE_STRING:
+    {
+      char** str_array = (char**)iupArrayGetData(column->str_array);
+      return str_array[((int*)column->values)[lin]];
+    }
+  case IMAT_STORAGE_BOOLEAN:
+    return ((unsigned char*)column->values)[lin]? "1": "0";
+  }
+
+  return NULL;
+}
+
+static int iMatrixColumnStoreValue(ImatColumnData* column, int lin, const char* value)
+{
+  switch (column->type)
+  {
+  case IMAT_STORAGE_REAL:
+    {
+      char* end;
+      double number = strtod(value, &end);
+      if (end == value || *end != 0)
+        return 0;
+      ((double*)column->values)[lin] = number;
+      break;
+    }
+  case IMAT_STORAGE_INTEGER:
+    {
+      long long number;
+      int n = 0;
+      if (sscanf(value, "%lld%n", &number, &n) != 1 || value[n] != 0)
+        return 0;
+      ((long long*)column->values)[lin] = number;
+      break;
+    }
+  case IMAT_STORAGE_STRING:
+    ((int*)column->values)[lin] = iMatrixColumnInternString(column, value);
+    break;
+  case IMAT_STORAGE_BOOLEAN:
+    if (iupStrEqual(value, "1"))
+      ((unsigned char*)column->values)[lin] = 1;
+    else if (iupStrEqual(value, "0"))
+      ((unsigned char*)column->values)[lin] = 0;
+    else
+      return 0;  /* other boolean names are kept as text */
+    break;
+  default:
+    return 0;
+  }
+
+  /* values that are not formatted back to the same text (like "1.50" or "007") 
+     are kept as text, so the cell value is returned exactly as it was set */
+  if (column->type != IMAT_STORAGE_STRING && !iupStrEqual(iMatrixColumnFormatValue(column, lin), value))
+    return 0;
+
+  iMatrixBitSet(column->valid, lin, 1);
+  return 1;
+}
+
+
+static void iMatrixRotateLines(ImatCell** cells, int base, int count1, int count2)
+{
+  /* swap the block of count1 lines starting at base 
+     with the block of count2 lines that follows it */
+  ImatCell** tmp;
+  int tmp_count = count1 < count2? count1: count2;
+
+  tmp = (ImatCell**)malloc(tmp_count*sizeof(ImatCell*));
+
+  if (count1 <= count2)
+  {
+    memcpy(tmp, cells+base, count1*sizeof(ImatCell*));
+    memmove(cells+base, cells+base+count1, count2*sizeof(ImatCell*));
+    memcpy(cells+base+count2, tmp, count1*sizeof(ImatCell*));
+  }
+  else
+  {
+    memcpy(tmp, cells+base+count1, count2*sizeof(ImatCell*));
+    memmove(cells+base+count2, cells+base, count1*sizeof(ImatCell*));
+    memcpy(cells+base, tmp, count2*sizeof(ImatCell*));
+  }
+
+  free(tmp);
+}
+
 static void iMatrixGetInitialValues(Ihandle* ih)
 {
   int lin, col;
@@ -75,6 +297,7 @@ void iupMatrixMemAlloc(Ihandle* ih)
   ih->data->columns.dt = (ImatLinCol*)calloc(ih->data->columns.num_alloc, sizeof(ImatLinCol));
 
   /* numeric_columns is allocated when a NUMERIC* attribute is set */
+  /* column_data is allocated when the COLUMNSTORAGE attribute is set */
   /* sort_line_index is allocated when the SORTCOLUMN attribute is set */
 }
 
@@ -113,12 +336,37 @@ void iupMatrixMemRelease(Ihandle* ih)
     ih->data->lines.dt = NULL;
   }
 
+  if (ih->data->columns.pos)
+  {
+    free(ih->data->columns.pos);
+    ih->data->columns.pos = NULL;
+    ih->data->columns.pos_alloc = 0;
+    ih->data->columns.pos_valid = 0;
+  }
+
+  if (ih->data->lines.pos)
+  {
+    free(ih->data->lines.pos);
+    ih->data->lines.pos = NULL;
+    ih->data->lines.pos_alloc = 0;
+    ih->data->lines.pos_valid = 0;
+  }
+
   if (ih->data->numeric_columns)
   {
     free(ih->data->numeric_columns);
     ih->data->numeric_columns = NULL;
   }
 
+  if (ih->data->column_data)
+  {
+    int col;
+    for (col = 0; col < ih->data->columns.num_alloc; col++)
+      iMatrixColumnDataFree(ih->data->column_data + col);
+    free(ih->data->column_data);
+    ih->data->column_data = NULL;
+  }
+
   if (ih->data->sort_line_index)
   {
     free(ih->data->sort_line_index);
@@ -140,6 +388,8 @@ void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
 
   if (ih->data->undo_redo) iupAttribSetClassObject(ih, "UNDOCLEAR", NULL);
 
+  ih->data->lines.pos_valid = 0;
+
   /* base is the first line where the change started */
 
   /* If it doesn't have enough lines allocated, then allocate more space */
@@ -160,6 +410,8 @@ void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
     ih->data->lines.dt = (ImatLinCol*)realloc(ih->data->lines.dt, ih->data->lines.num_alloc*sizeof(ImatLinCol));
     if (ih->data->sort_line_index)
       ih->data->sort_line_index = (int*)realloc(ih->data->sort_line_index, ih->data->lines.num_alloc*sizeof(int));
+    if (ih->data->column_data)
+      iMatrixColumnDataReAllocLines(ih, old_alloc);
   }
 
   if (old_num==num)
@@ -172,12 +424,10 @@ void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
     end = base+diff_num;
 
     /* shift the old data, opening space for new data, from base to end */
-    /*   do it in reverse order to avoid overlapping */
     if (shift_num)
     {
-      if (!ih->data->callback_mode)
-        for (lin = shift_num-1; lin >= 0; lin--)   /* all columns, shift_num lines */
-          memmove(ih->data->cells[lin+end], ih->data->cells[lin+base], ih->data->columns.num_alloc*sizeof(ImatCell));
+      if (!ih->data->callback_mode)  /* only the line pointers are moved, the unused lines after old_num are reused at base */
+        iMatrixRotateLines(ih->data->cells, base, shift_num, diff_num);
       memmove(ih->data->lines.dt+end, ih->data->lines.dt+base, shift_num*sizeof(ImatLinCol));
     }
 
@@ -186,6 +436,8 @@ void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
       for (lin = 0; lin < diff_num; lin++)        /* all columns, diff_num lines */
         memset(ih->data->cells[lin+base], 0, ih->data->columns.num_alloc*sizeof(ImatCell));
     memset(ih->data->lines.dt+base, 0, diff_num*sizeof(ImatLinCol));
+    if (ih->data->column_data)
+      iMatrixColumnDataMoveLines(ih, end, base, shift_num, base, diff_num);
 
     /* reset sort indices */
     if (ih->data->sort_has_index) ih->data->sort_has_index = 0;
@@ -217,9 +469,8 @@ void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
     /* move the old data to opened space from end to base */
     if (shift_num)
     {
-      if (!ih->data->callback_mode)
-        for (lin = 0; lin < shift_num; lin++) /* all columns, shift_num lines */
-          memmove(ih->data->cells[lin+base], ih->data->cells[lin+end], ih->data->columns.num_alloc*sizeof(ImatCell));
+      if (!ih->data->callback_mode)  /* only the line pointers are moved, the removed lines are reused after num */
+        iMatrixRotateLines(ih->data->cells, base, diff_num, shift_num);
       memmove(ih->data->lines.dt+base, ih->data->lines.dt+end, shift_num*sizeof(ImatLinCol));
     }
 
@@ -228,6 +479,8 @@ void iupMatrixMemReAllocLines(Ihandle* ih, int old_num, int num, int base)
       for (lin = 0; lin < diff_num; lin++)   /* all columns, diff_num lines */
         memset(ih->data->cells[lin+num], 0, ih->data->columns.num_alloc*sizeof(ImatCell));
     memset(ih->data->lines.dt+num, 0, diff_num*sizeof(ImatLinCol));
+    if (ih->data->column_data)
+      iMatrixColumnDataMoveLines(ih, base, end, shift_num, num, diff_num);
 
     /* reset sort indices */
     if (ih->data->sort_has_index) ih->data->sort_has_index = 0;
@@ -240,11 +493,14 @@ void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base)
 
   if (ih->data->undo_redo) iupAttribSetClassObject(ih, "UNDOCLEAR", NULL);
 
+  ih->data->columns.pos_valid = 0;
+
   /* base is the first column where the change started */
 
   /* If it doesn't have enough columns allocated, then allocate more space */
   if (num > ih->data->columns.num_alloc)  /* this also implicates that also num>old_num */
   {
+    int old_alloc = ih->data->columns.num_alloc;
     ih->data->columns.num_alloc = num;
 
     /* new space are allocated at the end, later we need to move the old data and clear the available space */
@@ -258,6 +514,11 @@ void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base)
     ih->data->columns.dt = (ImatLinCol*)realloc(ih->data->columns.dt, ih->data->columns.num_alloc*sizeof(ImatLinCol));
     if (ih->data->numeric_columns)
       ih->data->numeric_columns = (ImatNumericData*)realloc(ih->data->numeric_columns, ih->data->columns.num_alloc*sizeof(ImatNumericData));
+    if (ih->data->column_data)
+    {
+      ih->data->column_data = (ImatColumnData*)realloc(ih->data->column_data, ih->data->columns.num_alloc*sizeof(ImatColumnData));
+      memset(ih->data->column_data+old_alloc, 0, (num-old_alloc)*sizeof(ImatColumnData));
+    }
   }
 
   if (old_num==num)
@@ -281,6 +542,8 @@ void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base)
       memmove(ih->data->columns.dt+end, ih->data->columns.dt+base, shift_num*sizeof(ImatLinCol));
       if (ih->data->numeric_columns)
         memmove(ih->data->numeric_columns+end, ih->data->numeric_columns+base, shift_num*sizeof(ImatNumericData));
+      if (ih->data->column_data)
+        memmove(ih->data->column_data+end, ih->data->column_data+base, shift_num*sizeof(ImatColumnData));
     }
 
     /* then clear the opened space starting at base */
@@ -290,6 +553,8 @@ void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base)
     memset(ih->data->columns.dt+base, 0, diff_num*sizeof(ImatLinCol));
     if (ih->data->numeric_columns)
       memset(ih->data->numeric_columns+base, 0, diff_num*sizeof(ImatNumericData));
+    if (ih->data->column_data)
+      memset(ih->data->column_data+base, 0, diff_num*sizeof(ImatColumnData));
   }
   else /* DEL */
   {
@@ -315,6 +580,12 @@ void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base)
       }
     }
 
+    if (ih->data->column_data)
+    {
+      for(col = base; col < end; col++)
+        iMatrixColumnDataFree(ih->data->column_data + col);
+    }
+
     /* move the old data to opened space from end to base */
     /*   even if (num-base)>(old_num-num) memmove will correctly copy the memory */
     if (shift_num)
@@ -325,6 +596,8 @@ void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base)
       memmove(ih->data->columns.dt+base, ih->data->columns.dt+end, shift_num*sizeof(ImatLinCol));
       if (ih->data->numeric_columns)
         memmove(ih->data->numeric_columns+base, ih->data->numeric_columns+end, shift_num*sizeof(ImatNumericData));
+      if (ih->data->column_data)
+        memmove(ih->data->column_data+base, ih->data->column_data+end, shift_num*sizeof(ImatColumnData));
     }
 
     /* then clear the remaining space starting at num */
@@ -334,5 +607,124 @@ void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base)
     memset(ih->data->columns.dt+num, 0, diff_num*sizeof(ImatLinCol));
     if (ih->data->numeric_columns)
       memset(ih->data->numeric_columns+num, 0, diff_num*sizeof(ImatNumericData));
+    if (ih->data->column_data)
+      memset(ih->data->column_data+num, 0, diff_num*sizeof(ImatColumnData));
   }
 }
+
+int iupMatrixMemGetColumnStorage(Ihandle* ih, int col)
+{
+  if (!ih->data->column_data)
+    return IMAT_STORAGE_TEXT;
+  return ih->data->column_data[col].type;
+}
+
+void iupMatrixMemSetColumnStorage(Ihandle* ih, int col, int type)
+{
+  ImatColumnData* column;
+  int lin;
+
+  if (ih->data->callback_mode)
+    return;
+
+  if (!ih->data->column_data)
+  {
+    if (type == IMAT_STORAGE_TEXT)
+      return;
+
+    ih->data->column_data = (ImatColumnData*)calloc(ih->data->columns.num_alloc, sizeof(ImatColumnData));
+  }
+
+  column = &(ih->data->column_data[col]);
+  if (column->type == type)
+    return;
+
+  if (column->type != IMAT_STORAGE_TEXT)
+  {
+    /* move the typed values back to the cells as text */
+    for (lin = 1; lin < ih->data->lines.num; lin++)
+    {
+      if (iMatrixBitIsSet(column->valid, lin))
+        ih->data->cells[lin][col].value = iupStrDup(iMatrixColumnFormatValue(column, lin));
+    }
+
+    iMatrixColumnDataFree(column);
+  }
+
+  if (type != IMAT_STORAGE_TEXT)
+  {
+    column->type = type;
+    column->values = calloc(ih->data->lines.num_alloc, iMatrixColumnValueSize(type));
+    column->valid = (unsigned char*)calloc(iMatrixBitsSize(ih->data->lines.num_alloc), 1);
+
+    if (type == IMAT_STORAGE_STRING)
+    {
+      column->str_table = iupTableCreate(IUPTABLE_STRINGINDEXED);
+      column->str_array = iupArrayCreate(50, sizeof(char*));
+    }
+
+    /* convert the text values of the cells, 
+       values that can not be converted are kept in the cells */
+    for (lin = 1; lin < ih->data->lines.num; lin++)
+    {
+      ImatCell* cell = &(ih->data->cells[lin][col]);
+      if (cell->value && iMatrixColumnStoreValue(column, lin, cell->value))
+      {
+        free(cell->value);
+        cell->value = NULL;
+      }
+    }
+  }
+}
+
+void iupMatrixMemSetTypedValue(Ihandle* ih, int lin, int col, const char* value)
+{
+  ImatColumnData* column = &(ih->data->column_data[col]);
+  ImatCell* cell = &(ih->data->cells[lin][col]);
+
+  if (cell->value)
+  {
+    free(cell->value);
+    cell->value = NULL;
+  }
+
+  if (value && iMatrixColumnStoreValue(column, lin, value))
+    return;
+
+  /* can not be stored in the column type, keep it as text */
+  iMatrixBitSet(column->valid, lin, 0);
+  cell->value = iupStrDup(value);
+}
+
+char* iupMatrixMemGetTypedValue(Ihandle* ih, int lin, int col)
+{
+  ImatColumnData* column = &(ih->data->column_data[col]);
+
+  if (!iMatrixBitIsSet(column->valid, lin))
+    return ih->data->cells[lin][col].value;
+
+  return iMatrixColumnFormatValue(column, lin);
+}
+
+int iupMatrixMemGetTypedNumber(Ihandle* ih, int lin, int col, double *number)
+{
+  ImatColumnData* column = &(ih->data->column_data[col]);
+
+  if (!iMatrixBitIsSet(column->valid, lin))
+    return 0;
+
+  switch (column->type)
+  {
+  case IMAT_STORAGE_REAL:
+    *number = ((double*)column->values)[lin];
+    return 1;
+  case IMAT_STORAGE_INTEGER:
+    *number = (double)((long long*)column->values)[lin];
+    return 1;
+  case IMAT_STORAGE_BOOLEAN:
+    *number = (double)((unsigned char*)column->values)[lin];
+    return 1;
+  }
+
+  return 0;
+}
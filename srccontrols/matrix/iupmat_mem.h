@@ -17,6 +17,13 @@ void iupMatrixMemRelease(Ihandle* ih);
 void iupMatrixMemReAllocLines  (Ihandle* ih, int old_num, int num, int base);
 void iupMatrixMemReAllocColumns(Ihandle* ih, int old_num, int num, int base);
 
+/* Typed column storage, not used in callback mode and for the title line */
+int   iupMatrixMemGetColumnStorage(Ihandle* ih, int col);
+void  iupMatrixMemSetColumnStorage(Ihandle* ih, int col, int type);
+void  iupMatrixMemSetTypedValue(Ihandle* ih, int lin, int col, const char* value);
+char* iupMatrixMemGetTypedValue(Ihandle* ih, int lin, int col);
+int   iupMatrixMemGetTypedNumber(Ihandle* ih, int lin, int col, double *number);
+
 #ifdef __cplusplus
 }
 #endif
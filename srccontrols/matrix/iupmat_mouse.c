@@ -207,8 +207,8 @@ static void iMatrixMouseLeftPress(Ihandle* ih, int lin, int col, int shift, int
           }
           else
           {
-            togglevalue = !iupAttribGetIntId2(ih, "TOGGLEVALUE", lin, col);  /* invert value */
-            iupAttribSetIntId2(ih, "TOGGLEVALUE", lin, col, togglevalue);
+            togglevalue = !iupMatrixGetIntAttribId2(ih, "TOGGLEVALUE", lin, col);  /* invert value */
+            iupMatrixSetAttribId2(ih, "TOGGLEVALUE", lin, col, iupStrReturnInt(togglevalue));
           }
 
           iupMatrixDrawCells(ih, lin, col, lin, col);
@@ -28,20 +28,25 @@
 #include "iupmat_edit.h"
 #include "iupmat_mem.h"
 #include "iupmat_numlc.h"
+#include "iupmat_getset.h"
 #include "iupmat_draw.h"
 #include "iupmat_aux.h"
 
 
-/* Always preserve these attributes here because they are actually stored in the hash table.
-   Some of there also have flags, but flags are only used to signal that an attribute was set 
-   and we must be consistent between flags and hash table.
+/* These attributes are stored in attrib_table using the storage id of the column/line 
+   (see iupMatrixGetAttribId2), so when columns/lines are added or removed only 
+   the storage ids are moved, see iMatrixUpdateSlots.
+   Some of them also have flags, but flags are only used to signal that an attribute was set 
+   and they are moved together with the cells.
 
    BGCOLOR
    FGCOLOR
    FONT
    FRAMEHORIZCOLOR
    FRAMEVERTCOLOR
-   MASK
+   FRAMETITLEHORIZCOLOR
+   FRAMETITLEVERTCOLOR
+   MASK (and MASKINT, MASKFLOAT, MASKNOEMPTY, MASKCASEI)
    ALIGN
    MERGED
    SORTSIGN
@@ -54,8 +59,8 @@
    NUMERICFORMATTITLE
    TYPE
 
-   Obs: L:C is never stored in the hash table.
-         MARK is stored in the hash table when in callback mode and the MARK*_CB callbacks are not defined.
+   Obs: L:C is never stored in attrib_table.
+         MARK is stored in attrib_table when in callback mode and the MARK*_CB callbacks are not defined.
 */
 
 #define IMAT_NUM_ATTRIB_LINE 8
@@ -85,17 +90,23 @@ static char* imatrix_col_attrib[IMAT_NUM_ATTRIB_COL] = {
   "TYPE",
   "FRAMEVERTCOLOR"};
 
-#define IMAT_NUM_ATTRIB_CELL 11
+#define IMAT_NUM_ATTRIB_CELL 17
 static char* imatrix_cell_attrib[IMAT_NUM_ATTRIB_CELL] = { 
   "BGCOLOR",   /* all use L:C */
   "FGCOLOR",
   "FONT",
   "TYPE",
   "MASK",
+  "MASKINT",
+  "MASKFLOAT",
+  "MASKNOEMPTY",
+  "MASKCASEI",
   "ALIGN",
   "TOGGLEVALUE",
   "FRAMEHORIZCOLOR",
   "FRAMEVERTCOLOR",
+  "FRAMETITLEHORIZCOLOR",
+  "FRAMETITLEVERTCOLOR",
   "MARK",    /* must be at last */
   "MERGED"}; /* must be at last */
 
@@ -109,13 +120,13 @@ void iupMatrixCopyLinAttributes(Ihandle* ih, int lin1, int lin2)
   {
     if (a < IMAT_NUM_ATTRIB_LINE_ONLY)
     {
-      value = iupAttribGetId(ih, imatrix_lin_attrib[a], lin1);
-      iupAttribSetStrId(ih, imatrix_lin_attrib[a], lin2, value);
+      value = iupMatrixGetAttribLin(ih, imatrix_lin_attrib[a], lin1);
+      iupMatrixSetAttribLin(ih, imatrix_lin_attrib[a], lin2, value);
     }
     else
     {
-      value = iupAttribGetId2(ih, imatrix_lin_attrib[a], lin1, IUP_INVALID_ID);
-      iupAttribSetStrId2(ih, imatrix_lin_attrib[a], lin2, IUP_INVALID_ID, value);
+      value = iupMatrixGetAttribId2(ih, imatrix_lin_attrib[a], lin1, IUP_INVALID_ID);
+      iupMatrixSetAttribId2(ih, imatrix_lin_attrib[a], lin2, IUP_INVALID_ID, value);
     }
   }
 
@@ -124,8 +135,8 @@ void iupMatrixCopyLinAttributes(Ihandle* ih, int lin1, int lin2)
   {
     for(col = 0; col < ih->data->columns.num; col++)
     {
-      value = iupAttribGetId2(ih, imatrix_cell_attrib[a], lin1, col);
-      iupAttribSetStrId2(ih, imatrix_cell_attrib[a], lin2, col, value);
+      value = iupMatrixGetAttribId2(ih, imatrix_cell_attrib[a], lin1, col);
+      iupMatrixSetAttribId2(ih, imatrix_cell_attrib[a], lin2, col, value);
     }
   }
 }
@@ -140,13 +151,13 @@ void iupMatrixCopyColAttributes(Ihandle* ih, int col1, int col2)
   {
     if (a < IMAT_NUM_ATTRIB_COL_ONLY)
     {
-      value = iupAttribGetId(ih, imatrix_col_attrib[a], col1);
-      iupAttribSetStrId(ih, imatrix_col_attrib[a], col2, value);
+      value = iupMatrixGetAttribCol(ih, imatrix_col_attrib[a], col1);
+      iupMatrixSetAttribCol(ih, imatrix_col_attrib[a], col2, value);
     }
     else
     {
-      value = iupAttribGetId2(ih, imatrix_col_attrib[a], IUP_INVALID_ID, col1);
-      iupAttribSetStrId2(ih, imatrix_col_attrib[a], IUP_INVALID_ID, col2, value);
+      value = iupMatrixGetAttribId2(ih, imatrix_col_attrib[a], IUP_INVALID_ID, col1);
+      iupMatrixSetAttribId2(ih, imatrix_col_attrib[a], IUP_INVALID_ID, col2, value);
     }
   }
 
@@ -155,8 +166,8 @@ void iupMatrixCopyColAttributes(Ihandle* ih, int col1, int col2)
   {
     for(lin = 0; lin < ih->data->lines.num; lin++)
     {
-      value = iupAttribGetId2(ih, imatrix_cell_attrib[a], lin, col1);
-      iupAttribSetStrId2(ih, imatrix_cell_attrib[a], lin, col2, value);
+      value = iupMatrixGetAttribId2(ih, imatrix_cell_attrib[a], lin, col1);
+      iupMatrixSetAttribId2(ih, imatrix_cell_attrib[a], lin, col2, value);
     }
   }
 }
@@ -200,7 +211,7 @@ static void iMatrixCheckMergedLin(Ihandle* ih, int lin, int add)
             merged_data->used = 0;
             ih->data->merge_info_count--;
 
-            iupAttribSetId2(ih, "MERGED", merged_data->start_lin, merged_data->start_col, NULL);
+            iupMatrixSetAttribId2(ih, "MERGED", merged_data->start_lin, merged_data->start_col, NULL);
           }
         }
       }
@@ -247,7 +258,7 @@ static void iMatrixCheckMergedCol(Ihandle* ih, int col, int add)
             merged_data->used = 0;
             ih->data->merge_info_count--;
 
-            iupAttribSetId2(ih, "MERGED", merged_data->start_lin, merged_data->start_col, NULL);
+            iupMatrixSetAttribId2(ih, "MERGED", merged_data->start_lin, merged_data->start_col, NULL);
           }
         }
       }
@@ -255,81 +266,255 @@ static void iMatrixCheckMergedCol(Ihandle* ih, int col, int add)
   }
 }
 
-static void iMatrixClearLinAttributes(Ihandle* ih, int lin, int add)
+static int iMatrixFindAttrib(char** attrib_list, int start, int end, const char* name, int name_len)
 {
-  int a, col, num_attrib_cell;
+  int a;
+  for (a = start; a < end; a++)
+  {
+    if (strncmp(attrib_list[a], name, name_len) == 0 && attrib_list[a][name_len] == 0)
+      return a;
+  }
+  return -1;
+}
 
-  for(a = 0; a < IMAT_NUM_ATTRIB_LINE; a++)
+static const char* iMatrixParseId(const char* str, int *id)
+{
+  int neg = 0;
+
+  if (*str == '*')
   {
-    if (a < IMAT_NUM_ATTRIB_LINE_ONLY)
-      iupAttribSetId(ih, imatrix_lin_attrib[a], lin, NULL);
-    else
-      iupAttribSetId2(ih, imatrix_lin_attrib[a], lin, IUP_INVALID_ID, NULL);
+    *id = IUP_INVALID_ID;
+    return str + 1;
   }
 
-  num_attrib_cell = IMAT_NUM_ATTRIB_CELL;
-  if (add)
-    num_attrib_cell -= 2; /* do not clear MARK and MERGED */
+  if (*str == '-')  /* storage ids after the last column/line */
+  {
+    neg = 1;
+    str++;
+  }
+
+  if (*str < '0' || *str > '9')
+    return NULL;
 
-  for (a = 0; a < num_attrib_cell; a++)
+  *id = 0;
+  while (*str >= '0' && *str <= '9')
   {
-    for(col = 0; col < ih->data->columns.num; col++)
-      iupAttribSetId2(ih, imatrix_cell_attrib[a], lin, col, NULL);
+    *id = *id * 10 + (*str - '0');
+    str++;
   }
+
+  if (neg)
+    *id = -(*id);
+  return str;
 }
 
-static void iMatrixClearColAttributes(Ihandle* ih, int col, int add)
+static int iMatrixParseAttribId(const char* attrib, int *name_len, int *lin, int *col)
 {
-  int a, lin, num_attrib_cell;
+  /* returns 1 for "NAMEid" and 2 for "NAMElin:col", 0 if it is not an attribute with id */
+  const char* str = attrib;
+  while (*str && *str != '*' && *str != '-' && (*str < '0' || *str > '9'))
+    str++;
 
-  for(a = 0; a < IMAT_NUM_ATTRIB_COL; a++)
+  *name_len = (int)(str - attrib);
+  if (*name_len == 0 || *str == 0)
+    return 0;
+
+  str = iMatrixParseId(str, lin);
+  if (!str)
+    return 0;
+
+  if (*str == 0)
   {
-    if (a < IMAT_NUM_ATTRIB_COL_ONLY)
-      iupAttribSetId(ih, imatrix_col_attrib[a], col, NULL);
+    *col = *lin;
+    return 1;
+  }
+
+  if (*str != ':')
+    return 0;
+
+  str = iMatrixParseId(str + 1, col);
+  if (!str || *str != 0)
+    return 0;
+
+  return 2;
+}
+
+static int iMatrixGetAttribLinCol(const char* attrib, int name_len, int ret, int lin, int col, int m)
+{
+  /* returns the line or the column of one of the attributes stored in attrib_table, 
+     or IUP_INVALID_ID if it is not one of them or it does not have an id for the given dimension */
+  if (ret == 1)
+  {
+    if (m == IMAT_PROCESS_LIN)
+      return (iMatrixFindAttrib(imatrix_lin_attrib, 0, IMAT_NUM_ATTRIB_LINE_ONLY, attrib, name_len) != -1)? lin: IUP_INVALID_ID;
     else
-      iupAttribSetId2(ih, imatrix_col_attrib[a], IUP_INVALID_ID, col, NULL);
+      return (iMatrixFindAttrib(imatrix_col_attrib, 0, IMAT_NUM_ATTRIB_COL_ONLY, attrib, name_len) != -1)? col: IUP_INVALID_ID;
   }
 
-  num_attrib_cell = IMAT_NUM_ATTRIB_CELL;
-  if (add)
-    num_attrib_cell -= 2; /* do not clear MARK and MERGED */
+  if (iMatrixFindAttrib(imatrix_cell_attrib, 0, IMAT_NUM_ATTRIB_CELL, attrib, name_len) == -1)
+    return IUP_INVALID_ID;
 
-  for (a = 0; a < num_attrib_cell; a++)
+  return (m == IMAT_PROCESS_LIN)? lin: col;
+}
+
+static void iMatrixRemoveAttribList(Itable* table, Iarray* names_array)
+{
+  char** names = (char**)iupArrayGetData(names_array);
+  int i, count = iupArrayCount(names_array);
+
+  for (i = 0; i < count; i++)
   {
-    for(lin = 0; lin < ih->data->lines.num; lin++)
-      iupAttribSetId2(ih, imatrix_cell_attrib[a], lin, col, NULL);
+    iupTableRemove(table, names[i]);
+    free(names[i]);
   }
+
+  iupArrayDestroy(names_array);
 }
 
-static void iMatrixUpdateLineAttributes(Ihandle* ih, int base, int count, int add)
+static void iMatrixCreateSlots(Ihandle* ih, ImatLinColData* lincol, int old_num)
 {
-  int lin;
+  /* Until now the storage id was the index of the column/line.
+     The new storage ids must not be used by any existent attribute. */
+  int i, max_id = old_num - 1;
 
-  /* Here the size of the matrix is already updated */
+  if (ih->data->attrib_table)
+  {
+    char* attrib = iupTableFirst(ih->data->attrib_table);
+    while (attrib)
+    {
+      int name_len, lin, col;
+      if (iMatrixParseAttribId(attrib, &name_len, &lin, &col))
+      {
+        if (lin > max_id) max_id = lin;
+        if (col > max_id) max_id = col;
+      }
+
+      attrib = iupTableNext(ih->data->attrib_table);
+    }
+  }
+
+  lincol->slot_alloc = old_num + 10;
+  lincol->slot = (int*)malloc(lincol->slot_alloc * sizeof(int));
+  for (i = 0; i < old_num; i++)
+    lincol->slot[i] = i;
+
+  lincol->slot_next = max_id + 1;
+  lincol->slot_dead = 0;
+}
 
-  if (add)  /* ADD */
+static void iMatrixCompactSlots(Ihandle* ih, ImatLinColData* lincol, int m)
+{
+  /* remove the attributes of the removed columns/lines */
+  unsigned char* used = (unsigned char*)calloc(lincol->slot_next, 1);
+  Iarray* removed_array = iupArrayCreate(50, sizeof(char*));
+  char* attrib;
+  int i;
+
+  for (i = 0; i < lincol->num; i++)
+    used[lincol->slot[i]] = 1;
+
+  attrib = iupTableFirst(ih->data->attrib_table);
+  while (attrib)
   {
-    /* copy the attributes of the moved cells, from base+count to num */
-    /*   do it in reverse order to avoid overlapping */
-    /* then clear the new space starting from base to base+count */
+    int name_len, lin, col, id;
+    int ret = iMatrixParseAttribId(attrib, &name_len, &lin, &col);
+    id = ret? iMatrixGetAttribLinCol(attrib, name_len, ret, lin, col, m): IUP_INVALID_ID;
+
+    if (id >= 0 && id < lincol->slot_next && !used[id])
+    {
+      char** removed = (char**)iupArrayInc(removed_array);
+      removed[iupArrayCount(removed_array) - 1] = iupStrDup(attrib);
+    }
+
+    attrib = iupTableNext(ih->data->attrib_table);
+  }
+
+  iMatrixRemoveAttribList(ih->data->attrib_table, removed_array);
+  free(used);
+
+  lincol->slot_dead = 0;
+}
+
+static void iMatrixUpdateSlots(Ihandle* ih, ImatLinColData* lincol, int base, int count, int add, int m)
+{
+  /* Here the size of the matrix is already updated.
+     Instead of renaming the attributes of all the columns/lines after base, 
+     only the storage ids are moved. */
+  int num = lincol->num;
+  int old_num = add? num - count: num + count;
 
-    for(lin = ih->data->lines.num-1; lin >= base+count; lin--)
-      iupMatrixCopyLinAttributes(ih, lin-count, lin);  /* from lin1 to lin2 */
+  if (!lincol->slot)
+  {
+    if (add && base >= old_num)  /* when only appending the index can still be used as storage id */
+      return;
 
-    for(lin = base; lin < base+count; lin++)
-      iMatrixClearLinAttributes(ih, lin, 1);
+    iMatrixCreateSlots(ih, lincol, old_num);
   }
-  else  /* DEL */
+
+  if (add)
   {
-    /* copy the attributes of the moved cells from base+count to base */
-    /* then clear the remaining space starting at num */
+    int i;
 
-    for(lin = base; lin < ih->data->lines.num; lin++)
-      iupMatrixCopyLinAttributes(ih, lin+count, lin);
+    if (num > lincol->slot_alloc)
+    {
+      lincol->slot_alloc = num + num / 2;
+      lincol->slot = (int*)realloc(lincol->slot, lincol->slot_alloc * sizeof(int));
+    }
 
-    for(lin = ih->data->lines.num; lin < ih->data->lines.num+count; lin++)
-      iMatrixClearLinAttributes(ih, lin, 0);
+    if (base < old_num)
+      memmove(lincol->slot + base + count, lincol->slot + base, (old_num - base) * sizeof(int));
+
+    /* new columns/lines have no attributes */
+    for (i = base; i < base + count; i++)
+      lincol->slot[i] = lincol->slot_next++;
   }
+  else
+  {
+    if (base + count < old_num)
+      memmove(lincol->slot + base, lincol->slot + base + count, (old_num - base - count) * sizeof(int));
+
+    lincol->slot_dead += count;
+
+    if (ih->data->attrib_table && lincol->slot_dead > 1000 && lincol->slot_dead > num)
+      iMatrixCompactSlots(ih, lincol, m);
+  }
+}
+
+static void iMatrixKeepMarkAndMerged(Ihandle* ih, int base, int count, int old_num, int m)
+{
+  /* new columns/lines keep MARK and MERGED of the columns/lines that were at the same position */
+  int i, j, a, num;
+
+  if (!ih->data->attrib_table)
+    return;
+
+  num = (m == IMAT_PROCESS_LIN)? ih->data->columns.num: ih->data->lines.num;
+
+  for (i = base; i < base + count && i < old_num; i++)
+  {
+    for (j = 0; j < num; j++)
+    {
+      for (a = IMAT_NUM_ATTRIB_CELL - 2; a < IMAT_NUM_ATTRIB_CELL; a++)
+      {
+        if (m == IMAT_PROCESS_LIN)
+          iupMatrixSetAttribId2(ih, imatrix_cell_attrib[a], i, j, iupMatrixGetAttribId2(ih, imatrix_cell_attrib[a], i + count, j));
+        else
+          iupMatrixSetAttribId2(ih, imatrix_cell_attrib[a], j, i, iupMatrixGetAttribId2(ih, imatrix_cell_attrib[a], j, i + count));
+      }
+    }
+  }
+}
+
+static void iMatrixUpdateLineAttributes(Ihandle* ih, int base, int count, int add)
+{
+  int lin;
+
+  /* Here the size of the matrix is already updated */
+
+  iMatrixUpdateSlots(ih, &(ih->data->lines), base, count, add, IMAT_PROCESS_LIN);
+
+  if (add)
+    iMatrixKeepMarkAndMerged(ih, base, count, ih->data->lines.num - count, IMAT_PROCESS_LIN);
 
   /* check if a merged range was changed */
   if (ih->data->merge_info_count)
@@ -345,29 +530,10 @@ static void iMatrixUpdateColumnAttributes(Ihandle* ih, int base, int count, int
 
   /* Here the size of the matrix is already updated */
 
-  if (add)  /* ADD */
-  {
-    /* update the attributes of the moved cells, from base+count to num */
-    /*   do it in reverse order to avoid overlapping */
-    /* then clear the new space starting from base to base+count */
-
-    for(col = ih->data->columns.num-1; col >= base+count; col--)
-      iupMatrixCopyColAttributes(ih, col-count, col);
-
-    for(col = base; col < base+count; col++)
-      iMatrixClearColAttributes(ih, col, 1);
-  }
-  else   /* DEL */
-  {
-    /* copy the attributes of the moved cells from base+count to base */
-    /* then clear the remaining space starting at num */
-
-    for(col = base; col < ih->data->columns.num; col++)
-      iupMatrixCopyColAttributes(ih, col+count, col);
+  iMatrixUpdateSlots(ih, &(ih->data->columns), base, count, add, IMAT_PROCESS_COL);
 
-    for(col = ih->data->columns.num; col < ih->data->columns.num+count; col++)
-      iMatrixClearColAttributes(ih, col, 0);
-  }
+  if (add)
+    iMatrixKeepMarkAndMerged(ih, base, count, ih->data->columns.num - count, IMAT_PROCESS_COL);
 
   if (ih->data->merge_info_count)
   {
@@ -462,8 +628,7 @@ int iupMatrixSetAddLinAttrib(Ihandle* ih, const char* value)
   ih->data->lines.num += count;
   ih->data->need_calcsize = 1;
 
-  if (base < lines_num)  /* If before the last line. */
-    iMatrixUpdateLineAttributes(ih, base, count, 1);
+  iMatrixUpdateLineAttributes(ih, base, count, 1);
 
   if (focus_cell_changed)
     iupMatrixAuxCallEnterCellCb(ih);
@@ -507,8 +672,7 @@ int iupMatrixSetDelLinAttrib(Ihandle* ih, const char* value)
   ih->data->lines.num -= count;
   ih->data->need_calcsize = 1;
 
-  if (base < lines_num)  /* If before the last line. (always true when deleting) */
-    iMatrixUpdateLineAttributes(ih, base, count, 0);
+  iMatrixUpdateLineAttributes(ih, base, count, 0);
 
   if (focus_cell_changed)
     iupMatrixAuxCallEnterCellCb(ih);
@@ -547,8 +711,7 @@ int iupMatrixSetAddColAttrib(Ihandle* ih, const char* value)
   ih->data->columns.num += count;
   ih->data->need_calcsize = 1;
 
-  if (base < columns_num)  /* If before the last column. */
-    iMatrixUpdateColumnAttributes(ih, base, count, 1);
+  iMatrixUpdateColumnAttributes(ih, base, count, 1);
 
   if (focus_cell_changed)
     iupMatrixAuxCallEnterCellCb(ih);
@@ -592,8 +755,7 @@ int iupMatrixSetDelColAttrib(Ihandle* ih, const char* value)
   ih->data->columns.num -= count;
   ih->data->need_calcsize = 1;
 
-  if (base < columns_num)  /* If before the last column. (always true when deleting) */
-    iMatrixUpdateColumnAttributes(ih, base, count, 0);
+  iMatrixUpdateColumnAttributes(ih, base, count, 0);
 
   if (focus_cell_changed)
     iupMatrixAuxCallEnterCellCb(ih);
@@ -607,7 +769,7 @@ int iupMatrixSetNumLinAttrib(Ihandle* ih, const char* value)
   int num = 0;
   if (iupStrToInt(value, &num))
   {
-    int old_focus_cell;
+    int old_focus_cell, old_num = ih->data->lines.num;
 
     if (num < 0) num = 0;
 
@@ -625,6 +787,15 @@ int iupMatrixSetNumLinAttrib(Ihandle* ih, const char* value)
     }
 
     ih->data->lines.num = num;  
+
+    /* while the storage ids are the indices, the attributes of the lines after the end are kept */
+    if (ih->data->lines.slot && num != old_num)
+    {
+      if (num > old_num)
+        iMatrixUpdateSlots(ih, &(ih->data->lines), old_num, num - old_num, 1, IMAT_PROCESS_LIN);
+      else
+        iMatrixUpdateSlots(ih, &(ih->data->lines), num, old_num - num, 0, IMAT_PROCESS_LIN);
+    }
     if (ih->data->lines.num_noscroll >= ih->data->lines.num)
       ih->data->lines.num_noscroll = ih->data->lines.num - 1;
     if (ih->data->lines.num_noscroll < 1)
@@ -654,7 +825,7 @@ int iupMatrixSetNumColAttrib(Ihandle* ih, const char* value)
   int num = 0;
   if (iupStrToInt(value, &num))
   {
-    int old_focus_cell;
+    int old_focus_cell, old_num = ih->data->columns.num;
 
     if (num < 0) num = 0;
 
@@ -672,6 +843,15 @@ int iupMatrixSetNumColAttrib(Ihandle* ih, const char* value)
     }
 
     ih->data->columns.num = num;
+
+    /* while the storage ids are the indices, the attributes of the columns after the end are kept */
+    if (ih->data->columns.slot && num != old_num)
+    {
+      if (num > old_num)
+        iMatrixUpdateSlots(ih, &(ih->data->columns), old_num, num - old_num, 1, IMAT_PROCESS_COL);
+      else
+        iMatrixUpdateSlots(ih, &(ih->data->columns), num, old_num - num, 0, IMAT_PROCESS_COL);
+    }
     if (ih->data->columns.num_noscroll >= ih->data->columns.num)
       ih->data->columns.num_noscroll = ih->data->columns.num - 1;
     if (ih->data->columns.num_noscroll < 1)
@@ -695,3 +875,80 @@ int iupMatrixSetNumColAttrib(Ihandle* ih, const char* value)
 
   return 0;
 }
+
+void iupMatrixMoveHashAttributes(Ihandle* ih)
+{
+  /* Attributes with ids that were stored in the hash table of the element,
+     because they do not have a set method or it is called only after map,
+     are moved to attrib_table. */
+  Iarray* moved_array = iupArrayCreate(50, sizeof(char*));
+  char** moved;
+  int i, moved_count;
+  char* attrib;
+
+  attrib = iupTableFirst(ih->attrib);
+  while (attrib)
+  {
+    int name_len, lin, col;
+    int ret = iMatrixParseAttribId(attrib, &name_len, &lin, &col);
+
+    if (ret && iupTableGetCurrType(ih->attrib) == IUPTABLE_STRING &&
+        (iMatrixGetAttribLinCol(attrib, name_len, ret, lin, col, IMAT_PROCESS_LIN) != IUP_INVALID_ID ||
+         iMatrixGetAttribLinCol(attrib, name_len, ret, lin, col, IMAT_PROCESS_COL) != IUP_INVALID_ID))
+    {
+      moved = (char**)iupArrayInc(moved_array);
+      moved[iupArrayCount(moved_array) - 1] = iupStrDup(attrib);
+    }
+
+    attrib = iupTableNext(ih->attrib);
+  }
+
+  moved = (char**)iupArrayGetData(moved_array);
+  moved_count = iupArrayCount(moved_array);
+
+  for (i = 0; i < moved_count; i++)
+  {
+    int name_len, lin, col;
+    int ret = iMatrixParseAttribId(moved[i], &name_len, &lin, &col);
+    char* value = iupAttribGet(ih, moved[i]);
+    char name[100];
+
+    sprintf(name, "%.*s", name_len, moved[i]);
+
+    if (ret == 1)
+    {
+      if (iMatrixGetAttribLinCol(moved[i], name_len, ret, lin, col, IMAT_PROCESS_LIN) != IUP_INVALID_ID)
+        iupMatrixSetAttribLin(ih, name, lin, value);
+      else
+        iupMatrixSetAttribCol(ih, name, col, value);
+    }
+    else
+      iupMatrixSetAttribId2(ih, name, lin, col, value);
+
+    iupAttribSet(ih, moved[i], NULL);
+    free(moved[i]);
+  }
+
+  iupArrayDestroy(moved_array);
+}
+
+void iupMatrixReleaseAttributes(Ihandle* ih)
+{
+  if (ih->data->attrib_table)
+  {
+    iupTableDestroy(ih->data->attrib_table);
+    ih->data->attrib_table = NULL;
+  }
+
+  if (ih->data->lines.slot)
+  {
+    free(ih->data->lines.slot);
+    ih->data->lines.slot = NULL;
+  }
+
+  if (ih->data->columns.slot)
+  {
+    free(ih->data->columns.slot);
+    ih->data->columns.slot = NULL;
+  }
+}
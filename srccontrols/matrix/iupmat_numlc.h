@@ -24,6 +24,9 @@ int  iupMatrixSetNumColAttrib(Ihandle* ih, const char* value);
 void iupMatrixCopyLinAttributes(Ihandle* ih, int lin1, int lin2);
 void iupMatrixCopyColAttributes(Ihandle* ih, int col1, int col2);
 
+void iupMatrixMoveHashAttributes(Ihandle* ih);
+void iupMatrixReleaseAttributes(Ihandle* ih);
+
 #ifdef __cplusplus
 }
 #endif
@@ -448,17 +448,17 @@ static char* iMatrixGetEditNextAttrib(Ihandle* ih)
 
 static int iMatrixHasColWidth(Ihandle* ih, int col)
 {
-  char* value = iupAttribGetId(ih, "WIDTH", col);
+  char* value = iupMatrixGetAttribCol(ih, "WIDTH", col);
   if (!value)
-    value = iupAttribGetId(ih, "RASTERWIDTH", col);
+    value = iupMatrixGetAttribCol(ih, "RASTERWIDTH", col);
   return (value != NULL);
 }
 
 static int iMatrixHasLineHeight(Ihandle* ih, int lin)
 {
-  char* value = iupAttribGetId(ih, "HEIGHT", lin);
+  char* value = iupMatrixGetAttribLin(ih, "HEIGHT", lin);
   if (!value)
-    value = iupAttribGetId(ih, "RASTERHEIGHT", lin);
+    value = iupMatrixGetAttribLin(ih, "RASTERHEIGHT", lin);
   return (value != NULL);
 }
 
@@ -513,7 +513,7 @@ static void iMatrixFitLines(Ihandle* ih, int height)
     line_height = height / empty_lin_visible - (IMAT_PADDING_H + IMAT_FRAME_H);
 
     for (i = 0; i < empty_num; i++)
-      iupAttribSetIntId(ih, "RASTERHEIGHT", empty_lines[i], line_height);
+      iupMatrixSetAttribLin(ih, "RASTERHEIGHT", empty_lines[i], iupStrReturnInt(line_height));
   }
 
   free(empty_lines);
@@ -570,7 +570,7 @@ static void iMatrixFitColumns(Ihandle* ih, int width)
     column_width = width / empty_col_visible - (IMAT_PADDING_W + IMAT_FRAME_W);
 
     for (i = 0; i < empty_num; i++)
-      iupAttribSetIntId(ih, "RASTERWIDTH", empty_columns[i], column_width);
+      iupMatrixSetAttribCol(ih, "RASTERWIDTH", empty_columns[i], iupStrReturnInt(column_width));
   }
 
   free(empty_columns);
@@ -635,7 +635,7 @@ static void iMatrixFitColText(Ihandle* ih, int col)
   if (max && max > max_width)
     max_width = max;
 
-  iupAttribSetIntId(ih, "RASTERWIDTH", col, max_width);
+  iupMatrixSetAttribCol(ih, "RASTERWIDTH", col, iupStrReturnInt(max_width));
 }
 
 static void iMatrixFitLineText(Ihandle* ih, int line)
@@ -659,7 +659,7 @@ static void iMatrixFitLineText(Ihandle* ih, int line)
   if (max && max > max_height)
     max_height = max;
 
-  iupAttribSetIntId(ih, "RASTERHEIGHT", line, max_height);
+  iupMatrixSetAttribLin(ih, "RASTERHEIGHT", line, iupStrReturnInt(max_height));
 }
 
 static int iMatrixSetFitToTextAttrib(Ihandle* ih, const char* value)
@@ -846,13 +846,40 @@ static int iMatrixSetMoveLinAttrib(Ihandle* ih, int from_lin, const char* value)
   return 0;
 }
 
-static int iMatrixSetSizeAttrib(Ihandle* ih, int pos, const char* value)
+static int iMatrixSetSize(Ihandle* ih, const char* name, int pos, const char* value, int m)
 {
-  (void)pos;
-  (void)value;
   ih->data->need_calcsize = 1;
   IupUpdate(ih);  /* post a redraw */
-  return 1;  /* always save in the hash table, so when FONT is changed SIZE can be updated */
+
+  if (pos == IUP_INVALID_ID)
+    return 1;
+
+  /* always save the value, so when FONT is changed SIZE can be updated */
+  if (m == IMAT_PROCESS_COL)
+    iupMatrixSetAttribCol(ih, name, pos, value);
+  else
+    iupMatrixSetAttribLin(ih, name, pos, value);
+  return 0;
+}
+
+static int iMatrixSetWidthAttrib(Ihandle* ih, int col, const char* value)
+{
+  return iMatrixSetSize(ih, "WIDTH", col, value, IMAT_PROCESS_COL);
+}
+
+static int iMatrixSetHeightAttrib(Ihandle* ih, int lin, const char* value)
+{
+  return iMatrixSetSize(ih, "HEIGHT", lin, value, IMAT_PROCESS_LIN);
+}
+
+static int iMatrixSetRasterWidthAttrib(Ihandle* ih, int col, const char* value)
+{
+  return iMatrixSetSize(ih, "RASTERWIDTH", col, value, IMAT_PROCESS_COL);
+}
+
+static int iMatrixSetRasterHeightAttrib(Ihandle* ih, int lin, const char* value)
+{
+  return iMatrixSetSize(ih, "RASTERHEIGHT", lin, value, IMAT_PROCESS_LIN);
 }
 
 static char* iMatrixGetWidthAttrib(Ihandle* ih, int col)
@@ -877,7 +904,7 @@ static char* iMatrixGetRasterHeightAttrib(Ihandle* ih, int lin)
 
 static char* iMatrixGetAlignmentAttrib(Ihandle* ih, int col)
 {
-  char* align = iupAttribGetId(ih, "ALIGNMENT", col);
+  char* align = iupMatrixGetAttribCol(ih, "ALIGNMENT", col);
   if (!align)
   {
     align = iupAttribGet(ih, "ALIGNMENT");
@@ -892,7 +919,44 @@ static char* iMatrixGetAlignmentAttrib(Ihandle* ih, int col)
     }
   }
 
-  return NULL;
+  return align;
+}
+
+static int iMatrixSetAlignmentAttrib(Ihandle* ih, int col, const char* value)
+{
+  ih->data->need_redraw = 1;
+  if (col == IUP_INVALID_ID)
+    return 1;
+  iupMatrixSetAttribCol(ih, "ALIGNMENT", col, value);
+  return 0;
+}
+
+static char* iMatrixGetLineAlignmentAttrib(Ihandle* ih, int lin)
+{
+  return iupMatrixGetAttribLin(ih, "LINEALIGNMENT", lin);
+}
+
+static int iMatrixSetLineAlignmentAttrib(Ihandle* ih, int lin, const char* value)
+{
+  ih->data->need_redraw = 1;
+  if (lin == IUP_INVALID_ID)
+    return 1;
+  iupMatrixSetAttribLin(ih, "LINEALIGNMENT", lin, value);
+  return 0;
+}
+
+static char* iMatrixGetSortSignAttrib(Ihandle* ih, int col)
+{
+  return iupMatrixGetAttribCol(ih, "SORTSIGN", col);
+}
+
+static int iMatrixSetSortSignAttrib(Ihandle* ih, int col, const char* value)
+{
+  ih->data->need_redraw = 1;
+  if (col == IUP_INVALID_ID)
+    return 1;
+  iupMatrixSetAttribCol(ih, "SORTSIGN", col, value);
+  return 0;
 }
 
 static int iMatrixSetIdValueAttrib(Ihandle* ih, int lin, int col, const char* value)
@@ -961,33 +1025,33 @@ static void iMatrixClearAttribFlags(Ihandle* ih, unsigned char *flags, int lin,
   int is_marked = (*flags) & IMAT_IS_MARKED;
 
   if ((*flags) & IMAT_HAS_FONT)
-    iupAttribSetId2(ih, "FONT", lin, col, NULL);
+    iupMatrixSetAttribId2(ih, "FONT", lin, col, NULL);
 
   if ((*flags) & IMAT_HAS_FGCOLOR)
-    iupAttribSetId2(ih, "FGCOLOR", lin, col, NULL);
+    iupMatrixSetAttribId2(ih, "FGCOLOR", lin, col, NULL);
 
   if ((*flags) & IMAT_HAS_BGCOLOR)
-    iupAttribSetId2(ih, "BGCOLOR", lin, col, NULL);
+    iupMatrixSetAttribId2(ih, "BGCOLOR", lin, col, NULL);
 
   if ((*flags) & IMAT_HAS_FRAMEHORIZCOLOR)
-    iupAttribSetId2(ih, "FRAMEHORIZCOLOR", lin, col, NULL);
+    iupMatrixSetAttribId2(ih, "FRAMEHORIZCOLOR", lin, col, NULL);
 
   if ((*flags) & IMAT_HAS_FRAMEVERTCOLOR)
-    iupAttribSetId2(ih, "FRAMEVERTCOLOR", lin, col, NULL);
+    iupMatrixSetAttribId2(ih, "FRAMEVERTCOLOR", lin, col, NULL);
 
   if (lin == IUP_INVALID_ID)
   {
-    iupAttribSetId(ih, "ALIGNMENT", col, NULL);
-    iupAttribSetId(ih, "SORTSIGN", col, NULL);
+    iupMatrixSetAttribCol(ih, "ALIGNMENT", col, NULL);
+    iupMatrixSetAttribCol(ih, "SORTSIGN", col, NULL);
   }
 
   if (col == IUP_INVALID_ID)
-    iupAttribSetId(ih, "LINEALIGNMENT", lin, NULL);
+    iupMatrixSetAttribLin(ih, "LINEALIGNMENT", lin, NULL);
 
   if (lin == 0)
     iupAttribSetId(ih, "ALIGNMENTLIN", 0, NULL);
 
-  iupAttribSetId2(ih, "ALIGN", lin, col, NULL);
+  iupMatrixSetAttribId2(ih, "ALIGN", lin, col, NULL);
 
   *flags = 0; /* clear all flags, except marked state */
   if (is_marked)
@@ -1237,29 +1301,42 @@ static char* iMatrixGetShowFillValueAttrib(Ihandle* ih)
   return iupStrReturnBoolean(ih->data->show_fill_value);
 }
 
-static int iMatrixSetAttribFlags(Ihandle* ih, int lin, int col, const char* value, unsigned char attr)
+static int iMatrixSetAttribFlags(Ihandle* ih, const char* name, int lin, int col, const char* value, unsigned char attr)
 {
   if (lin >= 0 || col >= 0)
   {
     iupMatrixSetCellFlag(ih, lin, col, attr, value != NULL);
     ih->data->need_redraw = 1;
+
+    iupMatrixSetAttribId2(ih, name, lin, col, value);
+    return 0;
   }
   return 1;
 }
 
 static int iMatrixSetBgColorAttrib(Ihandle* ih, int lin, int col, const char* value)
 {
-  return iMatrixSetAttribFlags(ih, lin, col, value, IMAT_HAS_BGCOLOR);
+  return iMatrixSetAttribFlags(ih, "BGCOLOR", lin, col, value, IMAT_HAS_BGCOLOR);
 }
 
 static int iMatrixSetFgColorAttrib(Ihandle* ih, int lin, int col, const char* value)
 {
-  return iMatrixSetAttribFlags(ih, lin, col, value, IMAT_HAS_FGCOLOR);
+  return iMatrixSetAttribFlags(ih, "FGCOLOR", lin, col, value, IMAT_HAS_FGCOLOR);
+}
+
+static char* iMatrixGetFgColorAttrib(Ihandle* ih, int lin, int col)
+{
+  return iupMatrixGetAttribId2(ih, "FGCOLOR", lin, col);
 }
 
 static int iMatrixSetTypeAttrib(Ihandle* ih, int lin, int col, const char* value)
 {
-  return iMatrixSetAttribFlags(ih, lin, col, value, IMAT_HAS_TYPE);
+  return iMatrixSetAttribFlags(ih, "TYPE", lin, col, value, IMAT_HAS_TYPE);
+}
+
+static char* iMatrixGetTypeAttrib(Ihandle* ih, int lin, int col)
+{
+  return iupMatrixGetAttribId2(ih, "TYPE", lin, col);
 }
 
 static char* iMatrixGetFontAttribute(Ihandle* ih, int lin, int col)
@@ -1267,11 +1344,11 @@ static char* iMatrixGetFontAttribute(Ihandle* ih, int lin, int col)
   char* font = NULL;
 
   if (lin != IUP_INVALID_ID && col != IUP_INVALID_ID)
-    font = iupAttribGetId2(ih, "FONT", lin, col);
+    font = iupMatrixGetAttribId2(ih, "FONT", lin, col);
   if (!font && lin != IUP_INVALID_ID)
-    font = iupAttribGetId2(ih, "FONT", lin, IUP_INVALID_ID);
+    font = iupMatrixGetAttribId2(ih, "FONT", lin, IUP_INVALID_ID);
   if (!font && col != IUP_INVALID_ID)
-    font = iupAttribGetId2(ih, "FONT", IUP_INVALID_ID, col);
+    font = iupMatrixGetAttribId2(ih, "FONT", IUP_INVALID_ID, col);
   if (!font)
     font = IupGetAttribute(ih, "FONT");
 
@@ -1378,7 +1455,7 @@ static int iMatrixSetFontAttrib(Ihandle* ih, int lin, int col, const char* value
     return 1;
   }
 
-  return iMatrixSetAttribFlags(ih, lin, col, value, IMAT_HAS_FONT);
+  return iMatrixSetAttribFlags(ih, "FONT", lin, col, value, IMAT_HAS_FONT);
 }
 
 static char* iMatrixGetFontAttrib(Ihandle* ih, int lin, int col)
@@ -1391,17 +1468,137 @@ static char* iMatrixGetFontAttrib(Ihandle* ih, int lin, int col)
     else
       return value;
   }
-  return NULL;
+  return iupMatrixGetAttribId2(ih, "FONT", lin, col);
 }
 
 static int iMatrixSetFrameHorizColorAttrib(Ihandle* ih, int lin, int col, const char* value)
 {
-  return iMatrixSetAttribFlags(ih, lin, col, value, IMAT_HAS_FRAMEHORIZCOLOR);
+  return iMatrixSetAttribFlags(ih, "FRAMEHORIZCOLOR", lin, col, value, IMAT_HAS_FRAMEHORIZCOLOR);
+}
+
+static char* iMatrixGetFrameHorizColorAttrib(Ihandle* ih, int lin, int col)
+{
+  return iupMatrixGetAttribId2(ih, "FRAMEHORIZCOLOR", lin, col);
 }
 
 static int iMatrixSetFrameVertColorAttrib(Ihandle* ih, int lin, int col, const char* value)
 {
-  return iMatrixSetAttribFlags(ih, lin, col, value, IMAT_HAS_FRAMEVERTCOLOR);
+  return iMatrixSetAttribFlags(ih, "FRAMEVERTCOLOR", lin, col, value, IMAT_HAS_FRAMEVERTCOLOR);
+}
+
+static char* iMatrixGetFrameVertColorAttrib(Ihandle* ih, int lin, int col)
+{
+  return iupMatrixGetAttribId2(ih, "FRAMEVERTCOLOR", lin, col);
+}
+
+static int iMatrixSetFrameTitleHorizColorAttrib(Ihandle* ih, int lin, int col, const char* value)
+{
+  return iMatrixSetAttribFlags(ih, "FRAMETITLEHORIZCOLOR", lin, col, value, IMAT_HAS_FRAMEHORIZCOLOR);
+}
+
+static char* iMatrixGetFrameTitleHorizColorAttrib(Ihandle* ih, int lin, int col)
+{
+  return iupMatrixGetAttribId2(ih, "FRAMETITLEHORIZCOLOR", lin, col);
+}
+
+static int iMatrixSetFrameTitleVertColorAttrib(Ihandle* ih, int lin, int col, const char* value)
+{
+  return iMatrixSetAttribFlags(ih, "FRAMETITLEVERTCOLOR", lin, col, value, IMAT_HAS_FRAMEVERTCOLOR);
+}
+
+static char* iMatrixGetFrameTitleVertColorAttrib(Ihandle* ih, int lin, int col)
+{
+  return iupMatrixGetAttribId2(ih, "FRAMETITLEVERTCOLOR", lin, col);
+}
+
+static int iMatrixSetCellAttrib(Ihandle* ih, const char* name, int lin, int col, const char* value)
+{
+  if (lin == IUP_INVALID_ID && col == IUP_INVALID_ID)
+    return 1;
+  iupMatrixSetAttribId2(ih, name, lin, col, value);
+  return 0;
+}
+
+static int iMatrixSetToggleValueAttrib(Ihandle* ih, int lin, int col, const char* value)
+{
+  ih->data->need_redraw = 1;
+  return iMatrixSetCellAttrib(ih, "TOGGLEVALUE", lin, col, value);
+}
+
+static char* iMatrixGetToggleValueAttrib(Ihandle* ih, int lin, int col)
+{
+  return iupMatrixGetAttribId2(ih, "TOGGLEVALUE", lin, col);
+}
+
+static int iMatrixSetAlignAttrib(Ihandle* ih, int lin, int col, const char* value)
+{
+  ih->data->need_redraw = 1;
+  return iMatrixSetCellAttrib(ih, "ALIGN", lin, col, value);
+}
+
+static char* iMatrixGetAlignAttrib(Ihandle* ih, int lin, int col)
+{
+  return iupMatrixGetAttribId2(ih, "ALIGN", lin, col);
+}
+
+static int iMatrixSetMergedAttrib(Ihandle* ih, int lin, int col, const char* value)
+{
+  return iMatrixSetCellAttrib(ih, "MERGED", lin, col, value);
+}
+
+static char* iMatrixGetMergedAttrib(Ihandle* ih, int lin, int col)
+{
+  return iupMatrixGetAttribId2(ih, "MERGED", lin, col);
+}
+
+static int iMatrixSetMaskAttrib(Ihandle* ih, int lin, int col, const char* value)
+{
+  return iMatrixSetCellAttrib(ih, "MASK", lin, col, value);
+}
+
+static char* iMatrixGetMaskAttrib(Ihandle* ih, int lin, int col)
+{
+  return iupMatrixGetAttribId2(ih, "MASK", lin, col);
+}
+
+static int iMatrixSetMaskIntAttrib(Ihandle* ih, int lin, int col, const char* value)
+{
+  return iMatrixSetCellAttrib(ih, "MASKINT", lin, col, value);
+}
+
+static char* iMatrixGetMaskIntAttrib(Ihandle* ih, int lin, int col)
+{
+  return iupMatrixGetAttribId2(ih, "MASKINT", lin, col);
+}
+
+static int iMatrixSetMaskFloatAttrib(Ihandle* ih, int lin, int col, const char* value)
+{
+  return iMatrixSetCellAttrib(ih, "MASKFLOAT", lin, col, value);
+}
+
+static char* iMatrixGetMaskFloatAttrib(Ihandle* ih, int lin, int col)
+{
+  return iupMatrixGetAttribId2(ih, "MASKFLOAT", lin, col);
+}
+
+static int iMatrixSetMaskNoEmptyAttrib(Ihandle* ih, int lin, int col, const char* value)
+{
+  return iMatrixSetCellAttrib(ih, "MASKNOEMPTY", lin, col, value);
+}
+
+static char* iMatrixGetMaskNoEmptyAttrib(Ihandle* ih, int lin, int col)
+{
+  return iupMatrixGetAttribId2(ih, "MASKNOEMPTY", lin, col);
+}
+
+static int iMatrixSetMaskCaseIAttrib(Ihandle* ih, int lin, int col, const char* value)
+{
+  return iMatrixSetCellAttrib(ih, "MASKCASEI", lin, col, value);
+}
+
+static char* iMatrixGetMaskCaseIAttrib(Ihandle* ih, int lin, int col)
+{
+  return iupMatrixGetAttribId2(ih, "MASKCASEI", lin, col);
 }
 
 static int iMatrixSetMergeAttrib(Ihandle* ih, int lin, int col, const char* value)
@@ -1487,7 +1684,7 @@ static char* iMatrixGetBgColorAttrib(Ihandle* ih, int lin, int col)
 
     return color;
   }
-  return NULL;
+  return iupMatrixGetAttribId2(ih, "BGCOLOR", lin, col);
 }
 
 static char* iMatrixGetCellBgColorAttrib(Ihandle* ih, int lin, int col)
@@ -1832,6 +2029,7 @@ static int iMatrixMapMethod(Ihandle* ih)
   }
 
   iupMatrixMemAlloc(ih);
+  iupMatrixMoveHashAttributes(ih);
 
   IupSetCallback(ih, "_IUP_XY2POS_CB", (Icallback)iMatrixConvertXYToPos);
   IupSetCallback(ih, "_IUP_POS2LINCOL_CB", (Icallback)iMatrixConvertPosToLinCol);
@@ -1851,6 +2049,11 @@ static void iMatrixUnMapMethod(Ihandle* ih)
   iupMatrixMemRelease(ih);
 }
 
+static void iMatrixDestroyMethod(Ihandle* ih)
+{
+  iupMatrixReleaseAttributes(ih);
+}
+
 static int iMatrixGetNaturalWidth(Ihandle* ih, int *full_width)
 {
   int width = 0, visible_num, col;
@@ -2128,6 +2331,7 @@ Iclass* iupMatrixNewClass(void)
   ic->Create = iMatrixCreateMethod;
   ic->Map = iMatrixMapMethod;
   ic->UnMap = iMatrixUnMapMethod;
+  ic->Destroy = iMatrixDestroyMethod;
   ic->ComputeNaturalSize = iMatrixComputeNaturalSizeMethod;
   ic->SetChildrenCurrentSize = iMatrixSetChildrenCurrentSizeMethod;
   ic->SetChildrenPosition = iMatrixSetChildrenPositionMethod;
@@ -2184,15 +2388,15 @@ Iclass* iupMatrixNewClass(void)
   /*OLD*/iupClassRegisterAttribute(ic, "FOCUS_CELL", iMatrixGetFocusCellAttrib, iMatrixSetFocusCellAttrib, IUPAF_SAMEASSYSTEM, "1:1", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT); /* can be NOT mapped */
   iupClassRegisterAttribute(ic, "VALUE", iMatrixGetValueAttrib, iMatrixSetValueAttrib, NULL, NULL, IUPAF_NO_SAVE | IUPAF_NO_DEFAULTVALUE | IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId2(ic, "BGCOLOR", iMatrixGetBgColorAttrib, iMatrixSetBgColorAttrib, IUPAF_NOT_MAPPED);
-  iupClassRegisterAttributeId2(ic, "FGCOLOR", NULL, iMatrixSetFgColorAttrib, IUPAF_NOT_MAPPED);
-  iupClassRegisterAttributeId2(ic, "TYPE", NULL, iMatrixSetTypeAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId2(ic, "FGCOLOR", iMatrixGetFgColorAttrib, iMatrixSetFgColorAttrib, IUPAF_NOT_MAPPED);
+  iupClassRegisterAttributeId2(ic, "TYPE", iMatrixGetTypeAttrib, iMatrixSetTypeAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId2(ic, "FONT", iMatrixGetFontAttrib, iMatrixSetFontAttrib, IUPAF_NOT_MAPPED);
   iupClassRegisterAttributeId2(ic, "FONTSTYLE", iMatrixGetFontStyleAttrib, iMatrixSetFontStyleAttrib, IUPAF_NOT_MAPPED);
   iupClassRegisterAttributeId2(ic, "FONTSIZE", iMatrixGetFontSizeAttrib, iMatrixSetFontSizeAttrib, IUPAF_NOT_MAPPED);
-  iupClassRegisterAttributeId2(ic, "FRAMEHORIZCOLOR", NULL, iMatrixSetFrameHorizColorAttrib, IUPAF_NOT_MAPPED);
-  iupClassRegisterAttributeId2(ic, "FRAMEVERTCOLOR", NULL, iMatrixSetFrameVertColorAttrib, IUPAF_NOT_MAPPED);
-  iupClassRegisterAttributeId2(ic, "FRAMETITLEHORIZCOLOR", NULL, iMatrixSetFrameHorizColorAttrib, IUPAF_NOT_MAPPED);
-  iupClassRegisterAttributeId2(ic, "FRAMETITLEVERTCOLOR", NULL, iMatrixSetFrameVertColorAttrib, IUPAF_NOT_MAPPED);
+  iupClassRegisterAttributeId2(ic, "FRAMEHORIZCOLOR", iMatrixGetFrameHorizColorAttrib, iMatrixSetFrameHorizColorAttrib, IUPAF_NOT_MAPPED);
+  iupClassRegisterAttributeId2(ic, "FRAMEVERTCOLOR", iMatrixGetFrameVertColorAttrib, iMatrixSetFrameVertColorAttrib, IUPAF_NOT_MAPPED);
+  iupClassRegisterAttributeId2(ic, "FRAMETITLEHORIZCOLOR", iMatrixGetFrameTitleHorizColorAttrib, iMatrixSetFrameTitleHorizColorAttrib, IUPAF_NOT_MAPPED);
+  iupClassRegisterAttributeId2(ic, "FRAMETITLEVERTCOLOR", iMatrixGetFrameTitleVertColorAttrib, iMatrixSetFrameTitleVertColorAttrib, IUPAF_NOT_MAPPED);
   iupClassRegisterAttribute(ic, "FRAMECOLOR", NULL, (IattribSetFunc)iMatrixSetNeedRedraw, IUPAF_SAMEASSYSTEM, "100 100 100", IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "FRAMETITLEHIGHLIGHT", NULL, (IattribSetFunc)iMatrixSetNeedRedraw, IUPAF_SAMEASSYSTEM, "Yes", IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "FRAMEBORDER", NULL, (IattribSetFunc)iMatrixSetNeedRedraw, NULL, NULL, IUPAF_NO_INHERIT);
@@ -2206,8 +2410,8 @@ Iclass* iupMatrixNewClass(void)
   iupClassRegisterAttributeId2(ic, "CELLFRAMEVERTCOLOR", iMatrixGetCellFrameVertColorAttrib, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId2(ic, "CELLALIGNMENT", iMatrixGetCellAlignmentAttrib, NULL, IUPAF_READONLY | IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId2(ic, "CELL", iMatrixGetCellAttrib, NULL, IUPAF_READONLY | IUPAF_NO_INHERIT);
-  iupClassRegisterAttributeId2(ic, "TOGGLEVALUE", NULL, (IattribSetId2Func)iMatrixSetNeedRedraw, IUPAF_NO_INHERIT);
-  iupClassRegisterAttributeId2(ic, "ALIGN", NULL, (IattribSetId2Func)iMatrixSetNeedRedraw, IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId2(ic, "TOGGLEVALUE", iMatrixGetToggleValueAttrib, iMatrixSetToggleValueAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId2(ic, "ALIGN", iMatrixGetAlignAttrib, iMatrixSetAlignAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "TOGGLECENTERED", NULL, (IattribSetFunc)iMatrixSetNeedRedraw, NULL, NULL, IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "TOGGLEIMAGEON", NULL, (IattribSetFunc)iMatrixSetNeedRedraw, NULL, NULL, IUPAF_IHANDLENAME | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "TOGGLEIMAGEOFF", NULL, (IattribSetFunc)iMatrixSetNeedRedraw, NULL, NULL, IUPAF_IHANDLENAME | IUPAF_NO_INHERIT);
@@ -2215,15 +2419,15 @@ Iclass* iupMatrixNewClass(void)
 
   iupClassRegisterAttributeId2(ic, "MERGE", iMatrixGetMergeAttrib, iMatrixSetMergeAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "MERGESPLIT", NULL, iMatrixSetMergeSplitAttrib, NULL, NULL, IUPAF_WRITEONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
-  iupClassRegisterAttributeId2(ic, "MERGED", NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT); /* internal, returns the merged range number */
+  iupClassRegisterAttributeId2(ic, "MERGED", iMatrixGetMergedAttrib, iMatrixSetMergedAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT); /* internal, returns the merged range number */
   iupClassRegisterAttributeId2(ic, "MERGEDSTART", iMatrixGetMergedStartAttrib, NULL, IUPAF_READONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId2(ic, "MERGEDEND", iMatrixGetMergedEndAttrib, NULL, IUPAF_READONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
 
   /* IupMatrix Attributes - COLUMN */
-  iupClassRegisterAttributeId(ic, "ALIGNMENT", iMatrixGetAlignmentAttrib, (IattribSetIdFunc)iMatrixSetNeedRedraw, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId(ic, "ALIGNMENT", iMatrixGetAlignmentAttrib, iMatrixSetAlignmentAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "ALIGNMENTLIN0", NULL, (IattribSetFunc)iMatrixSetNeedRedraw, IUPAF_SAMEASSYSTEM, "ACENTER", IUPAF_NO_INHERIT);
-  iupClassRegisterAttributeId(ic, "LINEALIGNMENT", NULL, (IattribSetIdFunc)iMatrixSetNeedRedraw, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
-  iupClassRegisterAttributeId(ic, "SORTSIGN", NULL, (IattribSetIdFunc)iMatrixSetNeedRedraw, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId(ic, "LINEALIGNMENT", iMatrixGetLineAlignmentAttrib, iMatrixSetLineAlignmentAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId(ic, "SORTSIGN", iMatrixGetSortSignAttrib, iMatrixSetSortSignAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "SORTIMAGEDOWN", NULL, (IattribSetFunc)iMatrixSetNeedRedraw, NULL, NULL, IUPAF_IHANDLENAME | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "SORTIMAGEUP", NULL, (IattribSetFunc)iMatrixSetNeedRedraw, NULL, NULL, IUPAF_IHANDLENAME | IUPAF_NO_INHERIT);
 
@@ -2240,10 +2444,10 @@ Iclass* iupMatrixNewClass(void)
   iupClassRegisterAttribute(ic, "NUMCOL_VISIBLE_LAST", NULL, NULL, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "WIDTHDEF", NULL, NULL, IUPAF_SAMEASSYSTEM, "80", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "HEIGHTDEF", NULL, NULL, IUPAF_SAMEASSYSTEM, "8", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
-  iupClassRegisterAttributeId(ic, "WIDTH", iMatrixGetWidthAttrib, iMatrixSetSizeAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
-  iupClassRegisterAttributeId(ic, "HEIGHT", iMatrixGetHeightAttrib, iMatrixSetSizeAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
-  iupClassRegisterAttributeId(ic, "RASTERWIDTH", iMatrixGetRasterWidthAttrib, iMatrixSetSizeAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
-  iupClassRegisterAttributeId(ic, "RASTERHEIGHT", iMatrixGetRasterHeightAttrib, iMatrixSetSizeAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId(ic, "WIDTH", iMatrixGetWidthAttrib, iMatrixSetWidthAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId(ic, "HEIGHT", iMatrixGetHeightAttrib, iMatrixSetHeightAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId(ic, "RASTERWIDTH", iMatrixGetRasterWidthAttrib, iMatrixSetRasterWidthAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId(ic, "RASTERHEIGHT", iMatrixGetRasterHeightAttrib, iMatrixSetRasterHeightAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "FITTOSIZE", NULL, iMatrixSetFitToSizeAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_WRITEONLY | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "FITTOTEXT", NULL, iMatrixSetFitToTextAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_WRITEONLY | IUPAF_NO_INHERIT);
   iupClassRegisterAttributeId(ic, "FITMAXHEIGHT", NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
@@ -2287,11 +2491,11 @@ Iclass* iupMatrixNewClass(void)
   iupClassRegisterAttribute(ic, "INSERT", NULL, iMatrixSetInsertAttrib, NULL, NULL, IUPAF_WRITEONLY | IUPAF_NO_SAVE | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "SELECTION", iMatrixGetSelectionAttrib, iMatrixSetSelectionAttrib, NULL, NULL, IUPAF_NO_SAVE | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "MULTILINE", iMatrixGetMultilineAttrib, iMatrixSetMultilineAttrib, NULL, NULL, IUPAF_NO_INHERIT);
-  iupClassRegisterAttributeId(ic, "MASK", NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
-  iupClassRegisterAttributeId(ic, "MASKINT", NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
-  iupClassRegisterAttributeId(ic, "MASKFLOAT", NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
-  iupClassRegisterAttributeId(ic, "MASKNOEMPTY", NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
-  iupClassRegisterAttributeId(ic, "MASKCASEI", NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId2(ic, "MASK", iMatrixGetMaskAttrib, iMatrixSetMaskAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId2(ic, "MASKINT", iMatrixGetMaskIntAttrib, iMatrixSetMaskIntAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId2(ic, "MASKFLOAT", iMatrixGetMaskFloatAttrib, iMatrixSetMaskFloatAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId2(ic, "MASKNOEMPTY", iMatrixGetMaskNoEmptyAttrib, iMatrixSetMaskNoEmptyAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttributeId2(ic, "MASKCASEI", iMatrixGetMaskCaseIAttrib, iMatrixSetMaskCaseIAttrib, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "EDITHIDEONFOCUS", iMatrixGetEditHideOnFocusAttrib, iMatrixSetEditHideOnFocusAttrib, IUPAF_SAMEASSYSTEM, "Yes", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "EDITCELL", iMatrixGetEditCellAttrib, NULL, NULL, NULL, IUPAF_READONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "EDITTEXT", iMatrixGetEditTextAttrib, NULL, NULL, NULL, IUPAF_READONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
@@ -17,6 +17,7 @@
 #include "iup_attrib.h"
 #include "iup_str.h"
 #include "iup_matrixex.h"
+#include "../matrix/iupmat_getset.h"
 
 
 static void iMatrixExStrCopyNoSepHTML(char* buffer, const char* str)
@@ -115,19 +116,19 @@ static char* iMatrixExGetCellAttrib(Ihandle* ih, const char* attrib, int lin, in
   char* value = NULL;
 
   /* 1 -  check for this cell */
-  value = iupAttribGetId2(ih, attrib, lin, col);
+  value = iupMatrixGetAttribId2(ih, attrib, lin, col);
 
   if (!value)
   {
     /* 2 - check for this line, if not title col */
     if (col != 0)
-      value = iupAttribGetId2(ih, attrib, lin, IUP_INVALID_ID);
+      value = iupMatrixGetAttribId2(ih, attrib, lin, IUP_INVALID_ID);
 
     if (!value)
     {
       /* 3 - check for this column, if not title line */
       if (lin != 0)
-        value = iupAttribGetId2(ih, attrib, IUP_INVALID_ID, col);
+        value = iupMatrixGetAttribId2(ih, attrib, IUP_INVALID_ID, col);
     }
   }
 
@@ -142,7 +143,7 @@ static char* iMatrixExGetCellFormat(Ihandle *ih, int lin, int col, char* format)
 
   *format = 0;
 
-  value = iupAttribGetId(ih, "ALIGNMENT", col);
+  value = iupMatrixGetAttribCol(ih, "ALIGNMENT", col);
   if (value)
   {
     if (iupStrEqualNoCase(value, "ARIGHT"))
@@ -283,7 +284,7 @@ static int iMatrixExIsBoldLine(Ihandle* ih, int lin)
   if (lin==0)
     return 0;
 
-  value = iupAttribGetId2(ih, "FONT", lin, IUP_INVALID_ID);
+  value = iupMatrixGetAttribId2(ih, "FONT", lin, IUP_INVALID_ID);
   if (value)
   {
     if (strstr(value, "Bold")||strstr(value, "BOLD"))
@@ -20,6 +20,7 @@
 #include "iup_str.h"
 #include "iup_assert.h"
 #include "iup_matrixex.h"
+#include "../matrix/iupmat_getset.h"
 
 
 int iupMatrixExIsColumnVisible(Ihandle* ih, int col)
@@ -33,10 +34,10 @@ int iupMatrixExIsColumnVisible(Ihandle* ih, int col)
   /* to be invisible must exist the attribute and must be set to 0 (zero), 
      or else is visible */
 
-  value = iupAttribGetId(ih, "WIDTH", col);
+  value = iupMatrixGetAttribCol(ih, "WIDTH", col);
   if (!value)
   {
-    value = iupAttribGetId(ih, "RASTERWIDTH", col);
+    value = iupMatrixGetAttribCol(ih, "RASTERWIDTH", col);
     if (!value)
       return 1;
   }
@@ -58,10 +59,10 @@ int iupMatrixExIsLineVisible(Ihandle* ih, int lin)
   if (lin==0)
     return (IupGetIntId(ih, "RASTERHEIGHT", 0) != 0);
 
-  value = iupAttribGetId(ih, "HEIGHT", lin);
+  value = iupMatrixGetAttribLin(ih, "HEIGHT", lin);
   if(!value)
   {
-    value = iupAttribGetId(ih, "RASTERHEIGHT", lin);
+    value = iupMatrixGetAttribLin(ih, "RASTERHEIGHT", lin);
     if(!value)
       return 1;
   }
@@ -91,17 +92,17 @@ static int iMatrixSetVisibleColAttribId(Ihandle *ih, int col, const char* value)
 
   if (!iupStrBoolean(value))
   {
-    old_width = iupAttribGetId(ih, "WIDTH", col);
+    old_width = iupMatrixGetAttribCol(ih, "WIDTH", col);
     if (old_width) iupAttribSetStrId(ih, "_IUP_SHOWCOL_WIDTH", col, old_width);
-    else { old_width = iupAttribGetId(ih, "RASTERWIDTH", col);
+    else { old_width = iupMatrixGetAttribCol(ih, "RASTERWIDTH", col);
          if (old_width) iupAttribSetStrId(ih, "_IUP_SHOWCOL_RASTERWIDTH", col, old_width); }
 
     IupSetAttributeId(ih, "WIDTH", col, "0");    /* this is enough */
   }
   else
   {
-    iupAttribSetId(ih, "WIDTH", col, NULL);  /* this may be insufficient */
-    iupAttribSetId(ih, "RASTERWIDTH", col, NULL);
+    iupMatrixSetAttribCol(ih, "WIDTH", col, NULL);  /* this may be insufficient */
+    iupMatrixSetAttribCol(ih, "RASTERWIDTH", col, NULL);
 
     old_width = iupAttribGetId(ih, "_IUP_SHOWCOL_WIDTH", col);
     if (old_width) IupSetStrAttributeId(ih, "WIDTH", col, old_width);
@@ -118,17 +119,17 @@ static int iMatrixSetVisibleLinAttribId(Ihandle *ih, int lin, const char* value)
 
   if (!iupStrBoolean(value))
   {
-    old_height = iupAttribGetId(ih, "HEIGHT", lin);
+    old_height = iupMatrixGetAttribLin(ih, "HEIGHT", lin);
     if (old_height) iupAttribSetStrId(ih, "_IUP_SHOWCOL_HEIGHT", lin, old_height);
-    else { old_height = iupAttribGetId(ih, "RASTERHEIGHT", lin);
+    else { old_height = iupMatrixGetAttribLin(ih, "RASTERHEIGHT", lin);
          if (old_height) iupAttribSetStrId(ih, "_IUP_SHOWCOL_RASTERHEIGHT", lin, old_height); }
 
     IupSetAttributeId(ih, "HEIGHT", lin, "0");    /* this is enough */
   }
   else
   {
-    iupAttribSetId(ih, "HEIGHT", lin, NULL);  /* this may be insufficient */
-    iupAttribSetId(ih, "RASTERHEIGHT", lin, NULL);
+    iupMatrixSetAttribLin(ih, "HEIGHT", lin, NULL);  /* this may be insufficient */
+    iupMatrixSetAttribLin(ih, "RASTERHEIGHT", lin, NULL);
 
     old_height = iupAttribGetId(ih, "_IUP_SHOWCOL_HEIGHT", lin);
     if (old_height) IupSetStrAttributeId(ih, "HEIGHT", lin, old_height);
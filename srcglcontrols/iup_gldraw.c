@@ -17,6 +17,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
 #include "iup.h"
@@ -35,34 +36,482 @@
 #include "iup_glimage.h"
 
 
-void iupGLDrawLine(Ihandle* ih, int x1, int y1, int x2, int y2, float linewidth, const char* color, int active)
+/* Primitives are not drawn in immediate mode.
+   During a canvas box redraw they are collected for the whole frame in window coordinates,
+   and then sorted by layer and state, so all the sub-canvases are drawn with a few glDrawArrays.
+   A primitive is placed in a layer above the overlapping sub-canvases drawn before it,
+   and above the previous primitives of its own sub-canvas that have a different state,
+   so the result is the same as drawing them in order. */
+typedef struct _IglDrawVertex
 {
-  unsigned char r = 0, g = 0, b = 0, a = 255;
+  GLfloat x, y;
+  GLfloat s, t;
+  GLubyte r, g, b, a;
+} IglDrawVertex;
 
-  if (!color || linewidth == 0)
+typedef struct _IglDrawPrimitive
+{
+  GLenum mode;
+  int first, count;  /* in the vertex array */
+  float linewidth;
+  GLuint texture;
+  int no_smooth;  /* must disable polygon smooth or fill may get diagonal lines */
+  int clip;       /* index of the sub-canvas clipping, or -1 when inside it */
+  int layer;
+  int order;
+} IglDrawPrimitive;
+
+typedef struct _IglDrawClip
+{
+  int x, y, w, h;  /* scissor in window coordinates */
+  int top_layer;   /* -1 if nothing was drawn */
+} IglDrawClip;
+
+static Iarray* igldraw_vertices = NULL;
+static Iarray* igldraw_sorted_vertices = NULL;
+static Iarray* igldraw_primitives = NULL;
+static Iarray* igldraw_clips = NULL;
+
+static int igldraw_batch = 0;
+static int igldraw_width = 0, igldraw_height = 0;  /* canvas size */
+static int igldraw_x = 0, igldraw_y = 0;  /* sub-canvas origin in window coordinates */
+static int igldraw_clip = -1;  /* current sub-canvas clipping, when -1 primitives are drawn right away */
+static int igldraw_layer = 0;
+static int igldraw_previous = -1;  /* previous primitive of the current sub-canvas */
+
+static Iarray* iGLDrawCreateArray(int start_max_count, int elem_size)
+{
+  Iarray* iarray = iupArrayCreate(start_max_count, elem_size);
+  iupArraySetZeroFill(iarray, 0);
+  return iarray;
+}
+
+static void iGLDrawClearArray(Iarray* iarray)
+{
+  iupArrayRemove(iarray, 0, iupArrayCount(iarray));
+}
+
+static int iGLDrawSameState(IglDrawPrimitive* p1, IglDrawPrimitive* p2)
+{
+  return p1->mode == p2->mode && p1->linewidth == p2->linewidth && p1->texture == p2->texture &&
+         p1->no_smooth == p2->no_smooth && p1->clip == p2->clip;
+}
+
+static int iGLDrawComparePrimitives(const void* elem1, const void* elem2)
+{
+  const IglDrawPrimitive* p1 = (const IglDrawPrimitive*)elem1;
+  const IglDrawPrimitive* p2 = (const IglDrawPrimitive*)elem2;
+
+  if (p1->layer != p2->layer) return p1->layer < p2->layer ? -1 : 1;
+  if (p1->texture != p2->texture) return p1->texture < p2->texture ? -1 : 1;
+  if (p1->no_smooth != p2->no_smooth) return p1->no_smooth < p2->no_smooth ? -1 : 1;
+  if (p1->mode != p2->mode) return p1->mode < p2->mode ? -1 : 1;
+  if (p1->linewidth != p2->linewidth) return p1->linewidth < p2->linewidth ? -1 : 1;
+  if (p1->clip != p2->clip) return p1->clip < p2->clip ? -1 : 1;
+  return p1->order < p2->order ? -1 : 1;  /* keep the order of the same state */
+}
+
+static void iGLDrawPrimitives(IglDrawVertex* vertices, IglDrawPrimitive* primitives, int count, IglDrawClip* clips)
+{
+  int i = 0, smooth, no_smooth = 0, clip = -1;
+  float linewidth = 0;
+  GLuint texture = 0;
+
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_COLOR_ARRAY);
+  glVertexPointer(2, GL_FLOAT, sizeof(IglDrawVertex), &vertices->x);
+  glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(IglDrawVertex), &vertices->r);
+  glTexCoordPointer(2, GL_FLOAT, sizeof(IglDrawVertex), &vertices->s);
+
+  smooth = glIsEnabled(GL_POLYGON_SMOOTH);
+
+  while (i < count)
+  {
+    IglDrawPrimitive* p = primitives + i;
+    int first = p->first;
+    int vertex_count = p->count;
+
+    i++;
+
+    /* independent primitives with the same state are drawn at once */
+    if (p->mode == GL_LINES || p->mode == GL_QUADS)
+    {
+      while (i < count && iGLDrawSameState(p, primitives + i) && primitives[i].first == first + vertex_count)
+      {
+        vertex_count += primitives[i].count;
+        i++;
+      }
+    }
+
+    if (smooth && p->no_smooth != no_smooth)
+    {
+      no_smooth = p->no_smooth;
+      if (no_smooth) glDisable(GL_POLYGON_SMOOTH);
+      else glEnable(GL_POLYGON_SMOOTH);
+    }
+
+    if (p->texture != texture)
+    {
+      if (!p->texture)
+      {
+        glDisable(GL_TEXTURE_2D);
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+      }
+      else if (!texture)
+      {
+        glEnable(GL_TEXTURE_2D);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+      }
+
+      if (p->texture)
+        glBindTexture(GL_TEXTURE_2D, p->texture);
+
+      texture = p->texture;
+    }
+
+    if (p->linewidth != 0 && p->linewidth != linewidth)
+    {
+      linewidth = p->linewidth;
+      glLineWidth(linewidth);
+    }
+
+    if (clips && p->clip != clip)
+    {
+      clip = p->clip;
+      if (clip == -1)
+        glScissor(0, 0, igldraw_width, igldraw_height);
+      else
+        glScissor(clips[clip].x, clips[clip].y, clips[clip].w, clips[clip].h);
+    }
+
+    glDrawArrays(p->mode, first, vertex_count);
+  }
+
+  /* restore explicitly, not all drivers restore texture enable in glPopAttrib */
+  if (texture)
+    glDisable(GL_TEXTURE_2D);
+  if (no_smooth)
+    glEnable(GL_POLYGON_SMOOTH);
+}
+
+static void iGLDrawFlushBatch(IglDrawVertex* vertices, IglDrawPrimitive* primitives, int count)
+{
+  IglDrawVertex* sorted_vertices;
+  int i, vertex_count = 0;
+
+  qsort(primitives, count, sizeof(IglDrawPrimitive), iGLDrawComparePrimitives);
+
+  /* copy the vertices in the drawing order, so primitives with the same state are contiguous */
+  iGLDrawClearArray(igldraw_sorted_vertices);
+  sorted_vertices = (IglDrawVertex*)iupArrayAdd(igldraw_sorted_vertices, iupArrayCount(igldraw_vertices));
+  for (i = 0; i < count; i++)
+  {
+    memcpy(sorted_vertices + vertex_count, vertices + primitives[i].first, primitives[i].count * sizeof(IglDrawVertex));
+    primitives[i].first = vertex_count;
+    vertex_count += primitives[i].count;
+  }
+
+  /* vertices are in window coordinates */
+  glPushAttrib(GL_VIEWPORT_BIT | GL_SCISSOR_BIT | GL_TRANSFORM_BIT);
+  glViewport(0, 0, igldraw_width, igldraw_height);
+
+  glMatrixMode(GL_PROJECTION);
+  glPushMatrix();
+  glLoadIdentity();
+  glOrtho(0, igldraw_width, 0, igldraw_height, -1, 1);
+
+  glMatrixMode(GL_MODELVIEW);
+  glPushMatrix();
+  glLoadIdentity();
+  glTranslatef(0.375, 0.375, 0.0);  /* render all primitives at integer positions */
+
+  iGLDrawPrimitives(sorted_vertices, primitives, count, (IglDrawClip*)iupArrayGetData(igldraw_clips));
+
+  glMatrixMode(GL_MODELVIEW);
+  glPopMatrix();
+
+  glMatrixMode(GL_PROJECTION);
+  glPopMatrix();
+
+  glPopAttrib();
+}
+
+void iupGLDrawFlush(void)
+{
+  int count;
+
+  if (!igldraw_primitives)
+    return;
+
+  count = iupArrayCount(igldraw_primitives);
+  if (count == 0)
     return;
 
-  iupStrToRGBA(color, &r, &g, &b, &a);
+  /* current color, texture and line width are restored, the application may rely on them */
+  glPushAttrib(GL_CURRENT_BIT | GL_ENABLE_BIT | GL_LINE_BIT | GL_TEXTURE_BIT);
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+  if (igldraw_clip == -1)
+    iGLDrawPrimitives((IglDrawVertex*)iupArrayGetData(igldraw_vertices), (IglDrawPrimitive*)iupArrayGetData(igldraw_primitives), count, NULL);
+  else
+  {
+    IglDrawClip* clips = (IglDrawClip*)iupArrayGetData(igldraw_clips);
+
+    iGLDrawFlushBatch((IglDrawVertex*)iupArrayGetData(igldraw_vertices), (IglDrawPrimitive*)iupArrayGetData(igldraw_primitives), count);
+
+    /* everything is drawn, only the current sub-canvas clipping is still used */
+    clips[0] = clips[igldraw_clip];
+    clips[0].top_layer = -1;
+    iupArrayRemove(igldraw_clips, 1, iupArrayCount(igldraw_clips) - 1);
+    igldraw_clip = 0;
+    igldraw_layer = 0;
+    igldraw_previous = -1;
+  }
+
+  glPopClientAttrib();
+  glPopAttrib();
+
+  iGLDrawClearArray(igldraw_primitives);
+  iGLDrawClearArray(igldraw_vertices);
+}
+
+void iupGLDrawBeginBatch(int width, int height)
+{
+  if (!igldraw_clips)
+    igldraw_clips = iGLDrawCreateArray(64, sizeof(IglDrawClip));
+
+  igldraw_batch = 1;
+  igldraw_width = width;
+  igldraw_height = height;
+}
+
+void iupGLDrawSetTransform(int x, int y, int clip_x, int clip_y, int clip_w, int clip_h, int direct)
+{
+  IglDrawClip* clips;
+  int i, count, layer = 0;
+
+  if (!igldraw_batch)
+    return;
+
+  if (direct)
+  {
+    /* the application may use OpenGL directly, so draw everything before it */
+    iupGLDrawFlush();
+    iGLDrawClearArray(igldraw_clips);
+    igldraw_clip = -1;
+    igldraw_x = 0;
+    igldraw_y = 0;
+    return;
+  }
+
+  /* place above all the overlapping sub-canvases drawn before */
+  count = iupArrayCount(igldraw_clips);
+  clips = (IglDrawClip*)iupArrayGetData(igldraw_clips);
+  for (i = 0; i < count; i++)
+  {
+    IglDrawClip* clip = clips + i;
+    if (clip->top_layer >= layer && clip_x < clip->x + clip->w && clip->x < clip_x + clip_w &&
+                                    clip_y < clip->y + clip->h && clip->y < clip_y + clip_h)
+      layer = clip->top_layer + 1;
+  }
+
+  clips = (IglDrawClip*)iupArrayInc(igldraw_clips);
+  clips[count].x = clip_x;
+  clips[count].y = clip_y;
+  clips[count].w = clip_w;
+  clips[count].h = clip_h;
+  clips[count].top_layer = -1;
+
+  igldraw_clip = count;
+  igldraw_layer = layer;
+  igldraw_previous = -1;
+  igldraw_x = x;
+  igldraw_y = y;
+}
+
+void iupGLDrawEndBatch(void)
+{
+  iupGLDrawFlush();
+
+  if (igldraw_clips)
+    iGLDrawClearArray(igldraw_clips);
+
+  igldraw_batch = 0;
+  igldraw_clip = -1;
+  igldraw_x = 0;
+  igldraw_y = 0;
+}
+
+static IglDrawVertex* iGLDrawAddVertices(GLenum mode, int count, float linewidth, GLuint texture, int no_smooth)
+{
+  IglDrawVertex* vertices;
+  IglDrawPrimitive* primitive;
+  int first, index;
+
+  if (!igldraw_vertices)
+  {
+    igldraw_vertices = iGLDrawCreateArray(1024, sizeof(IglDrawVertex));
+    igldraw_sorted_vertices = iGLDrawCreateArray(1024, sizeof(IglDrawVertex));
+    igldraw_primitives = iGLDrawCreateArray(256, sizeof(IglDrawPrimitive));
+  }
+
+  first = iupArrayCount(igldraw_vertices);
+  vertices = (IglDrawVertex*)iupArrayAdd(igldraw_vertices, count);
+
+  index = iupArrayCount(igldraw_primitives);
+  primitive = (IglDrawPrimitive*)iupArrayInc(igldraw_primitives);
+  primitive += index;
+  primitive->mode = mode;
+  primitive->first = first;
+  primitive->count = count;
+  primitive->linewidth = linewidth;
+  primitive->texture = texture;
+  primitive->no_smooth = no_smooth;
+  primitive->clip = -1;
+  primitive->layer = 0;
+  primitive->order = index;
+
+  return vertices + first;
+}
+
+static void iGLDrawEndVertices(void)
+{
+  IglDrawPrimitive *primitives, *primitive;
+  IglDrawVertex* vertices;
+  IglDrawClip* clip;
+  float xmin, xmax, ymin, ymax, margin;
+  int i, index;
+
+  /* outside a canvas box redraw, or in an application sub-canvas, draw right away */
+  if (igldraw_clip == -1)
+  {
+    iupGLDrawFlush();
+    return;
+  }
+
+  index = iupArrayCount(igldraw_primitives) - 1;
+  primitives = (IglDrawPrimitive*)iupArrayGetData(igldraw_primitives);
+  primitive = primitives + index;
+  vertices = (IglDrawVertex*)iupArrayGetData(igldraw_vertices) + primitive->first;
+  clip = (IglDrawClip*)iupArrayGetData(igldraw_clips) + igldraw_clip;
+
+  /* the sub-canvas clipping is not necessary if the primitive is inside it */
+  xmin = xmax = vertices[0].x;
+  ymin = ymax = vertices[0].y;
+  for (i = 1; i < primitive->count; i++)
+  {
+    if (vertices[i].x < xmin) xmin = vertices[i].x;
+    if (vertices[i].x > xmax) xmax = vertices[i].x;
+    if (vertices[i].y < ymin) ymin = vertices[i].y;
+    if (vertices[i].y > ymax) ymax = vertices[i].y;
+  }
+
+  margin = primitive->linewidth / 2 + 1;  /* includes anti-aliasing */
+  if (xmin - margin < clip->x || xmax + margin >= clip->x + clip->w ||
+      ymin - margin < clip->y || ymax + margin >= clip->y + clip->h)
+    primitive->clip = igldraw_clip;
+
+  if (igldraw_previous != -1 && !iGLDrawSameState(primitives + igldraw_previous, primitive))
+    igldraw_layer++;
+
+  primitive->layer = igldraw_layer;
+  if (igldraw_layer > clip->top_layer)
+    clip->top_layer = igldraw_layer;
+
+  igldraw_previous = index;
+}
+
+static void iGLDrawSetVertex(IglDrawVertex* v, double x, double y, unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+{
+  v->x = (GLfloat)(x + igldraw_x);
+  v->y = (GLfloat)(y + igldraw_y);
+  v->s = 0;
+  v->t = 0;
+  v->r = r;
+  v->g = g;
+  v->b = b;
+  v->a = a;
+}
+
+/* the same few colors are used by all the controls, so parsed colors are cached */
+#define IGLDRAW_COLOR_CACHE_SIZE 64
+#define IGLDRAW_COLOR_MAX_LEN 32
+
+typedef struct _IglDrawColor
+{
+  char str[IGLDRAW_COLOR_MAX_LEN];
+  unsigned char r, g, b, a;
+} IglDrawColor;
+
+static IglDrawColor igldraw_color_cache[IGLDRAW_COLOR_CACHE_SIZE];
+
+static void iGLDrawGetColor(const char* color, int active, unsigned char *r, unsigned char *g, unsigned char *b, unsigned char *a)
+{
+  IglDrawColor* cache;
+  unsigned int hash = 0;
+  int len = 0;
+
+  while (color[len] && len < IGLDRAW_COLOR_MAX_LEN)
+  {
+    hash = hash * 31 + (unsigned char)color[len];
+    len++;
+  }
+
+  *r = 0; *g = 0; *b = 0; *a = 255;
+
+  if (len == IGLDRAW_COLOR_MAX_LEN)  /* too long, not cached */
+    iupStrToRGBA(color, r, g, b, a);
+  else
+  {
+    cache = igldraw_color_cache + (hash % IGLDRAW_COLOR_CACHE_SIZE);
+    if (cache->str[0] && iupStrEqual(cache->str, color))
+    {
+      *r = cache->r;
+      *g = cache->g;
+      *b = cache->b;
+      *a = cache->a;
+    }
+    else
+    {
+      iupStrToRGBA(color, r, g, b, a);
+
+      memcpy(cache->str, color, len + 1);
+      cache->r = *r;
+      cache->g = *g;
+      cache->b = *b;
+      cache->a = *a;
+    }
+  }
+
   if (!active)
-    iupGLColorMakeInactive(&r, &g, &b);
+    iupGLColorMakeInactive(r, g, b);
+}
 
-  glColor4ub(r, g, b, a);
+void iupGLDrawLine(Ihandle* ih, int x1, int y1, int x2, int y2, float linewidth, const char* color, int active)
+{
+  unsigned char r, g, b, a;
+  IglDrawVertex* v;
+
+  if (!color || linewidth == 0)
+    return;
 
-  glLineWidth(linewidth);
+  iGLDrawGetColor(color, active, &r, &g, &b, &a);
 
   /* y is oriented top to bottom in IUP */
   y1 = ih->currentheight - 1 - y1;
   y2 = ih->currentheight - 1 - y2;
 
-  glBegin(GL_LINES);
-  glVertex2i(x1, y1);
-  glVertex2i(x2, y2);
-  glEnd();
+  v = iGLDrawAddVertices(GL_LINES, 2, linewidth, 0, 0);
+  iGLDrawSetVertex(v++, x1, y1, r, g, b, a);
+  iGLDrawSetVertex(v, x2, y2, r, g, b, a);
+  iGLDrawEndVertices();
 }
 
 void iupGLDrawFrameRect(Ihandle* ih, int xmin, int xmax, int ymin, int ymax, float linewidth, const char* color, int active, int title_x, int title_width, int title_height)
 {
-  unsigned char r = 0, g = 0, b = 0, a = 255;
+  unsigned char r, g, b, a;
+  IglDrawVertex* v;
   int d = 2;
 
   if (!color || linewidth == 0 || xmin == xmax || ymin == ymax)
@@ -71,13 +520,7 @@ void iupGLDrawFrameRect(Ihandle* ih, int xmin, int xmax, int ymin, int ymax, flo
   if (xmin > xmax) { int _t = xmin; xmin = xmax; xmax = _t; }
   if (ymin > ymax) { int _t = ymin; ymin = ymax; ymax = _t; }
 
-  iupStrToRGBA(color, &r, &g, &b, &a);
-  if (!active)
-    iupGLColorMakeInactive(&r, &g, &b);
-
-  glColor4ub(r, g, b, a);
-
-  glLineWidth(linewidth);
+  iGLDrawGetColor(color, active, &r, &g, &b, &a);
 
   /* y is oriented top to bottom in IUP */
   ymin = ih->currentheight - 1 - ymin;
@@ -86,30 +529,31 @@ void iupGLDrawFrameRect(Ihandle* ih, int xmin, int xmax, int ymin, int ymax, flo
   /* position frame title at left-center */
   ymin -= title_height / 2;
 
-  glBegin(GL_LINE_STRIP);
+  v = iGLDrawAddVertices(GL_LINE_STRIP, 10, linewidth, 0, 0);
 
-  glVertex2i(xmin + title_x + title_width, ymin);
+  iGLDrawSetVertex(v++, xmin + title_x + title_width, ymin, r, g, b, a);
 
-  glVertex2i(xmax - d, ymin);
-  glVertex2i(xmax, ymin - d);
+  iGLDrawSetVertex(v++, xmax - d, ymin, r, g, b, a);
+  iGLDrawSetVertex(v++, xmax, ymin - d, r, g, b, a);
 
-  glVertex2i(xmax, ymax + d);
-  glVertex2i(xmax - d, ymax);
+  iGLDrawSetVertex(v++, xmax, ymax + d, r, g, b, a);
+  iGLDrawSetVertex(v++, xmax - d, ymax, r, g, b, a);
 
-  glVertex2i(xmin + d, ymax);
-  glVertex2i(xmin, ymax + d);
+  iGLDrawSetVertex(v++, xmin + d, ymax, r, g, b, a);
+  iGLDrawSetVertex(v++, xmin, ymax + d, r, g, b, a);
 
-  glVertex2i(xmin, ymin - d);
-  glVertex2i(xmin + d, ymin);
+  iGLDrawSetVertex(v++, xmin, ymin - d, r, g, b, a);
+  iGLDrawSetVertex(v++, xmin + d, ymin, r, g, b, a);
 
-  glVertex2i(xmin + title_x, ymin);
+  iGLDrawSetVertex(v, xmin + title_x, ymin, r, g, b, a);
 
-  glEnd();
+  iGLDrawEndVertices();
 }
 
 void iupGLDrawRect(Ihandle* ih, int xmin, int xmax, int ymin, int ymax, float linewidth, const char* color, int active, int round)
 {
-  unsigned char r = 0, g = 0, b = 0, a = 255;
+  unsigned char r, g, b, a;
+  IglDrawVertex* v;
 
   if (!color || linewidth == 0 || xmin == xmax || ymin == ymax)
     return;
@@ -117,52 +561,50 @@ void iupGLDrawRect(Ihandle* ih, int xmin, int xmax, int ymin, int ymax, float li
   if (xmin > xmax) { int _t = xmin; xmin = xmax; xmax = _t; }
   if (ymin > ymax) { int _t = ymin; ymin = ymax; ymax = _t; }
 
-  iupStrToRGBA(color, &r, &g, &b, &a);
-  if (!active)
-    iupGLColorMakeInactive(&r, &g, &b);
-
-  glColor4ub(r, g, b, a);
-
-  glLineWidth(linewidth);
+  iGLDrawGetColor(color, active, &r, &g, &b, &a);
 
   /* y is oriented top to bottom in IUP */
   ymin = ih->currentheight - 1 - ymin;
   ymax = ih->currentheight - 1 - ymax;
 
-  glBegin(GL_LINE_LOOP);
-
   if (round)
   {
-    int r = 2;
+    int d = 2;
 
-    glVertex2i(xmin, ymin-r);
-    glVertex2i(xmin+r, ymin);
+    v = iGLDrawAddVertices(GL_LINE_LOOP, 8, linewidth, 0, 0);
 
-    glVertex2i(xmax-r, ymin);
-    glVertex2i(xmax, ymin-r);
+    iGLDrawSetVertex(v++, xmin, ymin - d, r, g, b, a);
+    iGLDrawSetVertex(v++, xmin + d, ymin, r, g, b, a);
 
-    glVertex2i(xmax, ymax+r);
-    glVertex2i(xmax-r, ymax);
+    iGLDrawSetVertex(v++, xmax - d, ymin, r, g, b, a);
+    iGLDrawSetVertex(v++, xmax, ymin - d, r, g, b, a);
 
-    glVertex2i(xmin+r, ymax);
-    glVertex2i(xmin, ymax+r);
+    iGLDrawSetVertex(v++, xmax, ymax + d, r, g, b, a);
+    iGLDrawSetVertex(v++, xmax - d, ymax, r, g, b, a);
+
+    iGLDrawSetVertex(v++, xmin + d, ymax, r, g, b, a);
+    iGLDrawSetVertex(v, xmin, ymax + d, r, g, b, a);
   }
   else
   {
-    glVertex2i(xmin, ymin);
-    glVertex2i(xmax, ymin);
-    glVertex2i(xmax, ymax);
-    glVertex2i(xmin, ymax);
+    v = iGLDrawAddVertices(GL_LINE_LOOP, 4, linewidth, 0, 0);
+
+    iGLDrawSetVertex(v++, xmin, ymin, r, g, b, a);
+    iGLDrawSetVertex(v++, xmax, ymin, r, g, b, a);
+    iGLDrawSetVertex(v++, xmax, ymax, r, g, b, a);
+    iGLDrawSetVertex(v, xmin, ymax, r, g, b, a);
   }
 
-  glEnd();
+  iGLDrawEndVertices();
 }
 
-static void iGLDrawBuildSmallCircle(int cx, int cy, int rd)
+#define IGLDRAW_CIRCLE_SEGMENTS 16
+
+static void iGLDrawBuildSmallCircle(IglDrawVertex* v, int cx, int cy, int rd, unsigned char r, unsigned char g, unsigned char b, unsigned char a)
 {
   /* Reference: http://slabode.exofire.net/circle_draw.shtml
   Copyright SiegeLord's Abode */
-  int i, num_segments = 16;
+  int i, num_segments = IGLDRAW_CIRCLE_SEGMENTS;
   double theta = 2 * 3.1415926 / (double)num_segments;
   double c = cos(theta);  /* precalculate the sine and cosine */
   double s = sin(theta);
@@ -173,7 +615,7 @@ static void iGLDrawBuildSmallCircle(int cx, int cy, int rd)
 
   for (i = 0; i < num_segments; i++)
   {
-    glVertex2d(x + cx, y + cy);
+    iGLDrawSetVertex(v++, x + cx, y + cy, r, g, b, a);
 
     /* apply the rotation matrix */
     t = x;
@@ -184,97 +626,71 @@ static void iGLDrawBuildSmallCircle(int cx, int cy, int rd)
 
 void iupGLDrawSmallCircle(Ihandle* ih, int cx, int cy, int rd, float linewidth, const char* color, int active)
 {
-  unsigned char r = 0, g = 0, b = 0, a = 255;
+  unsigned char r, g, b, a;
+  IglDrawVertex* v;
 
   if (!color || linewidth == 0 || rd == 0)
     return;
 
-  iupStrToRGBA(color, &r, &g, &b, &a);
-  if (!active)
-    iupGLColorMakeInactive(&r, &g, &b);
-
-  glColor4ub(r, g, b, a);
-
-  glLineWidth(linewidth);
+  iGLDrawGetColor(color, active, &r, &g, &b, &a);
 
   /* y is oriented top to bottom in IUP */
   cy = ih->currentheight - 1 - cy;
 
-  glBegin(GL_LINE_LOOP);
-
-  iGLDrawBuildSmallCircle(cx, cy, rd);
-
-  glEnd();
+  v = iGLDrawAddVertices(GL_LINE_LOOP, IGLDRAW_CIRCLE_SEGMENTS, linewidth, 0, 0);
+  iGLDrawBuildSmallCircle(v, cx, cy, rd, r, g, b, a);
+  iGLDrawEndVertices();
 }
 
 void iupGLDrawSmallDisc(Ihandle* ih, int cx, int cy, int rd, const char* color, int active)
 {
-  unsigned char r = 0, g = 0, b = 0, a = 255;
+  unsigned char r, g, b, a;
+  IglDrawVertex* v;
 
   if (!color || rd == 0)
     return;
 
-  iupStrToRGBA(color, &r, &g, &b, &a);
-  if (!active)
-    iupGLColorMakeInactive(&r, &g, &b);
-
-  glColor4ub(r, g, b, a);
+  iGLDrawGetColor(color, active, &r, &g, &b, &a);
 
   /* y is oriented top to bottom in IUP */
   cy = ih->currentheight - 1 - cy;
 
-  glBegin(GL_POLYGON);
-
-  iGLDrawBuildSmallCircle(cx, cy, rd);
-
-  glEnd();
+  v = iGLDrawAddVertices(GL_POLYGON, IGLDRAW_CIRCLE_SEGMENTS, 0, 0, 0);
+  iGLDrawBuildSmallCircle(v, cx, cy, rd, r, g, b, a);
+  iGLDrawEndVertices();
 }
 
 void iupGLDrawBox(Ihandle* ih, int xmin, int xmax, int ymin, int ymax, const char* color, int active)
 {
-  unsigned char r = 0, g = 0, b = 0, a = 255;
-  int smooth;
+  unsigned char r, g, b, a;
+  IglDrawVertex* v;
 
   if (!color || xmin == xmax || ymin == ymax)
     return;
 
-  iupStrToRGBA(color, &r, &g, &b, &a);
-  if (!active)
-    iupGLColorMakeInactive(&r, &g, &b);
-
-  glColor4ub(r, g, b, a);
+  iGLDrawGetColor(color, active, &r, &g, &b, &a);
 
   /* y is oriented top to bottom in IUP */
   ymin = ih->currentheight - 1 - ymin;
   ymax = ih->currentheight - 1 - ymax;
 
-  /* must disable polygon smooth or fill may get diagonal lines */
-  smooth = glIsEnabled(GL_POLYGON_SMOOTH);
-  if (smooth) glDisable(GL_POLYGON_SMOOTH);
-  glBegin(GL_QUADS);
-  glVertex2i(xmin, ymin);
-  glVertex2i(xmax, ymin);
-  glVertex2i(xmax, ymax);
-  glVertex2i(xmin, ymax);
-  glEnd();
-  if (smooth) glEnable(GL_POLYGON_SMOOTH);
+  v = iGLDrawAddVertices(GL_QUADS, 4, 0, 0, 1);
+  iGLDrawSetVertex(v++, xmin, ymin, r, g, b, a);
+  iGLDrawSetVertex(v++, xmax, ymin, r, g, b, a);
+  iGLDrawSetVertex(v++, xmax, ymax, r, g, b, a);
+  iGLDrawSetVertex(v, xmin, ymax, r, g, b, a);
+  iGLDrawEndVertices();
 }
 
-void iupGLDrawPolygon(Ihandle* ih, const int* points, int count, const char* color, int active)
+static void iGLDrawPoints(Ihandle* ih, GLenum mode, const int* points, int count, float linewidth, const char* color, int active)
 {
-  unsigned char r = 0, g = 0, b = 0, a = 255;
+  unsigned char r, g, b, a;
+  IglDrawVertex* v;
   int i, x, y;
 
-  if (!color || count < 3)
-    return;
+  iGLDrawGetColor(color, active, &r, &g, &b, &a);
 
-  iupStrToRGBA(color, &r, &g, &b, &a);
-  if (!active)
-    iupGLColorMakeInactive(&r, &g, &b);
-
-  glColor4ub(r, g, b, a);
-
-  glBegin(GL_POLYGON);
+  v = iGLDrawAddVertices(mode, count, linewidth, 0, 0);
 
   for (i = 0; i < count; i++)
   {
@@ -284,45 +700,26 @@ void iupGLDrawPolygon(Ihandle* ih, const int* points, int count, const char* col
     /* y is oriented top to bottom in IUP */
     y = ih->currentheight - 1 - y;
 
-    glVertex2i(x, y);
+    iGLDrawSetVertex(v++, x, y, r, g, b, a);
   }
 
-  glEnd();
+  iGLDrawEndVertices();
 }
 
-void iupGLDrawPolyline(Ihandle* ih, const int* points, int count, float linewidth, const char* color, int active, int loop)
+void iupGLDrawPolygon(Ihandle* ih, const int* points, int count, const char* color, int active)
 {
-  unsigned char r = 0, g = 0, b = 0, a = 255;
-  int i, x, y;
-
   if (!color || count < 3)
     return;
 
-  iupStrToRGBA(color, &r, &g, &b, &a);
-  if (!active)
-    iupGLColorMakeInactive(&r, &g, &b);
-
-  glColor4ub(r, g, b, a);
-
-  glLineWidth(linewidth);
-
-  if (loop)
-    glBegin(GL_LINE_LOOP);
-  else
-    glBegin(GL_LINE_STRIP);
-
-  for (i = 0; i < count; i++)
-  {
-    x = points[2 * i + 0];
-    y = points[2 * i + 1];
-
-    /* y is oriented top to bottom in IUP */
-    y = ih->currentheight - 1 - y;
+  iGLDrawPoints(ih, GL_POLYGON, points, count, 0, color, active);
+}
 
-    glVertex2i(x, y);
-  }
+void iupGLDrawPolyline(Ihandle* ih, const int* points, int count, float linewidth, const char* color, int active, int loop)
+{
+  if (!color || count < 3)
+    return;
 
-  glEnd();
+  iGLDrawPoints(ih, loop ? GL_LINE_LOOP : GL_LINE_STRIP, points, count, linewidth, color, active);
 }
 
 void iupGLDrawArrow(Ihandle *ih, int x, int y, int size, const char* color, int active, int dir)
@@ -439,12 +836,7 @@ static void iGLDrawImage(Ihandle* ih, int xmin, int xmax, int ymin, int ymax, Ih
     GLuint texture = iGLDrawGenTexture(ih, image, active);
     if (texture)
     {
-      int smooth = glIsEnabled(GL_POLYGON_SMOOTH);
-      if (smooth) glDisable(GL_POLYGON_SMOOTH);
-      glEnable(GL_TEXTURE_2D);
-
-      glBindTexture(GL_TEXTURE_2D, texture);
-      glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+      IglDrawVertex* v;
 
       /* y is oriented top to bottom in IUP */
       ymin = ih->currentheight - 1 - ymin;
@@ -453,15 +845,17 @@ static void iGLDrawImage(Ihandle* ih, int xmin, int xmax, int ymin, int ymax, Ih
       /* y is at image bottom and oriented bottom to top in OpenGL */
       { int tmp = ymin; ymin = ymax; ymax = tmp; }
 
-      glBegin(GL_QUADS);
-      glTexCoord2d(0.0, 0.0); glVertex2d(xmin, ymin);
-      glTexCoord2d(1.0, 0.0); glVertex2d(xmax + 0.375, ymin);
-      glTexCoord2d(1.0, 1.0); glVertex2d(xmax + 0.375, ymax + 0.375);
-      glTexCoord2d(0.0, 1.0); glVertex2d(xmin, ymax + 0.375);
-      glEnd();
-
-      glDisable(GL_TEXTURE_2D);
-      if (smooth) glEnable(GL_POLYGON_SMOOTH);
+      /* texture is modulated by white */
+      v = iGLDrawAddVertices(GL_QUADS, 4, 0, texture, 1);
+      iGLDrawSetVertex(v, xmin, ymin, 255, 255, 255, 255);
+      v->s = 0; v->t = 0; v++;
+      iGLDrawSetVertex(v, xmax + 0.375, ymin, 255, 255, 255, 255);
+      v->s = 1; v->t = 0; v++;
+      iGLDrawSetVertex(v, xmax + 0.375, ymax + 0.375, 255, 255, 255, 255);
+      v->s = 1; v->t = 1; v++;
+      iGLDrawSetVertex(v, xmin, ymax + 0.375, 255, 255, 255, 255);
+      v->s = 0; v->t = 1;
+      iGLDrawEndVertices();
     }
   }
   else
@@ -478,6 +872,9 @@ static void iGLDrawImage(Ihandle* ih, int xmin, int xmax, int ymin, int ymax, Ih
     if (depth == 4)
       format = GL_RGBA;
 
+    /* must be drawn after the pending primitives */
+    iupGLDrawFlush();
+
     /* y is at image bottom and oriented bottom to top in OpenGL */
     ymin = ymax;
 
@@ -514,7 +911,63 @@ void iupGLDrawIconImage(Ihandle* ih, int x, int y, const char* baseattrib, const
     iGLDrawImage(ih, x, x + image->currentwidth - 1, y, y + image->currentheight - 1, image, active);
 }
 
-static void iGLDrawText(Ihandle* ih, const char* str, int max_len, int x, int y)
+static void iGLDrawTextLine(Ihandle* ih, const char* str, int len, int x, int y, int underline, unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+{
+  const IglFontQuad* quads;
+  int i, count, atlas_width, atlas_height;
+  unsigned int texture;
+  IglDrawVertex* v;
+
+  if (iupGLFontGetStringQuads(ih, str, len, &quads, &count, &texture, &atlas_width, &atlas_height))
+  {
+    if (count)
+    {
+      float sw = 1.0f / (float)atlas_width;
+      float th = 1.0f / (float)atlas_height;
+
+      /* the alpha texture is modulated by the text color */
+      v = iGLDrawAddVertices(GL_QUADS, 4 * count, 0, (GLuint)texture, 1);
+      for (i = 0; i < count; i++)
+      {
+        const IglFontQuad* quad = quads + i;
+
+        iGLDrawSetVertex(v, x + quad->x0, y + quad->y0, r, g, b, a);
+        v->s = quad->s0 * sw; v->t = quad->t0 * th; v++;
+        iGLDrawSetVertex(v, x + quad->x0, y + quad->y1, r, g, b, a);
+        v->s = quad->s0 * sw; v->t = quad->t1 * th; v++;
+        iGLDrawSetVertex(v, x + quad->x1, y + quad->y1, r, g, b, a);
+        v->s = quad->s1 * sw; v->t = quad->t1 * th; v++;
+        iGLDrawSetVertex(v, x + quad->x1, y + quad->y0, r, g, b, a);
+        v->s = quad->s1 * sw; v->t = quad->t0 * th; v++;
+      }
+      iGLDrawEndVertices();
+    }
+  }
+  else
+  {
+    /* FTGL renders in immediate mode, must be drawn after the pending primitives */
+    iupGLDrawFlush();
+
+    glColor4ub(r, g, b, a);
+
+    glPushMatrix();
+    glTranslated((double)x, (double)y, 0.0);
+    iupGLFontRenderString(ih, str, len);
+    glPopMatrix();
+  }
+
+  if (underline)
+  {
+    int width = iupGLFontGetStringWidth(ih, str, len);
+
+    v = iGLDrawAddVertices(GL_LINES, 2, 1.0f, 0, 0);
+    iGLDrawSetVertex(v++, x, y - 2, r, g, b, a);
+    iGLDrawSetVertex(v, x + width - 1, y - 2, r, g, b, a);
+    iGLDrawEndVertices();
+  }
+}
+
+static void iGLDrawText(Ihandle* ih, const char* str, int max_len, int x, int y, unsigned char r, unsigned char g, unsigned char b, unsigned char a)
 {
   int len, cur_len, lineheight, ascent, baseline;
   const char *nextstr;
@@ -530,12 +983,6 @@ static void iGLDrawText(Ihandle* ih, const char* str, int max_len, int x, int y)
   /* y is oriented top to bottom in IUP */
   y = ih->currentheight - 1 - y;
 
-  if (underline)
-    glLineWidth(1.0f);
-
-  glPushMatrix();
-  glTranslated((double)x, (double)y, 0.0);
-
   do
   {
     nextstr = iupStrNextLine(curstr, &len);
@@ -556,41 +1003,26 @@ static void iGLDrawText(Ihandle* ih, const char* str, int max_len, int x, int y)
         }
       }
 
-      iupGLFontRenderString(ih, curstr, len);
-
-      if (underline)
-      {
-        int width = iupGLFontGetStringWidth(ih, curstr, len);
-        glBegin(GL_LINES);
-        glVertex2i(0, -2);
-        glVertex2i(width - 1, -2);
-        glEnd();
-      }
+      iGLDrawTextLine(ih, curstr, len, x, y, underline, r, g, b, a);
     }
 
-    glTranslated(0.0, (double)-lineheight, 0.0);
+    y -= lineheight;
 
     curstr = nextstr;
   } while (nextstr && *nextstr);
-
-  glPopMatrix();
 }
 
 void iupGLDrawMultilineText(Ihandle* ih, int x, int y, const char* str, const char* color, int active)
 {
-  unsigned char r = 0, g = 0, b = 0, a = 255;
+  unsigned char r, g, b, a;
 
   if (!color || !str)
     return;
 
-  iupStrToRGBA(color, &r, &g, &b, &a);
-  if (!active)
-    iupGLColorMakeInactive(&r, &g, &b);
-
-  glColor4ub(r, g, b, a);
+  iGLDrawGetColor(color, active, &r, &g, &b, &a);
 
   if (str[0])
-    iGLDrawText(ih, str, -1, x, y);
+    iGLDrawText(ih, str, -1, x, y, r, g, b, a);
 }
 
 
@@ -608,6 +1040,8 @@ void IupGLDrawImage(Ihandle* ih, const char* name, int x, int y, int active)
 
 void IupGLDrawText(Ihandle* ih, const char* str, int len, int x, int y)
 {
+  GLfloat color[4];
+
   iupASSERT(iupObjectCheck(ih));
   if (!iupObjectCheck(ih))
     return;
@@ -615,7 +1049,10 @@ void IupGLDrawText(Ihandle* ih, const char* str, int len, int x, int y)
   if (!str || str[0] == 0)
     return;
 
-  iGLDrawText(ih, str, len, x, y);
+  /* uses the current color */
+  glGetFloatv(GL_CURRENT_COLOR, color);
+  iGLDrawText(ih, str, len, x, y, (unsigned char)iupRound(color[0] * 255), (unsigned char)iupRound(color[1] * 255),
+                                  (unsigned char)iupRound(color[2] * 255), (unsigned char)iupRound(color[3] * 255));
 }
 
 void IupGLDrawGetTextSize(Ihandle* ih, const char* str, int *w, int *h)
@@ -27,6 +27,14 @@ void iupGLDrawArrow(Ihandle *ih, int x, int y, int size, const char* color, int
 void iupGLDrawSmallCircle(Ihandle* ih, int cx, int cy, int r, float linewidth, const char* color, int active);
 void iupGLDrawSmallDisc(Ihandle* ih, int cx, int cy, int rd, const char* color, int active);
 
+/* primitives of all the sub-canvases are drawn at once by EndBatch,
+   SetTransform is called for each sub-canvas with its position and clipping in window coordinates,
+   Flush draws everything collected so far */
+void iupGLDrawBeginBatch(int width, int height);
+void iupGLDrawSetTransform(int x, int y, int clip_x, int clip_y, int clip_w, int clip_h, int direct);
+void iupGLDrawEndBatch(void);
+void iupGLDrawFlush(void);
+
 
 #ifdef __cplusplus
 }
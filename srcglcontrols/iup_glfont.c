@@ -10,10 +10,20 @@
 #include <iconv.h>
 #endif
 
+#if defined (__APPLE__) || defined (OSX)
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
 #include <FTGL/ftgl.h>
+#include <ft2build.h>
+#include FT_FREETYPE_H
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
 
 #include "iup.h"
 #include "iupgl.h"
@@ -23,23 +33,78 @@
 #include "iup_attrib.h"
 #include "iup_str.h"
 #include "iup_array.h"
+#include "iup_table.h"
 #include "iup_drvfont.h"
 
 #include "iup_glcontrols.h"
 #include "iup_glfont.h"
+#include "iup_gldraw.h"
+
 
+/* Glyphs are rendered by FreeType in a single alpha texture per font,
+   and the glyph quads of each string are cached,
+   so text is drawn with the other primitives and measured without FTGL.
+   The FTGL font is still used for the font metrics,
+   and to render the text if the atlas can not be created. */
+typedef struct _IglFontGlyph
+{
+  float advance;
+  int left, top;  /* bitmap position relative to the pen, y oriented bottom to top */
+  int width, height;
+  int atlas_x, atlas_y;
+  FT_UInt index;  /* for kerning */
+  int failed;  /* could not be loaded in the atlas, the strings that use it are rendered by FTGL */
+} IglFontGlyph;
+
+typedef struct _IglFontLayout
+{
+  char* key;
+  int used;  /* used since the last eviction pass */
+  int width;
+  int count;  /* -1 when the string has a failed glyph */
+  IglFontQuad quads[1];  /* allocated with count quads */
+} IglFontLayout;
+
+#define IGLFONT_ATLAS_WIDTH 512
+#define IGLFONT_ATLAS_MAXHEIGHT 2048
+#define IGLFONT_LAYOUT_MAX 1024
+
+typedef struct _IglFontAtlas
+{
+  FT_Face face;
+  unsigned char* data;
+  int width, height;
+  int pen_x, pen_y, row_height;  /* rows of glyphs, from top to bottom */
+  int dirty_ymin, dirty_ymax;  /* rows not uploaded to the texture */
+  int generation;  /* incremented when the atlas is full and all glyphs are removed */
+  GLuint texture;
+  int texture_height, texture_generation;
+
+  IglFontGlyph latin1[256];
+  char latin1_loaded[256];
+  Itable* glyphs;   /* code point -> IglFontGlyph*, above Latin-1 */
+
+  Itable* layouts;  /* string -> IglFontLayout* */
+  IglFontLayout* layout_ring[IGLFONT_LAYOUT_MAX];  /* the same layouts, in eviction order */
+  int layout_count, layout_hand;
+  int layout_utf8mode;
+} IglFontAtlas;
 
 typedef struct _IglFont
 {
   char filename[10240];
   int size;
   FTGLfont* ftgl_font;
+  IglFontAtlas* atlas;
   int charwidth, charheight;
 } IglFont;
 
 
 static char* gl_utf8_buffer = NULL;
 static int gl_utf8_buffer_len = 0;
+static char* gl_key_buffer = NULL;
+static int gl_key_buffer_len = 0;
+static FT_Library gl_ft_library = NULL;
 
 
 #ifdef WIN32
@@ -398,6 +463,7 @@ static void iGLGetFontFilename(char* filename, const char *typeface, int is_bold
 }
 
 static int iGLFontGetFontAveWidth(FTGLfont* ftgl_font);
+static IglFontAtlas* iGLFontCreateAtlas(const char* filename, int size, int res);
 
 static IglFont* iGLFindFont(Ihandle* ih, Ihandle* gl_parent, const char *font)
 {
@@ -460,6 +526,8 @@ static IglFont* iGLFindFont(Ihandle* ih, Ihandle* gl_parent, const char *font)
   fonts[i].charwidth = iGLFontGetFontAveWidth(ftgl_font);
   fonts[i].charheight = iupRound(ftglGetFontLineHeight(ftgl_font));
 
+  fonts[i].atlas = iGLFontCreateAtlas(filename, size, (int)res);
+
   return &fonts[i];
 }
 
@@ -523,6 +591,410 @@ static int iGLFontGetFontAveWidth(FTGLfont* ftgl_font)
   return iupRound(ftglGetFontAdvance(ftgl_font, sample) / (256.0f - 32.0f));
 }
 
+static IglFontAtlas* iGLFontCreateAtlas(const char* filename, int size, int res)
+{
+  IglFontAtlas* atlas;
+  FT_Face face;
+
+  if (!gl_ft_library && FT_Init_FreeType(&gl_ft_library) != 0)
+  {
+    gl_ft_library = NULL;
+    return NULL;
+  }
+
+  if (FT_New_Face(gl_ft_library, filename, 0, &face) != 0)
+    return NULL;
+
+  /* same as ftglSetFontFaceSize */
+  if (FT_Set_Char_Size(face, 0, size * 64, res, res) != 0)
+  {
+    FT_Done_Face(face);
+    return NULL;
+  }
+
+  atlas = (IglFontAtlas*)calloc(1, sizeof(IglFontAtlas));
+  atlas->face = face;
+  atlas->width = IGLFONT_ATLAS_WIDTH;
+  atlas->height = 256;
+  atlas->data = (unsigned char*)calloc(atlas->width * atlas->height, 1);
+  atlas->dirty_ymin = atlas->height;
+  atlas->glyphs = iupTableCreate(IUPTABLE_POINTERINDEXED);
+  atlas->layouts = iupTableCreate(IUPTABLE_STRINGINDEXED);
+  return atlas;
+}
+
+static void iGLFontFreeLayout(IglFontLayout* layout)
+{
+  free(layout->key);
+  free(layout);
+}
+
+static void iGLFontClearLayouts(IglFontAtlas* atlas)
+{
+  int i;
+  for (i = 0; i < atlas->layout_count; i++)
+    iGLFontFreeLayout(atlas->layout_ring[i]);
+
+  iupTableClear(atlas->layouts);
+  atlas->layout_count = 0;
+  atlas->layout_hand = 0;
+}
+
+static void iGLFontAddLayout(IglFontAtlas* atlas, IglFontLayout* layout)
+{
+  if (atlas->layout_count < IGLFONT_LAYOUT_MAX)
+    atlas->layout_ring[atlas->layout_count++] = layout;
+  else
+  {
+    /* second chance (clock) eviction, the strings used since the last pass are kept */
+    IglFontLayout* old = atlas->layout_ring[atlas->layout_hand];
+    while (old->used)
+    {
+      old->used = 0;
+      atlas->layout_hand = (atlas->layout_hand + 1) % IGLFONT_LAYOUT_MAX;
+      old = atlas->layout_ring[atlas->layout_hand];
+    }
+
+    iupTableRemove(atlas->layouts, old->key);
+    iGLFontFreeLayout(old);
+
+    atlas->layout_ring[atlas->layout_hand] = layout;
+    atlas->layout_hand = (atlas->layout_hand + 1) % IGLFONT_LAYOUT_MAX;
+  }
+
+  iupTableSet(atlas->layouts, layout->key, layout, IUPTABLE_POINTER);
+}
+
+static void iGLFontClearGlyphs(IglFontAtlas* atlas)
+{
+  char* key = iupTableFirst(atlas->glyphs);
+  while (key)
+  {
+    free(iupTableGetCurr(atlas->glyphs));
+    key = iupTableNext(atlas->glyphs);
+  }
+
+  iupTableClear(atlas->glyphs);
+  memset(atlas->latin1_loaded, 0, sizeof(atlas->latin1_loaded));
+
+  /* the quads of the cached strings point to the removed glyphs */
+  iGLFontClearLayouts(atlas);
+
+  memset(atlas->data, 0, atlas->width * atlas->height);
+  atlas->pen_x = 0;
+  atlas->pen_y = 0;
+  atlas->row_height = 0;
+  atlas->dirty_ymin = atlas->height;
+  atlas->dirty_ymax = 0;
+  atlas->generation++;
+}
+
+static void iGLFontDestroyAtlas(IglFontAtlas* atlas)
+{
+  iGLFontClearGlyphs(atlas);
+  iupTableDestroy(atlas->glyphs);
+  iupTableDestroy(atlas->layouts);
+
+  if (atlas->texture)
+    glDeleteTextures(1, &atlas->texture);
+
+  FT_Done_Face(atlas->face);
+  free(atlas->data);
+  free(atlas);
+}
+
+static int iGLFontAtlasAlloc(IglFontAtlas* atlas, int w, int h, int *x, int *y)
+{
+  /* one pixel between glyphs */
+  if (w + 1 > atlas->width)
+    return 0;
+
+  if (atlas->pen_x + w + 1 > atlas->width)
+  {
+    atlas->pen_y += atlas->row_height + 1;
+    atlas->pen_x = 0;
+    atlas->row_height = 0;
+  }
+
+  while (atlas->pen_y + h + 1 > atlas->height)
+  {
+    int height = atlas->height * 2;
+    if (height > IGLFONT_ATLAS_MAXHEIGHT)
+    {
+      if (h + 1 > atlas->height)
+        return 0;
+
+      /* full, start again with the glyphs in use */
+      iGLFontClearGlyphs(atlas);
+      continue;
+    }
+
+    atlas->data = (unsigned char*)realloc(atlas->data, atlas->width * height);
+    memset(atlas->data + atlas->width * atlas->height, 0, atlas->width * (height - atlas->height));
+    atlas->height = height;
+  }
+
+  *x = atlas->pen_x;
+  *y = atlas->pen_y;
+
+  atlas->pen_x += w + 1;
+  if (h > atlas->row_height)
+    atlas->row_height = h;
+
+  if (*y < atlas->dirty_ymin) atlas->dirty_ymin = *y;
+  if (*y + h > atlas->dirty_ymax) atlas->dirty_ymax = *y + h;
+  return 1;
+}
+
+static void iGLFontLoadGlyph(IglFontAtlas* atlas, IglFontGlyph* glyph, unsigned int code)
+{
+  FT_Face face = atlas->face;
+  FT_GlyphSlot slot;
+  int i;
+
+  memset(glyph, 0, sizeof(IglFontGlyph));
+
+  glyph->index = FT_Get_Char_Index(face, code);
+
+  /* same flags as FTGL */
+  if (FT_Load_Glyph(face, glyph->index, FT_LOAD_DEFAULT | FT_LOAD_NO_BITMAP) != 0)
+  {
+    glyph->failed = 1;
+    return;
+  }
+
+  slot = face->glyph;
+  glyph->advance = slot->advance.x / 64.0f;
+
+  if (FT_Render_Glyph(slot, FT_RENDER_MODE_NORMAL) != 0 || slot->bitmap.pixel_mode != FT_PIXEL_MODE_GRAY)
+  {
+    glyph->failed = 1;
+    return;
+  }
+
+  if (slot->bitmap.width == 0 || slot->bitmap.rows == 0)
+    return;  /* a space, nothing to draw */
+
+  if (!iGLFontAtlasAlloc(atlas, slot->bitmap.width, slot->bitmap.rows, &glyph->atlas_x, &glyph->atlas_y))
+  {
+    /* larger than the atlas */
+    glyph->failed = 1;
+    return;
+  }
+
+  glyph->left = slot->bitmap_left;
+  glyph->top = slot->bitmap_top;
+  glyph->width = slot->bitmap.width;
+  glyph->height = slot->bitmap.rows;
+
+  for (i = 0; i < glyph->height; i++)
+    memcpy(atlas->data + (glyph->atlas_y + i) * atlas->width + glyph->atlas_x, slot->bitmap.buffer + i * slot->bitmap.pitch, glyph->width);
+}
+
+static IglFontGlyph* iGLFontGetGlyph(IglFontAtlas* atlas, unsigned int code)
+{
+  IglFontGlyph* glyph;
+
+  if (code < 256)
+  {
+    glyph = atlas->latin1 + code;
+    if (!atlas->latin1_loaded[code])
+    {
+      iGLFontLoadGlyph(atlas, glyph, code);
+      atlas->latin1_loaded[code] = 1;
+    }
+    return glyph;
+  }
+
+  glyph = (IglFontGlyph*)iupTableGet(atlas->glyphs, (const char*)(size_t)code);
+  if (!glyph)
+  {
+    glyph = (IglFontGlyph*)malloc(sizeof(IglFontGlyph));
+    iGLFontLoadGlyph(atlas, glyph, code);
+    iupTableSet(atlas->glyphs, (const char*)(size_t)code, glyph, IUPTABLE_POINTER);
+  }
+  return glyph;
+}
+
+static unsigned int iGLFontNextCodePoint(const unsigned char** str)
+{
+  const unsigned char* s = *str;
+  unsigned int code = *s++;
+  int n = 0;
+
+  if (code >= 0xF0) { code &= 0x07; n = 3; }
+  else if (code >= 0xE0) { code &= 0x0F; n = 2; }
+  else if (code >= 0xC0) { code &= 0x1F; n = 1; }
+
+  while (n > 0 && (*s & 0xC0) == 0x80)
+  {
+    code = (code << 6) | (*s & 0x3F);
+    s++;
+    n--;
+  }
+
+  *str = s;
+  return code;
+}
+
+/* returns NULL if the atlas was cleared, and a layout with count=-1 if a glyph failed */
+static IglFontLayout* iGLFontCreateLayout(IglFontAtlas* atlas, const char* utf8_str)
+{
+  const unsigned char* s = (const unsigned char*)utf8_str;
+  int count = 0, generation = atlas->generation;
+  FT_UInt previous = 0;
+  float pen = 0;
+  IglFontLayout* layout = (IglFontLayout*)malloc(sizeof(IglFontLayout) + strlen(utf8_str) * sizeof(IglFontQuad));
+
+  while (*s)
+  {
+    IglFontGlyph* glyph = iGLFontGetGlyph(atlas, iGLFontNextCodePoint(&s));
+
+    if (atlas->generation != generation)
+    {
+      /* the atlas was cleared while loading the glyphs of this string */
+      free(layout);
+      return NULL;
+    }
+
+    if (glyph->failed)
+    {
+      /* do not draw the string with missing glyphs */
+      layout = (IglFontLayout*)realloc(layout, sizeof(IglFontLayout));
+      layout->count = -1;
+      return layout;
+    }
+
+    if (previous && glyph->index && FT_HAS_KERNING(atlas->face))
+    {
+      FT_Vector kerning;
+      if (FT_Get_Kerning(atlas->face, previous, glyph->index, FT_KERNING_UNFITTED, &kerning) == 0)
+        pen += kerning.x / 64.0f;
+    }
+
+    if (glyph->width)
+    {
+      /* same position as the FTGL texture glyph */
+      IglFontQuad* quad = layout->quads + count;
+      quad->x0 = (int)floor(pen + glyph->left);
+      quad->y0 = glyph->top;
+      quad->x1 = quad->x0 + glyph->width;
+      quad->y1 = glyph->top - glyph->height;
+      quad->s0 = glyph->atlas_x;
+      quad->t0 = glyph->atlas_y;
+      quad->s1 = glyph->atlas_x + glyph->width;
+      quad->t1 = glyph->atlas_y + glyph->height;
+      count++;
+    }
+
+    pen += glyph->advance;
+    previous = glyph->index;
+  }
+
+  layout->width = iupRound(pen);
+  layout->count = count;
+  return layout;
+}
+
+static IglFontLayout* iGLFontGetLayout(IglFont* glfont, const char* str, int len)
+{
+  IglFontAtlas* atlas = glfont->atlas;
+  IglFontLayout* layout;
+  int utf8mode;
+
+  if (!atlas)
+    return NULL;
+
+  if (len < 0)
+    len = (int)strlen(str);
+
+  /* strings are not terminated at len */
+  if (len + 1 > gl_key_buffer_len)
+  {
+    gl_key_buffer_len = len + 1 + 100;
+    gl_key_buffer = (char*)realloc(gl_key_buffer, gl_key_buffer_len);
+  }
+  memcpy(gl_key_buffer, str, len);
+  gl_key_buffer[len] = 0;
+
+  utf8mode = IupGetInt(NULL, "UTF8MODE");
+  if (utf8mode != atlas->layout_utf8mode)
+  {
+    iGLFontClearLayouts(atlas);
+    atlas->layout_utf8mode = utf8mode;
+  }
+
+  layout = (IglFontLayout*)iupTableGet(atlas->layouts, gl_key_buffer);
+  if (layout)
+  {
+    layout->used = 1;
+    return layout->count < 0? NULL: layout;
+  }
+
+  /* FreeType code points come from UTF-8 */
+  gl_utf8_buffer = iupStrConvertToUTF8(str, len, gl_utf8_buffer, &gl_utf8_buffer_len, utf8mode);
+
+  layout = iGLFontCreateLayout(atlas, gl_utf8_buffer);
+  if (!layout)
+    layout = iGLFontCreateLayout(atlas, gl_utf8_buffer);  /* again, with an empty atlas */
+  if (!layout)
+    return NULL;
+
+  /* the failed strings are also cached, so FTGL is used without loading the glyphs again */
+  layout->key = iupStrDup(gl_key_buffer);
+  layout->used = 0;
+  iGLFontAddLayout(atlas, layout);
+  return layout->count < 0? NULL: layout;
+}
+
+static void iGLFontUpdateTexture(IglFontAtlas* atlas)
+{
+  glPushAttrib(GL_TEXTURE_BIT);
+  glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+  if (!atlas->texture)
+    glGenTextures(1, &atlas->texture);
+
+  glBindTexture(GL_TEXTURE_2D, atlas->texture);
+
+  if (atlas->texture_height != atlas->height || atlas->texture_generation != atlas->generation)
+  {
+    /* pending text uses the previous texture */
+    iupGLDrawFlush();
+
+    /* same as the FTGL texture font, the glyphs are separated by one empty pixel */
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, atlas->width, atlas->height, 0, GL_ALPHA, GL_UNSIGNED_BYTE, atlas->data);
+
+    atlas->texture_height = atlas->height;
+    atlas->texture_generation = atlas->generation;
+  }
+  else if (atlas->dirty_ymax > atlas->dirty_ymin)
+  {
+    /* new glyphs only, the others are not changed */
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, atlas->dirty_ymin, atlas->width, atlas->dirty_ymax - atlas->dirty_ymin,
+                    GL_ALPHA, GL_UNSIGNED_BYTE, atlas->data + atlas->dirty_ymin * atlas->width);
+  }
+
+  atlas->dirty_ymin = atlas->height;
+  atlas->dirty_ymax = 0;
+
+  glPopClientAttrib();
+  glPopAttrib();
+}
+
+static int iGLFontGetWidth(IglFont* glfont, const char* str, int len)
+{
+  IglFontLayout* layout = iGLFontGetLayout(glfont, str, len);
+  if (layout)
+    return layout->width;
+
+  iGLFontConvertToUTF8(str, len);
+  return iupRound(ftglGetFontAdvance(glfont->ftgl_font, gl_utf8_buffer));
+}
+
 int iupGLFontGetStringWidth(Ihandle* ih, const char* str, int len)
 {
   IglFont* glfont;
@@ -534,8 +1006,7 @@ int iupGLFontGetStringWidth(Ihandle* ih, const char* str, int len)
   if (!glfont)
     return 0;
 
-  iGLFontConvertToUTF8(str, len);
-  return iupRound(ftglGetFontAdvance(glfont->ftgl_font, gl_utf8_buffer));
+  return iGLFontGetWidth(glfont, str, len);
 }
 
 void iupGLFontGetMultiLineStringSize(Ihandle* ih, const char* str, int *w, int *h)
@@ -576,8 +1047,7 @@ void iupGLFontGetMultiLineStringSize(Ihandle* ih, const char* str, int *w, int *
       nextstr = iupStrNextLine(curstr, &len);
       if (len)
       {
-        iGLFontConvertToUTF8(curstr, len);
-        size = iupRound(ftglGetFontAdvance(glfont->ftgl_font, gl_utf8_buffer));
+        size = iGLFontGetWidth(glfont, curstr, len);
         max_w = iupMAX(max_w, size);
       }
 
@@ -665,6 +1135,32 @@ void iupGLFontRenderString(Ihandle* ih, const char* str, int len)
   ftglRenderFont(glfont->ftgl_font, gl_utf8_buffer, FTGL_RENDER_ALL);
 }
 
+int iupGLFontGetStringQuads(Ihandle* ih, const char* str, int len, const IglFontQuad** quads, int *count, unsigned int *texture, int *atlas_width, int *atlas_height)
+{
+  IglFontLayout* layout;
+  IglFont* glfont;
+
+  if (!ih->handle)
+    return 0;
+
+  glfont = iGLFontGet(ih);
+  if (!glfont)
+    return 0;
+
+  layout = iGLFontGetLayout(glfont, str, len);
+  if (!layout)
+    return 0;
+
+  iGLFontUpdateTexture(glfont->atlas);
+
+  *quads = layout->quads;
+  *count = layout->count;
+  *texture = glfont->atlas->texture;
+  *atlas_width = glfont->atlas->width;
+  *atlas_height = glfont->atlas->height;
+  return 1;
+}
+
 void iupGLFontInit(void)
 {
 #ifdef WIN32
@@ -684,6 +1180,12 @@ void iupGLFontRelease(Ihandle* gl_parent)
     {
       ftglDestroyFont(fonts[i].ftgl_font);
       fonts[i].ftgl_font = NULL;
+
+      if (fonts[i].atlas)
+      {
+        iGLFontDestroyAtlas(fonts[i].atlas);
+        fonts[i].atlas = NULL;
+      }
     }
     iupArrayDestroy(gl_fonts);
     iupAttribSet(gl_parent, "GL_FONTLIST", NULL);
@@ -699,6 +1201,19 @@ void iupGLFontFinish(void)
     gl_utf8_buffer_len = 0;
   }
 
+  if (gl_key_buffer)
+  {
+    free(gl_key_buffer);
+    gl_key_buffer = NULL;
+    gl_key_buffer_len = 0;
+  }
+
+  if (gl_ft_library)
+  {
+    FT_Done_FreeType(gl_ft_library);
+    gl_ft_library = NULL;
+  }
+
 #ifdef WIN32
   if (win_fonts)
     free(win_fonts);
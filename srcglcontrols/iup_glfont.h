@@ -20,6 +20,15 @@ void iupGLFontGetDim(Ihandle* ih, int *maxwidth, int *height, int *ascent, int *
 
 int iupGLFontSetFontAttrib(Ihandle* ih, const char* value);
 void iupGLFontRenderString(Ihandle* ih, const char* str, int len);
+
+typedef struct _IglFontQuad
+{
+  int x0, y0, x1, y1;  /* relative to the baseline start, y oriented bottom to top */
+  int s0, t0, s1, t1;  /* in atlas pixels */
+} IglFontQuad;
+
+/* returns 0 if the font has no glyph atlas, then iupGLFontRenderString must be used */
+int iupGLFontGetStringQuads(Ihandle* ih, const char* str, int len, const IglFontQuad** quads, int *count, unsigned int *texture, int *atlas_width, int *atlas_height);
 void iupGLFontInit(void);
 void iupGLFontFinish(void);
 void iupGLFontRelease(Ihandle* gl_parent);
@@ -29,6 +29,7 @@
 
 #include "iup_glcontrols.h"
 #include "iup_glfont.h"
+#include "iup_gldraw.h"
 #include "iup_glsubcanvas.h"
 
 
@@ -81,7 +82,7 @@ static void iGLSaveClientClipping(Ihandle* ih, int clip_x, int clip_y, int clip_
   iupAttribSetInt(ih, "CLIP_H", h);
 }
 
-static int iGLSetClipping(Ihandle* ih, int x, int y, int w, int h, Ihandle* gl_parent)
+static int iGLSetClipping(Ihandle* ih, int x, int y, int w, int h, Ihandle* gl_parent, int *scissor)
 {
   int clip_x = iupAttribGetInt(ih->parent, "CLIP_X");
   int clip_y = iupAttribGetInt(ih->parent, "CLIP_Y");
@@ -125,6 +126,11 @@ static int iGLSetClipping(Ihandle* ih, int x, int y, int w, int h, Ihandle* gl_p
 
   iGLFixRectY(gl_parent, &y, h);
   glScissor(x, y, w, h);
+
+  scissor[0] = x;
+  scissor[1] = y;
+  scissor[2] = w;
+  scissor[3] = h;
   return 1;
 }
 
@@ -134,9 +140,10 @@ int iupGLSubCanvasSetTransform(Ihandle* ih, Ihandle* gl_parent)
   int y = ih->y;
   int w = ih->currentwidth;
   int h = ih->currentheight;
+  int scissor[4];
 
   /* crop to parent's rectangle */
-  if (!iGLSetClipping(ih, x, y, w, h, gl_parent))
+  if (!iGLSetClipping(ih, x, y, w, h, gl_parent, scissor))
     return 0;
 
   iGLFixRectY(gl_parent, &y, h);
@@ -150,6 +157,9 @@ int iupGLSubCanvasSetTransform(Ihandle* ih, Ihandle* gl_parent)
   glLoadIdentity();
   glTranslatef(0.375, 0.375, 0.0);  /* render all primitives at integer positions */
 
+  /* the application sub-canvas may draw using OpenGL directly */
+  iupGLDrawSetTransform(x, y, scissor[0], scissor[1], scissor[2], scissor[3], iupStrEqual(ih->iclass->name, "glsubcanvas"));
+
   return 1;
 }
 
@@ -193,6 +203,8 @@ void iupGLSubCanvasSaveState(Ihandle* gl_parent)
 
   iupAttribSet(gl_parent, "_IUP_GLSUBCANVAS_SAVED", "1");
 
+  iupGLDrawBeginBatch(gl_parent->currentwidth - 2 * border, gl_parent->currentheight - 2 * border);
+
   iupAttribSetInt(gl_parent, "CLIP_X", 0);
   iupAttribSetInt(gl_parent, "CLIP_Y", 0);
   iupAttribSetInt(gl_parent, "CLIP_W", gl_parent->currentwidth - 2 * border);
@@ -206,6 +218,8 @@ void iupGLSubCanvasRestoreState(Ihandle* gl_parent)
   if (!saved)
     return;
 
+  iupGLDrawEndBatch();
+
   /* restore transformation matrix */
   glMatrixMode(GL_MODELVIEW);
   glPopMatrix();
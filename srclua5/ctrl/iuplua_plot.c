@@ -198,6 +198,14 @@ static int PlotEnd(lua_State *L)
   return 1;
 }
 
+static int PlotNewRingDataSet(lua_State *L)
+{
+  Ihandle *ih = iuplua_checkihandle(L,1);
+  int ret = IupPlotNewRingDataSet(ih, (int)luaL_checkinteger(L,2));
+  lua_pushinteger(L, ret);
+  return 1;
+}
+
 static int PlotLoadData(lua_State *L)
 {
   Ihandle *ih = iuplua_checkihandle(L, 1);
@@ -206,6 +214,22 @@ static int PlotLoadData(lua_State *L)
   return 1;
 }
 
+static int PlotLoadDataColumns(lua_State *L)
+{
+  Ihandle *ih = iuplua_checkihandle(L, 1);
+  int ret = IupPlotLoadDataColumns(ih, luaL_checkstring(L, 2), luaL_checkinteger(L, 3), luaL_optstring(L, 4, NULL));
+  lua_pushinteger(L, ret);
+  return 1;
+}
+
+static int PlotLoadDataBinary(lua_State *L)
+{
+  Ihandle *ih = iuplua_checkihandle(L, 1);
+  int ret = IupPlotLoadDataBinary(ih, luaL_checkstring(L, 2), luaL_checkinteger(L, 3), luaL_checkinteger(L, 4), luaL_optstring(L, 5, NULL));
+  lua_pushinteger(L, ret);
+  return 1;
+}
+
 static int PlotSetFormula(lua_State *L)
 {
   Ihandle *ih = iuplua_checkihandle(L, 1);
@@ -420,7 +444,10 @@ void iuplua_plotfuncs_open (lua_State *L)
   iuplua_register(L, PlotAddStr      ,"PlotAddStr");
   iuplua_register(L, PlotAddSegment  ,"PlotAddSegment");
   iuplua_register(L, PlotEnd         ,"PlotEnd");
+  iuplua_register(L, PlotNewRingDataSet, "PlotNewRingDataSet");
   iuplua_register(L, PlotLoadData    ,"PlotLoadData");
+  iuplua_register(L, PlotLoadDataColumns, "PlotLoadDataColumns");
+  iuplua_register(L, PlotLoadDataBinary, "PlotLoadDataBinary");
   iuplua_register(L, PlotSetFormula  ,"PlotSetFormula");
   iuplua_register(L, PlotFindSample  ,"PlotFindSample");
   iuplua_register(L, PlotFindSegment, "PlotFindSegment");
@@ -36,7 +36,10 @@ ctrl.Add = iup.PlotAdd
 ctrl.AddStr = iup.PlotAddStr 
 ctrl.AddSegment = iup.PlotAddSegment 
 ctrl.End = iup.PlotEnd 
+ctrl.NewRingDataSet = iup.PlotNewRingDataSet
 ctrl.LoadData = iup.PlotLoadData 
+ctrl.LoadDataColumns = iup.PlotLoadDataColumns
+ctrl.LoadDataBinary = iup.PlotLoadDataBinary
 ctrl.SetFormula = iup.PlotSetFormula 
 ctrl.FindSample = iup.PlotFindSample 
 ctrl.Insert = iup.PlotInsert 
@@ -76,6 +76,28 @@ static int tree_togglevalue_cb(Ihandle *self, int p0, int p1)
   return iuplua_call(L, 2);
 }
 
+static int tree_nodecount_cb(Ihandle *self, char * p0)
+{
+  lua_State *L = iuplua_call_start(self, "nodecount_cb");
+  lua_pushstring(L, p0);
+  return iuplua_call(L, 1);
+}
+
+static char * tree_nodetitle_cb(Ihandle *self, char * p0)
+{
+  lua_State *L = iuplua_call_start(self, "nodetitle_cb");
+  lua_pushstring(L, p0);
+  return iuplua_call_ret_s(L, 1);
+}
+
+static int tree_nodeuserdata_cb(Ihandle *self, char * p0, int p1)
+{
+  lua_State *L = iuplua_call_start(self, "nodeuserdata_cb");
+  lua_pushstring(L, p0);
+  lua_pushinteger(L, p1);
+  return iuplua_call(L, 2);
+}
+
 static int tree_branchclose_cb(Ihandle *self, int p0)
 {
   lua_State *L = iuplua_call_start(self, "branchclose_cb");
@@ -126,6 +148,9 @@ int iuptreelua_open(lua_State * L)
   iuplua_register_cb(L, "MULTIUNSELECTION_CB", (lua_CFunction)tree_multiunselection_cb, NULL);
   iuplua_register_cb(L, "SHOWRENAME_CB", (lua_CFunction)tree_showrename_cb, NULL);
   iuplua_register_cb(L, "TOGGLEVALUE_CB", (lua_CFunction)tree_togglevalue_cb, NULL);
+  iuplua_register_cb(L, "NODECOUNT_CB", (lua_CFunction)tree_nodecount_cb, NULL);
+  iuplua_register_cb(L, "NODETITLE_CB", (lua_CFunction)tree_nodetitle_cb, NULL);
+  iuplua_register_cb(L, "NODEUSERDATA_CB", (lua_CFunction)tree_nodeuserdata_cb, NULL);
   iuplua_register_cb(L, "BRANCHCLOSE_CB", (lua_CFunction)tree_branchclose_cb, NULL);
   iuplua_register_cb(L, "EXECUTELEAF_CB", (lua_CFunction)tree_executeleaf_cb, NULL);
   iuplua_register_cb(L, "RIGHTCLICK_CB", (lua_CFunction)tree_rightclick_cb, NULL);
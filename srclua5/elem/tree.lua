@@ -19,6 +19,9 @@ local ctrl = {
     rightclick_cb = "n",
     dragdrop_cb = "nnnn",
     togglevalue_cb = "nn",
+    nodecount_cb = "s",  -- fake definition to be replaced by treefuncs module
+    nodetitle_cb = {"s", ret = "s"},  -- fake definition to be replaced by treefuncs module
+    nodeuserdata_cb = "sn",  -- fake definition to be replaced by treefuncs module
   },
   extrafuncs = 1,
 }
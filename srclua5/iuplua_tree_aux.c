@@ -167,10 +167,58 @@ static int tree_noderemoved_cb(Ihandle *ih, void* p1)
   return iuplua_call(L, 1);
 }
 
+static int tree_nodecount_cb(Ihandle *ih, void* p1)
+{
+  lua_State *L = iuplua_call_start(ih, "nodecount_cb");
+  tree_push_userid(L, p1);
+  return iuplua_call(L, 1);
+}
+
+static char* tree_nodetitle_cb(Ihandle *ih, void* p1)
+{
+  lua_State *L = iuplua_call_start(ih, "nodetitle_cb");
+  tree_push_userid(L, p1);
+  return iuplua_call_ret_s(L, 1);
+}
+
+static void* tree_nodeuserdata_cb(Ihandle *ih, void* p1, int p2)
+{
+  int ref, pos;
+  lua_State *L = iuplua_call_start(ih, "nodeuserdata_cb");
+  tree_push_userid(L, p1);
+  lua_pushinteger(L, p2);
+  if (iuplua_call_raw(L, 2 + 2, 1) != LUA_OK)  /* name, ih and 2 args, 1 return */
+    return NULL;
+
+  pos = lua_gettop(L);
+  if (lua_isnil(L, pos))
+  {
+    lua_settop(L, pos - 1);
+    return NULL;
+  }
+
+  /* the returned object is referenced like in TreeSetUserId, 
+     but the same reference is reused when the object was already returned */
+  ref = tree_gettableref(L, pos);
+  if (ref == LUA_NOREF)
+  {
+    lua_pushvalue(L, pos);
+    ref = luaL_ref(L, LUA_REGISTRYINDEX);
+    tree_settableref(L, pos, ref);
+  }
+  lua_settop(L, pos - 1);  /* also removes the TREEREFTABLE left by tree_gettableref */
+
+  if (ref >= 0) ref++;  /* only positive references are shifted */
+  return (void*)ref;
+}
+
 void iuplua_treefuncs_open (lua_State *L)
 {
   iuplua_register_cb(L, "MULTISELECTION_CB", (lua_CFunction)tree_multiselection_cb, NULL);
   iuplua_register_cb(L, "MULTIUNSELECTION_CB", (lua_CFunction)tree_multiunselection_cb, NULL);
+  iuplua_register_cb(L, "NODECOUNT_CB", (lua_CFunction)tree_nodecount_cb, NULL);
+  iuplua_register_cb(L, "NODETITLE_CB", (lua_CFunction)tree_nodetitle_cb, NULL);
+  iuplua_register_cb(L, "NODEUSERDATA_CB", (lua_CFunction)tree_nodeuserdata_cb, NULL);
   iuplua_register_cb(L, "NODEREMOVED_CB", (lua_CFunction)tree_noderemoved_cb, NULL);
 
   /* Table/Userdata <-> id */
@@ -28,7 +28,7 @@ ifdef USE_CONTEXTPLUS
   DEFINES += USE_CONTEXTPLUS
 endif
 
-SRC = iup_plot.cpp  iupPlotCalc.cpp iupPlot.cpp iupPlotDraw.cpp iupPlotTick.cpp iup_plot_attrib.cpp
+SRC = iup_plot.cpp  iupPlotCalc.cpp iupPlot.cpp iupPlotDraw.cpp iupPlotTick.cpp iup_plot_attrib.cpp iupPlotAsync.cpp
 
 ifneq ($(findstring MacOS, $(TEC_UNAME)), )
   INCLUDES += $(X11_INC)
@@ -39,6 +39,7 @@ endif
 
 ifneq ($(findstring Linux, $(TEC_UNAME)), )
   CPPFLAGS = -Wno-reorder -Wno-write-strings
+  LIBS += pthread
 endif
 ifneq ($(findstring cygw, $(TEC_UNAME)), )
   CPPFLAGS = -Wno-reorder -Wno-write-strings
@@ -3,6 +3,12 @@
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
+#include <float.h>
+#include <limits.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 #include "iupPlot.h"
 
@@ -112,24 +118,350 @@ bool iupPlotTrafoLog::Calculate(int inBegin, int inEnd, const iupPlotAxis& inAxi
 /************************************************************************************************/
 
 
-bool iupPlotDataReal::CalculateRange(double &outMin, double &outMax) const
+static inline double iPlotRangeSample(const double* inData, int inStride, int inIndex)
+{
+  return *(const double*)((const char*)inData + (size_t)inIndex * inStride);
+}
+
+iupPlotRangePyramid::~iupPlotRangePyramid()
+{
+  for (int level = 0; level < mLevelCount; level++)
+    free(mLevel[level]);
+}
+
+void iupPlotRangePyramid::UpdateBlock(const double* inData, int inStride, int inCount, int inBlock)
+{
+  int theBegin = inBlock * IUP_PLOT_RANGE_BLOCK;
+  int theEnd = theBegin + IUP_PLOT_RANGE_BLOCK;
+  if (theEnd > inCount)
+    theEnd = inCount;
+
+  double theMin = iPlotRangeSample(inData, inStride, theBegin);
+  double theMax = theMin;
+  for (int i = theBegin + 1; i < theEnd; i++)
+  {
+    double theValue = iPlotRangeSample(inData, inStride, i);
+    if (theValue > theMax)
+      theMax = theValue;
+    if (theValue < theMin)
+      theMin = theValue;
+  }
+
+  mLevel[0][2 * inBlock] = theMin;
+  mLevel[0][2 * inBlock + 1] = theMax;
+}
+
+void iupPlotRangePyramid::UpdateNode(int inLevel, int inNode, int inChildCount)
 {
-  int theCount = iupArrayCount(mArray);
-  if (theCount > 0)
+  double* theChild = mLevel[inLevel - 1] + 4 * inNode;
+  double* theNode = mLevel[inLevel] + 2 * inNode;
+
+  theNode[0] = theChild[0];
+  theNode[1] = theChild[1];
+
+  if (2 * inNode + 1 < inChildCount)  // second child exists
   {
-    double* theData = (double*)iupArrayGetData(mArray);
-    outMax = outMin = theData[0];
-    for (int i = 1; i < theCount; i++)
+    if (theChild[2] < theNode[0])
+      theNode[0] = theChild[2];
+    if (theChild[3] > theNode[1])
+      theNode[1] = theChild[3];
+  }
+}
+
+void iupPlotRangePyramid::Update(const double* inData, int inStride, int inCount)
+{
+  int theFirstNode = mValidCount / IUP_PLOT_RANGE_BLOCK;
+  int theNodeCount = (inCount + IUP_PLOT_RANGE_BLOCK - 1) / IUP_PLOT_RANGE_BLOCK;
+  int theChildCount = 0;
+
+  for (int level = 0; level < IUP_PLOT_RANGE_MAXLEVEL; level++)
+  {
+    if (level == mLevelCount)
     {
-      if (theData[i] > outMax)
-        outMax = theData[i];
-      if (theData[i] < outMin)
-        outMin = theData[i];
+      mLevel[level] = NULL;
+      mLevelMax[level] = 0;
+      mLevelCount++;
     }
+
+    if (theNodeCount > mLevelMax[level])
+    {
+      mLevelMax[level] = theNodeCount + theNodeCount / 2;
+      mLevel[level] = (double*)realloc(mLevel[level], 2 * mLevelMax[level] * sizeof(double));
+    }
+
+    for (int node = theFirstNode; node < theNodeCount; node++)
+    {
+      if (level == 0)
+        UpdateBlock(inData, inStride, inCount, node);
+      else
+        UpdateNode(level, node, theChildCount);
+    }
+
+    if (theNodeCount <= 1)
+      break;
+
+    theChildCount = theNodeCount;
+    theNodeCount = (theNodeCount + 1) / 2;
+    theFirstNode /= 2;
+  }
+
+  mValidCount = inCount;
+  mUpdateCount = inCount;
+}
+
+void iupPlotRangePyramid::UpdateSample(const double* inData, int inStride, int inCount, int inSampleIndex)
+{
+  if (inSampleIndex >= mValidCount)
+    return;  // will be updated later
+
+  if (mValidCount < inCount || mUpdateCount != inCount)
+    Update(inData, inStride, inCount);  // levels must have the current size
+
+  int theNode = inSampleIndex / IUP_PLOT_RANGE_BLOCK;
+  int theNodeCount = (inCount + IUP_PLOT_RANGE_BLOCK - 1) / IUP_PLOT_RANGE_BLOCK;
+
+  UpdateBlock(inData, inStride, inCount, theNode);
+
+  for (int level = 1; level < mLevelCount && theNodeCount > 1; level++)
+  {
+    int theChildCount = theNodeCount;
+    theNodeCount = (theNodeCount + 1) / 2;
+    theNode /= 2;
+    UpdateNode(level, theNode, theChildCount);
+  }
+}
+
+static inline void iPlotRangeAdd(double inMin, double inMax, double &ioMin, double &ioMax, bool &ioFirst)
+{
+  if (ioFirst)
+  {
+    ioMin = inMin;
+    ioMax = inMax;
+    ioFirst = false;
+  }
+  else
+  {
+    if (inMin < ioMin)
+      ioMin = inMin;
+    if (inMax > ioMax)
+      ioMax = inMax;
+  }
+}
+
+bool iupPlotRangePyramid::GetRange(const double* inData, int inStride, int inCount, int inBegin, int inEnd, double &outMin, double &outMax)
+{
+  if (inBegin < 0) inBegin = 0;
+  if (inEnd > inCount - 1) inEnd = inCount - 1;
+  if (inBegin > inEnd)
+    return false;
+
+  if (mValidCount < inCount || mUpdateCount != inCount)
+    Update(inData, inStride, inCount);
+
+  bool theFirst = true;
+
+  // blocks completely inside the interval
+  int theFirstBlock = (inBegin + IUP_PLOT_RANGE_BLOCK - 1) / IUP_PLOT_RANGE_BLOCK;
+  int theLastBlock = (inEnd + 1) / IUP_PLOT_RANGE_BLOCK - 1;
+  if (inEnd == inCount - 1)
+    theLastBlock = (inCount - 1) / IUP_PLOT_RANGE_BLOCK;  // last block can be incomplete
+
+  if (theFirstBlock > theLastBlock)
+  {
+    for (int i = inBegin; i <= inEnd; i++)
+      iPlotRangeAdd(iPlotRangeSample(inData, inStride, i), iPlotRangeSample(inData, inStride, i), outMin, outMax, theFirst);
     return true;
   }
 
-  return false;
+  for (int i = inBegin; i < theFirstBlock * IUP_PLOT_RANGE_BLOCK; i++)
+    iPlotRangeAdd(iPlotRangeSample(inData, inStride, i), iPlotRangeSample(inData, inStride, i), outMin, outMax, theFirst);
+
+  // from the bottom to the top, using the largest nodes inside the interval
+  int theLeft = theFirstBlock, theRight = theLastBlock;
+  for (int level = 0; level < mLevelCount && theLeft <= theRight; level++)
+  {
+    const double* theLevel = mLevel[level];
+
+    if (theLeft & 1)
+    {
+      iPlotRangeAdd(theLevel[2 * theLeft], theLevel[2 * theLeft + 1], outMin, outMax, theFirst);
+      theLeft++;
+    }
+    if (!(theRight & 1) && theLeft <= theRight)
+    {
+      iPlotRangeAdd(theLevel[2 * theRight], theLevel[2 * theRight + 1], outMin, outMax, theFirst);
+      theRight--;
+    }
+
+    theLeft /= 2;
+    theRight = (theRight - 1) / 2;
+  }
+
+  for (int i = (theLastBlock + 1) * IUP_PLOT_RANGE_BLOCK; i <= inEnd; i++)
+    iPlotRangeAdd(iPlotRangeSample(inData, inStride, i), iPlotRangeSample(inData, inStride, i), outMin, outMax, theFirst);
+
+  return true;
+}
+
+iupPlotSampleStore* iupPlotSampleStoreCreate(int inMax, int inSampleSize)
+{
+  iupPlotSampleStore* theStore = (iupPlotSampleStore*)malloc(sizeof(iupPlotSampleStore));
+  theStore->mRefCount = 1;
+  theStore->mMax = inMax;
+  theStore->mData = (char*)malloc((size_t)inMax * inSampleSize);
+  return theStore;
+}
+
+void iupPlotSampleStoreAddRef(iupPlotSampleStore* inStore)
+{
+#ifdef _MSC_VER
+  _InterlockedIncrement(&inStore->mRefCount);
+#else
+  __atomic_add_fetch(&inStore->mRefCount, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+void iupPlotSampleStoreRelease(iupPlotSampleStore* inStore)
+{
+#ifdef _MSC_VER
+  long theRefCount = _InterlockedDecrement(&inStore->mRefCount);
+#else
+  long theRefCount = __atomic_sub_fetch(&inStore->mRefCount, 1, __ATOMIC_ACQ_REL);
+#endif
+  if (theRefCount == 0)
+  {
+    free(inStore->mData);
+    free(inStore);
+  }
+}
+
+bool iupPlotSampleStoreIsShared(iupPlotSampleStore* inStore)
+{
+  // when not shared, the render thread has finished reading it
+#ifdef _MSC_VER
+  return _InterlockedCompareExchange(&inStore->mRefCount, 0, 0) > 1;
+#else
+  return __atomic_load_n(&inStore->mRefCount, __ATOMIC_ACQUIRE) > 1;
+#endif
+}
+
+void iupPlotDataBase::Unshare(int inMax)
+{
+  // copy the samples to a new memory, the snapshots keep the old one
+  iupPlotSampleStore* theStore = iupPlotSampleStoreCreate(inMax, mSampleSize);
+  memcpy(theStore->mData, mStore->mData + (size_t)mOffset * mSampleSize, (size_t)mCount * mSampleSize);
+  iupPlotSampleStoreRelease(mStore);
+  mStore = theStore;
+
+  if (mOffset)
+  {
+    mOffset = 0;
+    SamplesChanged(0);
+  }
+
+  UpdateData();
+}
+
+void iupPlotDataBase::CheckStore(bool inWrite, int inAddCount)
+{
+  int theNeed = mOffset + mCount + inAddCount;
+
+  if (iupPlotSampleStoreIsShared(mStore))
+  {
+    // appending after the last sample does not change the samples of the snapshots
+    if (inWrite || theNeed > mStore->mMax)
+    {
+      int theMax = mCount + inAddCount;
+      Unshare(theMax + theMax / 2 + 20);
+    }
+  }
+  else if (theNeed > mStore->mMax)
+  {
+    int theMax = mStore->mMax + mStore->mMax / 2;
+    if (theMax < theNeed)
+      theMax = theNeed;
+
+    mStore->mData = (char*)realloc(mStore->mData, (size_t)theMax * mSampleSize);
+    mStore->mMax = theMax;
+    UpdateData();
+  }
+}
+
+void iupPlotDataBase::InsertSpace(int inSampleIndex)
+{
+  CheckStore(true, 1);
+
+  char* theData = mStore->mData + (size_t)(mOffset + inSampleIndex) * mSampleSize;
+  memmove(theData + mSampleSize, theData, (size_t)(mCount - inSampleIndex) * mSampleSize);
+}
+
+void iupPlotDataBase::RemoveSpace(int inSampleIndex)
+{
+  if (inSampleIndex >= mCount)
+    return;
+
+  CheckStore(true, 0);
+
+  char* theData = mStore->mData + (size_t)(mOffset + inSampleIndex) * mSampleSize;
+  memmove(theData, theData + mSampleSize, (size_t)(mCount - inSampleIndex - 1) * mSampleSize);
+  mCount--;
+  SamplesChanged(mOffset + inSampleIndex);
+}
+
+void iupPlotDataBase::Compact()
+{
+  if (iupPlotSampleStoreIsShared(mStore))
+  {
+    Unshare(mStore->mMax);
+    return;
+  }
+
+  memmove(mStore->mData, mStore->mData + (size_t)mOffset * mSampleSize, (size_t)mCount * mSampleSize);
+  mOffset = 0;
+  SamplesChanged(0);
+  UpdateData();
+}
+
+void iupPlotDataBase::ShareSamples(const iupPlotDataBase* inData)
+{
+  iupPlotSampleStoreAddRef(inData->mStore);
+  iupPlotSampleStoreRelease(mStore);
+  mStore = inData->mStore;
+  mOffset = inData->mOffset;
+  mCount = inData->mCount;
+  SamplesChanged(0);
+  UpdateData();
+}
+
+bool iupPlotDataReal::CalculateRange(int inBegin, int inEnd, double &outMin, double &outMax) const
+{
+  if (inBegin < 0) inBegin = 0;
+  if (inEnd > mCount - 1) inEnd = mCount - 1;
+  if (inBegin > inEnd)
+    return false;
+
+  // the pyramid uses the positions in the array
+  return mRange.GetRange(mData - mOffset, sizeof(double), mOffset + mCount, mOffset + inBegin, mOffset + inEnd, outMin, outMax);
+}
+
+bool iupPlotDataReal::CalculateRange(double &outMin, double &outMax) const
+{
+  return CalculateRange(0, mCount - 1, outMin, outMax);
+}
+
+bool iupPlotDataBuffer::CalculateRange(double &outMin, double &outMax) const
+{
+  if (!mBuffer)
+  {
+    if (mCount == 0)
+      return false;
+
+    outMin = 0;
+    outMax = mCount - 1;
+    return true;
+  }
+
+  return mRange.GetRange(mBuffer, mStride, mCount, 0, mCount - 1, outMin, outMax);
 }
 
 iupPlotDataString::~iupPlotDataString()
@@ -163,16 +495,351 @@ bool iupPlotDataBool::CalculateRange(double &outMin, double &outMax) const
 }
 
 
+#define IUP_PLOT_INDEX_MAXSIZE 1024
+#define IUP_PLOT_INDEX_SEGMENT_MAXCELLS 16
+#define IUP_PLOT_INDEX_MINAPPEND 256  // appended samples always accepted without a rebuild
+
+static inline bool iPlotIsFinite(double inValue)
+{
+  return inValue - inValue == 0;  // false for infinite and NaN
+}
+
+static inline int iPlotGetIndexCell(double inValue, double inMin, double inMax, int inSize)
+{
+  double theCell = 0;
+  if (inMax > inMin)
+    theCell = ((inValue - inMin) * inSize) / (inMax - inMin);
+  if (!(theCell > 0))  // also NaN
+    return 0;
+  if (theCell > inSize - 1)
+    return inSize - 1;
+  return (int)theCell;
+}
+
+static int iPlotGetIndexSize(double inRange, double inCellRange, int inMaxSize)
+{
+  if (inRange <= 0 || inMaxSize <= 1)
+    return 1;
+
+  double theSize = inRange / inCellRange;
+  if (!(theSize < inMaxSize))  // also NaN
+    return inMaxSize;
+  if (theSize < 1)
+    return 1;
+  return (int)theSize;
+}
+
+static void iPlotAppendIndex(Iarray* ioIndex, const int* inIndex, int inCount)
+{
+  if (inCount > 0)
+  {
+    int* theIndex = (int*)iupArrayAdd(ioIndex, inCount);
+    memcpy(theIndex + iupArrayCount(ioIndex) - inCount, inIndex, inCount * sizeof(int));
+  }
+}
+
+iupPlotSampleIndex::iupPlotSampleIndex()
+  : mVersion(-1), mSegmentVersion(-1), mBuildFirstSample(0), mBuildCount(0), mRemovedCount(0), mCount(0), 
+    mMinX(0), mMaxX(0), mMinY(0), mMaxY(0),
+    mSizeX(0), mSizeY(0), mCellStart(NULL), mCellSample(NULL),
+    mSegmentSizeX(0), mSegmentSizeY(0), mSegmentCellStart(NULL), mSegmentCellSample(NULL), mLongSegment(NULL), mLongSegmentCount(0)
+{
+}
+
+iupPlotSampleIndex::~iupPlotSampleIndex()
+{
+  free(mCellStart);
+  free(mCellSample);
+  free(mSegmentCellStart);
+  free(mSegmentCellSample);
+  free(mLongSegment);
+}
+
+void iupPlotSampleIndex::Update(const iupPlotDataBase* inDataX, const iupPlotDataBase* inDataY, int inVersion, int inFirstSample)
+{
+  int theCount = inDataX->GetCount();
+
+  if (mVersion == inVersion && inFirstSample >= mBuildFirstSample)
+  {
+    int theRemoved = inFirstSample - mBuildFirstSample;
+    int theIndexed = mBuildCount - theRemoved;  // indexed samples that were not removed
+    int theAppended = theCount - theIndexed;
+
+    // appended samples are returned one by one, and removed samples are skipped one by one,
+    // so rebuild when they are too many
+    if (theIndexed >= 0 && theAppended >= 0 &&
+        theAppended <= IUP_PLOT_INDEX_MINAPPEND + theIndexed / 16 && 
+        theRemoved <= mBuildCount / 2)
+    {
+      mRemovedCount = theRemoved;
+      mCount = theCount;
+      return;
+    }
+  }
+
+  mVersion = inVersion;
+  Build(inDataX, inDataY, inFirstSample);
+}
+
+void iupPlotSampleIndex::Build(const iupPlotDataBase* inDataX, const iupPlotDataBase* inDataY, int inFirstSample)
+{
+  int theCount = inDataX->GetCount();
+  bool theFirstX = true, theFirstY = true;
+
+  mSegmentVersion = -1;
+  mBuildFirstSample = inFirstSample;
+  mBuildCount = theCount;
+  mRemovedCount = 0;
+  mCount = theCount;
+
+  // grid limits from the finite values only, the others go to the border cells
+  for (int i = 0; i < theCount; i++)
+  {
+    double theX = inDataX->GetSample(i);
+    double theY = inDataY->GetSample(i);
+    if (iPlotIsFinite(theX))
+      iPlotRangeAdd(theX, theX, mMinX, mMaxX, theFirstX);
+    if (iPlotIsFinite(theY))
+      iPlotRangeAdd(theY, theY, mMinY, mMaxY, theFirstY);
+  }
+
+  if (theFirstX) mMinX = mMaxX = 0;
+  if (theFirstY) mMinY = mMaxY = 0;
+
+  // around 4 samples per cell
+  mSizeX = (int)sqrt(theCount / 4.0);
+  if (mSizeX < 1) mSizeX = 1;
+  if (mSizeX > IUP_PLOT_INDEX_MAXSIZE) mSizeX = IUP_PLOT_INDEX_MAXSIZE;
+  mSizeY = mSizeX;
+
+  int theCellCount = mSizeX * mSizeY;
+  mCellStart = (int*)realloc(mCellStart, (theCellCount + 1) * sizeof(int));
+  mCellSample = (int*)realloc(mCellSample, (theCount > 0 ? theCount : 1) * sizeof(int));
+  memset(mCellStart, 0, (theCellCount + 1) * sizeof(int));
+
+  for (int i = 0; i < theCount; i++)
+  {
+    int theCell = iPlotGetIndexCell(inDataY->GetSample(i), mMinY, mMaxY, mSizeY) * mSizeX + 
+                  iPlotGetIndexCell(inDataX->GetSample(i), mMinX, mMaxX, mSizeX);
+    mCellStart[theCell + 1]++;
+  }
+
+  for (int c = 0; c < theCellCount; c++)
+    mCellStart[c + 1] += mCellStart[c];
+
+  // samples keep their order inside each cell
+  int* thePos = (int*)malloc(theCellCount * sizeof(int));
+  memcpy(thePos, mCellStart, theCellCount * sizeof(int));
+
+  for (int i = 0; i < theCount; i++)
+  {
+    int theCell = iPlotGetIndexCell(inDataY->GetSample(i), mMinY, mMaxY, mSizeY) * mSizeX + 
+                  iPlotGetIndexCell(inDataX->GetSample(i), mMinX, mMaxX, mSizeX);
+    mCellSample[thePos[theCell]++] = i;
+  }
+
+  free(thePos);
+}
+
+void iupPlotSampleIndex::UpdateSegments(const iupPlotDataBase* inDataX, const iupPlotDataBase* inDataY, int inVersion, int inFirstSample)
+{
+  Update(inDataX, inDataY, inVersion, inFirstSample);
+
+  if (mSegmentVersion == inVersion)
+    return;
+
+  // the segments are indexed with the same samples of the sample grid
+  if (mRemovedCount != 0 || mCount != mBuildCount)
+    Build(inDataX, inDataY, inFirstSample);
+
+  mSegmentVersion = inVersion;
+
+  int theCount = inDataX->GetCount();
+
+  // cells about twice the average size of the segments, so most segments are in a few cells
+  double theSumDX = 0, theSumDY = 0;
+  int theSumCount = 0;
+  for (int i = 0; i < theCount - 1; i++)
+  {
+    double theDX = fabs(inDataX->GetSample(i + 1) - inDataX->GetSample(i));
+    double theDY = fabs(inDataY->GetSample(i + 1) - inDataY->GetSample(i));
+    if (iPlotIsFinite(theDX) && iPlotIsFinite(theDY))
+    {
+      theSumDX += theDX;
+      theSumDY += theDY;
+      theSumCount++;
+    }
+  }
+
+  int theMaxSize = (int)sqrt((double)theCount);
+  if (theMaxSize > IUP_PLOT_INDEX_MAXSIZE) theMaxSize = IUP_PLOT_INDEX_MAXSIZE;
+  mSegmentSizeX = mSegmentSizeY = 1;
+  if (theSumCount > 0)
+  {
+    mSegmentSizeX = iPlotGetIndexSize(mMaxX - mMinX, 2 * theSumDX / theSumCount, theMaxSize);
+    mSegmentSizeY = iPlotGetIndexSize(mMaxY - mMinY, 2 * theSumDY / theSumCount, theMaxSize);
+  }
+
+  int theCellCount = mSegmentSizeX * mSegmentSizeY;
+  mSegmentCellStart = (int*)realloc(mSegmentCellStart, (theCellCount + 1) * sizeof(int));
+  memset(mSegmentCellStart, 0, (theCellCount + 1) * sizeof(int));
+  mLongSegmentCount = 0;
+
+  // first pass counts, second pass stores
+  int* thePos = NULL;
+  for (int pass = 0; pass < 2; pass++)
+  {
+    for (int i = 0; i < theCount - 1; i++)
+    {
+      double theX1 = inDataX->GetSample(i);
+      double theY1 = inDataY->GetSample(i);
+      double theX2 = inDataX->GetSample(i + 1);
+      double theY2 = inDataY->GetSample(i + 1);
+
+      iPlotCheckMinMax(theX1, theX2);
+      iPlotCheckMinMax(theY1, theY2);
+
+      int theCellX1 = iPlotGetIndexCell(theX1, mMinX, mMaxX, mSegmentSizeX);
+      int theCellX2 = iPlotGetIndexCell(theX2, mMinX, mMaxX, mSegmentSizeX);
+      int theCellY1 = iPlotGetIndexCell(theY1, mMinY, mMaxY, mSegmentSizeY);
+      int theCellY2 = iPlotGetIndexCell(theY2, mMinY, mMaxY, mSegmentSizeY);
+
+      if (!iPlotIsFinite(theX1) || !iPlotIsFinite(theY1) || !iPlotIsFinite(theX2) || !iPlotIsFinite(theY2) ||
+          (theCellX2 - theCellX1 + 1) * (theCellY2 - theCellY1 + 1) > IUP_PLOT_INDEX_SEGMENT_MAXCELLS)
+      {
+        if (pass == 1)
+          mLongSegment[mLongSegmentCount] = i;
+        mLongSegmentCount++;
+        continue;
+      }
+
+      for (int cy = theCellY1; cy <= theCellY2; cy++)
+      {
+        for (int cx = theCellX1; cx <= theCellX2; cx++)
+        {
+          if (pass == 0)
+            mSegmentCellStart[cy * mSegmentSizeX + cx + 1]++;
+          else
+            mSegmentCellSample[thePos[cy * mSegmentSizeX + cx]++] = i;
+        }
+      }
+    }
+
+    if (pass == 0)
+    {
+      for (int c = 0; c < theCellCount; c++)
+        mSegmentCellStart[c + 1] += mSegmentCellStart[c];
+
+      int theTotal = mSegmentCellStart[theCellCount];
+      mSegmentCellSample = (int*)realloc(mSegmentCellSample, (theTotal > 0 ? theTotal : 1) * sizeof(int));
+      mLongSegment = (int*)realloc(mLongSegment, (mLongSegmentCount > 0 ? mLongSegmentCount : 1) * sizeof(int));
+      mLongSegmentCount = 0;
+
+      thePos = (int*)malloc(theCellCount * sizeof(int));
+      memcpy(thePos, mSegmentCellStart, theCellCount * sizeof(int));
+    }
+  }
+
+  free(thePos);
+}
+
+void iupPlotSampleIndex::AppendIndex(Iarray* ioIndex, const int* inIndex, int inCount) const
+{
+  if (mRemovedCount == 0)
+  {
+    iPlotAppendIndex(ioIndex, inIndex, inCount);
+    return;
+  }
+
+  // indices are from the build, skip the removed samples
+  for (int n = 0; n < inCount; n++)
+  {
+    int i = inIndex[n] - mRemovedCount;
+    if (i >= 0)
+    {
+      int* theIndex = (int*)iupArrayInc(ioIndex);
+      theIndex[iupArrayCount(ioIndex) - 1] = i;
+    }
+  }
+}
+
+void iupPlotSampleIndex::FindSamples(double inMinX, double inMaxX, double inMinY, double inMaxY, Iarray* ioIndex) const
+{
+  if (mSizeX == 0)
+    return;
+
+  int theCellX1 = iPlotGetIndexCell(inMinX, mMinX, mMaxX, mSizeX);
+  int theCellX2 = iPlotGetIndexCell(inMaxX, mMinX, mMaxX, mSizeX);
+  int theCellY1 = iPlotGetIndexCell(inMinY, mMinY, mMaxY, mSizeY);
+  int theCellY2 = iPlotGetIndexCell(inMaxY, mMinY, mMaxY, mSizeY);
+
+  // cells of the same row are contiguous
+  for (int cy = theCellY1; cy <= theCellY2; cy++)
+  {
+    int theBegin = mCellStart[cy * mSizeX + theCellX1];
+    int theEnd = mCellStart[cy * mSizeX + theCellX2 + 1];
+    AppendIndex(ioIndex, mCellSample + theBegin, theEnd - theBegin);
+  }
+
+  // samples appended after the build
+  for (int i = mBuildCount - mRemovedCount; i < mCount; i++)
+  {
+    int* theIndex = (int*)iupArrayInc(ioIndex);
+    theIndex[iupArrayCount(ioIndex) - 1] = i;
+  }
+}
+
+void iupPlotSampleIndex::FindSegments(double inMinX, double inMaxX, double inMinY, double inMaxY, Iarray* ioIndex) const
+{
+  if (mSegmentSizeX == 0)
+    return;
+
+  int theCellX1 = iPlotGetIndexCell(inMinX, mMinX, mMaxX, mSegmentSizeX);
+  int theCellX2 = iPlotGetIndexCell(inMaxX, mMinX, mMaxX, mSegmentSizeX);
+  int theCellY1 = iPlotGetIndexCell(inMinY, mMinY, mMaxY, mSegmentSizeY);
+  int theCellY2 = iPlotGetIndexCell(inMaxY, mMinY, mMaxY, mSegmentSizeY);
+
+  for (int cy = theCellY1; cy <= theCellY2; cy++)
+  {
+    int theBegin = mSegmentCellStart[cy * mSegmentSizeX + theCellX1];
+    int theEnd = mSegmentCellStart[cy * mSegmentSizeX + theCellX2 + 1];
+    AppendIndex(ioIndex, mSegmentCellSample + theBegin, theEnd - theBegin);
+  }
+
+  AppendIndex(ioIndex, mLongSegment, mLongSegmentCount);
+
+  // segments that end in a sample appended after the build
+  int i = mBuildCount - mRemovedCount - 1;
+  if (i < 0) i = 0;
+  for (; i < mCount - 1; i++)
+  {
+    int* theIndex = (int*)iupArrayInc(ioIndex);
+    theIndex[iupArrayCount(ioIndex) - 1] = i;
+  }
+}
+
+
 /************************************************************************************************/
 
 
+static int iPlotNewDrawVersion(void)
+{
+  // datasets are changed only in the UI thread
+  static int draw_version = 0;
+  draw_version++;
+  return draw_version;
+}
+
 iupPlotDataSet::iupPlotDataSet(bool strXdata)
 : mColor(CD_BLACK), mLineStyle(CD_CONTINUOUS), mLineWidth(1), mAreaTransparency(255), mMarkStyle(CD_X), mMarkSize(7),
   mMultibarIndex(-1), mMultibarCount(0), mBarOutlineColor(0), mBarShowOutline(false), mBarSpacingPercent(10),
   mPieStartAngle(0), mPieRadius(0.95), mPieContour(false), mPieHole(0), mPieSliceLabelPos(0.95),
   mHighlightedSample(-1), mHighlightedCurve(false), mBarMulticolor(false), mOrderedX(false),
-  mPieSliceLabel(IUP_PLOT_NONE), mMode(IUP_PLOT_LINE), mName(NULL), mHasSelected(false), mUserData(0)
+  mPieSliceLabel(IUP_PLOT_NONE), mMode(IUP_PLOT_LINE), mName(NULL), mHasSelected(false), mMaybeSelected(false), mUserData(0),
+  mDecimate(IUP_PLOT_DECIMATE_NONE), mCapacity(0), mDataVersion(0), mIndexVersion(0), mFirstSample(0), mDecimateIndex(NULL), mDecimateVersion(-1)
 {
+  mDrawVersion = iPlotNewDrawVersion();
+
   if (strXdata)
     mDataX = (iupPlotDataBase*)(new iupPlotDataString());
   else
@@ -196,6 +863,8 @@ iupPlotDataSet::~iupPlotDataSet()
     delete mSegment;
   if (mExtra)
     delete mExtra;
+  if (mDecimateIndex)
+    iupArrayDestroy(mDecimateIndex);
 }
 
 bool iupPlotDataSet::FindSample(iupPlotTrafoBase *inTrafoX, iupPlotTrafoBase *inTrafoY, double inScreenX, double inScreenY, double inScreenTolerance,
@@ -216,44 +885,138 @@ bool iupPlotDataSet::FindSample(iupPlotTrafoBase *inTrafoX, iupPlotTrafoBase *in
   }
 }
 
-bool iupPlotDataSet::FindPointSample(iupPlotTrafoBase *inTrafoX, iupPlotTrafoBase *inTrafoY, double inScreenX, double inScreenY, double inScreenTolerance,
-                                     int &outSampleIndex, double &outX, double &outY) const
+static void iPlotTransformBackRange(const iupPlotTrafoBase *inTrafo, double inScreenMin, double inScreenMax, double &outMin, double &outMax)
 {
-  double theX, theY, theScreenX, theScreenY;
-  double thePrevScreenX = 0;
+  outMin = inTrafo->TransformBack(inScreenMin);
+  outMax = inTrafo->TransformBack(inScreenMax);
+  iPlotCheckMinMax(outMin, outMax);
+
+  // a little larger, to include samples that are at the limit after the rounding errors
+  double theMargin = (outMax - outMin) * 1e-6 + (fabs(outMin) + fabs(outMax)) * 1e-12;
+  outMin -= theMargin;
+  outMax += theMargin;
+
+  // when the transformation clips the values (log scale), all values beyond the limit are at the same position
+  double theScreenLow = inTrafo->Transform(-DBL_MAX);
+  if (theScreenLow >= inScreenMin && theScreenLow <= inScreenMax)
+    outMin = -HUGE_VAL;
+  double theScreenHigh = inTrafo->Transform(DBL_MAX);
+  if (theScreenHigh >= inScreenMin && theScreenHigh <= inScreenMax)
+    outMax = HUGE_VAL;
+}
+
+static int iPlotFindFirstX(const iupPlotDataBase* inDataX, double inX)
+{
+  // first sample with X >= inX, X values are ordered
+  int theBegin = 0, theEnd = inDataX->GetCount();
+  while (theBegin < theEnd)
+  {
+    int theMiddle = (theBegin + theEnd) / 2;
+    if (inDataX->GetSample(theMiddle) < inX)
+      theBegin = theMiddle + 1;
+    else
+      theEnd = theMiddle;
+  }
+  return theBegin;
+}
+
+static int iPlotCompareIndex(const void* inA, const void* inB)
+{
+  int theA = *(const int*)inA;
+  int theB = *(const int*)inB;
+  return (theA > theB) - (theA < theB);
+}
+
+void iupPlotDataSet::FindSampleCandidates(double inMinX, double inMaxX, double inMinY, double inMaxY, Iarray* ioIndex) const
+{
+  if (mOrderedX)
+  {
+    int theCount = mDataX->GetCount();
+    for (int i = iPlotFindFirstX(mDataX, inMinX); i < theCount; i++)
+    {
+      if (mDataX->GetSample(i) > inMaxX)
+        break;
+
+      int* theIndex = (int*)iupArrayInc(ioIndex);
+      theIndex[iupArrayCount(ioIndex) - 1] = i;
+    }
+  }
+  else
+  {
+    mSampleIndex.Update(mDataX, mDataY, mIndexVersion, mFirstSample);
+    mSampleIndex.FindSamples(inMinX, inMaxX, inMinY, inMaxY, ioIndex);
+  }
+}
 
+void iupPlotDataSet::FindSegmentCandidates(double inMinX, double inMaxX, double inMinY, double inMaxY, Iarray* ioIndex) const
+{
   int theCount = mDataX->GetCount();
 
-  for (int i = 0; i < theCount; i++)
+  if (mOrderedX)
   {
-    theX = mDataX->GetSample(i);
-    theY = mDataY->GetSample(i);
-    theScreenX = inTrafoX->Transform(theX);
-    theScreenY = inTrafoY->Transform(theY);
+    // segments that start before the box and end inside or after it
+    int i = iPlotFindFirstX(mDataX, inMinX) - 1;
+    if (i < 0) i = 0;
 
-    // optimization when X values are ordered
-    if (mOrderedX && i > 0 && (inScreenX < thePrevScreenX - inScreenTolerance || inScreenX > theScreenX + inScreenTolerance))
+    for (; i < theCount - 1; i++)
     {
-      if (inScreenX < thePrevScreenX - inScreenTolerance)
+      if (mDataX->GetSample(i) > inMaxX)
         break;
 
-      thePrevScreenX = theScreenX;
-      continue;
+      int* theIndex = (int*)iupArrayInc(ioIndex);
+      theIndex[iupArrayCount(ioIndex) - 1] = i;
     }
+  }
+  else
+  {
+    mSampleIndex.UpdateSegments(mDataX, mDataY, mIndexVersion, mFirstSample);
+    mSampleIndex.FindSegments(inMinX, inMaxX, inMinY, inMaxY, ioIndex);
+  }
+}
+
+bool iupPlotDataSet::FindPointSample(iupPlotTrafoBase *inTrafoX, iupPlotTrafoBase *inTrafoY, double inScreenX, double inScreenY, double inScreenTolerance,
+                                     int &outSampleIndex, double &outX, double &outY) const
+{
+  double theMinX, theMaxX, theMinY, theMaxY;
+  iPlotTransformBackRange(inTrafoX, inScreenX - inScreenTolerance, inScreenX + inScreenTolerance, theMinX, theMaxX);
+  iPlotTransformBackRange(inTrafoY, inScreenY - inScreenTolerance, inScreenY + inScreenTolerance, theMinY, theMaxY);
+
+  Iarray* theIndexArray = iupArrayCreate(64, sizeof(int));
+  iupArraySetZeroFill(theIndexArray, 0);
+  FindSampleCandidates(theMinX, theMaxX, theMinY, theMaxY, theIndexArray);
+
+  int theIndexCount = iupArrayCount(theIndexArray);
+  int* theIndex = (int*)iupArrayGetData(theIndexArray);
+  int theFound = -1;
+
+  // the candidates are not in order, returns the first sample
+  for (int n = 0; n < theIndexCount; n++)
+  {
+    int i = theIndex[n];
+    if (theFound != -1 && i > theFound)
+      continue;
+
+    double theScreenX = inTrafoX->Transform(mDataX->GetSample(i));
+    double theScreenY = inTrafoY->Transform(mDataY->GetSample(i));
 
     if (fabs(theScreenX - inScreenX) < inScreenTolerance &&
         fabs(theScreenY - inScreenY) < inScreenTolerance)
     {
-      outX = theX;
-      outY = theY;
-      outSampleIndex = i;
-      return true;
+      theFound = i;
+      if (mOrderedX)
+        break;
     }
-
-    thePrevScreenX = theScreenX;
   }
 
-  return false;
+  iupArrayDestroy(theIndexArray);
+
+  if (theFound == -1)
+    return false;
+
+  outX = mDataX->GetSample(theFound);
+  outY = mDataY->GetSample(theFound);
+  outSampleIndex = theFound;
+  return true;
 }
 
 bool iupPlotDataSet::FindMultipleBarSample(iupPlotTrafoBase *inTrafoX, iupPlotTrafoBase *inTrafoY, double inScreenX, double inScreenY,
@@ -474,44 +1237,31 @@ bool iupPlotDataSet::FindSegment(iupPlotTrafoBase *mTrafoX, iupPlotTrafoBase *mT
 
   double lowestDist = 0;
   int found_Id = -1;
-  double found_x1 = 0, found_y1 = 0, found_x2 = 0, found_y2 = 0;
   bool found = false;
 
-  double theX1 = mDataX->GetSample(0);
-  double theY1 = mDataY->GetSample(0);
-  double theScreenX1 = mTrafoX->Transform(theX1);
-  double theScreenY1 = mTrafoY->Transform(theY1);
+  double theMinX, theMaxX, theMinY, theMaxY;
+  iPlotTransformBackRange(mTrafoX, inScreenX - inScreenTolerance, inScreenX + inScreenTolerance, theMinX, theMaxX);
+  iPlotTransformBackRange(mTrafoY, inScreenY - inScreenTolerance, inScreenY + inScreenTolerance, theMinY, theMaxY);
 
-  int theCount = mDataX->GetCount();
-  for (int i = 0; i < theCount - 1; i++)
-  {
-    double theX2 = mDataX->GetSample(i + 1);
-    double theY2 = mDataY->GetSample(i + 1);
-    double theScreenX2 = mTrafoX->Transform(theX2);
-    double theScreenY2 = mTrafoY->Transform(theY2);
+  Iarray* theIndexArray = iupArrayCreate(64, sizeof(int));
+  iupArraySetZeroFill(theIndexArray, 0);
+  FindSegmentCandidates(theMinX, theMaxX, theMinY, theMaxY, theIndexArray);
 
-    // optimization when X values are ordered
-    if (mOrderedX && (inScreenX < theScreenX1 || inScreenX > theScreenX2))
-    {
-      if (inScreenX < theScreenX1)
-        break;
+  int theIndexCount = iupArrayCount(theIndexArray);
+  int* theIndex = (int*)iupArrayGetData(theIndexArray);
 
-      theX1 = theX2;
-      theY1 = theY2;
-      theScreenX1 = theScreenX2;
-      theScreenY1 = theScreenY2;
-      continue;
-    }
+  for (int n = 0; n < theIndexCount; n++)
+  {
+    int i = theIndex[n];
+
+    double theScreenX1 = mTrafoX->Transform(mDataX->GetSample(i));
+    double theScreenY1 = mTrafoY->Transform(mDataY->GetSample(i));
+    double theScreenX2 = mTrafoX->Transform(mDataX->GetSample(i + 1));
+    double theScreenY2 = mTrafoY->Transform(mDataY->GetSample(i + 1));
 
     // inX,inY must be inside box theScreenX1,theScreenY1 - theScreenX2,theScreenY2
     if (!iPlotCheckInsideBoxTolerance(theScreenX1, theScreenY1, theScreenX2, theScreenY2, inScreenX, inScreenY, inScreenTolerance))
-    {
-      theX1 = theX2;
-      theY1 = theY2;
-      theScreenX1 = theScreenX2;
-      theScreenY1 = theScreenY2;
       continue;
-    }
 
     double v1x = theScreenX2 - theScreenX1;
     double v1y = theScreenY2 - theScreenY1;
@@ -524,55 +1274,37 @@ bool iupPlotDataSet::FindSegment(iupPlotTrafoBase *mTrafoX, iupPlotTrafoBase *mT
     double prod = v1x*v2x + v1y*v2y;
 
     if (v1 == 0.)
-    {
-      theX1 = theX2;
-      theY1 = theY2;
-      theScreenX1 = theScreenX2;
-      theScreenY1 = theScreenY2;
       continue;
-    }
 
     double p1 = prod / v1;
 
-    if (p1<0. || p1>1.)
-    {
-      theX1 = theX2;
-      theY1 = theY2;
-      theScreenX1 = theScreenX2;
-      theScreenY1 = theScreenY2;
+    if (!(p1 >= 0. && p1 <= 1.))  // also NaN
       continue;
-    }
 
     double px = theScreenX1 + (theScreenX2 - theScreenX1)*p1;
     double py = theScreenY1 + (theScreenY2 - theScreenY1)*p1;
 
     double d = sqrt((inScreenX - px)*(inScreenX - px) + (inScreenY - py)*(inScreenY - py));
 
-    if (!found || fabs(d) < lowestDist)
+    // the candidates are not in order, the first segment wins when at the same distance
+    if (!found || fabs(d) < lowestDist || (fabs(d) == lowestDist && i < found_Id))
     {
       lowestDist = fabs(d);
       found_Id = i;
-      found_x1 = theX1;
-      found_x2 = theX2;
-      found_y1 = theY1;
-      found_y2 = theY2;
       found = true;
     }
-
-    theX1 = theX2;
-    theY1 = theY2;
-    theScreenX1 = theScreenX2;
-    theScreenY1 = theScreenY2;
   }
 
+  iupArrayDestroy(theIndexArray);
+
   if (found && lowestDist < inScreenTolerance)
   {
     outSampleIndex1 = found_Id;
     outSampleIndex2 = found_Id + 1;
-    outX1 = found_x1;
-    outY1 = found_y1;
-    outX2 = found_x2;
-    outY2 = found_y2;
+    outX1 = mDataX->GetSample(found_Id);
+    outY1 = mDataY->GetSample(found_Id);
+    outX2 = mDataX->GetSample(found_Id + 1);
+    outY2 = mDataY->GetSample(found_Id + 1);
     return true;
   }
 
@@ -584,6 +1316,51 @@ bool iupPlotDataSet::SelectSamples(double inMinX, double inMaxX, double inMinY,
   bool theChanged = false;
   mHasSelected = false;
 
+  if (!mMaybeSelected)
+  {
+    // nothing is selected, only the samples inside the box can change
+    Iarray* theIndexArray = iupArrayCreate(256, sizeof(int));
+    iupArraySetZeroFill(theIndexArray, 0);
+    FindSampleCandidates(inMinX, inMaxX, inMinY, inMaxY, theIndexArray);
+
+    int theIndexCount = iupArrayCount(theIndexArray);
+    int* theIndex = (int*)iupArrayGetData(theIndexArray);
+    if (!mOrderedX)
+      qsort(theIndex, theIndexCount, sizeof(int), iPlotCompareIndex);  // notify in the sample order
+
+    for (int n = 0; n < theIndexCount; n++)
+    {
+      int i = theIndex[n];
+      double theX = mDataX->GetSample(i);
+      double theY = mDataY->GetSample(i);
+
+      if (theX >= inMinX && theX <= inMaxX &&
+          theY >= inMinY && theY <= inMaxY)
+      {
+        mHasSelected = true;
+
+        if (inNotify->cb)
+        {
+          int ret = inNotify->cb(inNotify->ih, inNotify->ds, i, theX, theY, 0);
+          if (ret == IUP_IGNORE)
+            continue;
+        }
+
+        theChanged = true;
+        mMaybeSelected = true;
+        mSelection->SetSampleBool(i, true);
+      }
+    }
+
+    iupArrayDestroy(theIndexArray);
+
+    if (theChanged)
+      mDrawVersion = iPlotNewDrawVersion();
+    return theChanged;
+  }
+
+  bool theMaybeSelected = false;
+
   int theCount = mDataX->GetCount();
   for (int i = 0; i < theCount; i++)
   {
@@ -608,6 +1385,8 @@ bool iupPlotDataSet::SelectSamples(double inMinX, double inMaxX, double inMinY,
         theChanged = true;
         mSelection->SetSampleBool(i, true);
       }
+
+      theMaybeSelected = true;
     }
     else
     {
@@ -617,7 +1396,10 @@ bool iupPlotDataSet::SelectSamples(double inMinX, double inMaxX, double inMinY,
         {
           int ret = inNotify->cb(inNotify->ih, inNotify->ds, i, theX, theY, (int)theSelected);
           if (ret == IUP_IGNORE)
+          {
+            theMaybeSelected = true;
             continue;
+          }
         }
 
         theChanged = true;
@@ -626,6 +1408,11 @@ bool iupPlotDataSet::SelectSamples(double inMinX, double inMaxX, double inMinY,
     }
   }
 
+  mMaybeSelected = theMaybeSelected;
+
+  if (theChanged)
+    mDrawVersion = iPlotNewDrawVersion();
+
   return theChanged;
 }
 
@@ -638,6 +1425,8 @@ bool iupPlotDataSet::ClearSelection(const iupPlotSampleNotify* inNotify)
 
   mHasSelected = false;
 
+  bool theMaybeSelected = false;
+
   int theCount = mDataX->GetCount();
   for (int i = 0; i < theCount; i++)
   {
@@ -650,7 +1439,10 @@ bool iupPlotDataSet::ClearSelection(const iupPlotSampleNotify* inNotify)
         double theY = mDataY->GetSample(i);
         int ret = inNotify->cb(inNotify->ih, inNotify->ds, i, theX, theY, (int)theSelected);
         if (ret == IUP_IGNORE)
+        {
+          theMaybeSelected = true;
           continue;
+        }
       }
 
       theChanged = true;
@@ -658,6 +1450,11 @@ bool iupPlotDataSet::ClearSelection(const iupPlotSampleNotify* inNotify)
     }
   }
 
+  mMaybeSelected = theMaybeSelected;
+
+  if (theChanged)
+    mDrawVersion = iPlotNewDrawVersion();
+
   return theChanged;
 }
 
@@ -665,11 +1462,13 @@ bool iupPlotDataSet::DeleteSelectedSamples(const iupPlotSampleNotify* inNotify)
 {
   bool theChanged = false;
 
-  if (!mHasSelected)
+  if (!mHasSelected || HasBuffers())
     return theChanged;
 
   mHasSelected = false;
 
+  bool theMaybeSelected = false;
+
   int theCount = mDataX->GetCount();
   for (int i = theCount - 1; i >= 0; i--)
   {
@@ -682,7 +1481,10 @@ bool iupPlotDataSet::DeleteSelectedSamples(const iupPlotSampleNotify* inNotify)
         double theY = mDataY->GetSample(i);
         int ret = inNotify->cb(inNotify->ih, inNotify->ds, i, theX, theY, (int)theSelected);
         if (ret == IUP_IGNORE)
+        {
+          theMaybeSelected = true;
           continue;
+        }
       }
 
       theChanged = true;
@@ -690,6 +1492,8 @@ bool iupPlotDataSet::DeleteSelectedSamples(const iupPlotSampleNotify* inNotify)
     }
   }
 
+  mMaybeSelected = theMaybeSelected;
+
   return theChanged;
 }
 
@@ -698,12 +1502,23 @@ int iupPlotDataSet::GetCount()
   return mDataX->GetCount();
 }
 
+void iupPlotDataSet::ReserveSamples(int inCount)
+{
+  mDataX->Reserve(inCount);
+  mDataY->Reserve(inCount);
+  mSelection->Reserve(inCount);
+  if (mSegment)
+    mSegment->Reserve(inCount);
+  if (mExtra)
+    mExtra->Reserve(inCount);
+}
+
 void iupPlotDataSet::AddSample(double inX, double inY)
 {
   iupPlotDataReal *theXData = (iupPlotDataReal*)mDataX;
   iupPlotDataReal *theYData = (iupPlotDataReal*)mDataY;
 
-  if (theXData->IsString())
+  if (theXData->IsString() || theXData->IsBuffer())
     return;
 
   theXData->AddSample(inX);
@@ -713,6 +1528,33 @@ void iupPlotDataSet::AddSample(double inX, double inY)
     mSegment->AddSample(false);
   if (mExtra)
     mExtra->AddSample(0);
+
+  mDataVersion++;
+  mDrawVersion = iPlotNewDrawVersion();
+
+  CheckCapacity();
+}
+
+void iupPlotDataSet::AddSamples(const double* inX, const double* inY, int inCount)
+{
+  iupPlotDataReal *theXData = (iupPlotDataReal*)mDataX;
+  iupPlotDataReal *theYData = (iupPlotDataReal*)mDataY;
+
+  if (theXData->IsString() || theXData->IsBuffer() || inCount <= 0)
+    return;
+
+  theXData->AddSamples(inX, inCount);
+  theYData->AddSamples(inY, inCount);
+  mSelection->AddSamples(false, inCount);
+  if (mSegment)
+    mSegment->AddSamples(false, inCount);
+  if (mExtra)
+    mExtra->AddSamples(NULL, inCount);
+
+  mDataVersion++;
+  mDrawVersion = iPlotNewDrawVersion();
+
+  CheckCapacity();
 }
 
 void iupPlotDataSet::InsertSample(int inSampleIndex, double inX, double inY)
@@ -720,7 +1562,11 @@ void iupPlotDataSet::InsertSample(int inSampleIndex, double inX, double inY)
   iupPlotDataReal *theXData = (iupPlotDataReal*)mDataX;
   iupPlotDataReal *theYData = (iupPlotDataReal*)mDataY;
 
-  if (theXData->IsString())
+  if (theXData->IsString() || theXData->IsBuffer())
+    return;
+
+  // it would be the oldest sample, removed right away
+  if (IsInsertEvicted(inSampleIndex))
     return;
 
   theXData->InsertSample(inSampleIndex, inX);
@@ -730,6 +1576,12 @@ void iupPlotDataSet::InsertSample(int inSampleIndex, double inX, double inY)
     mSegment->InsertSample(inSampleIndex, false);
   if (mExtra)
     mExtra->InsertSample(inSampleIndex, 0);
+
+  mDataVersion++;
+  IndexChanged();
+  mDrawVersion = iPlotNewDrawVersion();
+
+  CheckCapacity();
 }
 
 void iupPlotDataSet::InitSegment()
@@ -755,7 +1607,7 @@ void iupPlotDataSet::AddSampleSegment(double inX, double inY, bool inSegment)
   iupPlotDataReal *theXData = (iupPlotDataReal*)mDataX;
   iupPlotDataReal *theYData = (iupPlotDataReal*)mDataY;
 
-  if (theXData->IsString())
+  if (theXData->IsString() || theXData->IsBuffer())
     return;
 
   if (!mSegment)
@@ -767,6 +1619,11 @@ void iupPlotDataSet::AddSampleSegment(double inX, double inY, bool inSegment)
   mSegment->AddSample(inSegment);
   if (mExtra)
     mExtra->AddSample(0);
+
+  mDataVersion++;
+  mDrawVersion = iPlotNewDrawVersion();
+
+  CheckCapacity();
 }
 
 void iupPlotDataSet::InsertSampleSegment(int inSampleIndex, double inX, double inY, bool inSegment)
@@ -774,7 +1631,11 @@ void iupPlotDataSet::InsertSampleSegment(int inSampleIndex, double inX, double i
   iupPlotDataReal *theXData = (iupPlotDataReal*)mDataX;
   iupPlotDataReal *theYData = (iupPlotDataReal*)mDataY;
 
-  if (theXData->IsString())
+  if (theXData->IsString() || theXData->IsBuffer())
+    return;
+
+  // it would be the oldest sample, removed right away
+  if (IsInsertEvicted(inSampleIndex))
     return;
 
   if (!mSegment)
@@ -786,6 +1647,12 @@ void iupPlotDataSet::InsertSampleSegment(int inSampleIndex, double inX, double i
   mSegment->InsertSample(inSampleIndex, inSegment);
   if (mExtra)
     mExtra->InsertSample(inSampleIndex, 0);
+
+  mDataVersion++;
+  IndexChanged();
+  mDrawVersion = iPlotNewDrawVersion();
+
+  CheckCapacity();
 }
 
 void iupPlotDataSet::AddSample(const char* inX, double inY)
@@ -803,6 +1670,11 @@ void iupPlotDataSet::AddSample(const char* inX, double inY)
     mSegment->AddSample(false);
   if (mExtra)
     mExtra->AddSample(0);
+
+  mDataVersion++;
+  mDrawVersion = iPlotNewDrawVersion();
+
+  CheckCapacity();
 }
 
 void iupPlotDataSet::InsertSample(int inSampleIndex, const char* inX, double inY)
@@ -813,6 +1685,10 @@ void iupPlotDataSet::InsertSample(int inSampleIndex, const char* inX, double inY
   if (!theXData->IsString())
     return;
 
+  // it would be the oldest sample, removed right away
+  if (IsInsertEvicted(inSampleIndex))
+    return;
+
   theXData->InsertSample(inSampleIndex, inX);
   theYData->InsertSample(inSampleIndex, inY);
   mSelection->InsertSample(inSampleIndex, false);
@@ -820,10 +1696,119 @@ void iupPlotDataSet::InsertSample(int inSampleIndex, const char* inX, double inY
     mSegment->InsertSample(inSampleIndex, false);
   if (mExtra)
     mExtra->InsertSample(inSampleIndex, 0);
+
+  mDataVersion++;
+  IndexChanged();
+  mDrawVersion = iPlotNewDrawVersion();
+
+  CheckCapacity();
+}
+
+void iupPlotDataSet::SetCapacity(int inCapacity)
+{
+  if (inCapacity < 0)
+    inCapacity = 0;
+
+  mCapacity = inCapacity;
+  CheckCapacity();
+}
+
+void iupPlotDataSet::CheckCapacity()
+{
+  if (HasBuffers() || mCapacity <= 0)
+    return;
+
+  int theRemoveCount = mDataX->GetCount() - mCapacity;
+  if (theRemoveCount <= 0)
+    return;
+
+  // remove all the oldest samples at once, only the offset of each column changes
+  mDataX->RemoveFirstSamples(theRemoveCount);
+  mDataY->RemoveFirstSamples(theRemoveCount);
+  mSelection->RemoveFirstSamples(theRemoveCount);
+  if (mSegment)
+    mSegment->RemoveFirstSamples(theRemoveCount);
+  if (mExtra)
+    mExtra->RemoveFirstSamples(theRemoveCount);
+
+  RemovedFirstSamples(theRemoveCount);
+
+  mDataVersion++;
+  mDrawVersion = iPlotNewDrawVersion();
+}
+
+void iupPlotDataSet::RemovedFirstSamples(int inCount)
+{
+  // string samples are drawn at their index, so all the samples moved
+  if (mDataX->IsString() || mFirstSample > INT_MAX - inCount)
+    IndexChanged();
+  else
+    mFirstSample += inCount;
+}
+
+void iupPlotDataSet::SetBuffers(const double* inX, const double* inY, int inCount, int inStride)
+{
+  if (inStride <= 0)
+    inStride = sizeof(double);
+  if (inCount < 0 || !inY)
+    inCount = 0;
+
+  delete mDataX;
+  delete mDataY;
+  delete mSelection;
+  if (mSegment)
+    delete mSegment;
+  if (mExtra)
+    delete mExtra;
+
+  mDataX = new iupPlotDataBuffer(inX, inCount, inStride);
+  mDataY = new iupPlotDataBuffer(inY, inCount, inStride);
+  mSegment = NULL;
+  mExtra = NULL;
+  mCapacity = 0;
+
+  mSelection = new iupPlotDataBool();
+  mSelection->Reserve(inCount);
+  for (int i = 0; i < inCount; i++)
+    mSelection->AddSample(false);
+
+  mHasSelected = false;
+  mMaybeSelected = false;
+  mHighlightedSample = -1;
+  mDataVersion++;
+  IndexChanged();
+  mDrawVersion = iPlotNewDrawVersion();
+}
+
+void iupPlotDataSet::AppendBuffers(int inCount)
+{
+  if (!HasBuffers() || inCount <= 0)
+    return;
+
+  ((iupPlotDataBuffer*)mDataX)->AppendSamples(inCount);
+  ((iupPlotDataBuffer*)mDataY)->AppendSamples(inCount);
+  for (int i = 0; i < inCount; i++)
+    mSelection->AddSample(false);
+  if (mSegment)
+  {
+    for (int i = 0; i < inCount; i++)
+      mSegment->AddSample(false);
+  }
+  if (mExtra)
+  {
+    for (int i = 0; i < inCount; i++)
+      mExtra->AddSample(0);
+  }
+
+  mDataVersion++;
+  mDrawVersion = iPlotNewDrawVersion();
 }
 
 void iupPlotDataSet::RemoveSample(int inSampleIndex)
 {
+  if (HasBuffers())
+    return;
+
   mDataX->RemoveSample(inSampleIndex);
   mDataY->RemoveSample(inSampleIndex);
   mSelection->RemoveSample(inSampleIndex);
@@ -831,22 +1816,27 @@ void iupPlotDataSet::RemoveSample(int inSampleIndex)
     mSegment->RemoveSample(inSampleIndex);
   if (mExtra)
     mExtra->RemoveSample(inSampleIndex);
+
+  if (inSampleIndex <= 0)
+    RemovedFirstSamples(1);
+  else
+    IndexChanged();
+
+  mDataVersion++;
+  mDrawVersion = iPlotNewDrawVersion();
 }
 
 void iupPlotDataSet::GetSample(int inSampleIndex, double *inX, double *inY)
 {
-  iupPlotDataReal *theXData = (iupPlotDataReal*)mDataX;
-  iupPlotDataReal *theYData = (iupPlotDataReal*)mDataY;
-
-  if (theXData->IsString())
+  if (mDataX->IsString())
     return;
 
-  int theCount = theXData->GetCount();
+  int theCount = mDataX->GetCount();
   if (inSampleIndex < 0 || inSampleIndex >= theCount)
     return;
 
-  if (inX) *inX = theXData->GetSample(inSampleIndex);
-  if (inY) *inY = theYData->GetSample(inSampleIndex);
+  if (inX) *inX = mDataX->GetSample(inSampleIndex);
+  if (inY) *inY = mDataY->GetSample(inSampleIndex);
 }
 
 void iupPlotDataSet::GetSample(int inSampleIndex, const char* *inX, double *inY)
@@ -888,7 +1878,7 @@ void iupPlotDataSet::SetSample(int inSampleIndex, double inX, double inY)
   iupPlotDataReal *theXData = (iupPlotDataReal*)mDataX;
   iupPlotDataReal *theYData = (iupPlotDataReal*)mDataY;
 
-  if (theXData->IsString())
+  if (theXData->IsString() || theXData->IsBuffer())
     return;
 
   int theCount = theXData->GetCount();
@@ -897,6 +1887,10 @@ void iupPlotDataSet::SetSample(int inSampleIndex, double inX, double inY)
 
   theXData->SetSample(inSampleIndex, inX);
   theYData->SetSample(inSampleIndex, inY);
+
+  mDataVersion++;
+  IndexChanged();
+  mDrawVersion = iPlotNewDrawVersion();
 }
 
 void iupPlotDataSet::SetSample(int inSampleIndex, const char* inX, double inY)
@@ -913,6 +1907,10 @@ void iupPlotDataSet::SetSample(int inSampleIndex, const char* inX, double inY)
 
   theXData->SetSampleString(inSampleIndex, inX);
   theYData->SetSample(inSampleIndex, inY);
+
+  mDataVersion++;
+  IndexChanged();
+  mDrawVersion = iPlotNewDrawVersion();
 }
 
 void iupPlotDataSet::SetSampleSelection(int inSampleIndex, bool inSelected)
@@ -922,6 +1920,10 @@ void iupPlotDataSet::SetSampleSelection(int inSampleIndex, bool inSelected)
     return;
 
   mSelection->SetSampleBool(inSampleIndex, inSelected);
+  if (inSelected)
+    mMaybeSelected = true;
+
+  mDrawVersion = iPlotNewDrawVersion();
 }
 
 void iupPlotDataSet::SetSampleExtra(int inSampleIndex, double inExtra)
@@ -934,6 +1936,80 @@ void iupPlotDataSet::SetSampleExtra(int inSampleIndex, double inExtra)
     InitExtra();
 
   mExtra->SetSample(inSampleIndex, inExtra);
+
+  mDrawVersion = iPlotNewDrawVersion();
+}
+
+iupPlotDataSet* iupPlotDataSet::CreateSnapshot() const
+{
+  // X is always real in the snapshot, string samples are drawn at their index
+  iupPlotDataSet* theSnapshot = new iupPlotDataSet(false);
+
+  theSnapshot->mColor = mColor;
+  theSnapshot->mMode = mMode;
+  theSnapshot->mLineStyle = mLineStyle;
+  theSnapshot->mLineWidth = mLineWidth;
+  theSnapshot->mAreaTransparency = mAreaTransparency;
+  theSnapshot->mMarkStyle = mMarkStyle;
+  theSnapshot->mMarkSize = mMarkSize;
+  theSnapshot->mMultibarIndex = mMultibarIndex;
+  theSnapshot->mMultibarCount = mMultibarCount;
+  theSnapshot->mBarOutlineColor = mBarOutlineColor;
+  theSnapshot->mBarShowOutline = mBarShowOutline;
+  theSnapshot->mBarMulticolor = mBarMulticolor;
+  theSnapshot->mBarSpacingPercent = mBarSpacingPercent;
+  theSnapshot->mHighlightedSample = mHighlightedSample;
+  theSnapshot->mHighlightedCurve = mHighlightedCurve;
+  theSnapshot->mOrderedX = mOrderedX;
+  theSnapshot->mDecimate = mDecimate;
+  theSnapshot->mHasSelected = mHasSelected;
+
+  // the samples are shared with the dataset, only string and buffer samples are copied
+  if (mDataX->IsString() || mDataX->IsBuffer())
+    ((iupPlotDataReal*)theSnapshot->mDataX)->CopySamples(mDataX);
+  else
+    theSnapshot->mDataX->ShareSamples(mDataX);
+  if (mDataY->IsBuffer())
+    ((iupPlotDataReal*)theSnapshot->mDataY)->CopySamples(mDataY);
+  else
+    theSnapshot->mDataY->ShareSamples(mDataY);
+  theSnapshot->mSelection->ShareSamples(mSelection);
+  if (mSegment)
+  {
+    theSnapshot->mSegment = new iupPlotDataBool();
+    theSnapshot->mSegment->ShareSamples(mSegment);
+  }
+  if (mExtra)
+  {
+    theSnapshot->mExtra = new iupPlotDataReal();
+    theSnapshot->mExtra->ShareSamples(mExtra);
+  }
+
+  theSnapshot->mDataVersion = mDataVersion;
+  theSnapshot->mDrawVersion = mDrawVersion;
+  return theSnapshot;
+}
+
+bool iupPlotDataSet::SameDrawStyle(const iupPlotDataSet* inDataSet) const
+{
+  return mColor == inDataSet->mColor &&
+         mMode == inDataSet->mMode &&
+         mLineStyle == inDataSet->mLineStyle &&
+         mLineWidth == inDataSet->mLineWidth &&
+         mAreaTransparency == inDataSet->mAreaTransparency &&
+         mMarkStyle == inDataSet->mMarkStyle &&
+         mMarkSize == inDataSet->mMarkSize &&
+         mMultibarIndex == inDataSet->mMultibarIndex &&
+         mMultibarCount == inDataSet->mMultibarCount &&
+         mBarOutlineColor == inDataSet->mBarOutlineColor &&
+         mBarShowOutline == inDataSet->mBarShowOutline &&
+         mBarMulticolor == inDataSet->mBarMulticolor &&
+         mBarSpacingPercent == inDataSet->mBarSpacingPercent &&
+         mHighlightedSample == inDataSet->mHighlightedSample &&
+         mHighlightedCurve == inDataSet->mHighlightedCurve &&
+         mOrderedX == inDataSet->mOrderedX &&
+         mDecimate == inDataSet->mDecimate &&
+         mHasSelected == inDataSet->mHasSelected;
 }
 
 
@@ -1150,7 +2226,8 @@ iupPlot::iupPlot(Ihandle* _ih, int inDefaultFontStyle, int inDefaultFontSize)
    mGrid(true), mGridMinor(false), mViewportSquare(false), mScaleEqual(false), mHighlightMode(IUP_PLOT_HIGHLIGHT_NONE),
    mDefaultFontSize(inDefaultFontSize), mDefaultFontStyle(inDefaultFontStyle), mScreenTolerance(5),
    mAxisX(inDefaultFontStyle, inDefaultFontSize), mAxisY(inDefaultFontStyle, inDefaultFontSize),
-   mCrossHairX(0), mCrossHairY(0), mShowSelectionBand(false), mDataSetListMax(20), mDataSetClipping(IUP_PLOT_CLIPAREA)
+   mCrossHairX(0), mCrossHairY(0), mShowSelectionBand(false), mDataSetListMax(20), mDataSetClipping(IUP_PLOT_CLIPAREA),
+   mAsyncRender(NULL)
 {
   mDataSetList = (iupPlotDataSet**)malloc(sizeof(iupPlotDataSet*)* mDataSetListMax); /* use malloc because we will use realloc */
   memset(mDataSetList, 0, sizeof(iupPlotDataSet*)* mDataSetListMax);
@@ -1158,6 +2235,7 @@ iupPlot::iupPlot(Ihandle* _ih, int inDefaultFontStyle, int inDefaultFontSize)
 
 iupPlot::~iupPlot()
 {
+  StopAsyncRender();
   RemoveAllDataSets();
   free(mDataSetList);  /* use free because we used malloc */
 }
@@ -1534,34 +2612,62 @@ iupPlotDataSet* iupPlot::HasPie()
   return NULL;
 }
 
-void iupPlot::DataSetClipArea(cdCanvas* canvas, int xmin, int xmax, int ymin, int ymax)
+bool iupPlot::CalculateDataSetClipArea(int &ioXMin, int &ioXMax, int &ioYMin, int &ioYMax) const
 {
   if (mDataSetClipping == IUP_PLOT_CLIPAREAOFFSET)
   {
     if (!mAxisY.HasZoom())
     {
-      int yoff = (ymax - ymin) / 50; // 2%
+      int yoff = (ioYMax - ioYMin) / 50; // 2%
       if (yoff < 10) yoff = 10;
 
-      ymin -= yoff;
-      ymax += yoff;
+      ioYMin -= yoff;
+      ioYMax += yoff;
     }
 
     if (!mAxisX.HasZoom())
     {
-      int xoff = (xmax - xmin) / 50; // 2%
+      int xoff = (ioXMax - ioXMin) / 50; // 2%
       if (xoff < 10) xoff = 10;
 
-      xmin -= xoff;
-      xmax += xoff;
+      ioXMin -= xoff;
+      ioXMax += xoff;
     }
   }
 
-  if (mDataSetClipping != IUP_PLOT_CLIPNONE)
+  return mDataSetClipping != IUP_PLOT_CLIPNONE;
+}
+
+void iupPlot::DataSetClipArea(cdCanvas* canvas, int xmin, int xmax, int ymin, int ymax)
+{
+  if (CalculateDataSetClipArea(xmin, xmax, ymin, ymax))
     cdCanvasClipArea(canvas, xmin, xmax, ymin, ymax);
 }
 
-bool iupPlot::Render(cdCanvas* canvas)
+bool iupPlot::DrawDataSetsAsync(cdCanvas* canvas, int xmin, int xmax, int ymin, int ymax)
+{
+  if (!mAsyncRender)
+    mAsyncRender = new iupPlotAsyncRender(this);
+
+  bool theClip = CalculateDataSetClipArea(xmin, xmax, ymin, ymax);
+  return mAsyncRender->DrawDataSets(canvas, theClip, xmin, xmax, ymin, ymax);
+}
+
+void iupPlot::StopAsyncRender()
+{
+  if (mAsyncRender)
+  {
+    delete mAsyncRender;
+    mAsyncRender = NULL;
+  }
+}
+
+bool iupPlot::IsAsyncRenderPending()
+{
+  return mAsyncRender && mAsyncRender->IsPending();
+}
+
+bool iupPlot::Render(cdCanvas* canvas, bool inAsync)
 {
   if (!mRedraw)
     return true;
@@ -1654,20 +2760,25 @@ bool iupPlot::Render(cdCanvas* canvas)
 
   iupPlotDataSet* pie_dataset = HasPie();
 
-  for (int ds = 0; ds < mDataSetListCount; ds++)
+  // the callback must be called in the UI thread, and pie labels use the Y axis
+  if (!inAsync || drawsample_cb || pie_dataset ||
+      !DrawDataSetsAsync(canvas, theDataSetArea.mX, theDataSetArea.mX + theDataSetArea.mWidth - 1, theDataSetArea.mY, theDataSetArea.mY + theDataSetArea.mHeight - 1))
   {
-    iupPlotDataSet* dataset = mDataSetList[ds];
-    iupPlotSampleNotify theNotify = { ih, ds, drawsample_cb };
-
-    if (pie_dataset)
+    for (int ds = 0; ds < mDataSetListCount; ds++)
     {
-      if (dataset != pie_dataset)
-        continue;
-      else
-        dataset->DrawDataPie(mAxisX.mTrafo, mAxisY.mTrafo, canvas, &theNotify, mAxisY, mBack.mColor);
-    }
+      iupPlotDataSet* dataset = mDataSetList[ds];
+      iupPlotSampleNotify theNotify = { ih, ds, drawsample_cb };
+
+      if (pie_dataset)
+      {
+        if (dataset != pie_dataset)
+          continue;
+        else
+          dataset->DrawDataPie(mAxisX.mTrafo, mAxisY.mTrafo, canvas, &theNotify, mAxisY, mBack.mColor);
+      }
 
-    dataset->DrawData(mAxisX.mTrafo, mAxisY.mTrafo, canvas, &theNotify);
+      dataset->DrawData(mAxisX.mTrafo, mAxisY.mTrafo, canvas, &theNotify);
+    }
   }
 
   // draw the legend, crosshair and selection restricted to the dataset area
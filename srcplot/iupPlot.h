@@ -12,6 +12,7 @@
 #include "iup_str.h"
 
 #include <cd.h>
+#include <string.h>
 
 #ifndef __IUPPLOT_H__
 #define __IUPPLOT_H__
@@ -22,6 +23,7 @@ enum iupPlotLegendPosition { IUP_PLOT_TOPRIGHT, IUP_PLOT_TOPLEFT, IUP_PLOT_BOTTO
 enum iupPlotSliceLabel { IUP_PLOT_NONE, IUP_PLOT_X, IUP_PLOT_Y, IUP_PLOT_PERCENT };
 enum iupPlotHighlight { IUP_PLOT_HIGHLIGHT_NONE, IUP_PLOT_HIGHLIGHT_SAMPLE, IUP_PLOT_HIGHLIGHT_CURVE, IUP_PLOT_HIGHLIGHT_BOTH };
 enum iupPlotClipping { IUP_PLOT_CLIPNONE, IUP_PLOT_CLIPAREA, IUP_PLOT_CLIPAREAOFFSET };
+enum iupPlotDecimate { IUP_PLOT_DECIMATE_NONE, IUP_PLOT_DECIMATE_MINMAX };
 
 const double kFloatSmall = 1e-20;
 const double kLogMinClipValue = 1e-10;  // pragmatism to avoid problems with small values in log plot
@@ -110,13 +112,66 @@ public:
   double mBase;
 };
 
+#define IUP_PLOT_DATA_MINOFFSET 1024
+#define IUP_PLOT_RANGE_BLOCK 256
+#define IUP_PLOT_RANGE_MAXLEVEL 32
+
+/* Min/max pyramid of a data column.
+   Level 0 has the range of each block of samples,
+   each level above has the range of two nodes of the level below.
+   Blocks after mValidCount, or all when the number of samples changed, 
+   are updated only when the range is queried. 
+   Consecutive samples are inStride bytes apart in inData. 
+   For iupPlotDataReal it covers the whole array, including the removed samples before the offset,
+   so removing the first samples does not change it. */
+class iupPlotRangePyramid
+{
+public:
+  iupPlotRangePyramid() : mValidCount(0), mUpdateCount(0), mLevelCount(0) {}
+  ~iupPlotRangePyramid();
+
+  void Invalidate(int inSampleIndex) { if (inSampleIndex < 0) inSampleIndex = 0; if (inSampleIndex < mValidCount) mValidCount = inSampleIndex - inSampleIndex % IUP_PLOT_RANGE_BLOCK; }
+  void UpdateSample(const double* inData, int inStride, int inCount, int inSampleIndex);
+  bool GetRange(const double* inData, int inStride, int inCount, int inBegin, int inEnd, double &outMin, double &outMax);
+
+protected:
+  int mValidCount;   // samples in valid blocks
+  int mUpdateCount;  // number of samples in the last update
+  int mLevelCount;
+  double* mLevel[IUP_PLOT_RANGE_MAXLEVEL];  // min and max of each node
+  int mLevelMax[IUP_PLOT_RANGE_MAXLEVEL];
+
+  void Update(const double* inData, int inStride, int inCount);
+  void UpdateNode(int inLevel, int inNode, int inNodeCount);
+  void UpdateBlock(const double* inData, int inStride, int inCount, int inBlock);
+};
+
+/* Memory of the samples of a data column, shared with the snapshots of the asynchronous render.
+   A snapshot only reads the samples it had when created, so the column can still append samples 
+   and remove the first samples in place. Any other change copies the samples first when the memory is shared.
+   The reference count is changed atomically, because snapshots are released in the render thread. */
+struct iupPlotSampleStore
+{
+  long mRefCount;
+  int mMax;  // in samples
+  char* mData;
+};
+
+iupPlotSampleStore* iupPlotSampleStoreCreate(int inMax, int inSampleSize);
+void iupPlotSampleStoreAddRef(iupPlotSampleStore* inStore);
+void iupPlotSampleStoreRelease(iupPlotSampleStore* inStore);
+bool iupPlotSampleStoreIsShared(iupPlotSampleStore* inStore);
+
 class iupPlotDataBase
 {
 public:
-  iupPlotDataBase(int inSize) : mCount(0), mIsString(false) { mArray = iupArrayCreate(20, inSize); }
-  virtual ~iupPlotDataBase() { iupArrayDestroy(mArray); }
+  iupPlotDataBase(int inSize) : mCount(0), mOffset(0), mSampleSize(inSize), mIsString(false), mIsBuffer(false) { 
+    mStore = iupPlotSampleStoreCreate(20, inSize);
+  }
+  virtual ~iupPlotDataBase() { iupPlotSampleStoreRelease(mStore); }
 
   bool IsString() const { return mIsString; }
+  bool IsBuffer() const { return mIsBuffer; }
   int GetCount() const { return mCount; }
 
   virtual bool CalculateRange(double &outMin, double &outMax) const = 0;
@@ -124,39 +179,84 @@ public:
 
   void RemoveSample(int inSampleIndex) {
     if (inSampleIndex < 0) inSampleIndex = 0; if (inSampleIndex > mCount) inSampleIndex = mCount;
-    iupArrayRemove(mArray, inSampleIndex, 1); mCount--;
+    if (inSampleIndex == 0) { RemoveFirstSamples(1); return; }
+    FreeSample(inSampleIndex);
+    RemoveSpace(inSampleIndex);
+  }
+  void RemoveFirstSamples(int inCount) {  // the other samples keep their position in mStore until it is compacted
+    if (inCount > mCount) inCount = mCount;
+    if (inCount <= 0) return;
+    for (int i = 0; i < inCount; i++) FreeSample(i);
+    mOffset += inCount;
+    mCount -= inCount;
+    if (mOffset >= IUP_PLOT_DATA_MINOFFSET && mOffset >= mCount) Compact();
+    UpdateData();
   }
+  void Reserve(int inCount) { if (inCount > mCount) CheckStore(false, inCount - mCount); }
+  void ShareSamples(const iupPlotDataBase* inData);  // replaces the samples by the samples of inData, without copying them
 
 protected:
   int mCount;
-  Iarray* mArray;
+  int mOffset;  // removed samples at the start of mStore, compacted only after more than mCount samples are removed
+  iupPlotSampleStore* mStore;
+  int mSampleSize;
   bool mIsString;
+  bool mIsBuffer;
+
+  void CheckStore(bool inWrite, int inAddCount);  // makes room for inAddCount samples, and makes the samples writable when inWrite
+  void AddSpace(int inCount) { if (mOffset + mCount + inCount > mStore->mMax) CheckStore(false, inCount); }
+  void InsertSpace(int inSampleIndex);
+  void RemoveSpace(int inSampleIndex);
+  void Unshare(int inMax);
+  void Compact();
+
+  virtual void UpdateData() = 0;
+  virtual void FreeSample(int) {}
+  virtual void SamplesChanged(int) {}  // samples from the given position in mStore were moved
 };
 
 class iupPlotDataReal : public iupPlotDataBase
 {
 public:
-  iupPlotDataReal() :iupPlotDataBase(sizeof(double)) { mData = (double*)iupArrayGetData(mArray); }
+  iupPlotDataReal() :iupPlotDataBase(sizeof(double)) { mData = (double*)mStore->mData; }
 
   double GetSample(int inSampleIndex) const { return mData[inSampleIndex]; }
-  void SetSample(int inSampleIndex, double inReal) const { mData[inSampleIndex] = inReal; }
+  void SetSample(int inSampleIndex, double inReal) { CheckStore(true, 0); mData[inSampleIndex] = inReal; mRange.UpdateSample(mData - mOffset, sizeof(double), mOffset + mCount, mOffset + inSampleIndex); }
 
-  void AddSample(double inReal) { mData = (double*)iupArrayInc(mArray); mData[mCount] = inReal; mCount++; }
+  void AddSample(double inReal) { AddSpace(1); mData[mCount] = inReal; mCount++; }
+  void AddSamples(const double* inReal, int inCount) {  // inReal can be NULL to add zeros
+    AddSpace(inCount);
+    if (inReal) memcpy(mData + mCount, inReal, inCount * sizeof(double)); else memset(mData + mCount, 0, inCount * sizeof(double));
+    mCount += inCount;
+  }
+  void CopySamples(const iupPlotDataBase* inData) {  // appends all the samples of a string or buffer column
+    int theCount = inData->GetCount();
+    AddSpace(theCount);
+    for (int i = 0; i < theCount; i++)
+      mData[mCount + i] = inData->GetSample(i);
+    mCount += theCount;
+  }
   void InsertSample(int inSampleIndex, double inReal) {
     if (inSampleIndex < 0) inSampleIndex = 0; if (inSampleIndex > mCount) inSampleIndex = mCount;
-    mData = (double*)iupArrayInsert(mArray, inSampleIndex, 1); mData[inSampleIndex] = inReal; mCount++;
+    InsertSpace(inSampleIndex); mData[inSampleIndex] = inReal; mCount++;
+    mRange.Invalidate(mOffset + inSampleIndex);
   }
 
   bool CalculateRange(double &outMin, double &outMax) const;
+  bool CalculateRange(int inBegin, int inEnd, double &outMin, double &outMax) const;
 
 protected:
   double* mData;
+  mutable iupPlotRangePyramid mRange;
+
+  void UpdateData() { mData = (double*)mStore->mData + mOffset; }
+  void SamplesChanged(int inSampleIndex) { mRange.Invalidate(inSampleIndex); }
 };
 
 class iupPlotDataString : public iupPlotDataBase
 {
 public:
-  iupPlotDataString() :iupPlotDataBase(sizeof(char*)) { mIsString = true; mData = (char**)iupArrayGetData(mArray); }
+  iupPlotDataString() :iupPlotDataBase(sizeof(char*)) { mIsString = true; mData = (char**)mStore->mData; }
   ~iupPlotDataString();
 
   double GetSample(int inSampleIndex) const { return inSampleIndex; }
@@ -168,38 +268,113 @@ public:
     mData[inSampleIndex] = iupStrDup(inString); 
   }
 
-  void AddSample(const char *inString) { mData = (char**)iupArrayInc(mArray); mData[mCount] = iupStrDup(inString); mCount++; }
+  void AddSample(const char *inString) { AddSpace(1); mData[mCount] = iupStrDup(inString); mCount++; }
   void InsertSample(int inSampleIndex, const char *inString) {
     if (inSampleIndex < 0) inSampleIndex = 0; if (inSampleIndex > mCount) inSampleIndex = mCount;
-    mData = (char**)iupArrayInsert(mArray, inSampleIndex, 1); mData[inSampleIndex] = iupStrDup(inString); mCount++;
+    InsertSpace(inSampleIndex); mData[inSampleIndex] = iupStrDup(inString); mCount++;
   }
 
   bool CalculateRange(double &outMin, double &outMax) const;
 
 protected:
   char** mData;
+
+  void UpdateData() { mData = (char**)mStore->mData + mOffset; }
+  void FreeSample(int inSampleIndex) { if (inSampleIndex < mCount) free(mData[inSampleIndex]); }
 };
 
 class iupPlotDataBool : public iupPlotDataBase
 {
 public:
-  iupPlotDataBool() :iupPlotDataBase(sizeof(bool)) { mData = (bool*)iupArrayGetData(mArray); }
+  iupPlotDataBool() :iupPlotDataBase(sizeof(bool)) { mData = (bool*)mStore->mData; }
 
   double GetSample(int inSampleIndex) const { return (int)mData[inSampleIndex]; }
 
   bool GetSampleBool(int inSampleIndex) const { return mData[inSampleIndex]; }
-  void SetSampleBool(int inSampleIndex, bool inBool) { mData[inSampleIndex] = inBool; }
+  void SetSampleBool(int inSampleIndex, bool inBool) { if (mData[inSampleIndex] == inBool) return; CheckStore(true, 0); mData[inSampleIndex] = inBool; }
 
-  void AddSample(bool inBool) { mData = (bool*)iupArrayInc(mArray); mData[mCount] = inBool; mCount++; }
+  void AddSample(bool inBool) { AddSpace(1); mData[mCount] = inBool; mCount++; }
+  void AddSamples(bool inBool, int inCount) { AddSpace(inCount); memset(mData + mCount, inBool, inCount * sizeof(bool)); mCount += inCount; }
   void InsertSample(int inSampleIndex, bool inBool) {
     if (inSampleIndex < 0) inSampleIndex = 0; if (inSampleIndex > mCount) inSampleIndex = mCount;
-    mData = (bool*)iupArrayInsert(mArray, inSampleIndex, 1); mData[inSampleIndex] = inBool; mCount++;
+    InsertSpace(inSampleIndex); mData[inSampleIndex] = inBool; mCount++;
   }
 
   bool CalculateRange(double &outMin, double &outMax) const;
 
 protected:
   bool* mData;
+
+  void UpdateData() { mData = (bool*)mStore->mData + mOffset; }
+};
+
+/* Spatial index of the samples of a dataset, in data coordinates.
+   The samples are sorted by the cells of a regular grid.
+   Segments between consecutive samples use another grid, with cells about twice their average size,
+   and are stored in all the cells their bounding box overlaps,
+   or in a separate list that is always checked when they overlap too many cells.
+   The index does not depend on the axis transformations, it is rebuilt only when the data changes. 
+   Samples appended or removed from the start after the last rebuild are handled without a rebuild:
+   removed samples are skipped and appended samples are always returned, 
+   until they are too many compared to the indexed samples. */
+class iupPlotSampleIndex
+{
+public:
+  iupPlotSampleIndex();
+  ~iupPlotSampleIndex();
+
+  /* inFirstSample is the number of samples removed from the start since inVersion changed */
+  void Update(const iupPlotDataBase* inDataX, const iupPlotDataBase* inDataY, int inVersion, int inFirstSample);
+  void UpdateSegments(const iupPlotDataBase* inDataX, const iupPlotDataBase* inDataY, int inVersion, int inFirstSample);
+
+  /* Append to ioIndex the samples or segments that can be inside the box.
+     Segments can be appended more than once. */
+  void FindSamples(double inMinX, double inMaxX, double inMinY, double inMaxY, Iarray* ioIndex) const;
+  void FindSegments(double inMinX, double inMaxX, double inMinY, double inMaxY, Iarray* ioIndex) const;
+
+protected:
+  int mVersion;
+  int mSegmentVersion;
+  int mBuildFirstSample, mBuildCount;  // samples when the index was built
+  int mRemovedCount, mCount;           // samples removed since the build and current count
+  double mMinX, mMaxX, mMinY, mMaxY;  // finite values only
+
+  int mSizeX, mSizeY;
+  int* mCellStart;  // position of the first sample of each cell in mCellSample, plus the total
+  int* mCellSample;
+
+  int mSegmentSizeX, mSegmentSizeY;
+  int* mSegmentCellStart;
+  int* mSegmentCellSample;
+  int* mLongSegment;
+  int mLongSegmentCount;
+
+  void Build(const iupPlotDataBase* inDataX, const iupPlotDataBase* inDataY, int inFirstSample);
+  void AppendIndex(Iarray* ioIndex, const int* inIndex, int inCount) const;
+};
+
+/* Real data stored in a buffer owned by the application, the samples are never copied nor changed.
+   Consecutive samples are mStride bytes apart. When the buffer is NULL the sample index is used. */
+class iupPlotDataBuffer : public iupPlotDataBase
+{
+public:
+  iupPlotDataBuffer(const double* inBuffer, int inCount, int inStride) :iupPlotDataBase(sizeof(double)), mBuffer(inBuffer), mStride(inStride) { mIsBuffer = true; mCount = inCount; }
+
+  double GetSample(int inSampleIndex) const { 
+    if (!mBuffer) return inSampleIndex; 
+    return *(const double*)((const char*)mBuffer + (size_t)inSampleIndex * mStride); 
+  }
+
+  void AppendSamples(int inCount) { mCount += inCount; }  // already in the buffer
+
+  bool CalculateRange(double &outMin, double &outMax) const;
+
+protected:
+  const double* mBuffer;
+  int mStride;
+  mutable iupPlotRangePyramid mRange;
+
+  void UpdateData() {}
 };
 
 struct iupPlotSampleNotify
@@ -207,6 +382,8 @@ struct iupPlotSampleNotify
   Ihandle* ih;
   int ds;
   IFniiddi cb;
+  bool (*cancel_cb)(void* cancel_data);  // optional, checked inside the sample loops by the asynchronous render
+  void* cancel_data;
 };
 
 class iupPlotDataSet
@@ -230,13 +407,20 @@ public:
   void DrawDataPie(const iupPlotTrafoBase *inTrafoX, const iupPlotTrafoBase *inTrafoY, cdCanvas* canvas, const iupPlotSampleNotify* inNotify, const iupPlotAxis& inAxisY, long inBackColor) const;
 
   int GetCount();
+  void ReserveSamples(int inCount);
   void AddSample(double inX, double inY);
+  void AddSamples(const double* inX, const double* inY, int inCount);
   void InsertSample(int inSampleIndex, double inX, double inY);
   void AddSampleSegment(double inX, double inY, bool inSegment);
   void InsertSampleSegment(int inSampleIndex, double inX, double inY, bool inSegment);
   void AddSample(const char* inX, double inY);
   void InsertSample(int inSampleIndex, const char* inX, double inY);
   void RemoveSample(int inSampleIndex);
+  void SetCapacity(int inCapacity);
+  int GetCapacity() const { return mCapacity; }
+  void SetBuffers(const double* inX, const double* inY, int inCount, int inStride);
+  void AppendBuffers(int inCount);
+  bool HasBuffers() const { return mDataY->IsBuffer(); }
   void GetSample(int inSampleIndex, double *inX, double *inY);
   void GetSample(int inSampleIndex, const char* *inX, double *inY);
   bool GetSampleSelection(int inSampleIndex);
@@ -252,6 +436,10 @@ public:
   const iupPlotDataBool* GetSegment() const { return mSegment; }
   const iupPlotDataReal* GetExtra() const { return mExtra; }
 
+  int GetDrawVersion() const { return mDrawVersion; }
+  iupPlotDataSet* CreateSnapshot() const;
+  bool SameDrawStyle(const iupPlotDataSet* inDataSet) const;
+
   bool SelectSamples(double inMinX, double inMaxX, double inMinY, double inMaxY, const iupPlotSampleNotify* inNotify);
   bool ClearSelection(const iupPlotSampleNotify* inNotify);
   bool DeleteSelectedSamples(const iupPlotSampleNotify* inNotify);
@@ -279,6 +467,7 @@ public:
   bool mHighlightedCurve;
   void* mUserData;
   bool mOrderedX;
+  iupPlotDecimate mDecimate;
 
 protected:
   char* mName;
@@ -289,9 +478,33 @@ protected:
   iupPlotDataReal* mExtra;
   iupPlotDataBool* mSegment;
   bool mHasSelected;
+  bool mMaybeSelected;  // false only when no sample is selected
+  int mCapacity;  // when not 0, the oldest samples are removed to keep at most mCapacity samples
+  int mDataVersion;  // changed every time samples are added, removed or changed
+  int mIndexVersion;  // changed when samples are inserted, changed or removed, except when the first samples are removed
+  int mFirstSample;   // samples removed from the start since mIndexVersion changed
+  int mDrawVersion;  // unique among all datasets, changed every time samples, selection or extra values are changed
+
+  mutable iupPlotSampleIndex mSampleIndex;  // used only when X values are not ordered
+
+  // Decimation cache, indices of the samples that are actually drawn
+  mutable Iarray* mDecimateIndex;
+  mutable int mDecimateVersion;
+  mutable double mDecimateKey[8];
 
   void InitSegment();
   void InitExtra();
+  void CheckCapacity();
+  bool IsInsertEvicted(int inSampleIndex) const { return mCapacity > 0 && inSampleIndex <= 0 && mDataX->GetCount() >= mCapacity; }
+  void IndexChanged() { mIndexVersion++; mFirstSample = 0; }
+  void RemovedFirstSamples(int inCount);
+
+  void FindSampleCandidates(double inMinX, double inMaxX, double inMinY, double inMaxY, Iarray* ioIndex) const;
+  void FindSegmentCandidates(double inMinX, double inMaxX, double inMinY, double inMaxY, Iarray* ioIndex) const;
+
+  const int* GetDecimateIndex(const iupPlotTrafoBase *inTrafoX, const iupPlotTrafoBase *inTrafoY, cdCanvas* canvas, const iupPlotSampleNotify* inNotify, int &outCount) const;
+  bool DecimateLine(const iupPlotTrafoBase *inTrafoX, const iupPlotSampleNotify* inNotify) const;
+  bool DecimateMark(const iupPlotTrafoBase *inTrafoX, const iupPlotTrafoBase *inTrafoY, int inWidth, int inHeight, const iupPlotSampleNotify* inNotify) const;
 
   void DrawDataLine(const iupPlotTrafoBase *inTrafoX, const iupPlotTrafoBase *inTrafoY, cdCanvas* canvas, const iupPlotSampleNotify* inNotify, bool inShowMark, bool inErrorBar) const;
   void DrawDataMark(const iupPlotTrafoBase *inTrafoX, const iupPlotTrafoBase *inTrafoY, cdCanvas* canvas, const iupPlotSampleNotify* inNotify) const;
@@ -599,6 +812,58 @@ protected:
 };
 
 
+class iupPlot;
+struct iupPlotAsyncThread;
+struct iupPlotAsyncFrame;
+
+struct iupPlotAsyncImage
+{
+  unsigned char *mRed, *mGreen, *mBlue, *mAlpha;
+  int mWidth, mHeight;
+};
+
+/* Renders the datasets of a plot in a worker thread, into an offscreen RGBA image of the viewport.
+   Each frame draws snapshots of the datasets, a snapshot is copied only when samples or style changed.
+   The UI thread blits the last finished frame and draws the rest of the plot over and under it.
+   A new request cancels the frame being rendered, and a timer redraws the plot when a frame is finished. */
+class iupPlotAsyncRender
+{
+public:
+  iupPlotAsyncRender(iupPlot* inPlot);
+  ~iupPlotAsyncRender();
+
+  bool DrawDataSets(cdCanvas* canvas, bool inClip, int inClipXMin, int inClipXMax, int inClipYMin, int inClipYMax);
+  void CheckFrame();  // called by the timer
+  bool IsPending();  // the last requested frame was not shown yet
+  void Run();  // worker thread loop
+
+protected:
+  iupPlot* mPlot;
+  Ihandle* mTimer;
+  iupPlotAsyncThread* mThread;
+
+  // used only by the UI thread
+  iupPlotAsyncFrame* mLastRequest;
+  int mShownId;
+
+  // shared with the worker thread, protected by the lock
+  iupPlotAsyncFrame* mPending;
+  int mRequestId;
+  int mFrameId;
+  int mFailedId;
+  iupPlotAsyncImage mFrame;  // last finished frame
+  bool mQuit;
+
+  iupPlotAsyncImage mWork;  // used only by the worker thread
+
+  iupPlotAsyncFrame* NewFrame(bool inClip, int inClipXMin, int inClipXMax, int inClipYMin, int inClipYMax);
+  bool SameFrame(const iupPlotAsyncFrame* inFrame, const iupPlotAsyncFrame* inNewFrame) const;
+  void ReleaseFrame(iupPlotAsyncFrame* inFrame);
+  bool IsCancelled(const iupPlotAsyncFrame* inFrame);
+  static bool IsCancelledCB(void* cancel_data);
+  int RenderFrame(const iupPlotAsyncFrame* inFrame, iupPlotAsyncImage* ioImage);
+};
+
 class iupPlot
 {
 public:
@@ -619,7 +884,11 @@ public:
 
   void SetViewport(int x, int y, int w, int h);
   void DataSetClipArea(cdCanvas* canvas, int xmin, int xmax, int ymin, int ymax);
-  bool Render(cdCanvas* canvas);
+  bool CalculateDataSetClipArea(int &ioXMin, int &ioXMax, int &ioYMin, int &ioYMax) const;
+  bool Render(cdCanvas* canvas, bool inAsync);
+  bool DrawDataSetsAsync(cdCanvas* canvas, int xmin, int xmax, int ymin, int ymax);
+  void StopAsyncRender();
+  bool IsAsyncRenderPending();
   void ConfigureAxis();
   void SetFont(cdCanvas* canvas, int inFontStyle, int inFontSize) const;
   void UpdateMultibarCount();
@@ -697,6 +966,8 @@ public:
 
   /***********************************/
 
+  iupPlotAsyncRender* mAsyncRender;  // created when the datasets are first rendered in a worker thread
+
   iupPlotDataSet* *mDataSetList;
   int mDataSetListCount;
   int mDataSetListMax;
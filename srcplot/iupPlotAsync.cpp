@@ -0,0 +1,554 @@
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+#ifdef WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "iupPlot.h"
+
+#include <cdirgb.h>
+
+
+#define IPLOT_ASYNC_TIMER "10"  /* interval to check for finished frames, in milliseconds */
+
+
+struct iupPlotAsyncThread
+{
+#ifdef WIN32
+  HANDLE thread;
+  CRITICAL_SECTION lock;
+  CONDITION_VARIABLE cond;
+#else
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+#endif
+};
+
+/* Snapshot of a dataset, shared by all the frames that use it. */
+struct iupPlotAsyncSnapshot
+{
+  iupPlotDataSet* mDataSet;
+  int mRefCount;
+};
+
+struct iupPlotAsyncFrame
+{
+  int mId;
+  int mRefCount;
+
+  int mWidth, mHeight;
+  bool mClip;
+  int mClipXMin, mClipXMax, mClipYMin, mClipYMax;
+
+  bool mLogScaleX, mLogScaleY;
+  iupPlotTrafoLinear mLinTrafoX, mLinTrafoY;
+  iupPlotTrafoLog mLogTrafoX, mLogTrafoY;
+
+  iupPlotAsyncSnapshot** mSnapshots;
+  int mCount;
+
+  const iupPlotTrafoBase* GetTrafoX() const { if (mLogScaleX) return &mLogTrafoX; else return &mLinTrafoX; }
+  const iupPlotTrafoBase* GetTrafoY() const { if (mLogScaleY) return &mLogTrafoY; else return &mLinTrafoY; }
+};
+
+
+#ifdef WIN32
+static unsigned __stdcall iPlotAsyncThreadFunc(void* user_data)
+#else
+static void* iPlotAsyncThreadFunc(void* user_data)
+#endif
+{
+  iupPlotAsyncRender* async_render = (iupPlotAsyncRender*)user_data;
+  async_render->Run();
+  return 0;
+}
+
+static iupPlotAsyncThread* iPlotAsyncThreadCreate(void)
+{
+  iupPlotAsyncThread* thread = (iupPlotAsyncThread*)malloc(sizeof(iupPlotAsyncThread));
+
+#ifdef WIN32
+  InitializeCriticalSection(&thread->lock);
+  InitializeConditionVariable(&thread->cond);
+#else
+  pthread_mutex_init(&thread->lock, NULL);
+  pthread_cond_init(&thread->cond, NULL);
+#endif
+
+  return thread;
+}
+
+static void iPlotAsyncThreadFree(iupPlotAsyncThread* thread)
+{
+#ifdef WIN32
+  DeleteCriticalSection(&thread->lock);
+#else
+  pthread_cond_destroy(&thread->cond);
+  pthread_mutex_destroy(&thread->lock);
+#endif
+
+  free(thread);
+}
+
+static int iPlotAsyncThreadStart(iupPlotAsyncThread* thread, iupPlotAsyncRender* async_render)
+{
+#ifdef WIN32
+  thread->thread = (HANDLE)_beginthreadex(NULL, 0, iPlotAsyncThreadFunc, async_render, 0, NULL);
+  return thread->thread != NULL;
+#else
+  return pthread_create(&thread->thread, NULL, iPlotAsyncThreadFunc, async_render) == 0;
+#endif
+}
+
+static void iPlotAsyncThreadDestroy(iupPlotAsyncThread* thread)
+{
+  /* the thread must be already finishing */
+#ifdef WIN32
+  WaitForSingleObject(thread->thread, INFINITE);
+  CloseHandle(thread->thread);
+#else
+  pthread_join(thread->thread, NULL);
+#endif
+
+  iPlotAsyncThreadFree(thread);
+}
+
+static void iPlotAsyncLock(iupPlotAsyncThread* thread)
+{
+#ifdef WIN32
+  EnterCriticalSection(&thread->lock);
+#else
+  pthread_mutex_lock(&thread->lock);
+#endif
+}
+
+static void iPlotAsyncUnlock(iupPlotAsyncThread* thread)
+{
+#ifdef WIN32
+  LeaveCriticalSection(&thread->lock);
+#else
+  pthread_mutex_unlock(&thread->lock);
+#endif
+}
+
+static void iPlotAsyncWait(iupPlotAsyncThread* thread)
+{
+  /* must be called with the lock */
+#ifdef WIN32
+  SleepConditionVariableCS(&thread->cond, &thread->lock, INFINITE);
+#else
+  pthread_cond_wait(&thread->cond, &thread->lock);
+#endif
+}
+
+static void iPlotAsyncSignal(iupPlotAsyncThread* thread)
+{
+#ifdef WIN32
+  WakeConditionVariable(&thread->cond);
+#else
+  pthread_cond_signal(&thread->cond);
+#endif
+}
+
+static bool iPlotAsyncImageResize(iupPlotAsyncImage* image, int width, int height)
+{
+  if (image->mRed && image->mWidth == width && image->mHeight == height)
+    return true;
+
+  if (image->mRed)
+    free(image->mRed);
+
+  /* one allocation for the 4 channels */
+  int size = width * height;
+  image->mRed = (unsigned char*)malloc(4 * size);
+  if (!image->mRed)
+  {
+    image->mWidth = 0;
+    image->mHeight = 0;
+    return false;
+  }
+
+  image->mGreen = image->mRed + size;
+  image->mBlue = image->mGreen + size;
+  image->mAlpha = image->mBlue + size;
+  image->mWidth = width;
+  image->mHeight = height;
+  return true;
+}
+
+static bool iPlotAsyncSameTrafo(bool inLogScale, const iupPlotTrafoLinear& inLinTrafo1, const iupPlotTrafoLog& inLogTrafo1, const iupPlotTrafoLinear& inLinTrafo2, const iupPlotTrafoLog& inLogTrafo2)
+{
+  if (inLogScale)
+    return inLogTrafo1.mOffset == inLogTrafo2.mOffset && inLogTrafo1.mSlope == inLogTrafo2.mSlope && inLogTrafo1.mBase == inLogTrafo2.mBase;
+  else
+    return inLinTrafo1.mOffset == inLinTrafo2.mOffset && inLinTrafo1.mSlope == inLinTrafo2.mSlope;
+}
+
+static int iPlotAsyncTimer_CB(Ihandle* timer)
+{
+  iupPlotAsyncRender* async_render = (iupPlotAsyncRender*)IupGetAttribute(timer, "_IUP_PLOT_ASYNCRENDER");
+  async_render->CheckFrame();
+  return IUP_DEFAULT;
+}
+
+
+/************************************************************************************************/
+
+
+iupPlotAsyncRender::iupPlotAsyncRender(iupPlot* inPlot)
+  :mPlot(inPlot), mLastRequest(NULL), mShownId(0), mPending(NULL), mRequestId(0), mFrameId(0), mFailedId(0), mQuit(false)
+{
+  memset(&mFrame, 0, sizeof(iupPlotAsyncImage));
+  memset(&mWork, 0, sizeof(iupPlotAsyncImage));
+
+  mTimer = IupTimer();
+  IupSetAttribute(mTimer, "TIME", IPLOT_ASYNC_TIMER);
+  IupSetAttribute(mTimer, "_IUP_PLOT_ASYNCRENDER", (char*)this);
+  IupSetCallback(mTimer, "ACTION_CB", (Icallback)iPlotAsyncTimer_CB);
+
+  // must be the last, the thread starts running Run immediately
+  mThread = iPlotAsyncThreadCreate();
+  if (!iPlotAsyncThreadStart(mThread, this))
+  {
+    iPlotAsyncThreadFree(mThread);
+    mThread = NULL;
+  }
+}
+
+iupPlotAsyncRender::~iupPlotAsyncRender()
+{
+  IupDestroy(mTimer);
+
+  if (mThread)
+  {
+    iPlotAsyncLock(mThread);
+    mQuit = true;
+    iPlotAsyncSignal(mThread);
+    iPlotAsyncUnlock(mThread);
+
+    iPlotAsyncThreadDestroy(mThread);
+    mThread = NULL;
+  }
+
+  if (mPending)
+    ReleaseFrame(mPending);
+  if (mLastRequest)
+    ReleaseFrame(mLastRequest);
+
+  if (mFrame.mRed)
+    free(mFrame.mRed);
+  if (mWork.mRed)
+    free(mWork.mRed);
+}
+
+void iupPlotAsyncRender::ReleaseFrame(iupPlotAsyncFrame* inFrame)
+{
+  // must be called with the lock, when there is a thread
+  inFrame->mRefCount--;
+  if (inFrame->mRefCount > 0)
+    return;
+
+  for (int i = 0; i < inFrame->mCount; i++)
+  {
+    iupPlotAsyncSnapshot* theSnapshot = inFrame->mSnapshots[i];
+    theSnapshot->mRefCount--;
+    if (theSnapshot->mRefCount == 0)
+    {
+      delete theSnapshot->mDataSet;
+      free(theSnapshot);
+    }
+  }
+
+  free(inFrame->mSnapshots);
+  delete inFrame;
+}
+
+iupPlotAsyncFrame* iupPlotAsyncRender::NewFrame(bool inClip, int inClipXMin, int inClipXMax, int inClipYMin, int inClipYMax)
+{
+  // allocated with new because of the trafo objects
+  iupPlotAsyncFrame* theFrame = new iupPlotAsyncFrame;
+
+  theFrame->mId = 0;
+  theFrame->mRefCount = 1;
+  theFrame->mWidth = mPlot->mViewport.mWidth;
+  theFrame->mHeight = mPlot->mViewport.mHeight;
+  theFrame->mClip = inClip;
+  theFrame->mClipXMin = inClipXMin;
+  theFrame->mClipXMax = inClipXMax;
+  theFrame->mClipYMin = inClipYMin;
+  theFrame->mClipYMax = inClipYMax;
+
+  theFrame->mLogScaleX = mPlot->mAxisX.mLogScale;
+  if (theFrame->mLogScaleX)
+    theFrame->mLogTrafoX = *(iupPlotTrafoLog*)mPlot->mAxisX.mTrafo;
+  else
+    theFrame->mLinTrafoX = *(iupPlotTrafoLinear*)mPlot->mAxisX.mTrafo;
+
+  theFrame->mLogScaleY = mPlot->mAxisY.mLogScale;
+  if (theFrame->mLogScaleY)
+    theFrame->mLogTrafoY = *(iupPlotTrafoLog*)mPlot->mAxisY.mTrafo;
+  else
+    theFrame->mLinTrafoY = *(iupPlotTrafoLinear*)mPlot->mAxisY.mTrafo;
+
+  theFrame->mCount = mPlot->mDataSetListCount;
+  theFrame->mSnapshots = (iupPlotAsyncSnapshot**)malloc(theFrame->mCount * sizeof(iupPlotAsyncSnapshot*));
+
+  for (int ds = 0; ds < theFrame->mCount; ds++)
+  {
+    const iupPlotDataSet* theDataSet = mPlot->mDataSetList[ds];
+    iupPlotAsyncSnapshot* theSnapshot = NULL;
+
+    // reuse the snapshot of the last request when the dataset was not changed
+    if (mLastRequest)
+    {
+      for (int i = 0; i < mLastRequest->mCount; i++)
+      {
+        iupPlotDataSet* theLastDataSet = mLastRequest->mSnapshots[i]->mDataSet;
+        if (theLastDataSet->GetDrawVersion() == theDataSet->GetDrawVersion() && theLastDataSet->SameDrawStyle(theDataSet))
+        {
+          theSnapshot = mLastRequest->mSnapshots[i];
+          break;
+        }
+      }
+    }
+
+    if (theSnapshot)
+    {
+      iPlotAsyncLock(mThread);
+      theSnapshot->mRefCount++;
+      iPlotAsyncUnlock(mThread);
+    }
+    else
+    {
+      theSnapshot = (iupPlotAsyncSnapshot*)malloc(sizeof(iupPlotAsyncSnapshot));
+      theSnapshot->mDataSet = theDataSet->CreateSnapshot();
+      theSnapshot->mRefCount = 1;
+    }
+
+    theFrame->mSnapshots[ds] = theSnapshot;
+  }
+
+  return theFrame;
+}
+
+bool iupPlotAsyncRender::SameFrame(const iupPlotAsyncFrame* inFrame, const iupPlotAsyncFrame* inNewFrame) const
+{
+  if (inFrame->mWidth != inNewFrame->mWidth || inFrame->mHeight != inNewFrame->mHeight ||
+      inFrame->mClip != inNewFrame->mClip ||
+      inFrame->mClipXMin != inNewFrame->mClipXMin || inFrame->mClipXMax != inNewFrame->mClipXMax ||
+      inFrame->mClipYMin != inNewFrame->mClipYMin || inFrame->mClipYMax != inNewFrame->mClipYMax ||
+      inFrame->mLogScaleX != inNewFrame->mLogScaleX || inFrame->mLogScaleY != inNewFrame->mLogScaleY ||
+      inFrame->mCount != inNewFrame->mCount)
+    return false;
+
+  if (!iPlotAsyncSameTrafo(inFrame->mLogScaleX, inFrame->mLinTrafoX, inFrame->mLogTrafoX, inNewFrame->mLinTrafoX, inNewFrame->mLogTrafoX) ||
+      !iPlotAsyncSameTrafo(inFrame->mLogScaleY, inFrame->mLinTrafoY, inFrame->mLogTrafoY, inNewFrame->mLinTrafoY, inNewFrame->mLogTrafoY))
+    return false;
+
+  for (int ds = 0; ds < inFrame->mCount; ds++)
+  {
+    if (inFrame->mSnapshots[ds] != inNewFrame->mSnapshots[ds])
+      return false;
+  }
+
+  return true;
+}
+
+bool iupPlotAsyncRender::DrawDataSets(cdCanvas* canvas, bool inClip, int inClipXMin, int inClipXMax, int inClipYMin, int inClipYMax)
+{
+  if (!mThread)
+    return false;
+
+  for (int ds = 0; ds < mPlot->mDataSetListCount; ds++)
+  {
+    // the sample colors are attributes of the element, available only in the UI thread
+    if (mPlot->mDataSetList[ds]->mBarMulticolor)
+      return false;
+  }
+
+  // the new frame shares the snapshots of the last request,
+  // and the snapshots share the samples of the datasets, so it is cheap to create
+  iupPlotAsyncFrame* theFrame = NewFrame(inClip, inClipXMin, inClipXMax, inClipYMin, inClipYMax);
+
+  iPlotAsyncLock(mThread);
+
+  if (mLastRequest && SameFrame(mLastRequest, theFrame))
+    ReleaseFrame(theFrame);
+  else
+  {
+    mRequestId++;
+    theFrame->mId = mRequestId;
+
+    // the frame being rendered is cancelled, and the one not started yet is replaced
+    if (mPending)
+      ReleaseFrame(mPending);
+    mPending = theFrame;
+    theFrame->mRefCount++;
+
+    if (mLastRequest)
+      ReleaseFrame(mLastRequest);
+    mLastRequest = theFrame;
+
+    iPlotAsyncSignal(mThread);
+  }
+
+  bool thePending = mFrameId != mRequestId && mFailedId != mRequestId;
+
+  // blit the last finished frame, even if it is older than the last request
+  if (mFrame.mRed && mFrame.mWidth == mPlot->mViewport.mWidth && mFrame.mHeight == mPlot->mViewport.mHeight)
+  {
+    cdCanvasPutImageRectRGBA(canvas, mFrame.mWidth, mFrame.mHeight, mFrame.mRed, mFrame.mGreen, mFrame.mBlue, mFrame.mAlpha,
+                             0, 0, mFrame.mWidth, mFrame.mHeight, 0, 0, 0, 0);
+    mShownId = mFrameId;
+  }
+
+  iPlotAsyncUnlock(mThread);
+
+  if (thePending)
+    IupSetAttribute(mTimer, "RUN", "YES");
+
+  return true;
+}
+
+void iupPlotAsyncRender::CheckFrame()
+{
+  iPlotAsyncLock(mThread);
+  int theFrameId = mFrameId;
+  bool thePending = mFrameId != mRequestId && mFailedId != mRequestId;
+  iPlotAsyncUnlock(mThread);
+
+  if (!thePending)
+    IupSetAttribute(mTimer, "RUN", "NO");
+
+  if (theFrameId != mShownId)
+  {
+    // a new frame is finished, redraw the plot to blit it
+    mPlot->mRedraw = true;
+    IupUpdate(mPlot->ih);
+  }
+}
+
+bool iupPlotAsyncRender::IsPending()
+{
+  if (!mThread)
+    return false;
+
+  iPlotAsyncLock(mThread);
+  bool thePending = mFailedId != mRequestId && mShownId != mRequestId;
+  iPlotAsyncUnlock(mThread);
+  return thePending;
+}
+
+bool iupPlotAsyncRender::IsCancelled(const iupPlotAsyncFrame* inFrame)
+{
+  iPlotAsyncLock(mThread);
+  bool theCancelled = mQuit || inFrame->mId != mRequestId;
+  iPlotAsyncUnlock(mThread);
+  return theCancelled;
+}
+
+struct iPlotAsyncCancel
+{
+  iupPlotAsyncRender* mRender;
+  const iupPlotAsyncFrame* mFrame;
+};
+
+bool iupPlotAsyncRender::IsCancelledCB(void* cancel_data)
+{
+  iPlotAsyncCancel* theCancel = (iPlotAsyncCancel*)cancel_data;
+  return theCancel->mRender->IsCancelled(theCancel->mFrame);
+}
+
+int iupPlotAsyncRender::RenderFrame(const iupPlotAsyncFrame* inFrame, iupPlotAsyncImage* ioImage)
+{
+  // runs in the worker thread, returns 1 if finished, 0 if cancelled and -1 if failed
+
+  if (inFrame->mWidth <= 0 || inFrame->mHeight <= 0)
+    return -1;
+
+  if (!iPlotAsyncImageResize(ioImage, inFrame->mWidth, inFrame->mHeight))
+    return -1;
+
+  cdCanvas* canvas = cdCreateCanvasf(CD_IMAGERGB, "%dx%d %p %p %p %p -a", ioImage->mWidth, ioImage->mHeight,
+                                     ioImage->mRed, ioImage->mGreen, ioImage->mBlue, ioImage->mAlpha);
+  if (!canvas)
+    return -1;
+
+  // transparent where there are no samples
+  cdCanvasBackground(canvas, cdEncodeAlpha(CD_WHITE, 0));
+  cdCanvasClear(canvas);
+
+  if (inFrame->mClip)
+  {
+    cdCanvasClipArea(canvas, inFrame->mClipXMin, inFrame->mClipXMax, inFrame->mClipYMin, inFrame->mClipYMax);
+    cdCanvasClip(canvas, CD_CLIPAREA);
+  }
+
+  // a newer request cancels this frame, checked also inside the sample loops
+  iPlotAsyncCancel theCancel = { this, inFrame };
+
+  for (int ds = 0; ds < inFrame->mCount; ds++)
+  {
+    if (IsCancelled(inFrame))
+    {
+      cdKillCanvas(canvas);
+      return 0;
+    }
+
+    iupPlotSampleNotify theNotify = { NULL, ds, NULL, IsCancelledCB, &theCancel };
+    inFrame->mSnapshots[ds]->mDataSet->DrawData(inFrame->GetTrafoX(), inFrame->GetTrafoY(), canvas, &theNotify);
+  }
+
+  cdKillCanvas(canvas);
+
+  if (IsCancelled(inFrame))
+    return 0;
+
+  return 1;
+}
+
+void iupPlotAsyncRender::Run()
+{
+  iPlotAsyncLock(mThread);
+
+  for (;;)
+  {
+    while (!mQuit && !mPending)
+      iPlotAsyncWait(mThread);
+
+    if (mQuit)
+      break;
+
+    iupPlotAsyncFrame* theFrame = mPending;
+    mPending = NULL;
+
+    iPlotAsyncUnlock(mThread);
+
+    int ret = RenderFrame(theFrame, &mWork);
+
+    iPlotAsyncLock(mThread);
+
+    if (ret == 1 && theFrame->mId == mRequestId)
+    {
+      // the finished frame becomes the front image
+      iupPlotAsyncImage theImage = mFrame;
+      mFrame = mWork;
+      mWork = theImage;
+      mFrameId = theFrame->mId;
+    }
+    else if (ret == -1)
+      mFailedId = theFrame->mId;
+
+    ReleaseFrame(theFrame);
+  }
+
+  iPlotAsyncUnlock(mThread);
+}
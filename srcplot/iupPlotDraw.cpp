@@ -11,6 +11,7 @@
 
 #define HIGHTLIGHT_ALPHA 64
 #define HIGHTLIGHT_OFFSET 12
+#define DECIMATE_MIN_COUNT 4096  /* datasets with less samples are always fully drawn */
 
 static inline void iPlotSetLine(cdCanvas* canvas, int inLineStyle, int inLineWidth)
 {
@@ -926,13 +927,202 @@ bool iupPlot::DrawSampleColorLegend(iupPlotDataSet *dataset, const iupPlotRect &
 /************************************************************************************/
 
 
+static inline int iPlotScreenPixel(double inScreen)
+{
+  /* also avoids overflow when converting to int */
+  if (!(inScreen > -1e9)) return -1000000000;
+  if (inScreen > 1e9) return 1000000000;
+  return (int)floor(inScreen);
+}
+
+#define IPLOT_CANCEL_SAMPLES 4096  /* samples processed between checks for a cancelled frame */
+
+static inline bool iPlotIsCancelled(const iupPlotSampleNotify* inNotify, int inSample)
+{
+  return inNotify->cancel_cb && inSample % IPLOT_CANCEL_SAMPLES == 0 && inNotify->cancel_cb(inNotify->cancel_data);
+}
+
+static inline void iPlotAddDecimateIndex(Iarray* inIndexArray, int &ioLastIndex, int inIndex)
+{
+  if (inIndex == ioLastIndex)
+    return;
+
+  int* theIndex = (int*)iupArrayInc(inIndexArray);
+  theIndex[iupArrayCount(inIndexArray) - 1] = inIndex;
+  ioLastIndex = inIndex;
+}
+
+bool iupPlotDataSet::DecimateLine(const iupPlotTrafoBase *inTrafoX, const iupPlotSampleNotify* inNotify) const
+{
+  /* For each run of consecutive samples in the same screen column 
+     keep only the first, the last, and the samples with minimum and maximum Y. 
+     The polyline is drawn the same way, and the number of vertices is limited by the screen width. */
+  int theCount = mDataX->GetCount();
+  int theLastIndex = -1;
+  int theLastCheck = -IPLOT_CANCEL_SAMPLES;
+  int i = 0;
+
+  while (i < theCount)
+  {
+    if (i - theLastCheck >= IPLOT_CANCEL_SAMPLES)
+    {
+      if (iPlotIsCancelled(inNotify, 0))
+        return false;
+      theLastCheck = i;
+    }
+
+    int theColumn = iPlotScreenPixel(inTrafoX->Transform(mDataX->GetSample(i)));
+    int theFirst = i, theMin = i, theMax = i;
+    double theMinY = mDataY->GetSample(i);
+    double theMaxY = theMinY;
+
+    for (i = i + 1; i < theCount; i++)
+    {
+      if (mSegment && mSegment->GetSampleBool(i))
+        break;
+
+      if (iPlotScreenPixel(inTrafoX->Transform(mDataX->GetSample(i))) != theColumn)
+        break;
+
+      double theY = mDataY->GetSample(i);
+      if (theY < theMinY)
+      {
+        theMinY = theY;
+        theMin = i;
+      }
+      else if (theY > theMaxY)
+      {
+        theMaxY = theY;
+        theMax = i;
+      }
+    }
+
+    iPlotAddDecimateIndex(mDecimateIndex, theLastIndex, theFirst);
+    iPlotAddDecimateIndex(mDecimateIndex, theLastIndex, theMin < theMax ? theMin : theMax);
+    iPlotAddDecimateIndex(mDecimateIndex, theLastIndex, theMin < theMax ? theMax : theMin);
+    iPlotAddDecimateIndex(mDecimateIndex, theLastIndex, i - 1);
+  }
+
+  return true;
+}
+
+bool iupPlotDataSet::DecimateMark(const iupPlotTrafoBase *inTrafoX, const iupPlotTrafoBase *inTrafoY, int inWidth, int inHeight, const iupPlotSampleNotify* inNotify) const
+{
+  /* Keep only the first sample in each screen pixel,
+     and ignore samples with marks completely outside the canvas. */
+  int theCount = mDataX->GetCount();
+  int theMargin = mMarkSize / 2 + 1;
+  int theWidth = inWidth + 2 * theMargin;
+  int theHeight = inHeight + 2 * theMargin;
+  int theLastIndex = -1;
+
+  unsigned char* theUsed = (unsigned char*)calloc((theWidth * theHeight + 7) / 8, 1);
+  if (!theUsed)
+    return true;
+
+  for (int i = 0; i < theCount; i++)
+  {
+    if (iPlotIsCancelled(inNotify, i))
+    {
+      free(theUsed);
+      return false;
+    }
+
+    int theX = iPlotScreenPixel(inTrafoX->Transform(mDataX->GetSample(i))) + theMargin;
+    int theY = iPlotScreenPixel(inTrafoY->Transform(mDataY->GetSample(i))) + theMargin;
+
+    if (theX < 0 || theX >= theWidth || theY < 0 || theY >= theHeight)
+      continue;
+
+    int thePixel = theY * theWidth + theX;
+    if (theUsed[thePixel >> 3] & (1 << (thePixel & 7)))
+      continue;
+
+    theUsed[thePixel >> 3] |= (unsigned char)(1 << (thePixel & 7));
+    iPlotAddDecimateIndex(mDecimateIndex, theLastIndex, i);
+  }
+
+  free(theUsed);
+  return true;
+}
+
+const int* iupPlotDataSet::GetDecimateIndex(const iupPlotTrafoBase *inTrafoX, const iupPlotTrafoBase *inTrafoY, cdCanvas* canvas, const iupPlotSampleNotify* inNotify, int &outCount) const
+{
+  /* the callback must be called for every sample, and marks of different sizes can not be merged */
+  if (mDecimate == IUP_PLOT_DECIMATE_NONE || inNotify->cb || mDataX->GetCount() < DECIMATE_MIN_COUNT)
+    return NULL;
+  if (mMode != IUP_PLOT_LINE && (mMode != IUP_PLOT_MARK || mExtra))
+    return NULL;
+
+  /* the cache depends on the transformations, identified by the position of two values */
+  double theKey[8];
+  theKey[0] = mMode;
+  theKey[1] = inTrafoX->Transform(1);
+  theKey[2] = inTrafoX->Transform(2);
+  theKey[3] = 0;
+  theKey[4] = 0;
+  theKey[5] = 0;
+  theKey[6] = 0;
+  theKey[7] = 0;
+
+  if (mMode == IUP_PLOT_MARK)
+  {
+    int theWidth, theHeight;
+    cdCanvasGetSize(canvas, &theWidth, &theHeight, NULL, NULL);
+
+    theKey[3] = inTrafoY->Transform(1);
+    theKey[4] = inTrafoY->Transform(2);
+    theKey[5] = theWidth;
+    theKey[6] = theHeight;
+    theKey[7] = mMarkSize;
+  }
+
+  if (!mDecimateIndex)
+  {
+    mDecimateIndex = iupArrayCreate(1024, sizeof(int));
+    iupArraySetZeroFill(mDecimateIndex, 0);
+  }
+
+  if (mDecimateVersion != mDataVersion || memcmp(theKey, mDecimateKey, sizeof(theKey)) != 0)
+  {
+    bool theDone;
+
+    iupArrayRemove(mDecimateIndex, 0, iupArrayCount(mDecimateIndex));
+
+    if (mMode == IUP_PLOT_MARK)
+      theDone = DecimateMark(inTrafoX, inTrafoY, (int)theKey[5], (int)theKey[6], inNotify);
+    else
+      theDone = DecimateLine(inTrafoX, inNotify);
+
+    if (!theDone)
+    {
+      // cancelled, nothing is drawn and the index is not cached
+      mDecimateVersion = -1;
+      outCount = 0;
+      return (const int*)iupArrayGetData(mDecimateIndex);
+    }
+
+    mDecimateVersion = mDataVersion;
+    memcpy(mDecimateKey, theKey, sizeof(theKey));
+  }
+
+  outCount = iupArrayCount(mDecimateIndex);
+  return (const int*)iupArrayGetData(mDecimateIndex);
+}
+
 void iupPlotDataSet::DrawDataLine(const iupPlotTrafoBase *inTrafoX, const iupPlotTrafoBase *inTrafoY, cdCanvas* canvas, const iupPlotSampleNotify* inNotify, bool inShowMark, bool inErrorBar) const
 {
   int theCount = mDataX->GetCount();
+  const int* theIndex = GetDecimateIndex(inTrafoX, inTrafoY, canvas, inNotify, theCount);
+
   cdCanvasBegin(canvas, CD_OPEN_LINES);
 
-  for (int i = 0; i < theCount; i++)
+  for (int n = 0; n < theCount; n++)
   {
+    if (iPlotIsCancelled(inNotify, n))
+      break;
+
+    int i = theIndex ? theIndex[n] : n;
     double theX = mDataX->GetSample(i);
     double theY = mDataY->GetSample(i);
     double theScreenX = inTrafoX->Transform(theX);
@@ -955,7 +1145,7 @@ void iupPlotDataSet::DrawDataLine(const iupPlotTrafoBase *inTrafoX, const iupPlo
       cdfCanvasMark(canvas, theScreenX, theScreenY);
     }
 
-    if (i == mHighlightedSample)
+    if (!theIndex && i == mHighlightedSample)
       iPlotDrawHighlightedMark(canvas, theScreenX, theScreenY);
 
     if (i > 0 && mSegment && mSegment->GetSampleBool(i))
@@ -969,6 +1159,9 @@ void iupPlotDataSet::DrawDataLine(const iupPlotTrafoBase *inTrafoX, const iupPlo
 
   cdCanvasEnd(canvas);
 
+  if (theIndex && mHighlightedSample >= 0 && mHighlightedSample < mDataX->GetCount())
+    iPlotDrawHighlightedMark(canvas, inTrafoX->Transform(mDataX->GetSample(mHighlightedSample)), inTrafoY->Transform(mDataY->GetSample(mHighlightedSample)));
+
   if (mHighlightedCurve)
   {
     int foreground = cdCanvasForeground(canvas, CD_QUERY);
@@ -982,8 +1175,12 @@ void iupPlotDataSet::DrawDataLine(const iupPlotTrafoBase *inTrafoX, const iupPlo
 
     cdCanvasBegin(canvas, CD_OPEN_LINES);
 
-    for (int i = 0; i < theCount; i++)
+    for (int n = 0; n < theCount; n++)
     {
+      if (iPlotIsCancelled(inNotify, n))
+        break;
+
+      int i = theIndex ? theIndex[n] : n;
       double theX = mDataX->GetSample(i);
       double theY = mDataY->GetSample(i);
       double theScreenX = inTrafoX->Transform(theX);
@@ -1033,8 +1230,14 @@ void iupPlotDataSet::SetSampleExtraMarkSize(const iupPlotTrafoBase *inTrafoY, cd
 void iupPlotDataSet::DrawDataMark(const iupPlotTrafoBase *inTrafoX, const iupPlotTrafoBase *inTrafoY, cdCanvas* canvas, const iupPlotSampleNotify* inNotify) const
 {
   int theCount = mDataX->GetCount();
-  for (int i = 0; i < theCount; i++)
+  const int* theIndex = GetDecimateIndex(inTrafoX, inTrafoY, canvas, inNotify, theCount);
+
+  for (int n = 0; n < theCount; n++)
   {
+    if (iPlotIsCancelled(inNotify, n))
+      break;
+
+    int i = theIndex ? theIndex[n] : n;
     double theX = mDataX->GetSample(i);
     double theY = mDataY->GetSample(i);
     double theScreenX = inTrafoX->Transform(theX);
@@ -1048,9 +1251,12 @@ void iupPlotDataSet::DrawDataMark(const iupPlotTrafoBase *inTrafoX, const iupPlo
 
     cdfCanvasMark(canvas, theScreenX, theScreenY);
 
-    if (i == mHighlightedSample)
+    if (!theIndex && i == mHighlightedSample)
       iPlotDrawHighlightedMark(canvas, theScreenX, theScreenY);
   }
+
+  if (theIndex && mHighlightedSample >= 0 && mHighlightedSample < mDataX->GetCount())
+    iPlotDrawHighlightedMark(canvas, inTrafoX->Transform(mDataX->GetSample(mHighlightedSample)), inTrafoY->Transform(mDataY->GetSample(mHighlightedSample)));
 }
 
 void iupPlotDataSet::DrawDataStem(const iupPlotTrafoBase *inTrafoX, const iupPlotTrafoBase *inTrafoY, cdCanvas* canvas, const iupPlotSampleNotify* inNotify, bool inShowMark) const
@@ -1060,6 +1266,9 @@ void iupPlotDataSet::DrawDataStem(const iupPlotTrafoBase *inTrafoX, const iupPlo
   int theCount = mDataX->GetCount();
   for (int i = 0; i < theCount; i++)
   {
+    if (iPlotIsCancelled(inNotify, i))
+      break;
+
     double theX = mDataX->GetSample(i);
     double theY = mDataY->GetSample(i);
     double theScreenX = inTrafoX->Transform(theX);
@@ -1099,6 +1308,9 @@ void iupPlotDataSet::DrawDataArea(const iupPlotTrafoBase *inTrafoX, const iupPlo
 
   for (int i = 0; i < theCount; i++)
   {
+    if (iPlotIsCancelled(inNotify, i))
+      break;
+
     double theX = mDataX->GetSample(i);
     double theY = mDataY->GetSample(i);
     double theScreenX = inTrafoX->Transform(theX);
@@ -1137,6 +1349,9 @@ void iupPlotDataSet::DrawDataArea(const iupPlotTrafoBase *inTrafoX, const iupPlo
 
     for (int i = 0; i < theCount; i++)
     {
+      if (iPlotIsCancelled(inNotify, i))
+        break;
+
       double theX = mDataX->GetSample(i);
       double theY = mDataY->GetSample(i);
       double theScreenX = inTrafoX->Transform(theX);
@@ -1169,6 +1384,9 @@ void iupPlotDataSet::DrawDataArea(const iupPlotTrafoBase *inTrafoX, const iupPlo
 
     for (int i = 0; i < theCount; i++)
     {
+      if (iPlotIsCancelled(inNotify, i))
+        break;
+
       double theX = mDataX->GetSample(i);
       double theY = mDataY->GetSample(i);
       double theScreenX = inTrafoX->Transform(theX);
@@ -1206,6 +1424,9 @@ void iupPlotDataSet::DrawDataBar(const iupPlotTrafoBase *inTrafoX, const iupPlot
 
   for (int i = 0; i < theCount; i++)
   {
+    if (iPlotIsCancelled(inNotify, i))
+      break;
+
     double theX = mDataX->GetSample(i);
     double theY = mDataY->GetSample(i);
     double theScreenX = inTrafoX->Transform(theX);
@@ -1255,6 +1476,9 @@ void iupPlotDataSet::DrawDataHorizontalBar(const iupPlotTrafoBase *inTrafoX, con
 
   for (int i = 0; i < theCount; i++)
   {
+    if (iPlotIsCancelled(inNotify, i))
+      break;
+
     double theX = mDataX->GetSample(i);
     double theY = mDataY->GetSample(i);
     double theScreenX = inTrafoX->Transform(theX);
@@ -1304,6 +1528,9 @@ void iupPlotDataSet::DrawDataMultiBar(const iupPlotTrafoBase *inTrafoX, const iu
 
   for (int i = 0; i < theCount; i++)
   {
+    if (iPlotIsCancelled(inNotify, i))
+      break;
+
     double theX = mDataX->GetSample(i);
     double theY = mDataY->GetSample(i);
     double theScreenX = inTrafoX->Transform(theX);
@@ -1342,6 +1569,9 @@ void iupPlotDataSet::DrawDataStep(const iupPlotTrafoBase *inTrafoX, const iupPlo
 
   for (int i = 0; i < theCount; i++)
   {
+    if (iPlotIsCancelled(inNotify, i))
+      break;
+
     double theX = mDataX->GetSample(i);
     double theY = mDataY->GetSample(i);
     double theScreenX = inTrafoX->Transform(theX);
@@ -1385,6 +1615,9 @@ void iupPlotDataSet::DrawDataStep(const iupPlotTrafoBase *inTrafoX, const iupPlo
 
     for (int i = 0; i < theCount; i++)
     {
+      if (iPlotIsCancelled(inNotify, i))
+        break;
+
       double theX = mDataX->GetSample(i);
       double theY = mDataY->GetSample(i);
       double theScreenX = inTrafoX->Transform(theX);
@@ -1592,6 +1825,9 @@ void iupPlotDataSet::DrawSelection(const iupPlotTrafoBase *inTrafoX, const iupPl
 
   for (int i = 0; i < theCount; i++)
   {
+    if (iPlotIsCancelled(inNotify, i))
+      break;
+
     if (mSelection->GetSampleBool(i))
     {
       double theX = mDataX->GetSample(i);
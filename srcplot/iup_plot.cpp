@@ -7,6 +7,7 @@
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
+#include <limits.h>
 
 #include "iupPlot.h"
 
@@ -1321,11 +1322,14 @@ void iupPlotRedraw(Ihandle* ih, int flush, int only_current, int reset_redraw)
 
   cdCanvasActivate(ih->data->cd_canvas);
 
+  // the datasets can be rendered in a worker thread, except in OpenGL
+  bool async = ih->data->async_render && ih->data->graphics_mode != IUP_PLOT_OPENGL;
+
   if (only_current)
   {
     if (reset_redraw)
       ih->data->current_plot->mRedraw = true;
-    ih->data->current_plot->Render(ih->data->cd_canvas);
+    ih->data->current_plot->Render(ih->data->cd_canvas, async);
   }
   else
   {
@@ -1337,7 +1341,7 @@ void iupPlotRedraw(Ihandle* ih, int flush, int only_current, int reset_redraw)
 
       if (reset_redraw)
         ih->data->current_plot->mRedraw = true;
-      ih->data->current_plot->Render(ih->data->cd_canvas);
+      ih->data->current_plot->Render(ih->data->cd_canvas, async);
     }
     iupPlotSetPlotCurrent(ih, old_current);
   }
@@ -2197,6 +2201,29 @@ int IupPlotEnd(Ihandle* ih)
   return ih->data->current_plot->mCurrentDataSet;
 }
 
+int IupPlotNewRingDataSet(Ihandle* ih, int capacity)
+{
+  iupASSERT(iupObjectCheck(ih));
+  if (!iupObjectCheck(ih))
+    return -1;
+
+  if (ih->iclass->nativetype != IUP_TYPECANVAS ||
+      !IupClassMatch(ih, "plot"))
+      return -1;
+
+  if (capacity <= 0)
+    return -1;
+
+  iupPlotDataSet* theDataSet = new iupPlotDataSet(false);
+  theDataSet->SetCapacity(capacity);
+  theDataSet->ReserveSamples(capacity);
+
+  ih->data->current_plot->AddDataSet(theDataSet);
+
+  ih->data->current_plot->mRedraw = true;
+  return ih->data->current_plot->mCurrentDataSet;
+}
+
 void IupPlotInsert(Ihandle* ih, int inIndex, int inSampleIndex, double inX, double inY)
 {
   iupASSERT(iupObjectCheck(ih));
@@ -2262,8 +2289,7 @@ void IupPlotAddSamples(Ihandle* ih, int inIndex, double *x, double *y, int count
     return;
 
   iupPlotDataSet* theDataSet = ih->data->current_plot->mDataSetList[inIndex];
-  for (int i = 0; i < count; i++)
-    theDataSet->AddSample(x[i], y[i]);
+  theDataSet->AddSamples(x, y, count);
 }
 
 void IupPlotAddStrSamples(Ihandle* ih, int inIndex, const char** x, double* y, int count)
@@ -2284,7 +2310,24 @@ void IupPlotAddStrSamples(Ihandle* ih, int inIndex, const char** x, double* y, i
     theDataSet->AddSample(x[i], y[i]);
 }
 
-void IupPlotInsertStrSamples(Ihandle* ih, int inIndex, int inSampleIndex, const char** inX, double* inY, int count)
+void IupPlotSetDataSetBuffers(Ihandle* ih, int inIndex, const double* x, const double* y, int count, int stride)
+{
+  iupASSERT(iupObjectCheck(ih));
+  if (!iupObjectCheck(ih))
+    return;
+
+  if (ih->iclass->nativetype != IUP_TYPECANVAS ||
+      !IupClassMatch(ih, "plot"))
+      return;
+
+  if (inIndex < 0 || inIndex >= ih->data->current_plot->mDataSetListCount)
+    return;
+
+  iupPlotDataSet* theDataSet = ih->data->current_plot->mDataSetList[inIndex];
+  theDataSet->SetBuffers(x, y, count, stride);
+}
+
+void IupPlotAppendDataSetBuffers(Ihandle* ih, int inIndex, int count)
 {
   iupASSERT(iupObjectCheck(ih));
   if (!iupObjectCheck(ih))
@@ -2298,7 +2341,23 @@ void IupPlotInsertStrSamples(Ihandle* ih, int inIndex, int inSampleIndex, const
     return;
 
   iupPlotDataSet* theDataSet = ih->data->current_plot->mDataSetList[inIndex];
+  theDataSet->AppendBuffers(count);
+}
+
+void IupPlotInsertStrSamples(Ihandle* ih, int inIndex, int inSampleIndex, const char** inX, double* inY, int count)
+{
+  iupASSERT(iupObjectCheck(ih));
+  if (!iupObjectCheck(ih))
+    return;
+
+  if (ih->iclass->nativetype != IUP_TYPECANVAS ||
+      !IupClassMatch(ih, "plot"))
+      return;
 
+  if (inIndex < 0 || inIndex >= ih->data->current_plot->mDataSetListCount)
+    return;
+
+  iupPlotDataSet* theDataSet = ih->data->current_plot->mDataSetList[inIndex];
   for (int i = 0; i < count; i++)
     theDataSet->InsertSample(inSampleIndex + i, inX[i], inY[i]);
 }
@@ -2317,7 +2376,6 @@ void IupPlotInsertSamples(Ihandle* ih, int inIndex, int inSampleIndex, double *i
     return;
 
   iupPlotDataSet* theDataSet = ih->data->current_plot->mDataSetList[inIndex];
-
   for (int i = 0; i < count; i++)
     theDataSet->InsertSample(inSampleIndex + i, inX[i], inY[i]);
 }
@@ -2520,8 +2578,10 @@ void IupPlotPaintTo(Ihandle* ih, cdCanvas* cnv)
     return;
 
   cdCanvas *old_cd_canvas = ih->data->cd_canvas;
+  int old_async_render = ih->data->async_render;
 
   ih->data->cd_canvas = (cdCanvas*)cnv;
+  ih->data->async_render = 0;  // external canvases are always rendered at once
   iupPlotUpdateViewports(ih);
 
   // when drawing to an external canvas
@@ -2532,160 +2592,399 @@ void IupPlotPaintTo(Ihandle* ih, cdCanvas* cnv)
   iupPlotRedraw(ih, flush, only_current, reset_redraw);
 
   ih->data->cd_canvas = old_cd_canvas;
+  ih->data->async_render = old_async_render;
   iupPlotUpdateViewports(ih);
 }
 
 
-static const char* iPlotSkipValue(const char* line_buffer)
+#define IPLOT_LOAD_BLOCK 4096  /* samples appended at once to each dataset */
+
+static const double iplot_pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+static int iPlotIsSeparator(char ch)
 {
-  // fix next separator
-  char ch = *line_buffer;
-  while (ch != ' ' && ch != '\t' && ch != ';' && ch != 0)
-  {
-    line_buffer++;
-    ch = *line_buffer;
-  }
+  return ch == ' ' || ch == '\t' || ch == ';' || ch == ',' || ch == '\r';
+}
+
+static const char* iPlotSkipValue(const char* line, const char* line_end)
+{
+  // find next separator
+  while (line < line_end && !iPlotIsSeparator(*line))
+    line++;
 
   // skip separators
-  while ((ch == ' ' || ch == '\t' || ch == ';') && ch != 0)
+  while (line < line_end && iPlotIsSeparator(*line))
+    line++;
+
+  return line;
+}
+
+static int iPlotCountValues(const char* line, const char* line_end)
+{
+  int count = 0;
+
+  while (line < line_end)
   {
-    line_buffer++;
-    ch = *line_buffer;
+    line = iPlotSkipValue(line, line_end);
+    count++;
   }
 
-  return line_buffer;
+  return count;
 }
 
-static int iPlotCountDataSets(const char* line_buffer)
+static int iPlotSplitValues(const char* line, const char* line_end, const char** values, const char** values_end, int count)
 {
-  int ds_count = 0;
-
-  while (*line_buffer != 0)
+  for (int v = 0; v < count; v++)
   {
-    line_buffer = iPlotSkipValue(line_buffer);
-    ds_count++;
+    if (line == line_end)
+      return 0;
+
+    values[v] = line;
+    while (line < line_end && !iPlotIsSeparator(*line))
+      line++;
+    values_end[v] = line;
+
+    while (line < line_end && iPlotIsSeparator(*line))
+      line++;
   }
 
-  return ds_count;
+  return 1;
 }
 
-static int iPlotAddToDataSets(Ihandle* ih, const char* line_buffer, int ds_start, int ds_count)
+static int iPlotParseValue(const char* value, const char* value_end, double *outValue)
 {
-  double x = 0;
-  double value;
+  const char* p = value;
+  double mantissa = 0;
+  int digits = 0, exponent = 0, has_digits = 0, negative = 0;
 
-  for (int ds = 0; ds < ds_count; ds++)
+  if (p < value_end && (*p == '-' || *p == '+'))
   {
-    int ret = sscanf(line_buffer, "%lf", &value);
-    if (!ret)
-      return 0;
+    negative = (*p == '-');
+    p++;
+  }
 
-    line_buffer = iPlotSkipValue(line_buffer);
+  while (p < value_end && *p >= '0' && *p <= '9')
+  {
+    if (mantissa != 0 || *p != '0')
+    {
+      mantissa = mantissa * 10 + (*p - '0');
+      digits++;
+    }
+    has_digits = 1;
+    p++;
+  }
 
-    if (ds == 0)
-      x = value;
-    else
+  if (p < value_end && *p == '.')
+  {
+    p++;
+    while (p < value_end && *p >= '0' && *p <= '9')
+    {
+      if (mantissa != 0 || *p != '0')
+      {
+        mantissa = mantissa * 10 + (*p - '0');
+        digits++;
+      }
+      exponent--;
+      has_digits = 1;
+      p++;
+    }
+  }
+
+  if (has_digits && p < value_end && (*p == 'e' || *p == 'E'))
+  {
+    int exp_negative = 0, exp_value = 0;
+    const char* exp_start;
+
+    p++;
+    if (p < value_end && (*p == '-' || *p == '+'))
     {
-      double y = value;
+      exp_negative = (*p == '-');
+      p++;
+    }
 
-      iupPlotDataSet* theDataSet = ih->data->current_plot->mDataSetList[ds_start + ds - 1];
-      theDataSet->AddSample(x, y);
+    exp_start = p;
+    while (p < value_end && *p >= '0' && *p <= '9')
+    {
+      if (exp_value < 10000)
+        exp_value = exp_value * 10 + (*p - '0');
+      p++;
     }
+
+    if (p == exp_start)
+      has_digits = 0;
+
+    exponent += exp_negative ? -exp_value : exp_value;
   }
 
-  return 1;
+  /* up to 15 digits and 10^22 both mantissa and power of 10 are exact doubles, 
+     so a single multiplication or division gives the correctly rounded result */
+  if (has_digits && p == value_end && digits <= 15 && exponent >= -22 && exponent <= 22)
+  {
+    if (exponent < 0)
+      mantissa /= iplot_pow10[-exponent];
+    else
+      mantissa *= iplot_pow10[exponent];
+
+    *outValue = negative ? -mantissa : mantissa;
+    return 1;
+  }
+
+  /* long numbers, large exponents, "inf", "nan", hexadecimal, ... */
+  {
+    char buffer[100];
+    char* end;
+    int len = (int)(value_end - value);
+    if (len >= 100)
+      return 0;
+
+    memcpy(buffer, value, len);
+    buffer[len] = 0;
+
+    *outValue = strtod(buffer, &end);
+    return end != buffer;
+  }
 }
 
-static int iPlotAddToDataSetsStrX(Ihandle* ih, const char* line_buffer, int ds_start, int ds_count)
+static int* iPlotParseColumns(const char* columns, int *col_count)
 {
-  char x[100] = "";
-  double value = 0;
+  int count = 0, max_count = 10;
+  int* col_index = (int*)malloc(max_count * sizeof(int));
 
-  for (int ds = 0; ds < ds_count; ds++)
+  while (*columns)
   {
-    if (ds == 0)
+    if (*columns >= '0' && *columns <= '9')
     {
-      int ret = sscanf(line_buffer, "%s", x);
-      if (!ret)
-        return 0;
+      int col = 0;
+      while (*columns >= '0' && *columns <= '9')
+      {
+        col = col * 10 + (*columns - '0');
+        columns++;
+      }
+
+      if (count == max_count)
+      {
+        max_count += 10;
+        col_index = (int*)realloc(col_index, max_count * sizeof(int));
+      }
+
+      col_index[count] = col;
+      count++;
     }
+    else if (iPlotIsSeparator(*columns))
+      columns++;
     else
     {
-      int ret = sscanf(line_buffer, "%lf", &value);
-      if (!ret)
-        return 0;
+      free(col_index);
+      return NULL;
     }
+  }
+
+  if (count < 2) // must have at least X and Y1
+  {
+    free(col_index);
+    return NULL;
+  }
+
+  *col_count = count;
+  return col_index;
+}
 
-    line_buffer = iPlotSkipValue(line_buffer);
+static int* iPlotDefaultColumns(int col_count)
+{
+  int* col_index = (int*)malloc(col_count * sizeof(int));
+  for (int col = 0; col < col_count; col++)
+    col_index[col] = col;
+  return col_index;
+}
+
+static int iPlotCreateDataSets(Ihandle* ih, int ds_count, int strXdata)
+{
+  int ds_start = ih->data->current_plot->mDataSetListCount;
+
+  for (int ds = 0; ds < ds_count; ds++)
+  {
+    iupPlotDataSet* theDataSet = new iupPlotDataSet(strXdata ? true : false);
+    ih->data->current_plot->AddDataSet(theDataSet);
+  }
 
-    if (ds != 0)
+  return ds_start;
+}
+
+static void iPlotAddToDataSets(Ihandle* ih, int ds_start, int ds_count, const double* x, const double* y, int count)
+{
+  for (int ds = 0; ds < ds_count; ds++)
+  {
+    iupPlotDataSet* theDataSet = ih->data->current_plot->mDataSetList[ds_start + ds];
+    theDataSet->AddSamples(x, y + ds * IPLOT_LOAD_BLOCK, count);
+  }
+}
+
+static int iPlotLoadDataLine(Ihandle* ih, const char** values, const char** values_end, const int* col_index, int ds_start, int ds_count, int strXdata, double* x, double* y, int count)
+{
+  if (strXdata)
+  {
+    char x_str[100];
+    int len = (int)(values_end[col_index[0]] - values[col_index[0]]);
+    if (len > 99) len = 99;
+    memcpy(x_str, values[col_index[0]], len);
+    x_str[len] = 0;
+
+    for (int ds = 0; ds < ds_count; ds++)
     {
-      double y = value;
+      double value;
+      int col = col_index[ds + 1];
+      if (!iPlotParseValue(values[col], values_end[col], &value))
+        return 0;
+
+      iupPlotDataSet* theDataSet = ih->data->current_plot->mDataSetList[ds_start + ds];
+      theDataSet->AddSample(x_str, value);
+    }
+  }
+  else
+  {
+    if (!iPlotParseValue(values[col_index[0]], values_end[col_index[0]], x + count))
+      return 0;
 
-      iupPlotDataSet* theDataSet = ih->data->current_plot->mDataSetList[ds_start + ds - 1];
-      theDataSet->AddSample(x, y);
+    for (int ds = 0; ds < ds_count; ds++)
+    {
+      int col = col_index[ds + 1];
+      if (!iPlotParseValue(values[col], values_end[col], y + ds * IPLOT_LOAD_BLOCK + count))
+        return 0;
     }
   }
 
   return 1;
 }
 
-static int iPlotLoadDataFile(Ihandle* ih, IlineFile* line_file, int strXdata)
+static void iPlotSetDataSetNames(Ihandle* ih, const char** values, const char** values_end, const int* col_index, int ds_start, int ds_count)
+{
+  for (int ds = 0; ds < ds_count; ds++)
+  {
+    char name[100];
+    int col = col_index[ds + 1];
+    int len = (int)(values_end[col] - values[col]);
+    if (len > 99) len = 99;
+    memcpy(name, values[col], len);
+    name[len] = 0;
+
+    iupPlotDataSet* theDataSet = ih->data->current_plot->mDataSetList[ds_start + ds];
+    theDataSet->SetName(name);
+  }
+}
+
+static int iPlotLoadDataFile(Ihandle* ih, IlineFile* line_file, int strXdata, int* col_index, int col_count)
 {
   int first_line = 1;
-  int ds_count = 0;
-  int ds, ds_start = ih->data->current_plot->mDataSetListCount;
+  int ds_count = 0, ds_start = 0;
+  int value_count = 0, count = 0;
+  int ret = 1;
+  const char** values = NULL;
+  const char** values_end = NULL;
+  double* x = NULL;
+  double* y = NULL;
 
   do
   {
-    int line_len = iupLineFileReadLine(line_file);
-    if (line_len == -1)
-      return 0;
+    int line_len;
+    const char* line = iupLineFileReadLineView(line_file, &line_len);
+    if (!line)
+    {
+      ret = 0;
+      break;
+    }
 
-    const char* line_buffer = iupLineFileGetBuffer(line_file);
+    const char* line_end = line + line_len;
 
-    int i = 0;
-    while (line_buffer[i] == ' ') /* ignore spaces at start */
-      i++;
+    while (line < line_end && (*line == ' ' || *line == '\t')) /* ignore spaces at start */
+      line++;
 
-    if (line_buffer[i] == 0) /* skip empty line */
+    if (line == line_end) /* skip empty line */
       continue;
 
-    if (line_buffer[i] == '#') /* "#" signifies a comment line when used as the first non-space character on a line */
+    if (*line == '#') /* "#" signifies a comment line when used as the first non-space character on a line */
       continue;
 
     if (first_line)
     {
-      ds_count = iPlotCountDataSets(line_buffer);
-      if (ds_count < 2) // must have at least X and Y1, could have Y2, Y3, ...
-        return 0;
+      if (!col_index)
+      {
+        col_count = iPlotCountValues(line, line_end);
+        if (col_count < 2) // must have at least X and Y1, could have Y2, Y3, ...
+        {
+          ret = 0;
+          break;
+        }
+
+        col_index = iPlotDefaultColumns(col_count);
+      }
+
+      value_count = 0;
+      for (int col = 0; col < col_count; col++)
+      {
+        if (col_index[col] >= value_count)
+          value_count = col_index[col] + 1;
+      }
+
+      values = (const char**)malloc(value_count * sizeof(const char*));
+      values_end = (const char**)malloc(value_count * sizeof(const char*));
+      ds_count = col_count - 1;
+      x = (double*)malloc(IPLOT_LOAD_BLOCK * sizeof(double));
+      y = (double*)malloc(ds_count * IPLOT_LOAD_BLOCK * sizeof(double));
 
-      for (ds = 0; ds < ds_count - 1; ds++)
+      if (!iPlotSplitValues(line, line_end, values, values_end, value_count))
       {
-        iupPlotDataSet* theDataSet = new iupPlotDataSet(strXdata ? true : false);
-        ih->data->current_plot->AddDataSet(theDataSet);
+        ret = 0;
+        break;
       }
 
+      ds_start = iPlotCreateDataSets(ih, ds_count, strXdata);
       first_line = 0;
-    }
 
-    if (strXdata)
+      /* a first line that is not numeric is a header with the dataset names */
+      double value;
+      if (!iPlotParseValue(values[col_index[1]], values_end[col_index[1]], &value))
+      {
+        iPlotSetDataSetNames(ih, values, values_end, col_index, ds_start, ds_count);
+        continue;
+      }
+    }
+    else if (!iPlotSplitValues(line, line_end, values, values_end, value_count))
     {
-      if (!iPlotAddToDataSetsStrX(ih, line_buffer + i, ds_start, ds_count))
-        return 0;
+      ret = 0;
+      break;
     }
-    else
+
+    if (!iPlotLoadDataLine(ih, values, values_end, col_index, ds_start, ds_count, strXdata, x, y, count))
     {
-      if (!iPlotAddToDataSets(ih, line_buffer + i, ds_start, ds_count))
-        return 0;
+      ret = 0;
+      break;
     }
 
+    if (!strXdata)
+    {
+      count++;
+      if (count == IPLOT_LOAD_BLOCK)
+      {
+        iPlotAddToDataSets(ih, ds_start, ds_count, x, y, count);
+        count = 0;
+      }
+    }
   } while (!iupLineFileEOF(line_file));
 
-  return 1;
+  if (count)
+    iPlotAddToDataSets(ih, ds_start, ds_count, x, y, count);
+
+  if (values) free(values);
+  if (values_end) free(values_end);
+  if (x) free(x);
+  if (y) free(y);
+  if (col_index) free(col_index);
+
+  return ret;
 }
 
-int IupPlotLoadData(Ihandle* ih, const char* filename, int strXdata)
+int IupPlotLoadDataColumns(Ihandle* ih, const char* filename, int strXdata, const char* columns)
 {
   iupASSERT(iupObjectCheck(ih));
   if (!iupObjectCheck(ih))
@@ -2698,17 +2997,165 @@ int IupPlotLoadData(Ihandle* ih, const char* filename, int strXdata)
   if (!filename)
     return 0;
 
-  IlineFile* line_file = iupLineFileOpen(filename);
+  int* col_index = NULL;
+  int col_count = 0;
+  if (columns)
+  {
+    col_index = iPlotParseColumns(columns, &col_count);
+    if (!col_index)
+      return 0;
+  }
+
+  IlineFile* line_file = iupLineFileOpenMapped(filename);
   if (!line_file)
+  {
+    if (col_index) free(col_index);
     return 0;
+  }
 
-  int error = iPlotLoadDataFile(ih, line_file, strXdata);
+  int error = iPlotLoadDataFile(ih, line_file, strXdata, col_index, col_count);
 
   iupLineFileClose(line_file);
 
   return error;
 }
 
+int IupPlotLoadData(Ihandle* ih, const char* filename, int strXdata)
+{
+  return IupPlotLoadDataColumns(ih, filename, strXdata, NULL);
+}
+
+static double iPlotGetBinaryValue(const unsigned char* value, int float_data, int swap)
+{
+  unsigned char bytes[8];
+  int size = float_data ? 4 : 8;
+
+  if (swap)
+  {
+    for (int i = 0; i < size; i++)
+      bytes[i] = value[size - 1 - i];
+  }
+  else
+    memcpy(bytes, value, size);
+
+  if (float_data)
+  {
+    float f;
+    memcpy(&f, bytes, 4);
+    return f;
+  }
+  else
+  {
+    double d;
+    memcpy(&d, bytes, 8);
+    return d;
+  }
+}
+
+int IupPlotLoadDataBinary(Ihandle* ih, const char* filename, int col_count, int float_data, const char* columns)
+{
+  iupASSERT(iupObjectCheck(ih));
+  if (!iupObjectCheck(ih))
+    return 0;
+
+  if (ih->iclass->nativetype != IUP_TYPECANVAS ||
+      !IupClassMatch(ih, "plot"))
+      return 0;
+
+  if (!filename || col_count < 2)
+    return 0;
+
+  int* col_index;
+  int ds_count = col_count - 1;
+  if (columns)
+  {
+    int count;
+    col_index = iPlotParseColumns(columns, &count);
+    if (!col_index)
+      return 0;
+
+    for (int col = 0; col < count; col++)
+    {
+      if (col_index[col] >= col_count)
+      {
+        free(col_index);
+        return 0;
+      }
+    }
+
+    ds_count = count - 1;
+  }
+  else
+    col_index = iPlotDefaultColumns(col_count);
+
+  FILE* file = fopen(filename, "rb");
+  if (!file)
+  {
+    free(col_index);
+    return 0;
+  }
+
+  int one = 1;
+  int swap = *((unsigned char*)&one) == 0;  /* data is always little endian */
+  int value_size = float_data ? 4 : 8;
+  int row_size = col_count * value_size;
+  int ds_start = iPlotCreateDataSets(ih, ds_count, 0);
+  int ds, ret = 1;
+
+  /* reserve memory for all samples, when the file size is available,
+     appending to existing samples is left to the geometric growth of the arrays */
+  long file_size = 0;
+  if (fseek(file, 0, SEEK_END) == 0)
+    file_size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  if (file_size > 0 && file_size / row_size < INT_MAX)
+  {
+    for (ds = 0; ds < ds_count; ds++)
+    {
+      iupPlotDataSet* theDataSet = ih->data->current_plot->mDataSetList[ds_start + ds];
+      if (theDataSet->GetCount() == 0)
+        theDataSet->ReserveSamples((int)(file_size / row_size));
+    }
+  }
+
+  unsigned char* buffer = (unsigned char*)malloc(IPLOT_LOAD_BLOCK * row_size);
+  double* x = (double*)malloc(IPLOT_LOAD_BLOCK * sizeof(double));
+  double* y = (double*)malloc(ds_count * IPLOT_LOAD_BLOCK * sizeof(double));
+
+  for (;;)
+  {
+    size_t size = fread(buffer, 1, IPLOT_LOAD_BLOCK * row_size, file);
+    int count = (int)(size / row_size);
+
+    for (int i = 0; i < count; i++)
+    {
+      const unsigned char* row = buffer + i * row_size;
+
+      x[i] = iPlotGetBinaryValue(row + col_index[0] * value_size, float_data, swap);
+      for (ds = 0; ds < ds_count; ds++)
+        y[ds * IPLOT_LOAD_BLOCK + i] = iPlotGetBinaryValue(row + col_index[ds + 1] * value_size, float_data, swap);
+    }
+
+    if (count)
+      iPlotAddToDataSets(ih, ds_start, ds_count, x, y, count);
+
+    if (size < (size_t)(IPLOT_LOAD_BLOCK * row_size))
+    {
+      if (ferror(file) || size % row_size != 0)  /* incomplete last row */
+        ret = 0;
+      break;
+    }
+  }
+
+  free(buffer);
+  free(x);
+  free(y);
+  free(col_index);
+  fclose(file);
+
+  return ret;
+}
+
 int IupPlotFindSample(Ihandle* ih, double cnv_x, double cnv_y, int *ds_index, int *sample_index)
 {
   iupASSERT(iupObjectCheck(ih));
@@ -1280,6 +1280,35 @@ static char* iPlotGetSyncViewAttrib(Ihandle* ih)
   return iupStrReturnBoolean(ih->data->sync_view);
 }
 
+static int iPlotSetAsyncRenderAttrib(Ihandle* ih, const char* value)
+{
+  ih->data->async_render = iupStrBoolean(value);
+
+  if (!ih->data->async_render)
+  {
+    // stop the worker threads
+    for (int p = 0; p < ih->data->plot_list_count; p++)
+      ih->data->plot_list[p]->StopAsyncRender();
+  }
+
+  return 0;
+}
+
+static char* iPlotGetAsyncRenderAttrib(Ihandle* ih)
+{
+  return iupStrReturnBoolean(ih->data->async_render);
+}
+
+static char* iPlotGetAsyncRenderPendingAttrib(Ihandle* ih)
+{
+  for (int p = 0; p < ih->data->plot_list_count; p++)
+  {
+    if (ih->data->plot_list[p]->IsAsyncRenderPending())
+      return iupStrReturnBoolean(1);
+  }
+  return iupStrReturnBoolean(0);
+}
+
 static int iPlotSetReadOnlyAttrib(Ihandle* ih, const char* value)
 {
   ih->data->read_only = iupStrBoolean(value);
@@ -2038,6 +2067,62 @@ static char* iPlotGetDSOrderedXAttrib(Ihandle* ih)
   return iupStrReturnBoolean(dataset->mOrderedX ? 1 : 0);
 }
 
+static int iPlotSetDSCapacityAttrib(Ihandle* ih, const char* value)
+{
+  if (ih->data->current_plot->mCurrentDataSet < 0 ||
+      ih->data->current_plot->mCurrentDataSet >= ih->data->current_plot->mDataSetListCount)
+      return 0;
+
+  iupPlotDataSet* dataset = ih->data->current_plot->mDataSetList[ih->data->current_plot->mCurrentDataSet];
+
+  int capacity;
+  if (iupStrToInt(value, &capacity))
+  {
+    dataset->SetCapacity(capacity);
+    ih->data->current_plot->mRedraw = true;
+  }
+  return 0;
+}
+
+static char* iPlotGetDSCapacityAttrib(Ihandle* ih)
+{
+  if (ih->data->current_plot->mCurrentDataSet < 0 ||
+      ih->data->current_plot->mCurrentDataSet >= ih->data->current_plot->mDataSetListCount)
+      return NULL;
+
+  iupPlotDataSet* dataset = ih->data->current_plot->mDataSetList[ih->data->current_plot->mCurrentDataSet];
+  return iupStrReturnInt(dataset->GetCapacity());
+}
+
+static int iPlotSetDSDecimateAttrib(Ihandle* ih, const char* value)
+{
+  if (ih->data->current_plot->mCurrentDataSet < 0 ||
+      ih->data->current_plot->mCurrentDataSet >= ih->data->current_plot->mDataSetListCount)
+      return 0;
+
+  iupPlotDataSet* dataset = ih->data->current_plot->mDataSetList[ih->data->current_plot->mCurrentDataSet];
+
+  if (iupStrEqualNoCase(value, "MINMAX"))
+    dataset->mDecimate = IUP_PLOT_DECIMATE_MINMAX;
+  else
+    dataset->mDecimate = IUP_PLOT_DECIMATE_NONE;
+
+  ih->data->current_plot->mRedraw = true;
+  return 0;
+}
+
+static char* iPlotGetDSDecimateAttrib(Ihandle* ih)
+{
+  if (ih->data->current_plot->mCurrentDataSet < 0 ||
+      ih->data->current_plot->mCurrentDataSet >= ih->data->current_plot->mDataSetListCount)
+      return NULL;
+
+  const char* decimate_str[] = { "NONE", "MINMAX" };
+
+  iupPlotDataSet* dataset = ih->data->current_plot->mDataSetList[ih->data->current_plot->mCurrentDataSet];
+  return (char*)decimate_str[dataset->mDecimate];
+}
+
 
 static int iPlotSetDSPieSliceLabelPosAttrib(Ihandle* ih, const char* value)
 {
@@ -3461,6 +3546,8 @@ void iupPlotRegisterAttributes(Iclass* ic)
   iupClassRegisterAttribute(ic, "ANTIALIAS", iPlotGetAntialiasAttrib, iPlotSetAntialiasAttrib, IUPAF_SAMEASSYSTEM, "No", IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "REDRAW", NULL, iPlotSetRedrawAttrib, NULL, NULL, IUPAF_WRITEONLY | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "SYNCVIEW", iPlotGetSyncViewAttrib, iPlotSetSyncViewAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "ASYNCRENDER", iPlotGetAsyncRenderAttrib, iPlotSetAsyncRenderAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "ASYNCRENDERPENDING", iPlotGetAsyncRenderPendingAttrib, NULL, NULL, NULL, IUPAF_READONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "READONLY", iPlotGetReadOnlyAttrib, iPlotSetReadOnlyAttrib, IUPAF_SAMEASSYSTEM, "Yes", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "CANVAS", iPlotGetCanvasAttrib, NULL, NULL, NULL, IUPAF_READONLY | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "GRAPHICSMODE", iPlotGetGraphicsModeAttrib, iPlotSetGraphicsModeAttrib, IUPAF_SAMEASSYSTEM, "NATIVEPLUS", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
@@ -3551,6 +3638,8 @@ void iupPlotRegisterAttributes(Iclass* ic)
   iupClassRegisterAttribute(ic, "DS_STRXDATA", iPlotGetDSStrXDataAttrib, NULL, NULL, NULL, IUPAF_READONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "DS_EXTRA", iPlotGetDSExtraAttrib, NULL, NULL, NULL, IUPAF_READONLY | IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "DS_ORDEREDX", iPlotGetDSOrderedXAttrib, iPlotSetDSOrderedXAttrib, NULL, NULL, IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "DS_DECIMATE", iPlotGetDSDecimateAttrib, iPlotSetDSDecimateAttrib, IUPAF_SAMEASSYSTEM, "NONE", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
+  iupClassRegisterAttribute(ic, "DS_CAPACITY", iPlotGetDSCapacityAttrib, iPlotSetDSCapacityAttrib, IUPAF_SAMEASSYSTEM, "0", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
 
   iupClassRegisterAttribute(ic, "VIEWPORTSQUARE", iPlotGetViewportSquareAttrib, iPlotSetViewportSquareAttrib, IUPAF_SAMEASSYSTEM, "NO", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
   iupClassRegisterAttribute(ic, "AXS_SCALEEQUAL", iPlotGetAxisScaleEqualAttrib, iPlotSetAxisScaleEqualAttrib, IUPAF_SAMEASSYSTEM, "NO", IUPAF_NOT_MAPPED | IUPAF_NO_INHERIT);
@@ -23,6 +23,7 @@ struct _IcontrolData
 
   cdCanvas* cd_canvas;
   int graphics_mode;
+  int async_render;
   int default_font_size;
   int default_font_style;
 